@@ -1,16 +1,23 @@
 set(kortex_SOURCES
   src/check.cc
   src/color.cc
+  src/connected_components.cc
+  src/cpu_features.cc
   src/fileio.cc
   src/filter.cc
+  src/filter_fixed.cc
+  src/gradient.cc
   src/image.cc
   src/image_conversion.cc
+  src/image_integral.cc
   src/image_io.cc
   src/image_io_jpg.cc
   src/image_io_png.cc
   src/image_io_pnm.cc
   src/image_paint.cc
+  src/image_pointwise.cc
   src/image_processing.cc
+  src/image_stats.cc
   src/indexed_types.cc
   src/kmatrix.cc
   src/linear_algebra.cc
@@ -21,32 +28,44 @@ set(kortex_SOURCES
   src/mem_unit.cc
   src/message.cc
   src/minmax.cc
+  src/morphology.cc
   src/progress_bar.cc
+  src/pyramid.cc
   src/random.cc
   src/rect2.cc
+  src/resample.cc
   src/rotation.cc
   src/sorting.cc
   src/sse_extensions.cc
   src/string.cc
   src/svd.cc
   src/timer.cc
+  src/warp.cc
 )
 
 set(kortex_HEADERS
   kortex/include/bit_operations.h
   kortex/include/check.h
   kortex/include/color.h
+  kortex/include/connected_components.h
+  kortex/include/cpu_features.h
   kortex/include/defs.h
   kortex/include/fileio.h
   kortex/include/filter.h
+  kortex/include/filter_fixed.h
+  kortex/include/gradient.h
   kortex/include/image_conversion.h
+  kortex/include/image_expr.h
+  kortex/include/image_integral.h
   kortex/include/image.h
   kortex/include/image_io.h
   kortex/include/image_io_jpg.h
   kortex/include/image_io_png.h
   kortex/include/image_io_pnm.h
   kortex/include/image_paint.h
+  kortex/include/image_pixelwise.tcc
   kortex/include/image_processing.h
+  kortex/include/image_stats.h
   kortex/include/indexed_types.h
   kortex/include/kmatrix.h
   kortex/include/lapack_externs.h
@@ -58,9 +77,12 @@ set(kortex_HEADERS
   kortex/include/mem_unit.h
   kortex/include/message.h
   kortex/include/minmax.h
+  kortex/include/morphology.h
   kortex/include/progress_bar.h
+  kortex/include/pyramid.h
   kortex/include/random.h
   kortex/include/rect2.h
+  kortex/include/resample.h
   kortex/include/rotation.h
   kortex/include/sorting.h
   kortex/include/sse_extensions.h
@@ -68,4 +90,5 @@ set(kortex_HEADERS
   kortex/include/svd.h
   kortex/include/timer.h
   kortex/include/types.h
+  kortex/include/warp.h
 )
@@ -0,0 +1,50 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_CONNECTED_COMPONENTS_H
+#define KORTEX_CONNECTED_COMPONENTS_H
+
+#include <kortex/rect2.h>
+#include <cstddef>
+#include <vector>
+
+namespace kortex {
+
+    class Image;
+
+    struct ComponentStats {
+        int    area;
+        Rect2i bbox;     // [lx,ux) x [ly,uy) - dx, dy are the extents
+        float  cx, cy;   // centroid
+    };
+
+    //
+    // two-pass union-find labelling. the rows are cut into strips that are
+    // labelled in parallel, every strip drawing its provisional labels from
+    // the pixel indices it covers so that the strips share one equivalence
+    // table without locks. the strips are then joined along their first
+    // rows, the table is flattened to consecutive labels in raster order of
+    // the components' first pixels, and a second parallel pass relabels the
+    // image and accumulates the statistics.
+    //
+
+    /// labels the 4- or 8-connected components of the nonzero pixels of mask
+    /// (IT_U_GRAY or IT_F_GRAY) into labels - IT_I_GRAY, 0 for the background
+    /// and 1..n for the components. stats[l-1] describes component l when
+    /// stats is given. returns n.
+    int connected_components( const Image& mask, const bool& eight_connected, const bool& run_parallel,
+                              Image& labels, std::vector<ComponentStats>* stats=NULL );
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_CPU_FEATURES_H
+#define KORTEX_CPU_FEATURES_H
+
+#include <kortex/types.h>
+
+// wider instruction sets are compiled per function with the target attribute
+// and selected at runtime - the rest of the library is still built with the
+// baseline flags.
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define KORTEX_X86_DISPATCH
+#define KORTEX_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define KORTEX_TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+#endif
+
+namespace kortex {
+
+    enum SimdLevel { SIMD_NONE=0, SIMD_SSE=1, SIMD_AVX2=2, SIMD_AVX512=3 };
+
+    /// highest instruction set the host cpu (and os) supports. detected once
+    /// through cpuid and cached.
+    SimdLevel cpu_simd_level();
+
+    bool cpu_supports_sse   ();
+    bool cpu_supports_avx2  (); // avx2 + fma
+    bool cpu_supports_avx512(); // avx512f
+
+    string simd_level_name( const SimdLevel& level );
+
+}
+
+#endif
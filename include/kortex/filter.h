@@ -14,15 +14,145 @@
 #ifndef KORTEX_FILTER_H
 #define KORTEX_FILTER_H
 
+#include <kortex/cpu_features.h>
+#include <kortex/check.h>
+
 namespace kortex {
 
-    void filter_hor(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out);
-    void filter_ver(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out);
-    void filter_hv (const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out);
+    /// kernel variant the filter_* functions run with on this host: the widest
+    /// instruction set the cpu supports, capped by filter_set_simd_level(). the
+    /// sse variant requires the library to be built WITH_SSE.
+    SimdLevel filter_simd_level();
+
+    /// caps the kernel variant used by the filter_* functions - SIMD_NONE
+    /// forces the basic (scalar) kernels. returns the variant now in effect.
+    /// the cap is process-wide and applies to every kernel of the library
+    /// that dispatches on filter_simd_level(), not only to the filters.
+    SimdLevel filter_set_simd_level( const SimdLevel& max_level );
+
+    /// name of the kernel a filter_* call with a ksize-tap kernel will run
+    /// [ "avx512", "avx2", "sse", "basic-07", "basic-g" ... ]
+    string filter_kernel_name( const int& ksize );
+
+    /// how the filters extend the image beyond its borders:
+    ///   BORDER_ZERO        : 0 0 | a b c d | 0 0
+    ///   BORDER_REPLICATE   : a a | a b c d | d d
+    ///   BORDER_REFLECT_101 : c b | a b c d | c b
+    ///   BORDER_WRAP        : c d | a b c d | a b
+    enum BorderMode { BORDER_ZERO=0, BORDER_REPLICATE, BORDER_REFLECT_101, BORDER_WRAP };
+
+    /// sample of [0,n) the border mode maps i to - -1 if it reads as zero.
+    inline int border_index( const int& i, const int& n, const BorderMode& border ) {
+        if( i >= 0 && i < n ) return i;
+        switch( border ) {
+        case BORDER_ZERO       : return -1;
+        case BORDER_REPLICATE  : return i < 0 ? 0 : n-1;
+        case BORDER_REFLECT_101: {
+            if( n == 1 ) return 0;
+            int p = 2*(n-1);
+            int j = i % p;
+            if( j < 0 ) j += p;
+            return j < n ? j : p-j;
+        }
+        case BORDER_WRAP: {
+            int j = i % n;
+            return j < 0 ? j+n : j;
+        }
+        default: switch_fatality();
+        }
+    }
+
+    /// out[x] = sum_j kernel[j]*rows[j][x] for x<n - the vertical pass of the
+    /// filters, exposed for other separable passes. out must not alias any
+    /// of the rows.
+    void filter_rows(const float* const* rows, const int& n, const float* kernel, const int& ksize, float* out);
+
+    /// separable filtering of w x h images of nc interleaved channels (a
+    /// pixel-ordered rgb image has nc=3): every channel is filtered on its
+    /// own, but all of them in the same pass over the rows. im and out can be
+    /// the same. the rows of im and out start istride and ostride samples
+    /// apart (w*nc if 0) so that regions of larger images can be filtered
+    /// in place - in-place filtering needs equal strides.
+    void filter_hor(const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize, float* out, const BorderMode& border,
+                    const int& istride=0, const int& ostride=0);
+    void filter_ver(const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize, float* out, const BorderMode& border,
+                    const int& istride=0, const int& ostride=0);
+    void filter_hv (const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize, float* out, const BorderMode& border,
+                    const int& istride=0, const int& ostride=0);
 
-    void filter_hor_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out);
-    void filter_ver_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out);
-    void filter_hv_par (const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out);
+    void filter_hor_par(const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize, float* out, const BorderMode& border,
+                        const int& istride=0, const int& ostride=0);
+    void filter_ver_par(const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize, float* out, const BorderMode& border,
+                        const int& istride=0, const int& ostride=0);
+    void filter_hv_par (const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize, float* out, const BorderMode& border,
+                        const int& istride=0, const int& ostride=0);
+
+    /// recursive gaussian (deriche, 4th order): the cost per pixel does not
+    /// depend on sigma. requires sigma >= 0.5. with BORDER_ZERO the result
+    /// stays within 0.1% of the input range of filter_hv with a
+    /// filter_size(sigma) tap gaussian_1d kernel. strides as above.
+    void filter_gaussian_iir    ( const float* im, const int& w, const int& h, const int& nc, const float& sigma, float* out, const BorderMode& border,
+                                  const int& istride=0, const int& ostride=0 );
+    void filter_gaussian_iir_par( const float* im, const int& w, const int& h, const int& nc, const float& sigma, float* out, const BorderMode& border,
+                                  const int& istride=0, const int& ostride=0 );
+
+    //
+    // single channel versions
+    //
+
+    inline void filter_hor(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out, const BorderMode& border) {
+        filter_hor( im, w, h, 1, kernel, ksize, out, border );
+    }
+    inline void filter_ver(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out, const BorderMode& border) {
+        filter_ver( im, w, h, 1, kernel, ksize, out, border );
+    }
+    inline void filter_hv (const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out, const BorderMode& border) {
+        filter_hv( im, w, h, 1, kernel, ksize, out, border );
+    }
+    inline void filter_hor_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out, const BorderMode& border) {
+        filter_hor_par( im, w, h, 1, kernel, ksize, out, border );
+    }
+    inline void filter_ver_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out, const BorderMode& border) {
+        filter_ver_par( im, w, h, 1, kernel, ksize, out, border );
+    }
+    inline void filter_hv_par (const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out, const BorderMode& border) {
+        filter_hv_par( im, w, h, 1, kernel, ksize, out, border );
+    }
+    inline void filter_gaussian_iir    ( const float* im, const int& w, const int& h, const float& sigma, float* out, const BorderMode& border ) {
+        filter_gaussian_iir( im, w, h, 1, sigma, out, border );
+    }
+    inline void filter_gaussian_iir_par( const float* im, const int& w, const int& h, const float& sigma, float* out, const BorderMode& border ) {
+        filter_gaussian_iir_par( im, w, h, 1, sigma, out, border );
+    }
+
+    //
+    // zero padded versions
+    //
+
+    inline void filter_hor(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out) {
+        filter_hor( im, w, h, kernel, ksize, out, BORDER_ZERO );
+    }
+    inline void filter_ver(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out) {
+        filter_ver( im, w, h, kernel, ksize, out, BORDER_ZERO );
+    }
+    inline void filter_hv (const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out) {
+        filter_hv( im, w, h, kernel, ksize, out, BORDER_ZERO );
+    }
+    inline void filter_hor_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out) {
+        filter_hor_par( im, w, h, kernel, ksize, out, BORDER_ZERO );
+    }
+    inline void filter_ver_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out) {
+        filter_ver_par( im, w, h, kernel, ksize, out, BORDER_ZERO );
+    }
+    inline void filter_hv_par (const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out) {
+        filter_hv_par( im, w, h, kernel, ksize, out, BORDER_ZERO );
+    }
+    inline void filter_gaussian_iir    ( const float* im, const int& w, const int& h, const float& sigma, float* out ) {
+        filter_gaussian_iir( im, w, h, sigma, out, BORDER_ZERO );
+    }
+    inline void filter_gaussian_iir_par( const float* im, const int& w, const int& h, const float& sigma, float* out ) {
+        filter_gaussian_iir_par( im, w, h, sigma, out, BORDER_ZERO );
+    }
 
     inline void filter_hor( float*  im, const int& w, const int& h, const float* kernel, const int& ksize ) {
         filter_hor( im, w, h, kernel, ksize, im );
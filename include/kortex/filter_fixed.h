@@ -0,0 +1,87 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_FILTER_FIXED_H
+#define KORTEX_FILTER_FIXED_H
+
+#include <kortex/types.h>
+#include <kortex/filter.h>
+
+namespace kortex {
+
+    //
+    // separable filtering of 8-bit images in fixed point. the kernel taps are
+    // quantized to FILTER_FIXED_BITS fractional bits and multiplied with
+    // 16-bit samples in pairs (pmaddwd), the horizontal pass keeps
+    // FILTER_FIXED_MID_BITS fractional bits in a 16-bit intermediate. the
+    // results do not depend on the instruction set.
+    //
+    // nc interleaved channels are filtered together: a pixel-ordered rgb
+    // image is a w x h image with nc=3. the kernels need sum(|kernel|) <= 2
+    // so that the intermediate cannot saturate.
+    //
+
+    const int FILTER_FIXED_BITS     = 14;
+    const int FILTER_FIXED_MID_BITS = 6;
+
+    /// rounding of the final result: to nearest (halves up) or down
+    enum FixedRounding { FIXED_ROUND_NEAREST=0, FIXED_ROUND_DOWN=1 };
+
+    /// rounds the taps to FILTER_FIXED_BITS fractional bits. the rounding
+    /// error of the sum is moved to the largest tap so that a normalized
+    /// kernel stays normalized.
+    void filter_fixed_kernel( const float* kernel, const int& ksize, int16_t* qkernel );
+
+    /// uchar in, uchar out (saturated). im and out can be the same. rows
+    /// start istride and ostride samples apart, w*nc if 0 - see filter_hor.
+    void filter_hor_u8( const uchar* im, const int& w, const int& h, const int& nc,
+                        const float* kernel, const int& ksize, uchar* out,
+                        const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST,
+                        const int& istride=0, const int& ostride=0 );
+    void filter_ver_u8( const uchar* im, const int& w, const int& h, const int& nc,
+                        const float* kernel, const int& ksize, uchar* out,
+                        const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST,
+                        const int& istride=0, const int& ostride=0 );
+    void filter_hv_u8 ( const uchar* im, const int& w, const int& h, const int& nc,
+                        const float* kernel, const int& ksize, uchar* out,
+                        const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST,
+                        const int& istride=0, const int& ostride=0 );
+
+    void filter_hor_u8_par( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* kernel, const int& ksize, uchar* out,
+                            const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST,
+                            const int& istride=0, const int& ostride=0 );
+    void filter_ver_u8_par( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* kernel, const int& ksize, uchar* out,
+                            const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST,
+                            const int& istride=0, const int& ostride=0 );
+    void filter_hv_u8_par ( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* kernel, const int& ksize, uchar* out,
+                            const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST,
+                            const int& istride=0, const int& ostride=0 );
+
+    /// uchar in, int16 out: out = result * 2^frac_bits, saturated. frac_bits
+    /// in [0,7] - 7 still fits 255 exactly. hkernel runs along the rows and
+    /// vkernel along the columns, so derivatives keep their sign.
+    void filter_hv_s16    ( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* hkernel, const int& hksize, const float* vkernel, const int& vksize,
+                            const int& frac_bits, int16_t* out,
+                            const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST );
+    void filter_hv_s16_par( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* hkernel, const int& hksize, const float* vkernel, const int& vksize,
+                            const int& frac_bits, int16_t* out,
+                            const BorderMode& border=BORDER_ZERO, const FixedRounding& rounding=FIXED_ROUND_NEAREST );
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_GRADIENT_H
+#define KORTEX_GRADIENT_H
+
+#include <kortex/types.h>
+
+namespace kortex {
+
+    class Image;
+
+    /// the kernels of image_gradient_simple / _prewitt / _sobel with their
+    /// conventions:
+    ///   GRADIENT_SIMPLE : gx = I(x+1)-I(x-1), gy = I(y-1)-I(y+1). one-sided
+    ///                     differences, doubled, at the borders.
+    ///   GRADIENT_PREWITT: gx = ( I(x+1)-I(x-1) )/2 averaged over 3 rows with
+    ///                     1/3 weights, gy the same along y with I(y+1)-I(y-1).
+    ///                     0 at the one pixel boundary.
+    ///   GRADIENT_SOBEL  : as prewitt with 1/4, 1/2, 1/4 weights.
+    enum GradientKernel { GRADIENT_SIMPLE=0, GRADIENT_PREWITT, GRADIENT_SOBEL };
+
+    /// atan2(y,x) mapped to [0,2pi] from a 9th order odd polynomial of
+    /// min(|x|,|y|)/max(|x|,|y|) (abramowitz & stegun 4.4.47). the absolute
+    /// error is below 1.5e-5 radians. fast_atan2(0,0) is 0.
+    float fast_atan2( const float& y, const float& x );
+
+    /// the gradient of img (IT_F_GRAY or IT_U_GRAY) in one pass over the
+    /// source: every row band is converted once and gx, gy, the magnitude
+    /// and the orientation bin are computed together from it - with sse
+    /// four pixels at a time - and written to the outputs that are not NULL.
+    /// gx, gy and mag are created as IT_F_GRAY. ori is created as IT_U_GRAY
+    /// and holds floor( fast_atan2(gy,gx) * n_bins / 2pi ): n_bins bins
+    /// over the full circle, n_bins in [1,256]. bands run in parallel.
+    void image_gradients( const Image& img, const GradientKernel& kernel, const int& n_bins,
+                          const bool& run_parallel, Image* gx, Image* gy, Image* mag, Image* ori );
+
+}
+
+#endif
@@ -53,6 +53,8 @@ namespace kortex {
     class Image {
     private:
         void init_();
+        /// the first byte of sample row r - see row_offset
+        uchar* row_bytes_( const int& r ) const;
 
         int         m_w;
         int         m_h;
@@ -62,6 +64,8 @@ namespace kortex {
         uchar*      m_data_u;
         float*      m_data_f;
         int  *      m_data_i;
+        int         m_stride;
+        size_t      m_plane;
         MemUnit     m_memory;
         bool        m_wrapper;
 
@@ -92,6 +96,29 @@ namespace kortex {
         int         pixel_count()   const { return m_w*m_h;                 }
         size_t      element_count() const { return size_t(m_w)*size_t(m_h)*size_t(m_ch); }
 
+        /// samples between the starts of two rows - of a channel for
+        /// image-ordered types. w*ch or w unless the image is a padded
+        /// wrapper or a view.
+        int         stride()        const { return m_stride;                }
+        /// samples between the channel planes of image-ordered types
+        size_t      plane_stride()  const { return m_plane;                 }
+        /// whether the samples are packed without gaps - only then may
+        /// get_fptr/get_uptr/get_iptr be walked as element_count() samples
+        bool        is_contiguous() const {
+            return m_stride == row_length() && ( m_ch == 1 || m_channel_type == ITC_PIXEL || m_plane == size_t(m_stride)*m_h );
+        }
+
+        /// the samples as rows of equal length: h rows of w*ch samples for
+        /// pixel-ordered types and ch*h rows of w samples, channel by
+        /// channel, for image-ordered ones. row r starts row_offset(r)
+        /// samples after the first sample.
+        int         row_count ()    const { return m_channel_type == ITC_IMAGE ? m_ch*m_h : m_h; }
+        int         row_length()    const { return m_channel_type == ITC_IMAGE ? m_w : m_w*m_ch; }
+        size_t      row_offset( const int& r ) const {
+            if( m_channel_type == ITC_IMAGE ) return size_t(r/m_h)*m_plane + size_t(r%m_h)*m_stride;
+            return size_t(r)*m_stride;
+        }
+
         bool is_inside( int x, int y ) const {
             return kortex::is_inside(x,0,m_w)
                 && kortex::is_inside(y,0,m_h);
@@ -129,7 +156,7 @@ namespace kortex {
         void set( const int  & v );
 
         ///
-        /// get raw pointers
+        /// get raw pointers - to the first sample. see is_contiguous.
         ///
         const float* get_fptr() const { return m_data_f; }
         const uchar* get_uptr() const { return m_data_u; }
@@ -265,6 +292,18 @@ namespace kortex {
         Image      * get_channel_wrapper( int cid );
         const Image* get_channel_wrapper( int cid ) const;
 
+        /// turns the image into a wrapper of an external w x h buffer of the
+        /// given type - does not copy or own the data. the buffer has to
+        /// outlive the image. rows start stride samples apart (w*ch or w if
+        /// 0) and the channel planes of image-ordered types stride*h apart.
+        void wrap( void* data, int w, int h, ImageType type, int stride=0 );
+
+        /// turns the image into a view of the w x h region of parent at
+        /// (x0,y0): a wrapper on the rows of parent - nothing is copied and
+        /// writes go to parent. parent must outlive the view and must not
+        /// be re-created meanwhile. copying a view yields a packed image.
+        void view( const Image& parent, int x0, int y0, int w, int h );
+
         ///
         /// io
         ///
@@ -274,6 +313,7 @@ namespace kortex {
         void load( ifstream& fin  );
 
         /// is the v0 value the maximum within a square patch - wnd_rad is the half-width.
+        /// O(wnd_rad^2) per call - image_local_maxima finds all maxima at once.
         bool is_maximum( const int& x0, const int& y0, const int& wnd_rad, const float& v0 ) const;
         bool is_maximum( const int& x0, const int& y0, const int& wnd_rad, const int  & v0 ) const;
         /// is the v0 value the minimum within a square patch - wnd_rad is the half-width.
@@ -408,7 +448,30 @@ namespace kortex {
         return true;
     }
 
+    /// walks the samples of images of the same size and layout as count
+    /// rows of len samples: a single row if none of them is padded, the
+    /// rows of Image::row_offset otherwise.
+    struct SampleRows {
+        int    count;
+        size_t len;
+        bool   whole;
+
+        explicit SampleRows( const Image& a, const Image* b=NULL, const Image* c=NULL ) {
+            whole = a.is_contiguous() && ( !b || b->is_contiguous() ) && ( !c || c->is_contiguous() );
+            count = whole ? 1 : a.row_count();
+            len   = whole ? a.element_count() : size_t( a.row_length() );
+            if( a.is_empty() ) count = 0;
+        }
+
+        /// the start of row r of img whose first sample is p
+        template<typename T>
+        T* row( T* p, const Image& img, const int& r ) const {
+            return whole ? p : p + img.row_offset( r );
+        }
+    };
+
 //
+    /// copy the region into patch - see Image::view to refer to it in place
     void extract_region_patch  ( const Image& img, int x0, int y0, int x1, int y1, Image& patch );
     void extract_centered_patch( const Image& img, int x0, int y0, int pw, int ph, Image& patch );
 
@@ -0,0 +1,374 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_IMAGE_EXPR_H
+#define KORTEX_IMAGE_EXPR_H
+
+#include <kortex/image.h>
+#include <kortex/filter.h>
+#include <kortex/check.h>
+
+#include <cmath>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace kortex {
+
+    //
+    // lazy pixelwise expressions: the operators below do not compute
+    // anything, they build a tree of the operands that image_eval runs in a
+    // single loop over the samples - no intermediate images.
+    //
+    //    image_eval( clip( expr(a)*b + s*expr(c), 0.0f, 1.0f ), run_parallel, out );
+    //
+    // one operand of every operator has to be an expression - wrap the
+    // first image with expr(). scalars are broadcast. the operands can be
+    // of any precision and are converted to float blocks of EXPR_BLOCK
+    // samples; the tree is evaluated on these blocks four samples at a time
+    // with sse. the result is converted to the type of out at the store.
+    //
+    // all image operands must have the size, the number of channels and the
+    // channel order of each other - the samples are combined in memory
+    // order, row by row if some operand or out is a view.
+    //
+
+    /// samples per block - uchar and int operands are converted block by block
+    const int EXPR_BLOCK       = 256;
+
+    /// blocks per parallel task
+    const int EXPR_TASK_BLOCKS = 16;
+
+    /// size and layout of the image operands of an expression. padded is
+    /// one of them that is not contiguous, if any.
+    struct ExprShape {
+        int          w, h, nc;
+        ChannelType  ct;
+        bool         set;
+        const Image* padded;
+
+        ExprShape() { w = h = nc = 0; ct = ITC_PIXEL; set = false; padded = NULL; }
+
+        void merge( const Image& im ) {
+            if( !padded && !im.is_contiguous() )
+                padded = &im;
+            if( !set ) {
+                w   = im.w();
+                h   = im.h();
+                nc  = im.ch();
+                ct  = image_channel_type( im.type() );
+                set = true;
+                return;
+            }
+            passert_statement( im.w() == w && im.h() == h && im.ch() == nc &&
+                               image_channel_type( im.type() ) == ct, "operand dimension mismatch" );
+        }
+    };
+
+    template<typename T>
+    inline void expr_convert( const T* src, const int& n, float* dst ) {
+        for( int j=0; j<n; j++ )
+            dst[j] = float( src[j] );
+    }
+
+    /// image operand. float images are read in place, the others through
+    /// the block buffer.
+    class ExprImage {
+    private:
+        const Image* m_im;
+        const float* m_cur;
+        float        m_buf[EXPR_BLOCK];
+    public:
+        explicit ExprImage( const Image& im ) : m_im( &im ), m_cur( NULL ) {}
+
+        void shape( ExprShape& s ) const { s.merge( *m_im ); }
+
+        /// the n samples from x0 on of sample row r
+        void bind( const SampleRows& rows, const int& r, const size_t& x0, const int& n ) {
+            const Image& im = *m_im;
+            switch( im.type() ) {
+            case IT_F_GRAY:
+            case IT_F_PRGB: m_cur = rows.row( im.get_row_f(0),    im, r ) + x0; break;
+            case IT_F_IRGB: m_cur = rows.row( im.get_row_fi(0,0), im, r ) + x0; break;
+            case IT_U_GRAY:
+            case IT_U_PRGB: expr_convert( rows.row( im.get_row_u(0),    im, r ) + x0, n, m_buf ); m_cur = m_buf; break;
+            case IT_U_IRGB: expr_convert( rows.row( im.get_row_ui(0,0), im, r ) + x0, n, m_buf ); m_cur = m_buf; break;
+            case IT_I_GRAY: expr_convert( rows.row( im.get_row_i(0),    im, r ) + x0, n, m_buf ); m_cur = m_buf; break;
+            default: switch_fatality();
+            }
+        }
+
+        float  at ( const int& j ) const { return m_cur[j]; }
+#ifdef WITH_SSE
+        __m128 at4( const int& j ) const { return _mm_loadu_ps( m_cur+j ); }
+#endif
+    };
+
+    class ExprScalar {
+    private:
+        float m_v;
+    public:
+        explicit ExprScalar( const float& v ) : m_v( v ) {}
+        void   shape( ExprShape& ) const {}
+        void   bind ( const SampleRows&, const int&, const size_t&, const int& ) {}
+        float  at ( const int& ) const { return m_v; }
+#ifdef WITH_SSE
+        __m128 at4( const int& ) const { return _mm_set1_ps( m_v ); }
+#endif
+    };
+
+    template<typename Op, typename L, typename R>
+    class ExprBinary {
+    private:
+        L m_l;
+        R m_r;
+    public:
+        ExprBinary( const L& l, const R& r ) : m_l( l ), m_r( r ) {}
+        void   shape( ExprShape& s ) const { m_l.shape( s ); m_r.shape( s ); }
+        void   bind ( const SampleRows& rows, const int& r, const size_t& x0, const int& n ) {
+            m_l.bind( rows, r, x0, n );
+            m_r.bind( rows, r, x0, n );
+        }
+        float  at ( const int& j ) const { return Op::apply( m_l.at (j), m_r.at (j) ); }
+#ifdef WITH_SSE
+        __m128 at4( const int& j ) const { return Op::apply( m_l.at4(j), m_r.at4(j) ); }
+#endif
+    };
+
+    template<typename Op, typename E>
+    class ExprUnary {
+    private:
+        E m_e;
+    public:
+        explicit ExprUnary( const E& e ) : m_e( e ) {}
+        void   shape( ExprShape& s ) const { m_e.shape( s ); }
+        void   bind ( const SampleRows& rows, const int& r, const size_t& x0, const int& n ) { m_e.bind( rows, r, x0, n ); }
+        float  at ( const int& j ) const { return Op::apply( m_e.at (j) ); }
+#ifdef WITH_SSE
+        __m128 at4( const int& j ) const { return Op::apply( m_e.at4(j) ); }
+#endif
+    };
+
+    //
+    // operations - the scalar versions match the sse instructions, min and
+    // max included: a < b ? a : b is what minps computes.
+    //
+
+#ifdef WITH_SSE
+#define KORTEX_EXPR_OP2( name, expr_s, expr_v )                                         \
+    struct name {                                                                       \
+        static float  apply( const float&  a, const float&  b ) { return expr_s; }     \
+        static __m128 apply( const __m128& a, const __m128& b ) { return expr_v; }     \
+    };
+#define KORTEX_EXPR_OP1( name, expr_s, expr_v )                                         \
+    struct name {                                                                       \
+        static float  apply( const float&  a ) { return expr_s; }                      \
+        static __m128 apply( const __m128& a ) { return expr_v; }                      \
+    };
+#else
+#define KORTEX_EXPR_OP2( name, expr_s, expr_v )                                         \
+    struct name {                                                                       \
+        static float  apply( const float&  a, const float&  b ) { return expr_s; }     \
+    };
+#define KORTEX_EXPR_OP1( name, expr_s, expr_v )                                         \
+    struct name {                                                                       \
+        static float  apply( const float&  a ) { return expr_s; }                      \
+    };
+#endif
+
+    KORTEX_EXPR_OP2( ExprAdd,  a + b,         _mm_add_ps( a, b ) )
+    KORTEX_EXPR_OP2( ExprSub,  a - b,         _mm_sub_ps( a, b ) )
+    KORTEX_EXPR_OP2( ExprMul,  a * b,         _mm_mul_ps( a, b ) )
+    KORTEX_EXPR_OP2( ExprDiv,  a / b,         _mm_div_ps( a, b ) )
+    KORTEX_EXPR_OP2( ExprMin,  a < b ? a : b, _mm_min_ps( a, b ) )
+    KORTEX_EXPR_OP2( ExprMax,  a > b ? a : b, _mm_max_ps( a, b ) )
+    KORTEX_EXPR_OP1( ExprNeg,  -a,            _mm_xor_ps   ( _mm_set1_ps( -0.0f ), a ) )
+    KORTEX_EXPR_OP1( ExprAbs,  std::fabs(a),  _mm_andnot_ps( _mm_set1_ps( -0.0f ), a ) )
+    KORTEX_EXPR_OP1( ExprSqrt, std::sqrt(a),  _mm_sqrt_ps( a ) )
+
+#undef KORTEX_EXPR_OP2
+#undef KORTEX_EXPR_OP1
+
+    /// the user facing handle of an expression tree
+    template<typename E>
+    struct Expr {
+        E e;
+        explicit Expr( const E& v ) : e( v ) {}
+    };
+
+    inline Expr<ExprImage> expr( const Image& im ) {
+        return Expr<ExprImage>( ExprImage( im ) );
+    }
+
+#define KORTEX_EXPR_BINARY( fn, Op )                                                                    \
+    template<typename L, typename R>                                                                    \
+    inline Expr< ExprBinary<Op,L,R> > fn( const Expr<L>& l, const Expr<R>& r ) {                       \
+        return Expr< ExprBinary<Op,L,R> >( ExprBinary<Op,L,R>( l.e, r.e ) );                           \
+    }                                                                                                   \
+    template<typename L>                                                                                \
+    inline Expr< ExprBinary<Op,L,ExprScalar> > fn( const Expr<L>& l, const float& r ) {                \
+        return Expr< ExprBinary<Op,L,ExprScalar> >( ExprBinary<Op,L,ExprScalar>( l.e, ExprScalar(r) ) ); \
+    }                                                                                                   \
+    template<typename R>                                                                                \
+    inline Expr< ExprBinary<Op,ExprScalar,R> > fn( const float& l, const Expr<R>& r ) {                \
+        return Expr< ExprBinary<Op,ExprScalar,R> >( ExprBinary<Op,ExprScalar,R>( ExprScalar(l), r.e ) ); \
+    }                                                                                                   \
+    template<typename L>                                                                                \
+    inline Expr< ExprBinary<Op,L,ExprImage> > fn( const Expr<L>& l, const Image& r ) {                 \
+        return Expr< ExprBinary<Op,L,ExprImage> >( ExprBinary<Op,L,ExprImage>( l.e, ExprImage(r) ) );  \
+    }                                                                                                   \
+    template<typename R>                                                                                \
+    inline Expr< ExprBinary<Op,ExprImage,R> > fn( const Image& l, const Expr<R>& r ) {                 \
+        return Expr< ExprBinary<Op,ExprImage,R> >( ExprBinary<Op,ExprImage,R>( ExprImage(l), r.e ) );  \
+    }
+
+    KORTEX_EXPR_BINARY( operator+, ExprAdd )
+    KORTEX_EXPR_BINARY( operator-, ExprSub )
+    KORTEX_EXPR_BINARY( operator*, ExprMul )
+    KORTEX_EXPR_BINARY( operator/, ExprDiv )
+    KORTEX_EXPR_BINARY( min,       ExprMin )
+    KORTEX_EXPR_BINARY( max,       ExprMax )
+
+#undef KORTEX_EXPR_BINARY
+
+    template<typename E>
+    inline Expr< ExprUnary<ExprNeg,E> > operator-( const Expr<E>& e ) {
+        return Expr< ExprUnary<ExprNeg,E> >( ExprUnary<ExprNeg,E>( e.e ) );
+    }
+
+    // not abs / sqrt: those would hide the float versions from unqualified
+    // calls in the kortex namespace
+
+    template<typename E>
+    inline Expr< ExprUnary<ExprAbs,E> > expr_abs( const Expr<E>& e ) {
+        return Expr< ExprUnary<ExprAbs,E> >( ExprUnary<ExprAbs,E>( e.e ) );
+    }
+
+    template<typename E>
+    inline Expr< ExprUnary<ExprSqrt,E> > expr_sqrt( const Expr<E>& e ) {
+        return Expr< ExprUnary<ExprSqrt,E> >( ExprUnary<ExprSqrt,E>( e.e ) );
+    }
+
+    /// min( max( e, lo ), hi )
+    template<typename E>
+    inline Expr< ExprBinary< ExprMin, ExprBinary<ExprMax,E,ExprScalar>, ExprScalar > >
+    clip( const Expr<E>& e, const float& lo, const float& hi ) {
+        return min( max( e, lo ), hi );
+    }
+
+    //
+    // stores
+    //
+
+    template<typename E>
+    inline void expr_store( const E& e, const int& n, const bool& sse, float* o ) {
+        int j = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            for( ; j+4<=n; j+=4 )
+                _mm_storeu_ps( o+j, e.at4(j) );
+        }
+#endif
+        for( ; j<n; j++ )
+            o[j] = e.at(j);
+    }
+
+    /// rounded and saturated
+    template<typename E>
+    inline void expr_store( const E& e, const int& n, const bool& sse, uchar* o ) {
+        int j = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 lo   = _mm_setzero_ps();
+            const __m128 hi   = _mm_set1_ps( 255.0f );
+            const __m128 half = _mm_set1_ps( 0.5f );
+            for( ; j+4<=n; j+=4 ) {
+                __m128  v = _mm_add_ps( _mm_min_ps( _mm_max_ps( e.at4(j), lo ), hi ), half );
+                __m128i b = _mm_cvttps_epi32( v );
+                b = _mm_packus_epi16( _mm_packs_epi32( b, b ), _mm_setzero_si128() );
+                *(int*)( o+j ) = _mm_cvtsi128_si32( b );
+            }
+        }
+#endif
+        for( ; j<n; j++ ) {
+            float v = e.at(j);
+            v = v > 0.0f ? v : 0.0f;
+            v = v < 255.0f ? v : 255.0f;
+            o[j] = uchar( v + 0.5f );
+        }
+    }
+
+    /// rounded half away from zero
+    template<typename E>
+    inline void expr_store( const E& e, const int& n, const bool&, int* o ) {
+        for( int j=0; j<n; j++ ) {
+            float v = e.at(j);
+            o[j] = int( v >= 0.0f ? v + 0.5f : v - 0.5f );
+        }
+    }
+
+    /// the blocks of the sample rows, out at the first sample of img
+    template<typename E, typename T>
+    void expr_run( const E& ex, const SampleRows& rows, const bool& sse, const bool& run_parallel,
+                   const Image& img, T* out ) {
+        const int nx = int( ( rows.len + EXPR_BLOCK - 1 ) / EXPR_BLOCK );
+        const int nb = rows.count * nx;
+        const int nt = ( nb + EXPR_TASK_BLOCKS - 1 ) / EXPR_TASK_BLOCKS;
+#pragma omp parallel for if( run_parallel )
+        for( int t=0; t<nt; t++ ) {
+            E e = ex; // the task's own leaves and block buffers
+            int b1 = std::min( nb, (t+1)*EXPR_TASK_BLOCKS );
+            for( int b=t*EXPR_TASK_BLOCKS; b<b1; b++ ) {
+                int    r  = b / nx;
+                size_t x0 = size_t(b%nx)*EXPR_BLOCK;
+                int    m  = int( std::min( size_t(EXPR_BLOCK), rows.len-x0 ) );
+                e.bind( rows, r, x0, m );
+                expr_store( e, m, sse, rows.row( out, img, r ) + x0 );
+            }
+        }
+    }
+
+    /// evaluates the expression into out. out keeps its type if it already
+    /// has the shape of the operands - it can be one of them - and is
+    /// created as the float image of that shape otherwise.
+    template<typename E>
+    void image_eval( const Expr<E>& ex, const bool& run_parallel, Image& out ) {
+        ExprShape s;
+        ex.e.shape( s );
+        passert_statement( s.set, "expression without an image operand" );
+        if( out.w() != s.w || out.h() != s.h || out.ch() != s.nc || out.is_empty() ||
+            image_channel_type( out.type() ) != s.ct )
+            out.create( s.w, s.h, image_type( TYPE_FLOAT, s.nc, s.ct ) );
+
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        SampleRows rows( out, s.padded );
+        switch( out.type() ) {
+        case IT_F_GRAY:
+        case IT_F_PRGB: expr_run( ex.e, rows, sse, run_parallel, out, out.get_row_f(0)    ); break;
+        case IT_F_IRGB: expr_run( ex.e, rows, sse, run_parallel, out, out.get_row_fi(0,0) ); break;
+        case IT_U_GRAY:
+        case IT_U_PRGB: expr_run( ex.e, rows, sse, run_parallel, out, out.get_row_u(0)    ); break;
+        case IT_U_IRGB: expr_run( ex.e, rows, sse, run_parallel, out, out.get_row_ui(0,0) ); break;
+        case IT_I_GRAY: expr_run( ex.e, rows, sse, run_parallel, out, out.get_row_i(0)    ); break;
+        default: switch_fatality();
+        }
+    }
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_IMAGE_INTEGRAL_H
+#define KORTEX_IMAGE_INTEGRAL_H
+
+#include <kortex/types.h>
+
+namespace kortex {
+
+    class Image;
+
+    /// summed-area table: sat(x,y) = sum of img over [0,x) x [0,y). the table
+    /// is (w+1)x(h+1) with a zero first row and column so box sums need no
+    /// border checks.
+    ///   IT_U_GRAY, IT_I_GRAY -> IT_I_GRAY : accumulated modulo 2^32 - box sums
+    ///                                       are exact as long as the sum of
+    ///                                       the box itself fits in 32 bits.
+    ///   IT_F_GRAY            -> IT_F_GRAY : float precision, relative to the
+    ///                                       sum of the whole image.
+    void integral_image    ( const Image& img, Image& sat );
+    void integral_image_par( const Image& img, Image& sat );
+    inline void integral_image( const Image& img, const bool& run_parallel, Image& sat ) {
+        if( run_parallel ) integral_image_par( img, sat );
+        else               integral_image    ( img, sat );
+    }
+
+    /// summed-area table of the squared pixel values - same types and
+    /// precision as integral_image. (an IT_U_GRAY box of up to 66049 pixels
+    /// always fits.)
+    void integral_image_sq    ( const Image& img, Image& sqsat );
+    void integral_image_sq_par( const Image& img, Image& sqsat );
+    inline void integral_image_sq( const Image& img, const bool& run_parallel, Image& sqsat ) {
+        if( run_parallel ) integral_image_sq_par( img, sqsat );
+        else               integral_image_sq    ( img, sqsat );
+    }
+
+    /// sum over the box [x0,x1) x [y0,y1) from a table with rows sw elements
+    /// apart (its stride - image width + 1 unless it is a view). coordinates
+    /// are table coordinates: 0 <= x0 <= x1 <= w.
+    inline float box_sum( const float* sat, const int& sw,
+                          const int& x0, const int& y0, const int& x1, const int& y1 ) {
+        const float* r0 = sat + size_t(y0)*sw;
+        const float* r1 = sat + size_t(y1)*sw;
+        return ( r1[x1] - r1[x0] ) - ( r0[x1] - r0[x0] );
+    }
+    inline int box_sum( const int* sat, const int& sw,
+                        const int& x0, const int& y0, const int& x1, const int& y1 ) {
+        const uint32_t* r0 = (const uint32_t*)sat + size_t(y0)*sw;
+        const uint32_t* r1 = (const uint32_t*)sat + size_t(y1)*sw;
+        return int( ( r1[x1] - r1[x0] ) - ( r0[x1] - r0[x0] ) );
+    }
+
+    /// box sum over [x0,x1) x [y0,y1) of an integral_image table (IT_F_GRAY or IT_I_GRAY)
+    double box_sum( const Image& sat, const int& x0, const int& y0, const int& x1, const int& y1 );
+
+    /// mean and variance of the pixels in [x0,x1) x [y0,y1) from the tables of
+    /// integral_image and integral_image_sq. the variance is clamped at 0.
+    void box_mean_variance( const Image& sat, const Image& sqsat,
+                            const int& x0, const int& y0, const int& x1, const int& y1,
+                            float& mean, float& var );
+
+    /// sum over the (2*rx+1)x(2*ry+1) window around every pixel with zero
+    /// padding - the result of filter_hv with a kernel of ones, but at O(1)
+    /// per pixel. works with running sums accumulated in double. IT_F_GRAY.
+    /// img and out can be the same image.
+    void box_filter    ( const Image& img, const int& rx, const int& ry, Image& out );
+    void box_filter_par( const Image& img, const int& rx, const int& ry, Image& out );
+    inline void box_filter( const Image& img, const int& rx, const int& ry, const bool& run_parallel, Image& out ) {
+        if( run_parallel ) box_filter_par( img, rx, ry, out );
+        else               box_filter    ( img, rx, ry, out );
+    }
+
+    /// average over the (2*r+1)^2 window around every pixel - only the pixels
+    /// inside the image are counted. IT_F_GRAY.
+    void mean_filter    ( const Image& img, const int& r, Image& out );
+    void mean_filter_par( const Image& img, const int& r, Image& out );
+    inline void mean_filter( const Image& img, const int& r, const bool& run_parallel, Image& out ) {
+        if( run_parallel ) mean_filter_par( img, r, out );
+        else               mean_filter    ( img, r, out );
+    }
+
+    /// mean and variance over the (2*r+1)^2 window around every pixel. the
+    /// variance is E[x^2]-E[x]^2 clamped at 0. IT_F_GRAY.
+    void local_mean_variance( const Image& img, const int& r, const bool& run_parallel, Image& mean, Image& var );
+
+    /// (img - local mean) / sqrt( local variance + eps ) over (2*r+1)^2
+    /// windows. IT_F_GRAY. img and out can be the same image.
+    void local_normalize( const Image& img, const int& r, const float& eps, const bool& run_parallel, Image& out );
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_IMAGE_PIXELWISE_TCC
+#define KORTEX_IMAGE_PIXELWISE_TCC
+
+#include <kortex/image.h>
+#include <kortex/color.h>
+#include <algorithm>
+
+namespace kortex {
+
+    /// dst[i] = op( src[i] ) for i in [0,n), in blocks of PIXELWISE_BLOCK
+    template<typename S, typename D, typename Op>
+    void pixelwise_map( const S* src, const size_t& n, const Op& op, const bool& run_parallel, D* dst ) {
+        const int nb = int( ( n + PIXELWISE_BLOCK - 1 ) / PIXELWISE_BLOCK );
+#pragma omp parallel for if( run_parallel && nb > 1 )
+        for( int b=0; b<nb; b++ ) {
+            size_t   i0 = size_t(b)*PIXELWISE_BLOCK;
+            const S* s  = src + i0;
+            D*       d  = dst + i0;
+            int      m  = int( std::min( size_t(PIXELWISE_BLOCK), n-i0 ) );
+            for( int i=0; i<m; i++ )
+                d[i] = op( s[i] );
+        }
+    }
+
+    /// pixelwise_map over the samples of p into those of q, row by row if
+    /// either is a view
+    template<typename S, typename D, typename Op>
+    void pixelwise_map( const Image& p, const S* src, const Op& op, const bool& run_parallel, const Image& q, D* dst ) {
+        SampleRows rows( p, &q );
+        if( rows.whole ) {
+            pixelwise_map( src, rows.len, op, run_parallel, dst );
+            return;
+        }
+#pragma omp parallel for if( run_parallel && rows.count > 1 )
+        for( int r=0; r<rows.count; r++ )
+            pixelwise_map( rows.row( src, p, r ), rows.len, op, false, rows.row( dst, q, r ) );
+    }
+
+    /// op rounded and saturated to uchar
+    template<typename Op>
+    struct PixelwiseGray {
+        const Op& op;
+        explicit PixelwiseGray( const Op& o ) : op( o ) {}
+        uchar operator()( const float& v ) const { return cast_to_gray_range( float( op( v ) ) ); }
+    };
+
+    template<typename Op>
+    void apply_pixelwise_operation( const Image& p, const Op& op, bool run_parallel, Image& q ) {
+        passert_statement( check_dimensions(p,q), "dimension mismatch" );
+        passert_statement( p.ch() == q.ch() && image_channel_type( p.type() ) == image_channel_type( q.type() ),
+                           "channel layout mismatch" );
+        switch( p.precision() ) {
+        case TYPE_FLOAT:
+            if( q.precision() == TYPE_FLOAT ) {
+                pixelwise_map( p, p.get_fptr(), op, run_parallel, q, q.get_fptr() );
+            } else {
+                passert_statement( q.precision() == TYPE_UCHAR, "output should be float or uchar" );
+                pixelwise_map( p, p.get_fptr(), PixelwiseGray<Op>( op ), run_parallel, q, q.get_uptr() );
+            }
+            break;
+        case TYPE_UCHAR:
+            if( q.precision() == TYPE_FLOAT ) {
+                float lut[256];
+                for( int i=0; i<256; i++ )
+                    lut[i] = float( op( float(i) ) );
+                apply_pixelwise_lut( p, lut, run_parallel, q );
+            } else {
+                uchar lut[256];
+                for( int i=0; i<256; i++ )
+                    lut[i] = cast_to_gray_range( float( op( float(i) ) ) );
+                apply_pixelwise_lut( p, lut, run_parallel, q );
+            }
+            break;
+        default: switch_fatality();
+        }
+    }
+
+}
+
+#endif
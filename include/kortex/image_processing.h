@@ -15,70 +15,99 @@
 #define KORTEX_IMAGE_PROCESSING_H
 
 #include <kortex/types.h>
+#include <kortex/filter.h>
 
 namespace kortex {
 
     class Image;
 
     /// finds the [min,max] value range for the image region defined by
-    /// [xmin,ymin]->[xmax,ymax] ; NAN safe
+    /// [xmin,ymin]->[xmax,ymax] ; NAN safe. all channels of any image type
+    /// count - see image_stats in image_stats.h.
     bool image_min_max( const Image& img,
                         const int& xmin, const int& ymin,
                         const int& xmax, const int& ymax,
-                        float& min_v, float& max_v );
+                        float& min_v, float& max_v, const bool& run_parallel=false );
 
-    inline bool image_min_max( const Image& img, float& min_v, float& max_v ) {
-        return image_min_max( img, -1, -1, -1, -1, min_v, max_v );
+    inline bool image_min_max( const Image& img, float& min_v, float& max_v, const bool& run_parallel=false ) {
+        return image_min_max( img, -1, -1, -1, -1, min_v, max_v, run_parallel );
     }
 
     bool abs_image_min_max( const Image& img,
                             const int& xmin, const int& ymin,
                             const int& xmax, const int& ymax,
-                            float& min_v, float& max_v );
+                            float& min_v, float& max_v, const bool& run_parallel=false );
 
-    inline bool abs_image_min_max( const Image& img, float& min_v, float& max_v ) {
-        return abs_image_min_max( img, -1, -1, -1, -1, min_v, max_v );
+    inline bool abs_image_min_max( const Image& img, float& min_v, float& max_v, const bool& run_parallel=false ) {
+        return abs_image_min_max( img, -1, -1, -1, -1, min_v, max_v, run_parallel );
     }
 
 
-    void        filter_hv( const Image& img, const float* kernel, const int& ksz, Image& out );
+    /// separable filters - border selects how the image is extended beyond
+    /// its borders (see filter.h). uchar images are filtered in fixed point
+    /// (see filter_fixed.h) and stay uchar. pixel-ordered images are
+    /// filtered with all their channels in one pass, the planes of
+    /// channel-ordered ones one after the other.
+    void        filter_hv( const Image& img, const float* kernel, const int& ksz, Image& out,
+                           const BorderMode& border=BORDER_ZERO );
     inline void filter_hv( Image& img, const float* kernel, const int& ksz ) {
         filter_hv( img, kernel, ksz, img );
     }
-    void filter_hv_par( const Image& img, const float* kernel, const int& ksz, Image& out );
+    void filter_hv_par( const Image& img, const float* kernel, const int& ksz, Image& out,
+                        const BorderMode& border=BORDER_ZERO );
 
-    inline void filter_hv( const Image& img, const float* kernel, const int& ksz, const bool& run_parallel, Image& out ) {
-        if( run_parallel ) filter_hv_par( img, kernel, ksz, out );
-        else               filter_hv    ( img, kernel, ksz, out );
+    inline void filter_hv( const Image& img, const float* kernel, const int& ksz, const bool& run_parallel, Image& out,
+                           const BorderMode& border=BORDER_ZERO ) {
+        if( run_parallel ) filter_hv_par( img, kernel, ksz, out, border );
+        else               filter_hv    ( img, kernel, ksz, out, border );
     }
     inline void filter_hv( Image& img, const float* kernel, const int& ksz, const bool& run_parallel ) {
         filter_hv( img, kernel, ksz, run_parallel, img );
     }
 
-    void filter_hor ( const Image& img, const float* kernel, const int& ksz, Image& out );
+    void filter_hor ( const Image& img, const float* kernel, const int& ksz, Image& out,
+                      const BorderMode& border=BORDER_ZERO );
     inline void filter_hor( Image& img, const float* kernel, const int& ksz ) {
         filter_hor( img, kernel, ksz, img );
     }
-    void filter_hor_par( const Image& img, const float* kernel, const int& ksz, Image& out );
+    void filter_hor_par( const Image& img, const float* kernel, const int& ksz, Image& out,
+                         const BorderMode& border=BORDER_ZERO );
 
-    void filter_ver ( const Image& img, const float* kernel, const int& ksz, Image& out );
+    void filter_ver ( const Image& img, const float* kernel, const int& ksz, Image& out,
+                      const BorderMode& border=BORDER_ZERO );
     inline void filter_ver( Image& img, const float* kernel, const int& ksz ) {
         filter_ver( img, kernel, ksz, img );
     }
-    void filter_ver_par( const Image& img, const float* kernel, const int& ksz, Image& out );
+    void filter_ver_par( const Image& img, const float* kernel, const int& ksz, Image& out,
+                         const BorderMode& border=BORDER_ZERO );
 
 
-    void filter_gaussian    ( const Image& img, const float& sigma, Image& out );
-    void filter_gaussian_par( const Image& img, const float& sigma, Image& out );
+    /// filter_gaussian switches to the recursive implementation from this
+    /// sigma on - the fir kernel has 65 taps there.
+    const float GAUSSIAN_IIR_MIN_SIGMA = 8.0f;
+
+    void filter_gaussian    ( const Image& img, const float& sigma, Image& out, const BorderMode& border=BORDER_ZERO );
+    void filter_gaussian_par( const Image& img, const float& sigma, Image& out, const BorderMode& border=BORDER_ZERO );
     inline void filter_gaussian( Image& img, const float& sigma ) {
         filter_gaussian( img, sigma, img );
     }
     inline void filter_gaussian_par( Image& img, const float& sigma ) {
         filter_gaussian_par( img, sigma, img );
     }
-    inline void filter_gaussian( const Image& img, const float& sigma, const bool& run_parallel, Image& out ) {
-        if( run_parallel ) filter_gaussian_par( img, sigma, out );
-        else               filter_gaussian    ( img, sigma, out );
+    inline void filter_gaussian( const Image& img, const float& sigma, const bool& run_parallel, Image& out,
+                                 const BorderMode& border=BORDER_ZERO ) {
+        if( run_parallel ) filter_gaussian_par( img, sigma, out, border );
+        else               filter_gaussian    ( img, sigma, out, border );
+    }
+
+    /// recursive gaussian - constant cost per pixel regardless of sigma. see
+    /// filter.h for the accuracy.
+    void filter_gaussian_iir    ( const Image& img, const float& sigma, Image& out, const BorderMode& border=BORDER_ZERO );
+    void filter_gaussian_iir_par( const Image& img, const float& sigma, Image& out, const BorderMode& border=BORDER_ZERO );
+    inline void filter_gaussian_iir( const Image& img, const float& sigma, const bool& run_parallel, Image& out,
+                                     const BorderMode& border=BORDER_ZERO ) {
+        if( run_parallel ) filter_gaussian_iir_par( img, sigma, out, border );
+        else               filter_gaussian_iir    ( img, sigma, out, border );
     }
 
     void combine_horizontally(const Image& im0, const Image& im1, Image& out);
@@ -87,9 +116,14 @@ namespace kortex {
     void flip_image_ver( Image& img );
     void flip_image_hor( Image& img );
 
-    void image_threshold( const Image& img, float th, Image& out );
+    /// out = img > th as 0/1. img is IT_U_GRAY, IT_I_GRAY or IT_F_GRAY, out
+    /// IT_U_GRAY or IT_F_GRAY. allows aliasing.
+    void image_threshold( const Image& img, float th, bool run_parallel, Image& out );
+    inline void image_threshold( const Image& img, float th, Image& out ) {
+        image_threshold( img, th, false, out );
+    }
     inline void image_threshold( Image& img, float th ) {
-        image_threshold( img, th, img );
+        image_threshold( img, th, false, img );
     }
 
     ///
@@ -99,17 +133,28 @@ namespace kortex {
     void erode_mask( Image& mask, int er_size );
 
 
+    /// image_resize_coarse averages the source area every output pixel
+    /// covers (linear interpolation when enlarging), image_resize_fine
+    /// resamples with the bicubic kernel. both replicate the borders - see
+    /// image_resample in resample.h.
     void image_resize_coarse( const Image& src, const int& nw, const int& nh, bool run_parallel, Image& dst );
     void image_resize_fine  ( const Image& src, const int& nw, const int& nh, bool run_parallel, Image& dst );
 
     void image_resize_coarse( const Image& img, int max_img_dim, bool run_parallel, Image& rimg );
     void image_resize_fine  ( const Image& src, int max_img_dim, bool run_parallel, Image& dst  );
 
-    void image_subtract    ( const Image& im0, const Image& im1, Image& out );
-    void image_subtract_par( const Image& im0, const Image& im1, Image& out );
-    inline void image_subtract( const Image& im0, const Image& im1, bool run_parallel, Image& out ) {
-        if( run_parallel ) image_subtract_par( im0, im1, out );
-        else               image_subtract    ( im0, im1, out );
+    /// elements per block of the pointwise operations below - the unit of
+    /// their parallel work split
+    const int PIXELWISE_BLOCK = 4096;
+
+    /// out = im0 - im1 for images of the same type. saturates at 0 for uchar
+    /// images.
+    void image_subtract( const Image& im0, const Image& im1, bool run_parallel, Image& out );
+    inline void image_subtract    ( const Image& im0, const Image& im1, Image& out ) {
+        image_subtract( im0, im1, false, out );
+    }
+    inline void image_subtract_par( const Image& im0, const Image& im1, Image& out ) {
+        image_subtract( im0, im1, true, out );
     }
 
     /// adds v to every pixel
@@ -125,12 +170,14 @@ namespace kortex {
         else               image_add    ( im0, im1, out );
     }
 
-    /// r = p/q for q>1e-6 else 0
-    void image_divide    ( const Image& p, const Image& q, Image& r );
-    void image_divide_par( const Image& p, const Image& q, Image& r );
-    inline void image_divide( const Image& p, const Image& q, bool run_parallel, Image& r ) {
-        if( run_parallel ) image_divide_par( p, q, r );
-        else               image_divide    ( p, q, r );
+    /// r = p/q for |q|>=1e-6 else 0 for images of the same type. the integer
+    /// quotient for uchar and int images, 0 for q=0.
+    void image_divide( const Image& p, const Image& q, bool run_parallel, Image& r );
+    inline void image_divide    ( const Image& p, const Image& q, Image& r ) {
+        image_divide( p, q, false, r );
+    }
+    inline void image_divide_par( const Image& p, const Image& q, Image& r ) {
+        image_divide( p, q, true, r );
     }
 
 
@@ -161,32 +208,48 @@ namespace kortex {
 
 
 
+    //
+    // the checks below stop at the first offending row
+    //
+
     /// checks whether p has values of either 0.0f or 1.0f
-    bool is_binarized( const Image& p );
+    bool is_binarized( const Image& p, const bool& run_parallel=false );
 
     /// checks whether p has values in the range [0.0f 1.0f]
-    bool is_normalized( const Image& p );
+    bool is_normalized( const Image& p, const bool& run_parallel=false );
 
     /// checks whether p and q are non-zero for the same pixel
-    bool does_overlap( const Image& p, const Image& q );
+    bool does_overlap( const Image& p, const Image& q, const bool& run_parallel=false );
 
     void init_gaussian_weight_mask( Image& mask );
     void init_linear_weight_mask  ( Image& mask );
 
+    /// blend weights that ramp up with the distance to the mask border:
+    /// 254*min(d/feather,1)+1 for the foreground pixels of mask, d being the
+    /// euclidean distance to the nearest background pixel, and 0 for the
+    /// background - the range of init_linear_weight_mask. weights is created
+    /// as IT_F_GRAY.
+    void init_feather_weight_mask( const Image& mask, const float& feather, const bool& run_parallel, Image& weights );
+
     void image_color_invert( Image& img );
 
+    /// rows of img start stride samples apart - w*nc if 0
     template <typename T>
-    float bilinear_interpolation(const T* img, const int& w, const int& h, const int& nc, const int& c,  const float& x, const float& y);
+    float bilinear_interpolation(const T* img, const int& w, const int& h, const int& nc, const int& c,  const float& x, const float& y, const int& stride=0);
 
     template <typename T>
-    float  bicubic_interpolation(const T* im,  const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y);
+    float  bicubic_interpolation(const T* im,  const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y, const int& stride=0);
 
     int  filter_size( const float& sigma );
 
-    /// maps the src image to 0.0 -> 1.0 range linearly
-    void image_linearize( const Image& src, Image& dst );
+    /// maps the src image (IT_F_GRAY or IT_U_GRAY) to 0.0 -> 1.0 range
+    /// linearly into dst (IT_F_GRAY)
+    void image_linearize( const Image& src, bool run_parallel, Image& dst );
+    inline void image_linearize( const Image& src, Image& dst ) {
+        image_linearize( src, false, dst );
+    }
     inline void image_linearize( Image& img ) {
-        image_linearize( img, img );
+        image_linearize( img, false, img );
     }
 
     /// standard = true normalizes with 255 -> false normalizes according to the max value
@@ -209,8 +272,13 @@ namespace kortex {
     void image_gradient_magnitude( const Image& src, bool run_parallel, Image& mag );
 
     /// stretches image info such that its minv->0.0f maxv->255.0f. if minv,maxv
-    /// specified as 0.0f 0.0f range is extracted from the source image.
-    void image_stretch( const Image& src, float minv, float maxv, Image& out );
+    /// specified as 0.0f 0.0f range is extracted from the source image. src
+    /// is IT_F_GRAY or IT_U_GRAY, out is created as IT_U_GRAY - nan pixels
+    /// map to 0.
+    void image_stretch( const Image& src, float minv, float maxv, bool run_parallel, Image& out );
+    inline void image_stretch( const Image& src, float minv, float maxv, Image& out ) {
+        image_stretch( src, minv, maxv, false, out );
+    }
 
     /// computes the absolute value image
     void image_abs( const Image& img, bool run_parallel, Image& out );
@@ -218,9 +286,13 @@ namespace kortex {
         image_abs( img, run_parallel, img );
     }
 
-    void image_negate( const Image& img, Image& out );
+    /// out = -img for float and int images
+    void image_negate( const Image& img, bool run_parallel, Image& out );
+    inline void image_negate( const Image& img, Image& out ) {
+        image_negate( img, false, out );
+    }
     inline void image_negate( Image& img ) {
-        image_negate( img, img );
+        image_negate( img, false, img );
     }
 
     void image_clip_lower( const Image& src, float min_v, bool run_parallel, Image& out );
@@ -251,30 +323,57 @@ namespace kortex {
     // set nb pixels of the boundary to 0.0f
     void image_reset_boundary( Image& img, int nb );
 
-    // inverts a binary uchar image - allows aliasing
-    void mask_invert( const Image& img, Image& out );
+    //
+    // the mask operations below write 0/1 to an IT_U_GRAY or IT_F_GRAY
+    // output and allow aliasing.
+    //
 
+    // inverts a binary uchar or float image
+    void mask_invert( const Image& img, bool run_parallel, Image& out );
+    inline void mask_invert( const Image& img, Image& out ) {
+        mask_invert( img, false, out );
+    }
     inline void mask_invert( Image& img ) {
-        mask_invert( img, img );
+        mask_invert( img, false, img );
     }
 
-    // labels pixels with color v as 1, 0 otherwise. allows aliasing
-    void pick_pixels_with_color( const Image& img, const uchar& v, Image& out );
+    // labels pixels of the uchar image with color v as 1, 0 otherwise
+    void pick_pixels_with_color( const Image& img, const uchar& v, bool run_parallel, Image& out );
+    inline void pick_pixels_with_color( const Image& img, const uchar& v, Image& out ) {
+        pick_pixels_with_color( img, v, false, out );
+    }
     inline void pick_pixels_with_color( Image& img, const uchar& v ) {
-        pick_pixels_with_color( img, v, img );
+        pick_pixels_with_color( img, v, false, img );
     }
 
-    /// binarize a uchar image ( src(x,y)>0 -> dst(x,y)=1 ). allows aliasing.
-    void binarize_image( const Image& src, Image& dst );
+    /// binarize a uchar, int or float image ( src(x,y)>0 -> dst(x,y)=1 )
+    void binarize_image( const Image& src, bool run_parallel, Image& dst );
+    inline void binarize_image( const Image& src, Image& dst ) {
+        binarize_image( src, false, dst );
+    }
     inline void binarize_image( Image& img ) {
-        binarize_image( img, img );
+        binarize_image( img, false, img );
     }
 
     typedef float (*PixelOperator)(float);
-    void apply_pixelwise_operation( const Image& p, PixelOperator op, bool run_parallel, Image& q );
+
+    /// q = op( p ) for every sample, op being a functor or a PixelOperator
+    /// taking and returning float. a functor's call is inlined into the
+    /// loop. float images map into float or uchar (rounded and saturated)
+    /// outputs; for uchar images op is tabulated once for the 256 values
+    /// and applied with apply_pixelwise_lut. q has the layout of p.
+    template<typename Op>
+    void apply_pixelwise_operation( const Image& p, const Op& op, bool run_parallel, Image& q );
+
+    /// q = lut[ p ] for a uchar image p and a uchar or float image q of
+    /// the same layout
+    void apply_pixelwise_lut( const Image& p, const uchar* lut, bool run_parallel, Image& q );
+    void apply_pixelwise_lut( const Image& p, const float* lut, bool run_parallel, Image& q );
 
     void insert_image_to_channel( const Image& im, int ch, Image& out );
 
 }
 
+#include <kortex/image_pixelwise.tcc>
+
 #endif
@@ -0,0 +1,83 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_IMAGE_STATS_H
+#define KORTEX_IMAGE_STATS_H
+
+#include <kortex/rect2.h>
+#include <cstddef>
+#include <cfloat>
+
+namespace kortex {
+
+    class Image;
+
+    //
+    // reductions over the samples of an image region - every channel of
+    // every pixel of [lx,ux) x [ly,uy), the whole image if roi is NULL. the
+    // region is cut into row blocks that are reduced with sse in parallel;
+    // the block results are combined pairwise in a fixed order so that the
+    // serial and the parallel runs agree to the last bit. the predicates
+    // stop scanning once the answer is known.
+    //
+
+    enum ImageStatFlags {
+        STAT_MIN_MAX = 1,
+        STAT_SUM     = 2,
+        STAT_SUM_SQ  = 4,
+        STAT_ABS     = 8,   // reduce |v| instead of v
+        STAT_ALL     = STAT_MIN_MAX | STAT_SUM | STAT_SUM_SQ
+    };
+
+    /// the results of image_stats. nan samples are only counted.
+    struct ImageStats {
+        double min_v, max_v;   // DBL_MAX / -DBL_MAX if there is no number
+        double sum, sum_sq;
+        size_t count;          // samples that are numbers
+        size_t nan_count;
+
+        ImageStats() : min_v(DBL_MAX), max_v(-DBL_MAX), sum(0.0), sum_sq(0.0), count(0), nan_count(0) {}
+
+        double mean    () const { return count ? sum/count : 0.0; }
+        double variance() const { return count ? sum_sq/count - mean()*mean() : 0.0; }
+    };
+
+    /// the statistics selected by the STAT_ flags of the samples of img in
+    /// one pass. the counts are always computed.
+    void image_stats( const Image& img, const int& flags, const bool& run_parallel, ImageStats& st,
+                      const Rect2i* roi=NULL );
+
+    /// the tests of image_count, image_any and image_all
+    enum SampleTest {
+        TEST_NONZERO = 0,  // v != 0 - nan included
+        TEST_NAN,          // v is nan
+        TEST_IN_RANGE,     // a <= v <= b
+        TEST_OUTSIDE,      // v < a or v > b - nan excluded
+        TEST_EITHER        // v == a or v == b
+    };
+
+    /// number of samples that pass the test
+    size_t image_count( const Image& img, const SampleTest& test, const float& a, const float& b,
+                        const bool& run_parallel, const Rect2i* roi=NULL );
+
+    /// whether some sample passes the test
+    bool   image_any  ( const Image& img, const SampleTest& test, const float& a, const float& b,
+                        const bool& run_parallel, const Rect2i* roi=NULL );
+
+    /// whether every sample passes the test
+    bool   image_all  ( const Image& img, const SampleTest& test, const float& a, const float& b,
+                        const bool& run_parallel, const Rect2i* roi=NULL );
+
+}
+
+#endif
@@ -66,6 +66,20 @@ namespace kortex {
 
     };
 
+    /// number of independent scratch buffers each thread owns
+    const int N_THREAD_SCRATCH_SLOTS = 4;
+
+    /// per-thread scratch memory: returns a buffer of at least n_bytes owned
+    /// by the calling thread. the buffer grows on demand and is reused across
+    /// calls, content is not preserved. a function holding a slot must not
+    /// call into code using the same slot - lower level routines use the
+    /// lower slots.
+    uchar* thread_scratch( const int& slot, const size_t& n_bytes );
+
+    inline float* thread_scratch_f( const int& slot, const size_t& n_floats ) {
+        return (float*)thread_scratch( slot, n_floats*sizeof(float) );
+    }
+
 }
 
 #endif
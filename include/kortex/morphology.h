@@ -0,0 +1,95 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_MORPHOLOGY_H
+#define KORTEX_MORPHOLOGY_H
+
+#include <vector>
+
+namespace kortex {
+
+    class Image;
+
+    //
+    // morphology with (2*rx+1) x (2*ry+1) rectangular structuring elements.
+    // the rectangle is separated into a row and a column pass, each computed
+    // with the van herk / gil-werman prefix-suffix scheme: three min/max per
+    // pixel regardless of the radius. the column pass works on whole row
+    // segments and the row pass on bands of rows transposed together, so
+    // both run as sse vector min/max.
+    //
+
+    enum MorphOp { MORPH_ERODE=0, MORPH_DILATE, MORPH_OPEN, MORPH_CLOSE };
+
+    /// grayscale morphology of IT_U_GRAY, IT_F_GRAY and IT_I_GRAY images. pixels outside
+    /// the image do not take part - the structuring element is clipped at
+    /// the borders. dst is created with the type of src and can be src.
+    void image_morphology( const Image& src, const MorphOp& op, const int& rx, const int& ry,
+                           const bool& run_parallel, Image& dst );
+
+    inline void image_erode ( const Image& src, const int& rx, const int& ry, const bool& run_parallel, Image& dst ) {
+        image_morphology( src, MORPH_ERODE, rx, ry, run_parallel, dst );
+    }
+    inline void image_dilate( const Image& src, const int& rx, const int& ry, const bool& run_parallel, Image& dst ) {
+        image_morphology( src, MORPH_DILATE, rx, ry, run_parallel, dst );
+    }
+    inline void image_open  ( const Image& src, const int& rx, const int& ry, const bool& run_parallel, Image& dst ) {
+        image_morphology( src, MORPH_OPEN, rx, ry, run_parallel, dst );
+    }
+    inline void image_close ( const Image& src, const int& rx, const int& ry, const bool& run_parallel, Image& dst ) {
+        image_morphology( src, MORPH_CLOSE, rx, ry, run_parallel, dst );
+    }
+
+    /// a local maximum and its value - int values are exact up to 2^24
+    struct LocalMaximum {
+        int   x, y;
+        float v;
+    };
+
+    /// all pixels of img (IT_F_GRAY / IT_I_GRAY) that are the maximum of
+    /// the (2r+1) x (2r+1) window around them - as Image::is_maximum, ties
+    /// included and the window clipped at the borders - with values above
+    /// threshold and at least margin pixels away from the borders. the max
+    /// filter is the van herk / gil-werman dilation; the candidates are
+    /// picked with sse compare masks in parallel tiles. maxima is cleared
+    /// and filled in raster order.
+    void image_local_maxima( const Image& img, const int& r, const float& threshold, const int& margin,
+                             const bool& run_parallel, std::vector<LocalMaximum>& maxima );
+
+    /// binary morphology of IT_U_GRAY / IT_F_GRAY masks: nonzero pixels are
+    /// foreground. the mask is packed to 64 pixels per word (pack64) and
+    /// processed with word-wide and/or - O(log rx) shifts per word along the
+    /// rows, van herk / gil-werman along the columns. the result is 0 / 1 for
+    /// float masks and 0 / 255 for uchar masks. with outside_is_background
+    /// the pixels outside the mask count as background, so erosion also eats
+    /// in from the borders; otherwise they do not take part. dst can be mask.
+    void mask_morphology( const Image& mask, const MorphOp& op, const int& rx, const int& ry,
+                          const bool& run_parallel, Image& dst, const bool& outside_is_background=false );
+
+    //
+    // exact euclidean distance transform (felzenszwalb & huttenlocher): the
+    // distances to the nearest background pixel along every column, then
+    // along every row the lower envelope of the parabolas (x-q)^2 + g(q)^2
+    // of the column distances g. linear in the number of pixels.
+    //
+
+    /// distance of every pixel of mask (IT_U_GRAY / IT_F_GRAY) to the
+    /// nearest background - zero - pixel; background pixels get 0. the
+    /// pixels outside the mask do not count as background. dist is created
+    /// as IT_F_GRAY with the squared distances if squared is set. masks
+    /// without background pixels get FLT_MAX everywhere.
+    void mask_distance_transform( const Image& mask, const bool& squared, const bool& run_parallel, Image& dist );
+
+}
+
+#endif
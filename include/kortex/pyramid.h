@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_PYRAMID_H
+#define KORTEX_PYRAMID_H
+
+#include <kortex/image.h>
+#include <kortex/mem_unit.h>
+#include <kortex/resample.h>
+#include <vector>
+
+namespace kortex {
+
+    /// levels smaller than this along either side are not generated
+    const int PYRAMID_MIN_SIZE = 8;
+
+    //
+    // gaussian / laplacian image pyramid. level l is 2^(-l/n_sublevels) the
+    // size of the input - n_sublevels levels per octave. every gaussian level
+    // is blurred and decimated from the level above it in a single separable
+    // pass (RESAMPLE_GAUSSIAN). laplacian level l is G_l minus the bicubic
+    // expansion of G_{l+1}; the last laplacian level is the last gaussian.
+    //
+    // all levels live in one buffer that is sized on the first build - later
+    // builds with the same input size, type and level configuration neither
+    // allocate nor recompute the resampling tables. level images are wrappers
+    // into this buffer and stay valid until the next reconfiguration.
+    //
+    class Pyramid {
+    private:
+        int                       m_w, m_h;
+        ImageType                 m_type;
+        int                       m_n_octaves;
+        int                       m_n_sublevels;
+        bool                      m_laplacian;
+
+        MemUnit                   m_memory;
+        MemUnit                   m_work;     // collapse buffer
+        std::vector<Image>        m_gauss;
+        std::vector<Image>        m_lap;
+        std::vector<ResamplePlan> m_down;     // G_l     -> G_{l+1}
+        std::vector<ResamplePlan> m_up;       // G_{l+1} -> size of G_l
+
+        void configure( const int& w, const int& h, const ImageType& type,
+                        const int& n_octaves, const int& n_sublevels, const bool& laplacian );
+
+        Pyramid( const Pyramid& );
+        Pyramid& operator=( const Pyramid& );
+
+    public:
+        Pyramid();
+
+        /// builds the pyramid of img with at most n_octaves*n_sublevels
+        /// levels. img can be IT_F_GRAY, IT_F_PRGB and - for gaussian only
+        /// pyramids - IT_U_GRAY, IT_U_PRGB.
+        void build( const Image& img, const int& n_octaves, const int& n_sublevels,
+                    const bool& laplacian, const bool& run_parallel );
+
+        int          n_levels() const { return (int)m_gauss.size(); }
+        const Image& gaussian ( const int& l ) const;
+        const Image& laplacian( const int& l ) const;
+
+        /// size of level l relative to the input
+        float        scale    ( const int& l ) const;
+
+        /// reconstructs the input from the laplacian levels
+        void         collapse ( const bool& run_parallel, Image& out );
+
+        size_t       mem_usage() const { return m_memory.capacity() + m_work.capacity(); }
+    };
+
+}
+
+#endif
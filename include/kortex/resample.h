@@ -0,0 +1,99 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_RESAMPLE_H
+#define KORTEX_RESAMPLE_H
+
+#include <kortex/types.h>
+#include <kortex/filter.h>
+#include <vector>
+
+namespace kortex {
+
+    class Image;
+
+    //
+    // separable resampling: the weights of every output column and row are
+    // computed once into tables, then the image is resampled along the rows
+    // and the result along the columns. pixel centers are aligned - output
+    // pixel x samples the source at (x+0.5)*w/nw-0.5. when shrinking, the
+    // kernels are stretched by the scale so that they average over the
+    // source pixels they skip instead of aliasing.
+    //
+
+    /// kernels of the resampler:
+    ///   RESAMPLE_BICUBIC : keys' cubic convolution with a=-0.5 - the kernel
+    ///                      of bicubic_interpolation
+    ///   RESAMPLE_LANCZOS : lanczos-3, windowed sinc with 6 taps
+    ///   RESAMPLE_AREA    : the mean of the source area an output pixel
+    ///                      covers. linear interpolation when enlarging.
+    ///   RESAMPLE_GAUSSIAN: gaussian with a sigma of half an output pixel -
+    ///                      sigma 1 for a 2x reduction. the pyramid kernel.
+    enum ResampleMode { RESAMPLE_BICUBIC=0, RESAMPLE_LANCZOS, RESAMPLE_AREA, RESAMPLE_GAUSSIAN };
+
+    /// weights of a resampling along one axis: output sample i is
+    /// sum_k weights[i*ntaps+k] * src[first[i]+k]. first[i] can be outside
+    /// the source - those samples are taken from the border mode. the weights
+    /// of a sample sum to 1.
+    struct ResampleAxis {
+        int                n_out;
+        int                ntaps;
+        std::vector<int>   first;
+        std::vector<float> weights;
+    };
+
+    void resample_axis( const int& n_in, const int& n_out, const ResampleMode& mode, ResampleAxis& axis );
+
+    /// resamples a w x h image of nc interleaved channels to nw x nh. im and
+    /// out cannot be the same. uchar results are rounded and saturated.
+    /// RESAMPLE_AREA reductions by exactly 2 or 4 take a direct block
+    /// averaging path.
+    void resample    ( const float* im, const int& w, const int& h, const int& nc,
+                       const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, float* out );
+    void resample_par( const float* im, const int& w, const int& h, const int& nc,
+                       const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, float* out );
+    void resample    ( const uchar* im, const int& w, const int& h, const int& nc,
+                       const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, uchar* out );
+    void resample_par( const uchar* im, const int& w, const int& h, const int& nc,
+                       const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, uchar* out );
+
+    /// the weight tables of a resampling of w x h images of nc channels to
+    /// nw x nh. building a plan allocates, running it does not - keep one
+    /// around for repeated frames of the same size.
+    struct ResamplePlan {
+        int                w, h, nc, nw, nh;
+        ResampleMode       mode;
+        BorderMode         border;
+        ResampleAxis       ax, ay;
+        int                u0, nu;  // source columns [u0,u0+nu) the rows are padded to
+        int                hnt;     // taps of the row kernel, padded to 4 for sse
+        std::vector<int>   hofs;
+        std::vector<float> hwt;
+        bool               sse;
+    };
+
+    void resample_plan( const int& w, const int& h, const int& nc, const int& nw, const int& nh,
+                        const ResampleMode& mode, const BorderMode& border, ResamplePlan& plan );
+
+    void resample( const ResamplePlan& plan, const float* im, const bool& run_parallel, float* out );
+    void resample( const ResamplePlan& plan, const uchar* im, const bool& run_parallel, uchar* out );
+
+    /// resamples src to nw x nh - any image type. dst is created with the
+    /// type of src and cannot be src. IT_I_GRAY goes through float and is
+    /// exact up to 2^24.
+    void image_resample( const Image& src, const int& nw, const int& nh, const ResampleMode& mode,
+                         const bool& run_parallel, Image& dst, const BorderMode& border=BORDER_REPLICATE );
+
+}
+
+#endif
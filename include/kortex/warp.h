@@ -0,0 +1,92 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_WARP_H
+#define KORTEX_WARP_H
+
+#include <kortex/types.h>
+#include <kortex/filter.h>
+#include <cstddef>
+#include <vector>
+
+namespace kortex {
+
+    class Image;
+
+    //
+    // geometric warping: destination pixel (x,y) takes the source sample at
+    // the position the transformation maps it to - the transformations are
+    // destination -> source. pixel centers are at integer coordinates, as
+    // in bilinear_interpolation. samples outside the source are taken from
+    // the border mode. the destination is processed in tiles in parallel;
+    // source coordinates are stepped along the tile rows.
+    //
+
+    /// INTERP_BICUBIC uses the kernel of bicubic_interpolation
+    enum InterpolationMode { INTERP_NEAREST=0, INTERP_BILINEAR, INTERP_BICUBIC };
+
+    /// dst(x,y) = src( A[0]*x+A[1]*y+A[2], A[3]*x+A[4]*y+A[5] ). dst is
+    /// created as a nw x nh image of the type of src and cannot be src.
+    void warp_affine     ( const Image& src, const double* A, const int& nw, const int& nh,
+                           const InterpolationMode& interp, const bool& run_parallel, Image& dst,
+                           const BorderMode& border=BORDER_ZERO );
+
+    /// dst(x,y) = src( u/w, v/w ) with (u,v,w) = H*(x,y,1) - H is row-major
+    void warp_perspective( const Image& src, const double* H, const int& nw, const int& nh,
+                           const InterpolationMode& interp, const bool& run_parallel, Image& dst,
+                           const BorderMode& border=BORDER_ZERO );
+
+    /// dst(x,y) = src( mapx(x,y), mapy(x,y) ) - the maps are IT_F_GRAY
+    /// images of the size of dst.
+    void remap( const Image& src, const Image& mapx, const Image& mapy,
+                const InterpolationMode& interp, const bool& run_parallel, Image& dst,
+                const BorderMode& border=BORDER_ZERO );
+
+    /// image size in bytes above which image_interpolate buckets the large
+    /// batches by default
+    const size_t INTERP_BUCKET_BYTES = size_t(1)<<28;
+
+    /// samples src at the n points (xs[i],ys[i]): out[i*src.ch()+c] is
+    /// channel c of point i - for all image types and not rounded for uchar
+    /// images. large batches over images larger than bucket_bytes are
+    /// bucketed by image region for cache locality - 0 buckets every large
+    /// batch; the results are written in the input order.
+    void image_interpolate( const Image& src, const float* xs, const float* ys, const int& n,
+                            const InterpolationMode& interp, const bool& run_parallel, float* out,
+                            const BorderMode& border=BORDER_REPLICATE,
+                            const size_t& bucket_bytes=INTERP_BUCKET_BYTES );
+
+    /// fractional bits of the source coordinates of a WarpMap
+    const int WARP_MAP_BITS = 5;
+    const int WARP_MAP_FRAC = 1<<WARP_MAP_BITS;
+
+    /// precomputed bilinear warp for repeated warps with the same geometry:
+    /// the integer source position of every destination pixel and its
+    /// fractional part in 1/WARP_MAP_FRAC pixels, packed as fy*WARP_MAP_FRAC+fx.
+    /// uchar images are interpolated in integer arithmetic.
+    struct WarpMap {
+        int                   w, h;
+        std::vector<int>      xy;
+        std::vector<uint16_t> frac;
+    };
+
+    void warp_map_affine     ( const double* A, const int& nw, const int& nh, const bool& run_parallel, WarpMap& map );
+    void warp_map_perspective( const double* H, const int& nw, const int& nh, const bool& run_parallel, WarpMap& map );
+    void warp_map            ( const Image& mapx, const Image& mapy, const bool& run_parallel, WarpMap& map );
+
+    void remap( const Image& src, const WarpMap& map, const bool& run_parallel, Image& dst,
+                const BorderMode& border=BORDER_ZERO );
+
+}
+
+#endif
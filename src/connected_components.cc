@@ -0,0 +1,199 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/connected_components.h>
+#include <kortex/image.h>
+#include <kortex/check.h>
+
+#include <cstring>
+#include <algorithm>
+
+namespace kortex {
+
+    /// rows of a strip of the labelling pass
+    const int CC_STRIP_H = 64;
+
+    /// the statistics are accumulated in at most this many partial tables
+    const int CC_STAT_CHUNKS = 8;
+
+    /// root of label a with path halving. roots are the smallest label of
+    /// their set.
+    inline int cc_find( int* parent, int a ) {
+        while( parent[a] != a ) {
+            parent[a] = parent[ parent[a] ];
+            a = parent[a];
+        }
+        return a;
+    }
+
+    inline int cc_union( int* parent, const int& a, const int& b ) {
+        int ra = cc_find( parent, a );
+        int rb = cc_find( parent, b );
+        if( ra < rb ) { parent[rb] = ra; return ra; }
+        if( rb < ra ) { parent[ra] = rb; return rb; }
+        return ra;
+    }
+
+    /// first pass over rows [y0,y1): a foreground pixel takes the label of
+    /// its labelled neighbours above and to the left within the strip and
+    /// merges them, or opens the label 1+y*w+x. rows of im are is and rows
+    /// of lab ls elements apart.
+    template<typename T>
+    void cc_strip( const T* im, const size_t& is, const int& w, const int& y0, const int& y1, const bool& eight,
+                   int* parent, int* lab, const size_t& ls ) {
+        const int ww = w;
+        for( int y=y0; y<y1; y++ ) {
+            const T* ir = im  + size_t(y)*is;
+            int*     lr = lab + size_t(y)*ls;
+            const int* up = ( y > y0 ) ? lr - ls : NULL;
+            for( int x=0; x<ww; x++ ) {
+                if( !ir[x] ) { lr[x] = 0; continue; }
+                int l = 0;
+                if( x && lr[x-1] ) l = lr[x-1];
+                if( up ) {
+                    int nb[3] = { up[x], 0, 0 };
+                    if( eight ) {
+                        if( x      ) nb[1] = up[x-1];
+                        if( x+1<ww ) nb[2] = up[x+1];
+                    }
+                    for( int k=0; k<3; k++ ) {
+                        if( !nb[k] ) continue;
+                        l = l ? cc_union( parent, l, nb[k] ) : nb[k];
+                    }
+                }
+                if( !l ) {
+                    l = 1 + y*ww + x;
+                    parent[l] = l;
+                }
+                lr[x] = l;
+            }
+        }
+    }
+
+    struct ComponentAccum {
+        int    area;
+        int    lx, ly, ux, uy;
+        double sx, sy;
+    };
+
+    template<typename T>
+    int cc_label( const T* im, const size_t& is, const int& w, const int& h, const bool& eight,
+                  const bool& run_parallel, int* lab, const size_t& ls, std::vector<ComponentStats>* stats ) {
+        const int pc = w*h;
+        std::vector<int> parent( pc+1, 0 );
+        int* par = &parent[0];
+
+        const int ns = ( h + CC_STRIP_H - 1 ) / CC_STRIP_H;
+#pragma omp parallel for if( run_parallel )
+        for( int s=0; s<ns; s++ )
+            cc_strip( im, is, w, s*CC_STRIP_H, std::min( h, (s+1)*CC_STRIP_H ), eight, par, lab, ls );
+
+        // join the strips along their first rows
+        for( int s=1; s<ns; s++ ) {
+            const int* up = lab + size_t(s*CC_STRIP_H-1)*ls;
+            const int* lr = up  + ls;
+            for( int x=0; x<w; x++ ) {
+                if( !lr[x] ) continue;
+                if( up[x] ) cc_union( par, lr[x], up[x] );
+                if( eight ) {
+                    if( x     && up[x-1] ) cc_union( par, lr[x], up[x-1] );
+                    if( x+1<w && up[x+1] ) cc_union( par, lr[x], up[x+1] );
+                }
+            }
+        }
+
+        // every non-root points to a smaller label whose final label is
+        // already known by the time it is reached
+        int n = 0;
+        for( int l=1; l<=pc; l++ ) {
+            if( !par[l] ) continue;
+            par[l] = ( par[l] == l ) ? ++n : par[ par[l] ];
+        }
+
+        int nc = 1;
+        if( stats && run_parallel ) nc = std::min( CC_STAT_CHUNKS, ns );
+        std::vector<ComponentAccum> acc;
+        if( stats ) {
+            ComponentAccum a0 = { 0, w, h, -1, -1, 0.0, 0.0 };
+            acc.assign( size_t(nc)*n, a0 );
+        }
+        const int rows_per_chunk = ( h + nc - 1 ) / nc;
+#pragma omp parallel for if( run_parallel )
+        for( int c=0; c<nc; c++ ) {
+            const int       y0 = c*rows_per_chunk;
+            const int       y1 = std::min( h, y0+rows_per_chunk );
+            const int       ww = w;
+            ComponentAccum* ca = ( stats && n ) ? &acc[ size_t(c)*n ] - 1 : NULL;
+            for( int y=y0; y<y1; y++ ) {
+                int* lr = lab + size_t(y)*ls;
+                for( int x=0; x<ww; x++ ) {
+                    if( !lr[x] ) continue;
+                    int l = par[ lr[x] ];
+                    lr[x] = l;
+                    if( !ca ) continue;
+                    ComponentAccum& a = ca[l];
+                    a.area++;
+                    a.lx = std::min( a.lx, x );
+                    a.ux = std::max( a.ux, x );
+                    a.ly = std::min( a.ly, y );
+                    a.uy = std::max( a.uy, y );
+                    a.sx += x;
+                    a.sy += y;
+                }
+            }
+        }
+
+        if( stats ) {
+            stats->resize( n );
+            for( int l=0; l<n; l++ ) {
+                ComponentAccum a = acc[l];
+                for( int c=1; c<nc; c++ ) {
+                    const ComponentAccum& b = acc[ size_t(c)*n + l ];
+                    a.area += b.area;
+                    a.lx    = std::min( a.lx, b.lx );
+                    a.ly    = std::min( a.ly, b.ly );
+                    a.ux    = std::max( a.ux, b.ux );
+                    a.uy    = std::max( a.uy, b.uy );
+                    a.sx   += b.sx;
+                    a.sy   += b.sy;
+                }
+                ComponentStats& st = (*stats)[l];
+                st.area = a.area;
+                st.bbox.init( a.lx, a.ux+1, a.ly, a.uy+1 );
+                st.bbox.id = l+1;
+                st.cx   = float( a.sx / a.area );
+                st.cy   = float( a.sy / a.area );
+            }
+        }
+        return n;
+    }
+
+    int connected_components( const Image& mask, const bool& eight_connected, const bool& run_parallel,
+                              Image& labels, std::vector<ComponentStats>* stats ) {
+        passert_statement( !mask.is_empty(), "empty image" );
+        mask.passert_type( IT_U_GRAY | IT_F_GRAY );
+        passert_noalias( mask, labels );
+        int w = mask.w();
+        int h = mask.h();
+        labels.create( w, h, IT_I_GRAY );
+        switch( mask.type() ) {
+        case IT_U_GRAY: return cc_label( mask.get_row_u(0), mask.stride(), w, h, eight_connected, run_parallel,
+                                         labels.get_row_i(0), labels.stride(), stats );
+        case IT_F_GRAY: return cc_label( mask.get_row_f(0), mask.stride(), w, h, eight_connected, run_parallel,
+                                         labels.get_row_i(0), labels.stride(), stats );
+        default: switch_fatality();
+        }
+        return 0;
+    }
+
+}
@@ -0,0 +1,60 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/cpu_features.h>
+#include <kortex/check.h>
+
+namespace kortex {
+
+    static SimdLevel detect_simd_level() {
+#ifdef KORTEX_X86_DISPATCH
+        __builtin_cpu_init();
+        if( __builtin_cpu_supports("avx512f") )                                  return SIMD_AVX512;
+        if( __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") )    return SIMD_AVX2;
+        if( __builtin_cpu_supports("sse2") )                                     return SIMD_SSE;
+        return SIMD_NONE;
+#elif defined(WITH_SSE)
+        // no cpuid query available - trust the build configuration
+        return SIMD_SSE;
+#else
+        return SIMD_NONE;
+#endif
+    }
+
+    SimdLevel cpu_simd_level() {
+        static const SimdLevel level = detect_simd_level();
+        return level;
+    }
+
+    bool cpu_supports_sse() {
+        return cpu_simd_level() >= SIMD_SSE;
+    }
+    bool cpu_supports_avx2() {
+        return cpu_simd_level() >= SIMD_AVX2;
+    }
+    bool cpu_supports_avx512() {
+        return cpu_simd_level() >= SIMD_AVX512;
+    }
+
+    string simd_level_name( const SimdLevel& level ) {
+        switch( level ) {
+        case SIMD_NONE  : return "none";
+        case SIMD_SSE   : return "sse";
+        case SIMD_AVX2  : return "avx2";
+        case SIMD_AVX512: return "avx512";
+        default         : switch_fatality();
+        }
+    }
+
+}
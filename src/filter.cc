@@ -13,10 +13,32 @@
 // ---------------------------------------------------------------------------
 #include <kortex/filter.h>
 #include <kortex/sse_extensions.h>
+#include <kortex/cpu_features.h>
 #include <kortex/mem_manager.h>
+#include <kortex/mem_unit.h>
 #include <kortex/defs.h>
 
 #include <cstring>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+
+#ifdef KORTEX_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+// the basic and sse kernels accumulate the taps in the same order so that they
+// produce bit-identical results. keep the compiler from fusing their
+// multiply-adds when the library is built for an fma capable -march.
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+using std::vector;
 
 namespace kortex {
 
@@ -90,21 +112,21 @@ namespace kortex {
                 bi[12]*kernel[12] + bi[13]*kernel[13] + bi[14]*kernel[14];
         }
     }
-    void filter_buffer_g_basic (float* buffer, const int& bsz, const float* kernel, const int& ksize) {
+    void filter_buffer_g_basic (float* buffer, const int& bsz, const int& nc, const float* kernel, const int& ksize) {
         for( int i=0; i<bsz; ++i ) {
-            float sum = 0.0f;
-            int j;
-            for( j=0; j<ksize-5; j+=5 ) {
-                float* bij = buffer+i+j;
-                sum += bij[0]*kernel[j  ] + bij[1]*kernel[j+1] + bij[2]*kernel[j+2]
-                    +   bij[3]*kernel[j+3] + bij[4]*kernel[j+4];
-            }
-            for( ; j<ksize; j++ ) sum += buffer[i+j]*kernel[j];
+            const float* bi = buffer+i;
+            float sum = bi[0]*kernel[0];
+            for( int j=1; j<ksize; j++ )
+                sum += bi[j*nc]*kernel[j];
             buffer[i]=sum;
         }
     }
 
-    void filter_buffer_basic   (float* buffer, const int& bsz, const float* kernel, const int& ksize) {
+    void filter_buffer_basic   (float* buffer, const int& bsz, const int& nc, const float* kernel, const int& ksize) {
+        if( nc != 1 ) {
+            filter_buffer_g_basic(buffer,bsz,nc,kernel,ksize);
+            return;
+        }
         switch(ksize) {
         case  3: filter_buffer_03_basic(buffer,bsz,kernel); return;
         case  5: filter_buffer_05_basic(buffer,bsz,kernel); return;
@@ -113,403 +135,946 @@ namespace kortex {
         case 11: filter_buffer_11_basic(buffer,bsz,kernel); return;
         case 13: filter_buffer_13_basic(buffer,bsz,kernel); return;
         case 15: filter_buffer_15_basic(buffer,bsz,kernel); return;
-        default: filter_buffer_g_basic (buffer,bsz,kernel,ksize);
+        default: filter_buffer_g_basic (buffer,bsz,nc,kernel,ksize);
             return;
         }
     }
 
 
 
-#ifdef KORTEX_WITH_SSE
-    void filter_buffer_05_sse_u(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
+#ifdef WITH_SSE
+    /// broadcasts the kernel taps and produces 4 outputs per instruction. the
+    /// taps are accumulated in the same order as the basic kernels (multiply
+    /// then add, no fma) so the results are bit-identical to them.
+    void filter_buffer_sse(float* buffer, const int& bsz, const int& nc, const float* kernel, const int& ksize) {
+        int i=0;
+        for( ; i+16<=bsz; i+=16 ) {
             float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            xmm_a = _mm_loadu_ps(bi);
-            xmm_b = _mm_loadu_ps(kernel);
-            xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] + bi[4]*kernel[4];
+            __m128 k  = _mm_set1_ps(kernel[0]);
+            __m128 s0 = _mm_mul_ps( k, _mm_loadu_ps(bi   ) );
+            __m128 s1 = _mm_mul_ps( k, _mm_loadu_ps(bi+ 4) );
+            __m128 s2 = _mm_mul_ps( k, _mm_loadu_ps(bi+ 8) );
+            __m128 s3 = _mm_mul_ps( k, _mm_loadu_ps(bi+12) );
+            for( int j=1; j<ksize; j++ ) {
+                const float* bij = bi+j*nc;
+                k  = _mm_set1_ps(kernel[j]);
+                s0 = _mm_add_ps( s0, _mm_mul_ps( k, _mm_loadu_ps(bij   ) ) );
+                s1 = _mm_add_ps( s1, _mm_mul_ps( k, _mm_loadu_ps(bij+ 4) ) );
+                s2 = _mm_add_ps( s2, _mm_mul_ps( k, _mm_loadu_ps(bij+ 8) ) );
+                s3 = _mm_add_ps( s3, _mm_mul_ps( k, _mm_loadu_ps(bij+12) ) );
+            }
+            _mm_storeu_ps( bi   , s0 );
+            _mm_storeu_ps( bi+ 4, s1 );
+            _mm_storeu_ps( bi+ 8, s2 );
+            _mm_storeu_ps( bi+12, s3 );
         }
-    }
-    void filter_buffer_05_sse_a(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
+        for( ; i+4<=bsz; i+=4 ) {
             float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            xmm_a = _mm_loadu_ps(bi);
-            xmm_b = _mm_load_ps(kernel);
-            xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] + bi[4]*kernel[4];
+            __m128 s0 = _mm_mul_ps( _mm_set1_ps(kernel[0]), _mm_loadu_ps(bi) );
+            for( int j=1; j<ksize; j++ )
+                s0 = _mm_add_ps( s0, _mm_mul_ps( _mm_set1_ps(kernel[j]), _mm_loadu_ps(bi+j*nc) ) );
+            _mm_storeu_ps( bi, s0 );
         }
+        if( i<bsz ) filter_buffer_g_basic( buffer+i, bsz-i, nc, kernel, ksize );
     }
-    void filter_buffer_07_sse_u(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
+#endif
+
+
+#ifdef KORTEX_X86_DISPATCH
+    //
+    // wide kernels: instead of reducing one output sample per iteration, the
+    // kernel taps are broadcast and multiplied with shifted loads of the
+    // buffer so that every instruction produces 8 (avx2) or 16 (avx512)
+    // outputs. several accumulators are kept in flight to hide the fma
+    // latency. outputs are only written after all the taps of a block are
+    // read, so the buffer can still be filtered in-place.
+    //
+
+    KORTEX_TARGET_AVX2
+    void filter_buffer_avx2(float* buffer, const int& bsz, const int& nc, const float* kernel, const int& ksize) {
+        int i=0;
+        for( ; i+32<=bsz; i+=32 ) {
             float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            xmm_a = _mm_loadu_ps(bi);
-            xmm_b = _mm_loadu_ps(kernel);
-            xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[4]*kernel[4] + bi[5]*kernel[5] + bi[6]*kernel[6];
+            __m256 k  = _mm256_broadcast_ss(kernel);
+            __m256 s0 = _mm256_mul_ps( k, _mm256_loadu_ps(bi   ) );
+            __m256 s1 = _mm256_mul_ps( k, _mm256_loadu_ps(bi+ 8) );
+            __m256 s2 = _mm256_mul_ps( k, _mm256_loadu_ps(bi+16) );
+            __m256 s3 = _mm256_mul_ps( k, _mm256_loadu_ps(bi+24) );
+            for( int j=1; j<ksize; j++ ) {
+                const float* bij = bi+j*nc;
+                k  = _mm256_broadcast_ss(kernel+j);
+                s0 = _mm256_fmadd_ps( k, _mm256_loadu_ps(bij   ), s0 );
+                s1 = _mm256_fmadd_ps( k, _mm256_loadu_ps(bij+ 8), s1 );
+                s2 = _mm256_fmadd_ps( k, _mm256_loadu_ps(bij+16), s2 );
+                s3 = _mm256_fmadd_ps( k, _mm256_loadu_ps(bij+24), s3 );
+            }
+            _mm256_storeu_ps( bi   , s0 );
+            _mm256_storeu_ps( bi+ 8, s1 );
+            _mm256_storeu_ps( bi+16, s2 );
+            _mm256_storeu_ps( bi+24, s3 );
         }
-    }
-    void filter_buffer_07_sse_a(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
+        for( ; i+8<=bsz; i+=8 ) {
             float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            xmm_a = _mm_loadu_ps(bi);
-            xmm_b = _mm_load_ps(kernel);
-            xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[4]*kernel[4] + bi[5]*kernel[5] + bi[6]*kernel[6];
+            __m256 s0 = _mm256_mul_ps( _mm256_broadcast_ss(kernel), _mm256_loadu_ps(bi) );
+            for( int j=1; j<ksize; j++ )
+                s0 = _mm256_fmadd_ps( _mm256_broadcast_ss(kernel+j), _mm256_loadu_ps(bi+j*nc), s0 );
+            _mm256_storeu_ps( bi, s0 );
+        }
+        for( ; i<bsz; i++ ) {
+            float sum = buffer[i]*kernel[0];
+            for( int j=1; j<ksize; j++ ) sum += buffer[i+j*nc]*kernel[j];
+            buffer[i] = sum;
         }
     }
-    void filter_buffer_09_sse_u(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
+
+    KORTEX_TARGET_AVX512
+    void filter_buffer_avx512(float* buffer, const int& bsz, const int& nc, const float* kernel, const int& ksize) {
+        int i=0;
+        for( ; i+64<=bsz; i+=64 ) {
             float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<8; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j);
-                xmm_b = _mm_loadu_ps(kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
+            __m512 k  = _mm512_set1_ps(kernel[0]);
+            __m512 s0 = _mm512_mul_ps( k, _mm512_loadu_ps(bi   ) );
+            __m512 s1 = _mm512_mul_ps( k, _mm512_loadu_ps(bi+16) );
+            __m512 s2 = _mm512_mul_ps( k, _mm512_loadu_ps(bi+32) );
+            __m512 s3 = _mm512_mul_ps( k, _mm512_loadu_ps(bi+48) );
+            for( int j=1; j<ksize; j++ ) {
+                const float* bij = bi+j*nc;
+                k  = _mm512_set1_ps(kernel[j]);
+                s0 = _mm512_fmadd_ps( k, _mm512_loadu_ps(bij   ), s0 );
+                s1 = _mm512_fmadd_ps( k, _mm512_loadu_ps(bij+16), s1 );
+                s2 = _mm512_fmadd_ps( k, _mm512_loadu_ps(bij+32), s2 );
+                s3 = _mm512_fmadd_ps( k, _mm512_loadu_ps(bij+48), s3 );
             }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] + bi[8]*kernel[8];
+            _mm512_storeu_ps( bi   , s0 );
+            _mm512_storeu_ps( bi+16, s1 );
+            _mm512_storeu_ps( bi+32, s2 );
+            _mm512_storeu_ps( bi+48, s3 );
         }
-    }
-    void filter_buffer_09_sse_a(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
+        for( ; i+16<=bsz; i+=16 ) {
             float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<8; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j);
-                xmm_b = _mm_load_ps(kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] + bi[8]*kernel[8];
+            __m512 s0 = _mm512_mul_ps( _mm512_set1_ps(kernel[0]), _mm512_loadu_ps(bi) );
+            for( int j=1; j<ksize; j++ )
+                s0 = _mm512_fmadd_ps( _mm512_set1_ps(kernel[j]), _mm512_loadu_ps(bi+j*nc), s0 );
+            _mm512_storeu_ps( bi, s0 );
         }
+        if( i<bsz ) filter_buffer_avx2( buffer+i, bsz-i, nc, kernel, ksize );
     }
-    void filter_buffer_11_sse_u(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
-            float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<8; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j);
-                xmm_b = _mm_loadu_ps(kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[8]*kernel[8] + bi[9]*kernel[9] + bi[10]*kernel[10];
+#endif
+
+
+    //
+    // row kernels: out[x] = sum_j kernel[j]*rows[j][x] over n samples. these
+    // drive the vertical pass - every load is contiguous and the taps are
+    // accumulated in the same order as the buffer kernels. out must not alias
+    // any of the rows.
+    //
+
+    void filter_rows_basic(const float* const* rows, const int& n, const float* kernel, const int& ksize, float* out) {
+        const int    nn = n;
+        const float* r0 = rows[0];
+        float k = kernel[0];
+        for( int x=0; x<nn; x++ )
+            out[x] = r0[x]*k;
+        for( int j=1; j<ksize; j++ ) {
+            const float* rj = rows[j];
+            k = kernel[j];
+            for( int x=0; x<nn; x++ )
+                out[x] += rj[x]*k;
         }
     }
-    void filter_buffer_11_sse_a(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
-            float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<8; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j);
-                xmm_b = _mm_load_ps(kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
+
+#ifdef WITH_SSE
+    void filter_rows_sse(const float* const* rows, const int& n, const float* kernel, const int& ksize, float* out) {
+        int x=0;
+        for( ; x+16<=n; x+=16 ) {
+            const float* rx = rows[0]+x;
+            __m128 k  = _mm_set1_ps(kernel[0]);
+            __m128 s0 = _mm_mul_ps( _mm_loadu_ps(rx   ), k );
+            __m128 s1 = _mm_mul_ps( _mm_loadu_ps(rx+ 4), k );
+            __m128 s2 = _mm_mul_ps( _mm_loadu_ps(rx+ 8), k );
+            __m128 s3 = _mm_mul_ps( _mm_loadu_ps(rx+12), k );
+            for( int j=1; j<ksize; j++ ) {
+                rx = rows[j]+x;
+                k  = _mm_set1_ps(kernel[j]);
+                s0 = _mm_add_ps( s0, _mm_mul_ps( _mm_loadu_ps(rx   ), k ) );
+                s1 = _mm_add_ps( s1, _mm_mul_ps( _mm_loadu_ps(rx+ 4), k ) );
+                s2 = _mm_add_ps( s2, _mm_mul_ps( _mm_loadu_ps(rx+ 8), k ) );
+                s3 = _mm_add_ps( s3, _mm_mul_ps( _mm_loadu_ps(rx+12), k ) );
             }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[8]*kernel[8] + bi[9]*kernel[9] + bi[10]*kernel[10];
+            _mm_storeu_ps( out+x   , s0 );
+            _mm_storeu_ps( out+x+ 4, s1 );
+            _mm_storeu_ps( out+x+ 8, s2 );
+            _mm_storeu_ps( out+x+12, s3 );
+        }
+        for( ; x+4<=n; x+=4 ) {
+            __m128 s0 = _mm_mul_ps( _mm_loadu_ps(rows[0]+x), _mm_set1_ps(kernel[0]) );
+            for( int j=1; j<ksize; j++ )
+                s0 = _mm_add_ps( s0, _mm_mul_ps( _mm_loadu_ps(rows[j]+x), _mm_set1_ps(kernel[j]) ) );
+            _mm_storeu_ps( out+x, s0 );
+        }
+        for( ; x<n; x++ ) {
+            float sum = rows[0][x]*kernel[0];
+            for( int j=1; j<ksize; j++ ) sum += rows[j][x]*kernel[j];
+            out[x] = sum;
         }
     }
-    void filter_buffer_13_sse_u(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
-            float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<12; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j);
-                xmm_b = _mm_loadu_ps(kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
+#endif
+
+#ifdef KORTEX_X86_DISPATCH
+    KORTEX_TARGET_AVX2
+    void filter_rows_avx2(const float* const* rows, const int& n, const float* kernel, const int& ksize, float* out) {
+        int x=0;
+        for( ; x+32<=n; x+=32 ) {
+            const float* rx = rows[0]+x;
+            __m256 k  = _mm256_broadcast_ss(kernel);
+            __m256 s0 = _mm256_mul_ps( k, _mm256_loadu_ps(rx   ) );
+            __m256 s1 = _mm256_mul_ps( k, _mm256_loadu_ps(rx+ 8) );
+            __m256 s2 = _mm256_mul_ps( k, _mm256_loadu_ps(rx+16) );
+            __m256 s3 = _mm256_mul_ps( k, _mm256_loadu_ps(rx+24) );
+            for( int j=1; j<ksize; j++ ) {
+                rx = rows[j]+x;
+                k  = _mm256_broadcast_ss(kernel+j);
+                s0 = _mm256_fmadd_ps( k, _mm256_loadu_ps(rx   ), s0 );
+                s1 = _mm256_fmadd_ps( k, _mm256_loadu_ps(rx+ 8), s1 );
+                s2 = _mm256_fmadd_ps( k, _mm256_loadu_ps(rx+16), s2 );
+                s3 = _mm256_fmadd_ps( k, _mm256_loadu_ps(rx+24), s3 );
             }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[12]*kernel[12];
+            _mm256_storeu_ps( out+x   , s0 );
+            _mm256_storeu_ps( out+x+ 8, s1 );
+            _mm256_storeu_ps( out+x+16, s2 );
+            _mm256_storeu_ps( out+x+24, s3 );
+        }
+        for( ; x+8<=n; x+=8 ) {
+            __m256 s0 = _mm256_mul_ps( _mm256_broadcast_ss(kernel), _mm256_loadu_ps(rows[0]+x) );
+            for( int j=1; j<ksize; j++ )
+                s0 = _mm256_fmadd_ps( _mm256_broadcast_ss(kernel+j), _mm256_loadu_ps(rows[j]+x), s0 );
+            _mm256_storeu_ps( out+x, s0 );
+        }
+        for( ; x<n; x++ ) {
+            float sum = rows[0][x]*kernel[0];
+            for( int j=1; j<ksize; j++ ) sum += rows[j][x]*kernel[j];
+            out[x] = sum;
         }
     }
-    void filter_buffer_13_sse_a(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
-            float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<12; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j);
-                xmm_b = _mm_load_ps (kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
+
+    KORTEX_TARGET_AVX512
+    void filter_rows_avx512(const float* const* rows, const int& n, const float* kernel, const int& ksize, float* out) {
+        int x=0;
+        for( ; x+64<=n; x+=64 ) {
+            const float* rx = rows[0]+x;
+            __m512 k  = _mm512_set1_ps(kernel[0]);
+            __m512 s0 = _mm512_mul_ps( k, _mm512_loadu_ps(rx   ) );
+            __m512 s1 = _mm512_mul_ps( k, _mm512_loadu_ps(rx+16) );
+            __m512 s2 = _mm512_mul_ps( k, _mm512_loadu_ps(rx+32) );
+            __m512 s3 = _mm512_mul_ps( k, _mm512_loadu_ps(rx+48) );
+            for( int j=1; j<ksize; j++ ) {
+                rx = rows[j]+x;
+                k  = _mm512_set1_ps(kernel[j]);
+                s0 = _mm512_fmadd_ps( k, _mm512_loadu_ps(rx   ), s0 );
+                s1 = _mm512_fmadd_ps( k, _mm512_loadu_ps(rx+16), s1 );
+                s2 = _mm512_fmadd_ps( k, _mm512_loadu_ps(rx+32), s2 );
+                s3 = _mm512_fmadd_ps( k, _mm512_loadu_ps(rx+48), s3 );
             }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[12]*kernel[12];
+            _mm512_storeu_ps( out+x   , s0 );
+            _mm512_storeu_ps( out+x+16, s1 );
+            _mm512_storeu_ps( out+x+32, s2 );
+            _mm512_storeu_ps( out+x+48, s3 );
+        }
+        for( ; x+16<=n; x+=16 ) {
+            __m512 s0 = _mm512_mul_ps( _mm512_set1_ps(kernel[0]), _mm512_loadu_ps(rows[0]+x) );
+            for( int j=1; j<ksize; j++ )
+                s0 = _mm512_fmadd_ps( _mm512_set1_ps(kernel[j]), _mm512_loadu_ps(rows[j]+x), s0 );
+            _mm512_storeu_ps( out+x, s0 );
+        }
+        for( ; x+8<=n; x+=8 ) {
+            __m256 s0 = _mm256_mul_ps( _mm256_broadcast_ss(kernel), _mm256_loadu_ps(rows[0]+x) );
+            for( int j=1; j<ksize; j++ )
+                s0 = _mm256_fmadd_ps( _mm256_broadcast_ss(kernel+j), _mm256_loadu_ps(rows[j]+x), s0 );
+            _mm256_storeu_ps( out+x, s0 );
+        }
+        for( ; x<n; x++ ) {
+            float sum = rows[0][x]*kernel[0];
+            for( int j=1; j<ksize; j++ ) sum += rows[j][x]*kernel[j];
+            out[x] = sum;
         }
     }
-    void filter_buffer_15_sse_u(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
-            float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<12; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j    );
-                xmm_b = _mm_loadu_ps(kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[12]*kernel[12] + bi[13]*kernel[13] + bi[14]*kernel[14];
+#endif
+
+
+    /// read by the kernels of every thread - accessed atomically
+    static int s_filter_level_cap = SIMD_AVX512;
+
+    SimdLevel filter_simd_level() {
+        int cap;
+#pragma omp atomic read
+        cap = s_filter_level_cap;
+        SimdLevel level = std::min( cpu_simd_level(), SimdLevel( cap ) );
+#ifndef WITH_SSE
+        if( level == SIMD_SSE ) level = SIMD_NONE;
+#endif
+        return level;
+    }
+
+    SimdLevel filter_set_simd_level( const SimdLevel& max_level ) {
+#pragma omp atomic write
+        s_filter_level_cap = int( max_level );
+        return filter_simd_level();
+    }
+
+    string filter_kernel_name( const int& ksize ) {
+        passert_statement( ksize > 0, "invalid kernel size" );
+        SimdLevel level = filter_simd_level();
+        if( level != SIMD_NONE ) return simd_level_name( level );
+        char buf[32];
+        if( ksize%2 == 1 && ksize >= 3 && ksize <= 15 ) sprintf( buf, "basic-%02d", ksize );
+        else                                             sprintf( buf, "basic-g"         );
+        return string( buf );
+    }
+
+    void filter_buffer(float* buffer, const int& bsz, const int& nc, const float* kernel, const int& ksize) {
+        // buffer should be padded with +-halfsize*nc -- the taps are nc
+        // samples apart. see filter_hor for example use.
+        switch( filter_simd_level() ) {
+#ifdef KORTEX_X86_DISPATCH
+        case SIMD_AVX512: filter_buffer_avx512(buffer, bsz, nc, kernel, ksize); return;
+        case SIMD_AVX2  : filter_buffer_avx2  (buffer, bsz, nc, kernel, ksize); return;
+#endif
+#ifdef WITH_SSE
+        case SIMD_SSE   : filter_buffer_sse   (buffer, bsz, nc, kernel, ksize); return;
+#endif
+        default         : filter_buffer_basic (buffer, bsz, nc, kernel, ksize); return;
         }
     }
-    void filter_buffer_15_sse_a(float* buffer, const int& bsz, const float* kernel) {
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
-            float* bi = buffer+i;
-            xmm_s.pack = _mm_set1_ps(0.0);
-            for( int j=0; j<12; j+=4 ) {
-                xmm_a = _mm_loadu_ps(bi+j    );
-                xmm_b = _mm_load_ps (kernel+j);
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            }
-            bi[0] = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3] +
-                bi[12]*kernel[12] + bi[13]*kernel[13] + bi[14]*kernel[14];
+
+    void filter_rows(const float* const* rows, const int& n, const float* kernel, const int& ksize, float* out) {
+        switch( filter_simd_level() ) {
+#ifdef KORTEX_X86_DISPATCH
+        case SIMD_AVX512: filter_rows_avx512(rows, n, kernel, ksize, out); return;
+        case SIMD_AVX2  : filter_rows_avx2  (rows, n, kernel, ksize, out); return;
+#endif
+#ifdef WITH_SSE
+        case SIMD_SSE   : filter_rows_sse   (rows, n, kernel, ksize, out); return;
+#endif
+        default         : filter_rows_basic (rows, n, kernel, ksize, out); return;
         }
     }
-    void filter_buffer_g_sse_u (float* buffer, const int& bsz, const float* kernel, const int& ksize) {
-        int ksimdlen = ksize/4*4;
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; ++i ) {
-            xmm_s.pack = _mm_set1_ps(0.0);
-            int j;
-            for( j=0; j<ksimdlen; j+=4 ) {
-                xmm_a = _mm_loadu_ps(buffer+i+j);
-                xmm_b = _mm_loadu_ps(kernel+j  );
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
+
+
+
+    /// fills the halfsize pixels on both sides of a padded line of nc
+    /// interleaved channels: line[(halfsize+x)*nc+c] holds channel c of the
+    /// pixel x of a row of w pixels.
+    void filter_fill_line_border( float* line, const int& w, const int& nc, const int& halfsize,
+                                  const BorderMode& border ) {
+        const int hsn = halfsize*nc;
+        float*    mid = line + hsn;
+        if( border == BORDER_ZERO ) {
+            memset( line,       0, sizeof(*line)*hsn );
+            memset( mid + w*nc, 0, sizeof(*line)*hsn );
+            return;
+        }
+        for( int i=0; i<halfsize; i++ ) {
+            int ml = border_index( i-halfsize, w, border );
+            int mr = border_index( w+i,        w, border );
+            for( int c=0; c<nc; c++ ) {
+                line[i*nc+c]      = mid[ml*nc+c];
+                mid [(w+i)*nc+c]  = mid[mr*nc+c];
             }
-            float sum = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3];
-            for(; j<ksize; j++) sum += buffer[i+j] * kernel[j];
-            buffer[i] = sum;
         }
     }
-    void filter_buffer_g_sse_a (float* buffer, const int& bsz, const float* kernel, const int& ksize) {
-        int ksimdlen = ksize/4*4;
-        __m128 xmm_a, xmm_b;
-        F128 xmm_s;
-        for( int i=0; i<bsz; i++ ) {
-            xmm_s.pack = _mm_set1_ps(0.0);
-            int j;
-            for( j=0; j<ksimdlen; j+=4 ) {
-                xmm_a = _mm_loadu_ps(buffer+i+j);
-                xmm_b = _mm_load_ps (kernel+j  );
-                xmm_s.pack = _mm_add_ps(xmm_s.pack, _mm_mul_ps(xmm_a, xmm_b));
-            }
-            float sum = xmm_s.f[0] + xmm_s.f[1] + xmm_s.f[2] + xmm_s.f[3];
-            for(; j<ksize; j++) sum += buffer[i+j] * kernel[j];
-            buffer[i] = sum;
+
+    void filter_hor(const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize,
+                    float* out, const BorderMode& border, const int& istride, const int& ostride) {
+        int halfsize = ksize / 2;
+        int rl = w*nc;
+        int hsn = halfsize*nc;
+        size_t is = istride ? istride : rl;
+        size_t os = ostride ? ostride : rl;
+        float* buffer = thread_scratch_f( 0, rl+2*hsn );
+        for( int r=0; r<h; r++ ) {
+            memcpy( buffer+hsn, im+r*is, sizeof(*im)*rl );
+            filter_fill_line_border( buffer, w, nc, halfsize, border );
+            filter_buffer(buffer, rl, nc, kernel, ksize );
+            memcpy(out+r*os, buffer, rl*sizeof(*im));
         }
     }
-    void filter_buffer_sse_u   (float* buffer, const int& bsz, const float* kernel, const int& ksize) {
-        switch(ksize) {
-        case  3: filter_buffer_03_basic(buffer,bsz,kernel); return;
-        case  5: filter_buffer_05_sse_u(buffer,bsz,kernel); return;
-        case  7: filter_buffer_07_sse_u(buffer,bsz,kernel); return;
-        case  9: filter_buffer_09_sse_u(buffer,bsz,kernel); return;
-        case 11: filter_buffer_11_sse_u(buffer,bsz,kernel); return;
-        case 13: filter_buffer_13_sse_u(buffer,bsz,kernel); return;
-        case 15: filter_buffer_15_sse_u(buffer,bsz,kernel); return;
-        default: filter_buffer_g_sse_u(buffer,bsz,kernel,ksize);
-            return;
+
+
+    void filter_hor_par( const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize,
+                         float* out, const BorderMode& border, const int& istride, const int& ostride ) {
+        int halfsize = ksize / 2;
+        int rl = w*nc;
+        int hsn = halfsize*nc;
+        size_t is = istride ? istride : rl;
+        size_t os = ostride ? ostride : rl;
+#pragma omp parallel
+        {
+            float* buffer = thread_scratch_f( 0, rl+2*hsn );
+#pragma omp for
+            for( int r=0; r<h; r++ ) {
+                memcpy( buffer+hsn, im+r*is, sizeof(*buffer)*rl );
+                filter_fill_line_border( buffer, w, nc, halfsize, border );
+                filter_buffer(buffer, rl, nc, kernel, ksize );
+                memcpy( out+r*os, buffer, rl*sizeof(*out) );
+            }
         }
     }
-    void filter_buffer_sse_a   (float* buffer, const int& bsz, const float* kernel, const int& ksize) {
-        switch(ksize) {
-        case  3: filter_buffer_03_basic(buffer,bsz,kernel); return;
-        case  5: filter_buffer_05_sse_a(buffer,bsz,kernel); return;
-        case  7: filter_buffer_07_sse_a(buffer,bsz,kernel); return;
-        case  9: filter_buffer_09_sse_a(buffer,bsz,kernel); return;
-        case 11: filter_buffer_11_sse_a(buffer,bsz,kernel); return;
-        case 13: filter_buffer_13_sse_a(buffer,bsz,kernel); return;
-        case 15: filter_buffer_15_sse_a(buffer,bsz,kernel); return;
-        default: filter_buffer_g_sse_a(buffer,bsz,kernel,ksize);
-            return;
+
+    /// copies the rows the border mode extends the image with: the halfsize
+    /// rows above it followed by the halfsize rows below it. they are taken
+    /// before anything is written, so in-place filters can read them at any
+    /// time. NULL for BORDER_ZERO. the rows of im are is samples apart,
+    /// the copies w.
+    float* filter_border_rows( const float* im, const int& w, const size_t& is, const int& h, const int& halfsize,
+                               const BorderMode& border ) {
+        if( border == BORDER_ZERO || halfsize == 0 ) return NULL;
+        float* rows = thread_scratch_f( 2, 2*size_t(halfsize)*w );
+        for( int i=0; i<halfsize; i++ ) {
+            memcpy( rows+size_t(i)*w,          im+border_index(i-halfsize,h,border)*is, sizeof(*im)*w );
+            memcpy( rows+size_t(halfsize+i)*w, im+border_index(h+i,       h,border)*is, sizeof(*im)*w );
         }
+        return rows;
     }
-#endif
 
 
-    void filter_buffer(float* buffer, const int& bsz, const float* kernel, const int& ksize, const MemoryMode& mode) {
-        // buffer should be padded with +-ksize -- see filter_horizontal for
-        // example use.
-#ifdef KORTEX_WITH_SSE
-        switch( mode ) {
-        case MM_16_ALIGNED  : filter_buffer_sse_a(buffer, bsz, kernel, ksize); break;
-        case MM_16_UNALIGNED: filter_buffer_sse_u(buffer, bsz, kernel, ksize); break;
-        default:              logman_fatal("something is wrong here"); break;
+    /// width of the column strips the vertical pass works on: the ksize input
+    /// rows of a strip should stay in cache while the strip is swept down.
+    int filter_ver_strip_width( const int& w, const int& ksize ) {
+        int sw = std::max( 512, (16384/ksize) & ~63 );
+        return std::min( w, sw );
+    }
+
+    /// vertical pass over the rows [r0,r1) of a band, sweeping column strips
+    /// top to bottom and accumulating ksize row pointers per output row. rows
+    /// outside the image come from border (see filter_border_rows) or read
+    /// as zero if it is NULL. when filtering in-place the output rows
+    /// are held back in a ring until no later row needs their input, and rows
+    /// outside the band are read from halo: the halfsize rows above r0
+    /// followed by the halfsize rows below r1, saved before any band of the
+    /// image was written. the rows of im and out are is and os samples apart,
+    /// the ones of halo and border w.
+    void filter_ver_band( const float* im, const int& w, const size_t& is, const int& h, const float* kernel, const int& ksize,
+                          float* out, const size_t& os, const int& r0, const int& r1, const float* halo, const float* border ) {
+        int  halfsize = ksize / 2;
+        bool in_place = ( im == out );
+        int  sw       = filter_ver_strip_width( w, ksize );
+        int  n_ring   = in_place ? halfsize+1 : 0;
+
+        float* zeros = thread_scratch_f( 0, size_t(sw)*(n_ring+1) );
+        float* ring  = zeros + sw;
+        memset( zeros, 0, sizeof(*zeros)*sw );
+
+        vector<const float*> rows( ksize );
+        for( int x0=0; x0<w; x0+=sw ) {
+            int n = std::min( sw, w-x0 );
+            for( int r=r0; r<r1; r++ ) {
+                for( int j=0; j<ksize; j++ ) {
+                    int rr = r - halfsize + j;
+                    if( rr < 0 || rr >= h ) {
+                        if( !border )               rows[j] = zeros;
+                        else if( rr < 0 )           rows[j] = border + size_t(rr+halfsize  )*w + x0;
+                        else                        rows[j] = border + size_t(rr-h+halfsize)*w + x0;
+                    }
+                    else if( in_place && rr < r0 ) rows[j] = halo + size_t(rr-r0+halfsize)*w + x0;
+                    else if( in_place && rr >= r1 ) rows[j] = halo + size_t(rr-r1+halfsize)*w + x0;
+                    else                            rows[j] = im   + rr*is + x0;
+                }
+                if( !in_place ) {
+                    filter_rows( &rows[0], n, kernel, ksize, out+r*os+x0 );
+                    continue;
+                }
+                float* rbuf = ring + size_t((r-r0)%n_ring)*sw;
+                if( r-r0 >= n_ring )
+                    memcpy( out+(r-n_ring)*os+x0, rbuf, sizeof(*out)*n );
+                filter_rows( &rows[0], n, kernel, ksize, rbuf );
+            }
+            for( int r=std::max(r0,r1-n_ring); in_place && r<r1; r++ )
+                memcpy( out+r*os+x0, ring+size_t((r-r0)%n_ring)*sw, sizeof(*out)*n );
         }
-#else
-        filter_buffer_basic(buffer, bsz, kernel, ksize);
-#endif
     }
 
+    void filter_ver( const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize,
+                     float* out, const BorderMode& border, const int& istride, const int& ostride ) {
+        // the vertical pass does not see the channels: a row is w*nc samples
+        const int    rl    = w*nc;
+        const size_t is    = istride ? istride : rl;
+        const size_t os    = ostride ? ostride : rl;
+        passert_statement( im != out || is == os, "in-place filtering needs equal strides" );
+        const float* brows = filter_border_rows( im, rl, is, h, ksize/2, border );
+        filter_ver_band( im, rl, is, h, kernel, ksize, out, os, 0, h, NULL, brows );
+    }
 
+    /// row bands the _par filters distribute over the threads. a band is
+    /// never shorter than halfsize (except the last one) so its halo rows
+    /// only come from the adjacent bands.
+    int filter_band_height( const int& ksize ) {
+        return std::max( 64, 8*ksize );
+    }
 
-    /// filling the halfsize regions with 0 --> otherwise blending produces saturated results
-    void filter_hor(const float* im, const int& w, const int& h, const float* kernel, const int& ksize,
-                    float* out) {
-        float buffer[MAX_IMAGE_DIM];
-        passert_statement( w+ksize < MAX_IMAGE_DIM, "w+ksize is larger than max buffer size" );
-        int halfsize = ksize / 2;
-        MemoryMode opmode = get_alignment(kernel); // buffer is already loaded with mm_loadu
-        for( int r=0; r<h; r++ ) {
-            int rw = r*w;
-            memset( buffer,            0,     sizeof(*buffer)*halfsize );
-            memcpy( buffer+halfsize,   im+rw, sizeof(*im)*w            );
-            memset( buffer+halfsize+w, 0,     sizeof(*buffer)*halfsize );
-            filter_buffer(buffer, w, kernel, ksize, opmode);
-            memcpy(out+rw, buffer, w*sizeof(*im));
+    /// saves, for every band, the halfsize input rows above and below it
+    /// before any band gets written. returns NULL when no band needs them.
+    float* filter_save_band_halos( const float* im, const int& w, const size_t& is, const int& h, const int& halfsize,
+                                   const int& band, const int& n_bands ) {
+        if( n_bands < 2 || halfsize == 0 ) return NULL;
+        size_t halo_sz = 2*size_t(halfsize)*w;
+        float* halo    = thread_scratch_f( 1, n_bands*halo_sz );
+#pragma omp parallel for
+        for( int b=0; b<n_bands; b++ ) {
+            int r0 = b*band;
+            int r1 = std::min( h, r0+band );
+            float* bhalo = halo + b*halo_sz;
+            for( int rr=std::max(0,r0-halfsize); rr<r0; rr++ )
+                memcpy( bhalo+size_t(rr-r0+halfsize)*w, im+rr*is, sizeof(*im)*w );
+            for( int rr=r1; rr<std::min(h,r1+halfsize); rr++ )
+                memcpy( bhalo+size_t(rr-r1+halfsize)*w, im+rr*is, sizeof(*im)*w );
         }
+        return halo;
     }
 
+    void filter_ver_par(const float* im, const int& iw, const int& h, const int& nc, const float* kernel, const int& ksize,
+                        float* out, const BorderMode& border, const int& istride, const int& ostride ) {
+        int    w       = iw*nc;
+        size_t is      = istride ? istride : w;
+        size_t os      = ostride ? ostride : w;
+        int    band    = filter_band_height( ksize );
+        int    n_bands = (h+band-1) / band;
+        size_t halo_sz = 2*size_t(ksize/2)*w;
+        float* halo    = NULL;
+        passert_statement( im != out || is == os, "in-place filtering needs equal strides" );
+        if( im == out )
+            halo = filter_save_band_halos( im, w, is, h, ksize/2, band, n_bands );
+        const float* brows = filter_border_rows( im, w, is, h, ksize/2, border );
 
-    void filter_hor_par( const float* im, const int& w, const int& h, const float* kernel, const int& ksize,
-                         float* out ) {
-        passert_statement( w+ksize < MAX_IMAGE_DIM, "w+ksize is larger than max buffer size" );
-        int halfsize = ksize / 2;
-        MemoryMode opmode = get_alignment(kernel); // buffer is already loaded with mm_loadu
 #pragma omp parallel for
-        for( int r=0; r<h; r++ ) {
-            float buffer[MAX_IMAGE_DIM];
-            int rw = r*w;
-            memset( buffer,            0,     sizeof(*buffer)*halfsize );
-            memcpy( buffer+halfsize,   im+rw, sizeof(*buffer)*w        );
-            memset( buffer+halfsize+w, 0,     sizeof(*buffer)*halfsize );
-            filter_buffer(buffer, w, kernel, ksize, opmode );
-            memcpy( out+rw, buffer, w*sizeof(*out) );
+        for( int b=0; b<n_bands; b++ ) {
+            int r0 = b*band;
+            int r1 = std::min( h, r0+band );
+            filter_ver_band( im, w, is, h, kernel, ksize, out, os, r0, r1, halo ? halo+b*halo_sz : NULL, brows );
         }
     }
 
+    /// fused separable pass over the rows [r0,r1) of a band. the image is
+    /// swept in column strips; the horizontally filtered rows of a strip are
+    /// kept in a ring of ksize rows and consumed by the vertical pass as soon
+    /// as the ring covers an output row, so the intermediate result never
+    /// leaves the cache. the result is identical to filter_hor followed by
+    /// filter_ver.
+    ///
+    /// rows are handled as w*nc interleaved samples: the strips and halos are
+    /// counted in samples and the horizontal taps are nc samples apart, so
+    /// all channels of a pixel-ordered image are filtered in one sweep.
+    ///
+    /// in-place: an output row is written only after every horizontal row that
+    /// reads it is computed. the halfsize input pixels a strip shares with the
+    /// next one are saved in a column halo before they get overwritten, and
+    /// the input rows outside the band come from halo (see filter_ver_band).
+    /// the first and last halfsize+1 pixels of every row are saved in the
+    /// first strip for the border modes, whose samples may come from the other
+    /// end of the row. the rows of im and out are is and os samples apart.
+    void filter_hv_band( const float* im, const size_t& is, const int& w, const int& h, const int& nc,
+                         const float* kernel, const int& ksize,
+                         float* out, const size_t& os, const int& r0, const int& r1, const float* halo,
+                         const float* brows, const BorderMode& border ) {
+        int  halfsize = ksize / 2;
+        int  rl       = w*nc;
+        int  hsn      = halfsize*nc;
+        bool in_place = ( im == out );
+        int  sw       = std::max( ksize*nc, filter_ver_strip_width( rl, ksize ) );
+        int  lsz      = sw + 2*hsn;
+        int  n_hrows  = r1 - r0 + 2*halfsize;
+        int  ne       = border == BORDER_ZERO ? 0 : std::min( w, halfsize+1 );
+        int  nen      = ne*nc;
 
-    void filter_ver( const float* im, const int& w, const int& h, const float* kernel, const int& ksize,
-                     float* out ) {
-        passert_statement( h+ksize < MAX_IMAGE_DIM, "h+ksize is larger than max buffer size" );
+        size_t n_scratch = sw + size_t(ksize)*lsz + ( in_place ? size_t(n_hrows)*hsn : 0 )
+            + 2*size_t(n_hrows)*nen;
+        float* zeros   = thread_scratch_f( 0, n_scratch );
+        float* ring    = zeros + sw;
+        float* colhalo = ring  + size_t(ksize)*lsz;
+        float* edges   = colhalo + ( in_place ? size_t(n_hrows)*hsn : 0 );
+        memset( zeros, 0, sizeof(*zeros)*sw );
 
-        float buffer0[MAX_IMAGE_DIM], buffer1[MAX_IMAGE_DIM], buffer2[MAX_IMAGE_DIM], buffer3[MAX_IMAGE_DIM];
-        float buffer4[MAX_IMAGE_DIM], buffer5[MAX_IMAGE_DIM], buffer6[MAX_IMAGE_DIM], buffer7[MAX_IMAGE_DIM];
+        vector<const float*> rows( ksize );
+        for( int x0=0; x0<rl; x0+=sw ) {
+            int n  = std::min( sw, rl-x0 );
+            int x1 = x0 + n;
+            int next = r0 - halfsize;
+            for( int r=r0; r<r1; r++ ) {
+                for( ; next<=r+halfsize; next++ ) {
+                    const float* src = NULL;
+                    if( next < 0 || next >= h ) {
+                        if( !brows ) continue;
+                        src = brows + size_t( next < 0 ? next+halfsize : next-h+halfsize )*rl;
+                    }
+                    else if( in_place && next <  r0 ) src = halo + size_t(next-r0+halfsize)*rl;
+                    else if( in_place && next >= r1 ) src = halo + size_t(next-r1+halfsize)*rl;
+                    else                              src = im   + next*is;
 
-        int halfsize = ksize / 2;
-        int i, c, r;
-
-        MemoryMode opmode = get_alignment(kernel);
-
-        const float* imp;
-        for( c=0; c<w-8; c+=8 ) {
-            imp=im+c;
-            memset( buffer0, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer1, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer2, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer3, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer4, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer5, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer6, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer7, 0, sizeof(*buffer0)*halfsize );
-
-            for( i=0; i<h; i++ ) {
-                imp = im+i*w+c;
-                buffer0[halfsize+i] = imp[0];
-                buffer1[halfsize+i] = imp[1];
-                buffer2[halfsize+i] = imp[2];
-                buffer3[halfsize+i] = imp[3];
-                buffer4[halfsize+i] = imp[4];
-                buffer5[halfsize+i] = imp[5];
-                buffer6[halfsize+i] = imp[6];
-                buffer7[halfsize+i] = imp[7];
+                    // line covers the input samples [x0-hsn, x1+hsn)
+                    int    hr   = next - r0 + halfsize;
+                    float* line = ring + size_t(hr%ksize)*lsz;
+                    int xs = std::max( 0,  x0-hsn );
+                    int xe = std::min( rl, x1+hsn );
+                    memset( line, 0, sizeof(*line)*(xs-x0+hsn) );
+                    memcpy( line+xs-x0+hsn, src+xs, sizeof(*src)*(xe-xs) );
+                    memset( line+xe-x0+hsn, 0, sizeof(*line)*(x1+hsn-xe) );
+                    if( in_place ) {
+                        float* chalo = colhalo + size_t(hr)*hsn;
+                        if( x0 > 0 )
+                            memcpy( line+xs-x0+hsn, chalo+xs-x0+hsn, sizeof(*line)*(x0-xs) );
+                        if( x1 < rl )
+                            memcpy( chalo, src+x1-hsn, sizeof(*src)*hsn );
+                    }
+                    if( ne ) {
+                        float* edge = edges + 2*size_t(hr)*nen;
+                        if( x0 == 0 ) {
+                            memcpy( edge,     src,       sizeof(*src)*nen );
+                            memcpy( edge+nen, src+rl-nen, sizeof(*src)*nen );
+                        }
+                        // border pixels map into the first or last ne pixels
+                        for( int x=x0-hsn; x<0; x++ ) {
+                            int c = (x+hsn) % nc;
+                            int m = border_index( (x+hsn)/nc-halfsize, w, border );
+                            line[x-x0+hsn] = m < ne ? edge[m*nc+c] : edge[(ne+m-(w-ne))*nc+c];
+                        }
+                        for( int x=std::max(rl,x0-hsn); x<x1+hsn; x++ ) {
+                            int c = x % nc;
+                            int m = border_index( x/nc, w, border );
+                            line[x-x0+hsn] = m < ne ? edge[m*nc+c] : edge[(ne+m-(w-ne))*nc+c];
+                        }
+                    }
+                    filter_buffer( line, n, nc, kernel, ksize );
+                }
+                for( int j=0; j<ksize; j++ ) {
+                    int rr = r - halfsize + j;
+                    if( !brows && ( rr < 0 || rr >= h ) ) rows[j] = zeros;
+                    else                                  rows[j] = ring + size_t((rr-r0+halfsize)%ksize)*lsz;
+                }
+                filter_rows( &rows[0], n, kernel, ksize, out+r*os+x0 );
             }
+        }
+    }
 
-            memset( buffer0+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer1+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer2+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer3+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer4+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer5+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer6+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            memset( buffer7+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-
-            filter_buffer( buffer0, h, kernel, ksize, opmode );
-            filter_buffer( buffer1, h, kernel, ksize, opmode );
-            filter_buffer( buffer2, h, kernel, ksize, opmode );
-            filter_buffer( buffer3, h, kernel, ksize, opmode );
-            filter_buffer( buffer4, h, kernel, ksize, opmode );
-            filter_buffer( buffer5, h, kernel, ksize, opmode );
-            filter_buffer( buffer6, h, kernel, ksize, opmode );
-            filter_buffer( buffer7, h, kernel, ksize, opmode );
-
-            for( r=0; r<h; r++ ) {
-                out[r*w+c  ] = buffer0[r];
-                out[r*w+c+1] = buffer1[r];
-                out[r*w+c+2] = buffer2[r];
-                out[r*w+c+3] = buffer3[r];
-                out[r*w+c+4] = buffer4[r];
-                out[r*w+c+5] = buffer5[r];
-                out[r*w+c+6] = buffer6[r];
-                out[r*w+c+7] = buffer7[r];
-            }
+    void filter_hv( const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize,
+                    float* out, const BorderMode& border, const int& istride, const int& ostride ) {
+        size_t is = istride ? istride : w*nc;
+        size_t os = ostride ? ostride : w*nc;
+        passert_statement( im != out || is == os, "in-place filtering needs equal strides" );
+        const float* brows = filter_border_rows( im, w*nc, is, h, ksize/2, border );
+        filter_hv_band( im, is, w, h, nc, kernel, ksize, out, os, 0, h, NULL, brows, border );
+    }
+
+    void filter_hv_par(const float* im, const int& w, const int& h, const int& nc, const float* kernel, const int& ksize,
+                       float* out, const BorderMode& border, const int& istride, const int& ostride) {
+        int    rl      = w*nc;
+        size_t is      = istride ? istride : rl;
+        size_t os      = ostride ? ostride : rl;
+        int    band    = filter_band_height( ksize );
+        int    n_bands = (h+band-1) / band;
+        size_t halo_sz = 2*size_t(ksize/2)*rl;
+        float* halo    = NULL;
+        passert_statement( im != out || is == os, "in-place filtering needs equal strides" );
+        if( im == out )
+            halo = filter_save_band_halos( im, rl, is, h, ksize/2, band, n_bands );
+        const float* brows = filter_border_rows( im, rl, is, h, ksize/2, border );
+
+#pragma omp parallel for
+        for( int b=0; b<n_bands; b++ ) {
+            int r0 = b*band;
+            int r1 = std::min( h, r0+band );
+            filter_hv_band( im, is, w, h, nc, kernel, ksize, out, os, r0, r1, halo ? halo+b*halo_sz : NULL, brows, border );
         }
-        for(; c<w; c++ ) {
-            memset( buffer0, 0, sizeof(*buffer0)*halfsize );
-            for( i=0; i<h; i++ ) buffer0[halfsize+i  ] = im[i*w+c ];
-            memset( buffer0+halfsize+h, 0, sizeof(*buffer0)*halfsize );
-            filter_buffer(buffer0, h, kernel, ksize, get_alignment(kernel) );
-            for( r=0; r<h; r++ ) out[r*w+c] = buffer0[r];
+    }
+
+
+    //
+    // recursive gaussian
+    //
+
+    /// coefficients of deriche's 4th order recursive gaussian - "recursively
+    /// implementing the gaussian and its derivatives", inria rr-1893 (1993).
+    /// the impulse response is split into a causal and an anti-causal part
+    /// that run independently over the input and are summed. each part is a
+    /// sum of two second order sections, one per complex pole pair - the
+    /// direct 4th order form loses too much precision in float for large
+    /// sigma, where the poles approach the unit circle.
+    ///   causal      : y[i] = a0 x[i]   + a1 x[i-1] - b1 y[i-1] - b2 y[i-2]
+    ///   anti-causal : y[i] = m1 x[i+1] + m2 x[i+2] - b1 y[i+1] - b2 y[i+2]
+    struct GaussianIIR {
+        float a0[2], a1[2], m1[2], m2[2], b1[2], b2[2];
+        // steady state outputs of the sections for a unit input
+        float causal_gain[2], anticausal_gain[2];
+    };
+
+    GaussianIIR gaussian_iir_coefficients( const float& sigma ) {
+        passert_statement( sigma >= 0.5f, "recursive gaussian requires sigma >= 0.5" );
+        typedef std::complex<double> cdouble;
+
+        // h(x) = sum_k ( a_k cos(w_k x/s) + b_k sin(w_k x/s) ) exp(-l_k x/s), x>=0
+        const double a[2] = { 1.680, -0.6803 };
+        const double b[2] = { 3.735, -0.2598 };
+        const double l[2] = { 1.783,  1.723  };
+        const double w[2] = { 0.6318, 1.997  };
+
+        // section k: h+(i) = 2 re( r z^i ) with pole z, residue r
+        double a0[2], a1[2], m1[2], m2[2], b1[2], b2[2], gain = 0.0;
+        for( int k=0; k<2; k++ ) {
+            cdouble z = std::exp( cdouble( -l[k], w[k] ) / double(sigma) );
+            cdouble r = cdouble( a[k], -b[k] ) / 2.0;
+            b1[k] = -2.0*z.real();
+            b2[k] = std::norm( z );
+            a0[k] =  2.0*r.real();
+            a1[k] = -2.0*( r*std::conj(z) ).real();
+            // h-(i) = h+(-i) for i<0 - the tap at 0 belongs to the causal part
+            m1[k] = a1[k] - a0[k]*b1[k];
+            m2[k] = -a0[k]*b2[k];
+            gain += ( a0[k] + a1[k] + m1[k] + m2[k] ) / ( 1.0 + b1[k] + b2[k] );
         }
+
+        // normalize to unit dc gain
+        GaussianIIR c;
+        for( int k=0; k<2; k++ ) {
+            c.a0[k] = float( a0[k]/gain );
+            c.a1[k] = float( a1[k]/gain );
+            c.m1[k] = float( m1[k]/gain );
+            c.m2[k] = float( m2[k]/gain );
+            c.b1[k] = float( b1[k] );
+            c.b2[k] = float( b2[k] );
+            c.causal_gain    [k] = float( (a0[k]+a1[k]) / gain / (1.0+b1[k]+b2[k]) );
+            c.anticausal_gain[k] = float( (m1[k]+m2[k]) / gain / (1.0+b1[k]+b2[k]) );
+        }
+        return c;
     }
 
-    void filter_ver_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize,
-                        float* out ) {
-        passert_statement( h+ksize < MAX_IMAGE_DIM, "h+ksize is larger than max buffer size" );
-        int halfsize = ksize / 2;
-        MemoryMode opmode = get_alignment(kernel);
-#pragma omp parallel for
-        for( int c=0; c<w; c++ ) {
-            float buffer[MAX_IMAGE_DIM];
-            const float* imp = im+c;
-            int i, r;
-            memset( buffer,            0, sizeof(*buffer)*halfsize );
-            for( i=0; i<h; i++ ) {
-                imp = im+i*w+c;
-                buffer[halfsize+i] = imp[0];
-            }
-            memset( buffer+h+halfsize, 0, sizeof(*buffer)*halfsize );
-            filter_buffer( buffer, h, kernel, ksize, opmode );
-            for( r=0; r<h; r++ ) {
-                out[r*w+c  ] = buffer[r];
+    /// number of padding samples the recursions run through beyond the image
+    /// border - the same support the fir kernel of filter_size(sigma) has.
+    int gaussian_iir_padding( const float& sigma ) {
+        return int( 4.0f*sigma + 1.0f );
+    }
+
+    /// one causal step for every lane. st holds the last input and the last
+    /// two outputs of both sections: [x1 | x2 | p1 | p2 | q1 | q2], nl floats
+    /// each. the sum of the sections is written to out if it is not NULL.
+    inline void gaussian_iir_causal_step( const float* x, float* st, const int& nl,
+                                          const GaussianIIR& c, float* out ) {
+        float *x1=st, *p1=st+2*nl, *p2=st+3*nl, *q1=st+4*nl, *q2=st+5*nl;
+        int l=0;
+#ifdef WITH_SSE
+        const __m128 pa0=_mm_set1_ps(c.a0[0]), pa1=_mm_set1_ps(c.a1[0]);
+        const __m128 pb1=_mm_set1_ps(c.b1[0]), pb2=_mm_set1_ps(c.b2[0]);
+        const __m128 qa0=_mm_set1_ps(c.a0[1]), qa1=_mm_set1_ps(c.a1[1]);
+        const __m128 qb1=_mm_set1_ps(c.b1[1]), qb2=_mm_set1_ps(c.b2[1]);
+        for( ; l+4<=nl; l+=4 ) {
+            __m128 xv  = _mm_loadu_ps( x +l );
+            __m128 x1v = _mm_loadu_ps( x1+l );
+            __m128 p1v = _mm_loadu_ps( p1+l );
+            __m128 q1v = _mm_loadu_ps( q1+l );
+            __m128 pv  = _mm_add_ps( _mm_mul_ps(pa0,xv), _mm_mul_ps(pa1,x1v) );
+            __m128 qv  = _mm_add_ps( _mm_mul_ps(qa0,xv), _mm_mul_ps(qa1,x1v) );
+            pv = _mm_sub_ps( pv, _mm_add_ps( _mm_mul_ps(pb1,p1v), _mm_mul_ps(pb2,_mm_loadu_ps(p2+l)) ) );
+            qv = _mm_sub_ps( qv, _mm_add_ps( _mm_mul_ps(qb1,q1v), _mm_mul_ps(qb2,_mm_loadu_ps(q2+l)) ) );
+            _mm_storeu_ps( x1+l, xv  );
+            _mm_storeu_ps( p2+l, p1v );
+            _mm_storeu_ps( p1+l, pv  );
+            _mm_storeu_ps( q2+l, q1v );
+            _mm_storeu_ps( q1+l, qv  );
+            if( out ) _mm_storeu_ps( out+l, _mm_add_ps(pv,qv) );
+        }
+#endif
+        for( ; l<nl; l++ ) {
+            float pv = c.a0[0]*x[l] + c.a1[0]*x1[l] - ( c.b1[0]*p1[l] + c.b2[0]*p2[l] );
+            float qv = c.a0[1]*x[l] + c.a1[1]*x1[l] - ( c.b1[1]*q1[l] + c.b2[1]*q2[l] );
+            x1[l] = x[l];
+            p2[l] = p1[l]; p1[l] = pv;
+            q2[l] = q1[l]; q1[l] = qv;
+            if( out ) out[l] = pv + qv;
+        }
+    }
+
+    /// one anti-causal step for every lane, see gaussian_iir_causal_step.
+    /// when out is not NULL it receives yc plus the sum of the sections.
+    inline void gaussian_iir_anticausal_step( const float* x, float* st, const int& nl,
+                                              const GaussianIIR& c, const float* yc, float* out ) {
+        float *x1=st, *x2=st+nl, *p1=st+2*nl, *p2=st+3*nl, *q1=st+4*nl, *q2=st+5*nl;
+        int l=0;
+#ifdef WITH_SSE
+        const __m128 pm1=_mm_set1_ps(c.m1[0]), pm2=_mm_set1_ps(c.m2[0]);
+        const __m128 pb1=_mm_set1_ps(c.b1[0]), pb2=_mm_set1_ps(c.b2[0]);
+        const __m128 qm1=_mm_set1_ps(c.m1[1]), qm2=_mm_set1_ps(c.m2[1]);
+        const __m128 qb1=_mm_set1_ps(c.b1[1]), qb2=_mm_set1_ps(c.b2[1]);
+        for( ; l+4<=nl; l+=4 ) {
+            __m128 x1v = _mm_loadu_ps( x1+l );
+            __m128 x2v = _mm_loadu_ps( x2+l );
+            __m128 p1v = _mm_loadu_ps( p1+l );
+            __m128 q1v = _mm_loadu_ps( q1+l );
+            __m128 pv  = _mm_add_ps( _mm_mul_ps(pm1,x1v), _mm_mul_ps(pm2,x2v) );
+            __m128 qv  = _mm_add_ps( _mm_mul_ps(qm1,x1v), _mm_mul_ps(qm2,x2v) );
+            pv = _mm_sub_ps( pv, _mm_add_ps( _mm_mul_ps(pb1,p1v), _mm_mul_ps(pb2,_mm_loadu_ps(p2+l)) ) );
+            qv = _mm_sub_ps( qv, _mm_add_ps( _mm_mul_ps(qb1,q1v), _mm_mul_ps(qb2,_mm_loadu_ps(q2+l)) ) );
+            _mm_storeu_ps( x2+l, x1v );
+            _mm_storeu_ps( x1+l, _mm_loadu_ps(x+l) );
+            _mm_storeu_ps( p2+l, p1v );
+            _mm_storeu_ps( p1+l, pv  );
+            _mm_storeu_ps( q2+l, q1v );
+            _mm_storeu_ps( q1+l, qv  );
+            if( out ) _mm_storeu_ps( out+l, _mm_add_ps( _mm_loadu_ps(yc+l), _mm_add_ps(pv,qv) ) );
+        }
+#endif
+        for( ; l<nl; l++ ) {
+            float pv = c.m1[0]*x1[l] + c.m2[0]*x2[l] - ( c.b1[0]*p1[l] + c.b2[0]*p2[l] );
+            float qv = c.m1[1]*x1[l] + c.m2[1]*x2[l] - ( c.b1[1]*q1[l] + c.b2[1]*q2[l] );
+            x2[l] = x1[l]; x1[l] = x[l];
+            p2[l] = p1[l]; p1[l] = pv;
+            q2[l] = q1[l]; q1[l] = qv;
+            if( out ) out[l] = yc[l] + pv + qv;
+        }
+    }
+
+    /// runs the causal and the anti-causal recursions over n samples of lanes
+    /// independent signals, in-place: sample i of signal l is
+    /// data[i*stride+l]. pre and post hold npad padding samples (stride lanes)
+    /// preceding and following the data. both recursions start from the
+    /// steady state of their first padding sample, so a constant padding is
+    /// handled exactly. tmp needs n*lanes floats, state 6*lanes floats.
+    void gaussian_iir_lanes( float* data, const int& n, const size_t& stride, const int& lanes,
+                             const float* pre, const float* post, const int& npad,
+                             const GaussianIIR& c, float* tmp, float* state ) {
+        const int nl = lanes;
+
+        // causal pass into tmp
+        const float* first = npad ? pre : data;
+        for( int l=0; l<nl; l++ ) {
+            state[     l] = state[  nl+l] = first[l];
+            state[2*nl+l] = state[3*nl+l] = first[l]*c.causal_gain[0];
+            state[4*nl+l] = state[5*nl+l] = first[l]*c.causal_gain[1];
+        }
+        for( int i=0; i<npad; i++ )
+            gaussian_iir_causal_step( pre+size_t(i)*nl, state, nl, c, NULL );
+        for( int i=0; i<n; i++ )
+            gaussian_iir_causal_step( data+i*stride, state, nl, c, tmp+size_t(i)*nl );
+
+        // anti-causal pass, summed with the causal result back into data
+        const float* last = npad ? post+size_t(npad-1)*nl : data+(n-1)*stride;
+        for( int l=0; l<nl; l++ ) {
+            state[     l] = state[  nl+l] = last[l];
+            state[2*nl+l] = state[3*nl+l] = last[l]*c.anticausal_gain[0];
+            state[4*nl+l] = state[5*nl+l] = last[l]*c.anticausal_gain[1];
+        }
+        for( int i=npad-1; i>=0; i-- )
+            gaussian_iir_anticausal_step( post+size_t(i)*nl, state, nl, c, NULL, NULL );
+        for( int i=n-1; i>=0; i-- ) {
+            float* y = data+i*stride;
+            gaussian_iir_anticausal_step( y, state, nl, c, tmp+size_t(i)*nl, y );
+        }
+    }
+
+    /// rows interleaved per horizontal recursion and columns per vertical one
+    const int GAUSSIAN_IIR_ROWS    = 32;
+    const int GAUSSIAN_IIR_COLUMNS = 64;
+
+    /// dst[c*dstride+r] = src[r*sstride+c] for r<nr, c<nc
+    void transpose_block( const float* src, const size_t& sstride, const int& nr, const int& nc,
+                          float* dst, const size_t& dstride ) {
+        int r=0;
+#ifdef WITH_SSE
+        for( ; r+4<=nr; r+=4 ) {
+            const float* s0 = src + r*sstride;
+            int c=0;
+            for( ; c+4<=nc; c+=4 ) {
+                __m128 v0 = _mm_loadu_ps( s0          +c );
+                __m128 v1 = _mm_loadu_ps( s0+  sstride+c );
+                __m128 v2 = _mm_loadu_ps( s0+2*sstride+c );
+                __m128 v3 = _mm_loadu_ps( s0+3*sstride+c );
+                _MM_TRANSPOSE4_PS( v0, v1, v2, v3 );
+                float* d = dst + c*dstride + r;
+                _mm_storeu_ps( d,           v0 );
+                _mm_storeu_ps( d+  dstride, v1 );
+                _mm_storeu_ps( d+2*dstride, v2 );
+                _mm_storeu_ps( d+3*dstride, v3 );
             }
+            for( ; c<nc; c++ )
+                for( int k=0; k<4; k++ )
+                    dst[c*dstride+r+k] = s0[k*sstride+c];
+        }
+#endif
+        for( ; r<nr; r++ )
+            for( int c=0; c<nc; c++ )
+                dst[c*dstride+r] = src[r*sstride+c];
+    }
+
+    /// horizontal recursion over the rows [r0,r0+nr) of nc interleaved
+    /// channels: the rows are interleaved into a padded buffer so that the
+    /// recursion runs across the rows and the channels, nr*nc lanes at once.
+    void gaussian_iir_hor_rows( const float* im, const size_t& is, const int& w, const int& nc, const int& r0, const int& nr,
+                                const GaussianIIR& c, const int& npad, const BorderMode& border, float* out, const size_t& os ) {
+        int    rl  = w*nc;
+        int    nl  = nr*nc;
+        int    n   = w + 2*npad;
+        float* buf = thread_scratch_f( 0, size_t(n+w)*nl + 6*nl );
+        float* tmp = buf + size_t(n)*nl;
+        float* st  = tmp + size_t(w)*nl;
+        transpose_block( im+r0*is, is, nr, rl, buf+size_t(npad)*nl, nr );
+        for( int i=0; i<npad; i++ ) {
+            int ml = border_index( i-npad, w, border );
+            int mr = border_index( w+i,    w, border );
+            float* pl = buf + size_t(i       )*nl;
+            float* pr = buf + size_t(npad+w+i)*nl;
+            if( ml < 0 ) memset( pl, 0, sizeof(*pl)*nl );
+            else         memcpy( pl, buf+size_t(npad+ml)*nl, sizeof(*pl)*nl );
+            if( mr < 0 ) memset( pr, 0, sizeof(*pr)*nl );
+            else         memcpy( pr, buf+size_t(npad+mr)*nl, sizeof(*pr)*nl );
         }
+        gaussian_iir_lanes( buf+size_t(npad)*nl, w, nl, nl, buf, buf+size_t(npad+w)*nl, npad, c, tmp, st );
+        transpose_block( buf+size_t(npad)*nl, nr, rl, nr, out+r0*os, os );
     }
 
-    void filter_hv( const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out ) {
-        filter_hor(im, w,h,kernel,ksize,out);
-        filter_ver(out,w,h,kernel,ksize,out);
+    /// vertical recursion over the sample columns [x0,x0+ncols) of rows w
+    /// samples apart - runs on the image rows directly.
+    void gaussian_iir_ver_columns( float* out, const size_t& w, const int& h, const int& x0, const int& ncols,
+                                   const GaussianIIR& c, const int& npad, const BorderMode& border ) {
+        float* pad = thread_scratch_f( 0, (2*size_t(npad)+h)*ncols + 6*ncols );
+        float* tmp = pad + 2*size_t(npad)*ncols;
+        float* st  = tmp + size_t(h)*ncols;
+        for( int i=0; i<npad; i++ ) {
+            int mt = border_index( i-npad, h, border );
+            int mb = border_index( h+i,    h, border );
+            float* pt = pad + size_t(i     )*ncols;
+            float* pb = pad + size_t(npad+i)*ncols;
+            if( mt < 0 ) memset( pt, 0, sizeof(*pt)*ncols );
+            else         memcpy( pt, out+mt*w+x0, sizeof(*pt)*ncols );
+            if( mb < 0 ) memset( pb, 0, sizeof(*pb)*ncols );
+            else         memcpy( pb, out+mb*w+x0, sizeof(*pb)*ncols );
+        }
+        gaussian_iir_lanes( out+x0, h, w, ncols, pad, pad+size_t(npad)*ncols, npad, c, tmp, st );
     }
 
-    void filter_hv_par(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out) {
-        filter_hor_par(im, w,h,kernel,ksize,out);
-        filter_ver_par(out,w,h,kernel,ksize,out);
+    void filter_gaussian_iir( const float* im, const int& w, const int& h, const int& nc, const float& sigma,
+                              float* out, const BorderMode& border, const int& istride, const int& ostride ) {
+        GaussianIIR c    = gaussian_iir_coefficients( sigma );
+        int         npad = gaussian_iir_padding( sigma );
+        int         rl   = w*nc;
+        size_t      is   = istride ? istride : rl;
+        size_t      os   = ostride ? ostride : rl;
+        passert_statement( im != out || is == os, "in-place filtering needs equal strides" );
+        for( int r=0; r<h; r+=GAUSSIAN_IIR_ROWS )
+            gaussian_iir_hor_rows( im, is, w, nc, r, std::min(GAUSSIAN_IIR_ROWS, h-r), c, npad, border, out, os );
+        for( int x=0; x<rl; x+=GAUSSIAN_IIR_COLUMNS )
+            gaussian_iir_ver_columns( out, os, h, x, std::min(GAUSSIAN_IIR_COLUMNS, rl-x), c, npad, border );
     }
 
+    void filter_gaussian_iir_par( const float* im, const int& w, const int& h, const int& nc, const float& sigma,
+                                  float* out, const BorderMode& border, const int& istride, const int& ostride ) {
+        GaussianIIR c    = gaussian_iir_coefficients( sigma );
+        int         npad = gaussian_iir_padding( sigma );
+        int         rl   = w*nc;
+        size_t      is   = istride ? istride : rl;
+        size_t      os   = ostride ? ostride : rl;
+        passert_statement( im != out || is == os, "in-place filtering needs equal strides" );
+#pragma omp parallel for
+        for( int r=0; r<h; r+=GAUSSIAN_IIR_ROWS )
+            gaussian_iir_hor_rows( im, is, w, nc, r, std::min(GAUSSIAN_IIR_ROWS, h-r), c, npad, border, out, os );
+#pragma omp parallel for
+        for( int x=0; x<rl; x+=GAUSSIAN_IIR_COLUMNS )
+            gaussian_iir_ver_columns( out, os, h, x, std::min(GAUSSIAN_IIR_COLUMNS, rl-x), c, npad, border );
+    }
 
 }
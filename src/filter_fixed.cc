@@ -0,0 +1,563 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/filter_fixed.h>
+#include <kortex/filter.h>
+#include <kortex/mem_unit.h>
+#include <kortex/check.h>
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+#ifdef KORTEX_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+using std::vector;
+
+namespace kortex {
+
+    void filter_fixed_kernel( const float* kernel, const int& ksize, int16_t* qkernel ) {
+        assert_pointer( kernel && qkernel );
+        passert_pointer_size( ksize );
+        const float scale = float( 1<<FILTER_FIXED_BITS );
+        double sum = 0.0;
+        int    qsum = 0, jmax = 0;
+        for( int j=0; j<ksize; j++ ) {
+            passert_statement( std::fabs(kernel[j]) < 2.0f, "kernel tap does not fit the fixed point format" );
+            int q = int( std::floor( kernel[j]*scale + 0.5f ) );
+            qkernel[j] = int16_t( std::min( 32767, std::max( -32767, q ) ) );
+            qsum += qkernel[j];
+            sum  += kernel[j];
+            if( std::fabs(kernel[j]) > std::fabs(kernel[jmax]) ) jmax = j;
+        }
+        int target = int( std::floor( sum*scale + 0.5 ) );
+        int q      = qkernel[jmax] + target - qsum;
+        qkernel[jmax] = int16_t( std::min( 32767, std::max( -32767, q ) ) );
+    }
+
+    /// one stage of a fixed point filter: out = ( sum qk[j]*in[j] + rnd ) >> shift.
+    /// pairs holds the taps (2p,2p+1) packed for pmaddwd, the last one with
+    /// a zero high half for odd ksize.
+    struct FixedStage {
+        const int16_t* qk;
+        const int*     pairs;
+        int            ksize;
+        int            shift;
+        int            rnd;
+    };
+
+    inline int16_t saturate_s16( const int& v ) {
+        return int16_t( std::min( 32767, std::max( -32768, v ) ) );
+    }
+
+    //
+    // line kernels: out[x] = sum_j qk[j]*line[x+j*nc] over n samples, the
+    // taps nc samples apart. row kernels: out[x] = sum_j qk[j]*rows[j][x].
+    // the simd versions interleave two taps' samples and multiply them with
+    // a tap pair in one pmaddwd. all integer, so every variant gives the same
+    // result.
+    //
+
+    void fixed_line_basic( const int16_t* line, const int& n, const int& nc, const FixedStage& st, int16_t* out ) {
+        for( int x=0; x<n; x++ ) {
+            int acc = st.rnd;
+            for( int j=0; j<st.ksize; j++ )
+                acc += st.qk[j] * line[x+j*nc];
+            out[x] = saturate_s16( acc >> st.shift );
+        }
+    }
+
+    void fixed_rows_basic( const int16_t* const* rows, const int& n, const FixedStage& st, int16_t* out ) {
+        for( int x=0; x<n; x++ ) {
+            int acc = st.rnd;
+            for( int j=0; j<st.ksize; j++ )
+                acc += st.qk[j] * rows[j][x];
+            out[x] = saturate_s16( acc >> st.shift );
+        }
+    }
+
+    /// both taps of a pmaddwd pair in every 32 bit lane
+    inline int fixed_tap_pair( const int16_t& k0, const int16_t& k1 ) {
+        return int( uint32_t(uint16_t(k0)) | ( uint32_t(uint16_t(k1)) << 16 ) );
+    }
+
+#ifdef WITH_SSE
+    /// sums the pairs of taps of two 8 sample blocks, p0/p1 point to the
+    /// first and second sample of pair 0 and advance by step per pair.
+    inline void fixed_acc_sse( const FixedStage& st, const int16_t* const* p0, const int16_t* const* p1,
+                               const int& x, __m128i* acc, const bool& two ) {
+        const int np = st.ksize/2;
+        for( int p=0; p<np; p++ ) {
+            __m128i k  = _mm_set1_epi32( st.pairs[p] );
+            __m128i a0 = _mm_loadu_si128( (const __m128i*)(p0[p]+x) );
+            __m128i b0 = _mm_loadu_si128( (const __m128i*)(p1[p]+x) );
+            acc[0] = _mm_add_epi32( acc[0], _mm_madd_epi16( _mm_unpacklo_epi16(a0,b0), k ) );
+            acc[1] = _mm_add_epi32( acc[1], _mm_madd_epi16( _mm_unpackhi_epi16(a0,b0), k ) );
+            if( !two ) continue;
+            __m128i a1 = _mm_loadu_si128( (const __m128i*)(p0[p]+x+8) );
+            __m128i b1 = _mm_loadu_si128( (const __m128i*)(p1[p]+x+8) );
+            acc[2] = _mm_add_epi32( acc[2], _mm_madd_epi16( _mm_unpacklo_epi16(a1,b1), k ) );
+            acc[3] = _mm_add_epi32( acc[3], _mm_madd_epi16( _mm_unpackhi_epi16(a1,b1), k ) );
+        }
+        if( st.ksize%2 ) {
+            __m128i k  = _mm_set1_epi32( st.pairs[np] );
+            __m128i a0 = _mm_loadu_si128( (const __m128i*)(p0[np]+x) );
+            acc[0] = _mm_add_epi32( acc[0], _mm_madd_epi16( _mm_unpacklo_epi16(a0,a0), k ) );
+            acc[1] = _mm_add_epi32( acc[1], _mm_madd_epi16( _mm_unpackhi_epi16(a0,a0), k ) );
+            if( !two ) return;
+            __m128i a1 = _mm_loadu_si128( (const __m128i*)(p0[np]+x+8) );
+            acc[2] = _mm_add_epi32( acc[2], _mm_madd_epi16( _mm_unpacklo_epi16(a1,a1), k ) );
+            acc[3] = _mm_add_epi32( acc[3], _mm_madd_epi16( _mm_unpackhi_epi16(a1,a1), k ) );
+        }
+    }
+
+    /// p0[p]/p1[p] are the sample arrays of the taps 2p and 2p+1
+    void fixed_pairs_sse( const int16_t* const* p0, const int16_t* const* p1, const int& n,
+                          const FixedStage& st, int16_t* out ) {
+        const int     nn    = n;
+        const __m128i rnd   = _mm_set1_epi32( st.rnd );
+        const __m128i shift = _mm_cvtsi32_si128( st.shift );
+        __m128i acc[4];
+        int x=0;
+        for( ; x+16<=nn; x+=16 ) {
+            acc[0] = acc[1] = acc[2] = acc[3] = rnd;
+            fixed_acc_sse( st, p0, p1, x, acc, true );
+            for( int i=0; i<4; i++ ) acc[i] = _mm_sra_epi32( acc[i], shift );
+            _mm_storeu_si128( (__m128i*)(out+x  ), _mm_packs_epi32( acc[0], acc[1] ) );
+            _mm_storeu_si128( (__m128i*)(out+x+8), _mm_packs_epi32( acc[2], acc[3] ) );
+        }
+        for( ; x+8<=nn; x+=8 ) {
+            acc[0] = acc[1] = rnd;
+            fixed_acc_sse( st, p0, p1, x, acc, false );
+            for( int i=0; i<2; i++ ) acc[i] = _mm_sra_epi32( acc[i], shift );
+            _mm_storeu_si128( (__m128i*)(out+x), _mm_packs_epi32( acc[0], acc[1] ) );
+        }
+        for( ; x<nn; x++ ) {
+            int sum = st.rnd;
+            for( int j=0; j<st.ksize; j++ )
+                sum += st.qk[j] * ( j%2 ? p1[j/2][x] : p0[j/2][x] );
+            out[x] = saturate_s16( sum >> st.shift );
+        }
+    }
+#endif
+
+#ifdef KORTEX_X86_DISPATCH
+    // the 256 bit unpacks and packs both work within 128 bit lanes, so the
+    // samples come out of the pack in order.
+    KORTEX_TARGET_AVX2
+    void fixed_pairs_avx2( const int16_t* const* p0, const int16_t* const* p1, const int& n,
+                           const FixedStage& st, int16_t* out ) {
+        const int     nn    = n;
+        const int     np    = st.ksize/2;
+        const bool    odd   = st.ksize%2;
+        const __m256i rnd   = _mm256_set1_epi32( st.rnd );
+        const __m128i shift = _mm_cvtsi32_si128( st.shift );
+        int x=0;
+        for( ; x+32<=nn; x+=32 ) {
+            __m256i a0 = rnd, a1 = rnd, a2 = rnd, a3 = rnd;
+            for( int p=0; p<np+odd; p++ ) {
+                __m256i k = _mm256_set1_epi32( st.pairs[p] );
+                const int16_t* q1 = p1[p];
+                __m256i u0 = _mm256_loadu_si256( (const __m256i*)(p0[p]+x   ) );
+                __m256i v0 = _mm256_loadu_si256( (const __m256i*)(q1   +x   ) );
+                __m256i u1 = _mm256_loadu_si256( (const __m256i*)(p0[p]+x+16) );
+                __m256i v1 = _mm256_loadu_si256( (const __m256i*)(q1   +x+16) );
+                a0 = _mm256_add_epi32( a0, _mm256_madd_epi16( _mm256_unpacklo_epi16(u0,v0), k ) );
+                a1 = _mm256_add_epi32( a1, _mm256_madd_epi16( _mm256_unpackhi_epi16(u0,v0), k ) );
+                a2 = _mm256_add_epi32( a2, _mm256_madd_epi16( _mm256_unpacklo_epi16(u1,v1), k ) );
+                a3 = _mm256_add_epi32( a3, _mm256_madd_epi16( _mm256_unpackhi_epi16(u1,v1), k ) );
+            }
+            a0 = _mm256_sra_epi32( a0, shift );
+            a1 = _mm256_sra_epi32( a1, shift );
+            a2 = _mm256_sra_epi32( a2, shift );
+            a3 = _mm256_sra_epi32( a3, shift );
+            _mm256_storeu_si256( (__m256i*)(out+x   ), _mm256_packs_epi32( a0, a1 ) );
+            _mm256_storeu_si256( (__m256i*)(out+x+16), _mm256_packs_epi32( a2, a3 ) );
+        }
+        for( ; x+16<=nn; x+=16 ) {
+            __m256i a0 = rnd, a1 = rnd;
+            for( int p=0; p<np+odd; p++ ) {
+                __m256i k = _mm256_set1_epi32( st.pairs[p] );
+                const int16_t* q1 = p1[p];
+                __m256i u0 = _mm256_loadu_si256( (const __m256i*)(p0[p]+x) );
+                __m256i v0 = _mm256_loadu_si256( (const __m256i*)(q1   +x) );
+                a0 = _mm256_add_epi32( a0, _mm256_madd_epi16( _mm256_unpacklo_epi16(u0,v0), k ) );
+                a1 = _mm256_add_epi32( a1, _mm256_madd_epi16( _mm256_unpackhi_epi16(u0,v0), k ) );
+            }
+            a0 = _mm256_sra_epi32( a0, shift );
+            a1 = _mm256_sra_epi32( a1, shift );
+            _mm256_storeu_si256( (__m256i*)(out+x), _mm256_packs_epi32( a0, a1 ) );
+        }
+        for( ; x<nn; x++ ) {
+            int sum = st.rnd;
+            for( int j=0; j<st.ksize; j++ )
+                sum += st.qk[j] * ( j%2 ? p1[j/2][x] : p0[j/2][x] );
+            out[x] = saturate_s16( sum >> st.shift );
+        }
+    }
+#endif
+
+    /// the simd kernels take the sample arrays of the taps split in pairs.
+    /// there is no avx512 variant - the avx2 kernel runs on those hosts.
+    void fixed_pairs( const int16_t* const* taps, const int& n, const FixedStage& st, int16_t* out ) {
+        const int np = (st.ksize+1)/2;
+        const int16_t* p0[256];
+        const int16_t* p1[256];
+        vector<const int16_t*> vp0, vp1;
+        const int16_t** q0 = p0;
+        const int16_t** q1 = p1;
+        if( np > 256 ) {
+            vp0.resize( np ); q0 = &vp0[0];
+            vp1.resize( np ); q1 = &vp1[0];
+        }
+        for( int p=0; p<np; p++ ) {
+            q0[p] = taps[2*p];
+            q1[p] = 2*p+1 < st.ksize ? taps[2*p+1] : taps[2*p];
+        }
+        switch( filter_simd_level() ) {
+#ifdef KORTEX_X86_DISPATCH
+        case SIMD_AVX512:
+        case SIMD_AVX2  : fixed_pairs_avx2( q0, q1, n, st, out ); return;
+#endif
+#ifdef WITH_SSE
+        case SIMD_SSE   : fixed_pairs_sse ( q0, q1, n, st, out ); return;
+#endif
+        default         : fixed_rows_basic( taps, n, st, out ); return;
+        }
+    }
+
+    void fixed_line( const int16_t* line, const int& n, const int& nc, const FixedStage& st, int16_t* out ) {
+        if( filter_simd_level() == SIMD_NONE ) {
+            fixed_line_basic( line, n, nc, st, out );
+            return;
+        }
+        const int16_t*  taps[512];
+        vector<const int16_t*> vtaps;
+        const int16_t** t = taps;
+        if( st.ksize > 512 ) { vtaps.resize( st.ksize ); t = &vtaps[0]; }
+        for( int j=0; j<st.ksize; j++ )
+            t[j] = line + j*nc;
+        fixed_pairs( t, n, st, out );
+    }
+
+    void fixed_rows( const int16_t* const* rows, const int& n, const FixedStage& st, int16_t* out ) {
+        fixed_pairs( rows, n, st, out );
+    }
+
+    /// a separable fixed point filter: an optional horizontal stage (uchar
+    /// samples to 16 bits) followed by an optional vertical stage (16 bits
+    /// to 16 bits). without a horizontal stage the samples enter the vertical
+    /// one shifted left by lshift.
+    struct FixedFilter {
+        bool       hor;
+        bool       ver;
+        FixedStage hs;
+        FixedStage vs;
+        int        lshift;
+        BorderMode border;
+        bool       s16; // int16 output, otherwise saturated to uchar
+        size_t     is;  // samples between input rows
+        size_t     os;  // samples between output rows
+    };
+
+    /// dst[i] = src[i] << ls
+    void fixed_widen( const uchar* src, const int& n, const int& ls, int16_t* dst ) {
+        const int nn = n;
+        int i=0;
+#ifdef WITH_SSE
+        const __m128i zero  = _mm_setzero_si128();
+        const __m128i shift = _mm_cvtsi32_si128( ls );
+        for( ; i+16<=nn; i+=16 ) {
+            __m128i v = _mm_loadu_si128( (const __m128i*)(src+i) );
+            _mm_storeu_si128( (__m128i*)(dst+i  ), _mm_sll_epi16( _mm_unpacklo_epi8(v,zero), shift ) );
+            _mm_storeu_si128( (__m128i*)(dst+i+8), _mm_sll_epi16( _mm_unpackhi_epi8(v,zero), shift ) );
+        }
+#endif
+        for( ; i<nn; i++ )
+            dst[i] = int16_t( src[i] << ls );
+    }
+
+    /// dst[i] = src[i] saturated to [0,255]
+    void fixed_pack_u8( const int16_t* src, const int& n, uchar* dst ) {
+        const int nn = n;
+        int i=0;
+#ifdef WITH_SSE
+        for( ; i+16<=nn; i+=16 ) {
+            __m128i a = _mm_loadu_si128( (const __m128i*)(src+i  ) );
+            __m128i b = _mm_loadu_si128( (const __m128i*)(src+i+8) );
+            _mm_storeu_si128( (__m128i*)(dst+i), _mm_packus_epi16( a, b ) );
+        }
+#endif
+        for( ; i<nn; i++ )
+            dst[i] = uchar( std::min( 255, std::max( 0, int(src[i]) ) ) );
+    }
+
+    /// horizontal stage of a row of w pixels with nc channels into dst. line
+    /// is the padded buffer the samples are widened into.
+    void fixed_hor_stage( const uchar* src, const int& w, const int& nc, const FixedFilter& f,
+                          int16_t* line, int16_t* dst ) {
+        const int n = w*nc;
+        if( !f.hor ) {
+            fixed_widen( src, n, f.lshift, dst );
+            return;
+        }
+        const int hsz = f.hs.ksize/2;
+        const int pad = hsz*nc;
+        int16_t*  mid = line + pad;
+        fixed_widen( src, n, 0, mid );
+        for( int i=0; i<hsz; i++ ) {
+            int ml = border_index( i-hsz, w, f.border );
+            int mr = border_index( w+i,   w, f.border );
+            for( int c=0; c<nc; c++ ) {
+                line[i*nc+c]   = ml < 0 ? 0 : mid[ml*nc+c];
+                mid [n+i*nc+c] = mr < 0 ? 0 : mid[mr*nc+c];
+            }
+        }
+        fixed_line( line, n, nc, f.hs, dst );
+    }
+
+    void fixed_emit( const int16_t* res, const int& n, const bool& s16, void* out ) {
+        if( s16 ) {
+            memcpy( out, res, sizeof(*res)*n );
+            return;
+        }
+        fixed_pack_u8( res, n, (uchar*)out );
+    }
+
+    /// filters the rows [r0,r1) - the vertical stage keeps the horizontal
+    /// results of the last ksize rows in a ring. in-place, a row is written
+    /// only after the rows that read it are filtered horizontally, rows
+    /// outside the band come from halo (halfsize rows above r0, then below r1)
+    /// and rows outside the image from brows, or read as zero if NULL.
+    void filter_fixed_band( const uchar* im, const int& w, const int& h, const int& nc, const FixedFilter& f,
+                            void* out, const int& r0, const int& r1, const uchar* halo, const uchar* brows ) {
+        const int n        = w*nc;
+        const int hsz      = f.hor ? f.hs.ksize/2 : 0;
+        const int vsz      = f.ver ? f.vs.ksize/2 : 0;
+        const int n_ring   = f.ver ? f.vs.ksize : 0;
+        const int osz      = f.s16 ? sizeof(int16_t) : sizeof(uchar);
+        const bool in_place = ( (const void*)im == out );
+
+        size_t   n_scratch = size_t(n+2*hsz*nc) + size_t(n_ring+2)*n;
+        int16_t* line  = (int16_t*)thread_scratch( 0, n_scratch*sizeof(int16_t) );
+        int16_t* ring  = line + n+2*hsz*nc;
+        int16_t* zeros = ring + size_t(n_ring)*n;
+        int16_t* res   = zeros + n;
+
+        if( !f.ver ) {
+            for( int r=r0; r<r1; r++ ) {
+                fixed_hor_stage( im+r*f.is, w, nc, f, line, res );
+                fixed_emit( res, n, f.s16, (uchar*)out+r*f.os*osz );
+            }
+            return;
+        }
+
+        memset( zeros, 0, sizeof(*zeros)*n );
+        vector<const int16_t*> rows( n_ring );
+        int next = r0 - vsz;
+        for( int r=r0; r<r1; r++ ) {
+            for( ; next<=r+vsz; next++ ) {
+                const uchar* src = NULL;
+                if( next < 0 || next >= h ) {
+                    if( !brows ) continue;
+                    src = brows + size_t( next < 0 ? next+vsz : next-h+vsz )*n;
+                }
+                else if( in_place && next <  r0 ) src = halo + size_t(next-r0+vsz)*n;
+                else if( in_place && next >= r1 ) src = halo + size_t(next-r1+vsz)*n;
+                else                              src = im   + next*f.is;
+                fixed_hor_stage( src, w, nc, f, line, ring+size_t((next-r0+vsz)%n_ring)*n );
+            }
+            for( int j=0; j<n_ring; j++ ) {
+                int rr = r - vsz + j;
+                if( !brows && ( rr < 0 || rr >= h ) ) rows[j] = zeros;
+                else                                  rows[j] = ring + size_t((rr-r0+vsz)%n_ring)*n;
+            }
+            fixed_rows( &rows[0], n, f.vs, res );
+            fixed_emit( res, n, f.s16, (uchar*)out+r*f.os*osz );
+        }
+    }
+
+    /// splits the image in row bands for the parallel version. the input rows
+    /// in-place bands need from their neighbours, and the rows the border mode
+    /// extends the image with, are copied before anything is written.
+    void filter_fixed_run( const uchar* im, const int& w, const int& h, const int& nc, const FixedFilter& f,
+                           void* out, const bool& run_parallel ) {
+        assert_pointer( im && out );
+        passert_statement( w > 0 && h > 0 && nc > 0, "invalid image dimensions" );
+        const size_t n   = size_t(w)*nc;
+        const int    vsz = f.ver ? f.vs.ksize/2 : 0;
+        const bool   in_place = ( (const void*)im == out );
+        passert_statement( !in_place || f.is == f.os, "in-place filtering needs equal strides" );
+
+        int band    = run_parallel ? std::max( 64, 8*vsz ) : h;
+        int n_bands = (h+band-1) / band;
+
+        uchar* halo = NULL;
+        size_t halo_sz = 2*size_t(vsz)*n;
+        if( in_place && n_bands > 1 && vsz > 0 ) {
+            halo = thread_scratch( 1, n_bands*halo_sz );
+            for( int b=0; b<n_bands; b++ ) {
+                int r0 = b*band;
+                int r1 = std::min( h, r0+band );
+                uchar* bhalo = halo + b*halo_sz;
+                for( int rr=std::max(0,r0-vsz); rr<r0; rr++ )
+                    memcpy( bhalo+size_t(rr-r0+vsz)*n, im+rr*f.is, n );
+                for( int rr=r1; rr<std::min(h,r1+vsz); rr++ )
+                    memcpy( bhalo+size_t(rr-r1+vsz)*n, im+rr*f.is, n );
+            }
+        }
+        uchar* brows = NULL;
+        if( f.border != BORDER_ZERO && vsz > 0 ) {
+            brows = thread_scratch( 2, 2*size_t(vsz)*n );
+            for( int i=0; i<vsz; i++ ) {
+                memcpy( brows+size_t(i    )*n, im+border_index(i-vsz,h,f.border)*f.is, n );
+                memcpy( brows+size_t(vsz+i)*n, im+border_index(h+i,  h,f.border)*f.is, n );
+            }
+        }
+
+#pragma omp parallel for if( run_parallel )
+        for( int b=0; b<n_bands; b++ ) {
+            int r0 = b*band;
+            int r1 = std::min( h, r0+band );
+            filter_fixed_band( im, w, h, nc, f, out, r0, r1, halo ? halo+b*halo_sz : NULL, brows );
+        }
+    }
+
+    /// quantizes a kernel. with sum(|kernel|) <= 2 the horizontal stage
+    /// stays below 255*2 << FILTER_FIXED_MID_BITS = 32640 and never saturates.
+    void filter_fixed_stage( const float* kernel, const int& ksize, const int& shift, const bool& round,
+                             vector<int16_t>& qk, vector<int>& pairs, FixedStage& st ) {
+        assert_pointer( kernel );
+        passert_pointer_size( ksize );
+        float l1 = 0.0f;
+        for( int j=0; j<ksize; j++ )
+            l1 += std::fabs( kernel[j] );
+        passert_statement( l1 <= 2.001f, "sum of |kernel| should not exceed 2" );
+        qk.resize( ksize );
+        filter_fixed_kernel( kernel, ksize, &qk[0] );
+        pairs.resize( (ksize+1)/2 );
+        for( int p=0; p<(ksize+1)/2; p++ )
+            pairs[p] = fixed_tap_pair( qk[2*p], 2*p+1 < ksize ? qk[2*p+1] : int16_t(0) );
+        st.qk    = &qk[0];
+        st.pairs = &pairs[0];
+        st.ksize = ksize;
+        st.shift = shift;
+        st.rnd   = round && shift > 0 ? 1<<(shift-1) : 0;
+    }
+
+    void filter_u8( const uchar* im, const int& w, const int& h, const int& nc,
+                    const float* kernel, const int& ksize, const bool& hor, const bool& ver, uchar* out,
+                    const BorderMode& border, const FixedRounding& rounding, const bool& run_parallel,
+                    const int& istride, const int& ostride ) {
+        const bool      nearest = ( rounding == FIXED_ROUND_NEAREST );
+        vector<int16_t> qk;
+        vector<int>     pairs;
+        FixedFilter     f;
+        f.hor    = hor;
+        f.ver    = ver;
+        f.lshift = FILTER_FIXED_MID_BITS;
+        f.border = border;
+        f.s16    = false;
+        f.is     = istride ? istride : size_t(w)*nc;
+        f.os     = ostride ? ostride : size_t(w)*nc;
+        if( hor && ver ) {
+            filter_fixed_stage( kernel, ksize, FILTER_FIXED_BITS-FILTER_FIXED_MID_BITS, true, qk, pairs, f.hs );
+            f.vs       = f.hs;
+            f.vs.shift = FILTER_FIXED_BITS+FILTER_FIXED_MID_BITS;
+            f.vs.rnd   = nearest ? 1<<(f.vs.shift-1) : 0;
+        } else if( hor ) {
+            filter_fixed_stage( kernel, ksize, FILTER_FIXED_BITS, nearest, qk, pairs, f.hs );
+        } else {
+            filter_fixed_stage( kernel, ksize, FILTER_FIXED_BITS+FILTER_FIXED_MID_BITS, nearest, qk, pairs, f.vs );
+        }
+        filter_fixed_run( im, w, h, nc, f, out, run_parallel );
+    }
+
+    void filter_hor_u8( const uchar* im, const int& w, const int& h, const int& nc,
+                        const float* kernel, const int& ksize, uchar* out,
+                        const BorderMode& border, const FixedRounding& rounding,
+                        const int& istride, const int& ostride ) {
+        filter_u8( im, w, h, nc, kernel, ksize, true, false, out, border, rounding, false, istride, ostride );
+    }
+    void filter_ver_u8( const uchar* im, const int& w, const int& h, const int& nc,
+                        const float* kernel, const int& ksize, uchar* out,
+                        const BorderMode& border, const FixedRounding& rounding,
+                        const int& istride, const int& ostride ) {
+        filter_u8( im, w, h, nc, kernel, ksize, false, true, out, border, rounding, false, istride, ostride );
+    }
+    void filter_hv_u8( const uchar* im, const int& w, const int& h, const int& nc,
+                       const float* kernel, const int& ksize, uchar* out,
+                       const BorderMode& border, const FixedRounding& rounding,
+                       const int& istride, const int& ostride ) {
+        filter_u8( im, w, h, nc, kernel, ksize, true, true, out, border, rounding, false, istride, ostride );
+    }
+    void filter_hor_u8_par( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* kernel, const int& ksize, uchar* out,
+                            const BorderMode& border, const FixedRounding& rounding,
+                            const int& istride, const int& ostride ) {
+        filter_u8( im, w, h, nc, kernel, ksize, true, false, out, border, rounding, true, istride, ostride );
+    }
+    void filter_ver_u8_par( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* kernel, const int& ksize, uchar* out,
+                            const BorderMode& border, const FixedRounding& rounding,
+                            const int& istride, const int& ostride ) {
+        filter_u8( im, w, h, nc, kernel, ksize, false, true, out, border, rounding, true, istride, ostride );
+    }
+    void filter_hv_u8_par( const uchar* im, const int& w, const int& h, const int& nc,
+                           const float* kernel, const int& ksize, uchar* out,
+                           const BorderMode& border, const FixedRounding& rounding,
+                           const int& istride, const int& ostride ) {
+        filter_u8( im, w, h, nc, kernel, ksize, true, true, out, border, rounding, true, istride, ostride );
+    }
+
+    void filter_s16( const uchar* im, const int& w, const int& h, const int& nc,
+                     const float* hkernel, const int& hksize, const float* vkernel, const int& vksize,
+                     const int& frac_bits, int16_t* out,
+                     const BorderMode& border, const FixedRounding& rounding, const bool& run_parallel ) {
+        passert_statement( frac_bits >= 0 && frac_bits <= 7, "frac_bits should be in [0,7]" );
+        vector<int16_t> hqk, vqk;
+        vector<int>     hpairs, vpairs;
+        FixedFilter     f;
+        f.hor    = true;
+        f.ver    = true;
+        f.lshift = FILTER_FIXED_MID_BITS;
+        f.border = border;
+        f.s16    = true;
+        f.is     = size_t(w)*nc;
+        f.os     = size_t(w)*nc;
+        filter_fixed_stage( hkernel, hksize, FILTER_FIXED_BITS-FILTER_FIXED_MID_BITS, true, hqk, hpairs, f.hs );
+        filter_fixed_stage( vkernel, vksize, FILTER_FIXED_BITS+FILTER_FIXED_MID_BITS-frac_bits,
+                            rounding == FIXED_ROUND_NEAREST, vqk, vpairs, f.vs );
+        filter_fixed_run( im, w, h, nc, f, out, run_parallel );
+    }
+
+    void filter_hv_s16( const uchar* im, const int& w, const int& h, const int& nc,
+                        const float* hkernel, const int& hksize, const float* vkernel, const int& vksize,
+                        const int& frac_bits, int16_t* out,
+                        const BorderMode& border, const FixedRounding& rounding ) {
+        filter_s16( im, w, h, nc, hkernel, hksize, vkernel, vksize, frac_bits, out, border, rounding, false );
+    }
+    void filter_hv_s16_par( const uchar* im, const int& w, const int& h, const int& nc,
+                            const float* hkernel, const int& hksize, const float* vkernel, const int& vksize,
+                            const int& frac_bits, int16_t* out,
+                            const BorderMode& border, const FixedRounding& rounding ) {
+        filter_s16( im, w, h, nc, hkernel, hksize, vkernel, vksize, frac_bits, out, border, rounding, true );
+    }
+
+}
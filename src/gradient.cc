@@ -0,0 +1,256 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/gradient.h>
+#include <kortex/image.h>
+#include <kortex/mem_unit.h>
+#include <kortex/filter.h>
+#include <kortex/check.h>
+
+#include <cmath>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace kortex {
+
+    /// rows of a band - the source rows of a band plus the two halo rows
+    /// are converted to float once
+    const int GRADIENT_BAND_H = 32;
+
+    // abramowitz & stegun 4.4.47 - atan(a) for a in [0,1]
+    const float ATAN_A1 =  0.9998660f;
+    const float ATAN_A3 = -0.3302995f;
+    const float ATAN_A5 =  0.1801410f;
+    const float ATAN_A7 = -0.0851330f;
+    const float ATAN_A9 =  0.0208351f;
+
+    const float GRADIENT_PI   = 3.14159265358979f;
+    const float GRADIENT_PI_2 = 1.57079632679490f;
+    const float GRADIENT_2PI  = 6.28318530717959f;
+
+    float fast_atan2( const float& y, const float& x ) {
+        float ax = std::fabs( x );
+        float ay = std::fabs( y );
+        float mx = std::max( ax, ay );
+        float mn = std::min( ax, ay );
+        float a  = mx > 0.0f ? mn / mx : 0.0f;
+        float s  = a*a;
+        float r  = a*( ATAN_A1 + s*( ATAN_A3 + s*( ATAN_A5 + s*( ATAN_A7 + s*ATAN_A9 ) ) ) );
+        if( ay > ax   ) r = GRADIENT_PI_2 - r;
+        if( x  < 0.0f ) r = GRADIENT_PI   - r;
+        if( y  < 0.0f ) r = GRADIENT_2PI  - r;
+        return r;
+    }
+
+    inline int gradient_bin( const float& r, const float& bscale, const int& n_bins ) {
+        return std::min( int( r*bscale ), n_bins-1 );
+    }
+
+#ifdef WITH_SSE
+    inline __m128 gradient_select( const __m128& m, const __m128& a, const __m128& b ) {
+        return _mm_or_ps( _mm_and_ps( m, a ), _mm_andnot_ps( m, b ) );
+    }
+
+    /// fast_atan2 four at a time - the same operations in the same order
+    inline __m128 fast_atan2_sse( const __m128& y, const __m128& x ) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 sign = _mm_set1_ps( -0.0f );
+        __m128 ax = _mm_andnot_ps( sign, x );
+        __m128 ay = _mm_andnot_ps( sign, y );
+        __m128 mx = _mm_max_ps( ax, ay );
+        __m128 mn = _mm_min_ps( ax, ay );
+        __m128 a  = _mm_and_ps( _mm_div_ps( mn, mx ), _mm_cmpgt_ps( mx, zero ) );
+        __m128 s  = _mm_mul_ps( a, a );
+        __m128 p  = _mm_add_ps( _mm_set1_ps( ATAN_A7 ), _mm_mul_ps( s, _mm_set1_ps( ATAN_A9 ) ) );
+        p = _mm_add_ps( _mm_set1_ps( ATAN_A5 ), _mm_mul_ps( s, p ) );
+        p = _mm_add_ps( _mm_set1_ps( ATAN_A3 ), _mm_mul_ps( s, p ) );
+        p = _mm_add_ps( _mm_set1_ps( ATAN_A1 ), _mm_mul_ps( s, p ) );
+        __m128 r  = _mm_mul_ps( a, p );
+        r = gradient_select( _mm_cmpgt_ps( ay, ax ),   _mm_sub_ps( _mm_set1_ps( GRADIENT_PI_2 ), r ), r );
+        r = gradient_select( _mm_cmplt_ps( x, zero ), _mm_sub_ps( _mm_set1_ps( GRADIENT_PI   ), r ), r );
+        r = gradient_select( _mm_cmplt_ps( y, zero ), _mm_sub_ps( _mm_set1_ps( GRADIENT_2PI  ), r ), r );
+        return r;
+    }
+#endif
+
+    /// gx, gy of pixel x from the padded rows above, at and below it
+    inline void gradient_at( const float* rm, const float* r0, const float* rp, const int& x,
+                             const GradientKernel& kernel, const float& c0, const float& c1,
+                             float& gx, float& gy ) {
+        if( kernel == GRADIENT_SIMPLE ) {
+            gx = r0[x+1] - r0[x-1];
+            gy = rm[x]   - rp[x];
+            return;
+        }
+        float sr = c0*( rm[x+1] + rp[x+1] ) + c1*r0[x+1];
+        float sl = c0*( rm[x-1] + rp[x-1] ) + c1*r0[x-1];
+        gx = 0.5f*( sr - sl );
+        gy = 0.5f*( c0*( ( rp[x-1] - rm[x-1] ) + ( rp[x+1] - rm[x+1] ) ) + c1*( rp[x] - rm[x] ) );
+    }
+
+    /// one output row over [x0,x1) - the outputs that are NULL are skipped
+    void gradient_row( const float* rm, const float* r0, const float* rp, const int& x0, const int& x1,
+                       const GradientKernel& kernel, const float& c0, const float& c1,
+                       const int& n_bins, const bool& sse,
+                       float* gxr, float* gyr, float* mr, uchar* orow ) {
+        const float bscale = n_bins / GRADIENT_2PI;
+        int x = x0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128  half = _mm_set1_ps( 0.5f );
+            const __m128  vc0  = _mm_set1_ps( c0 );
+            const __m128  vc1  = _mm_set1_ps( c1 );
+            const __m128  vbs  = _mm_set1_ps( bscale );
+            const __m128i vmax = _mm_set1_epi32( n_bins-1 );
+            for( ; x+4<=x1; x+=4 ) {
+                __m128 gx, gy;
+                if( kernel == GRADIENT_SIMPLE ) {
+                    gx = _mm_sub_ps( _mm_loadu_ps( r0+x+1 ), _mm_loadu_ps( r0+x-1 ) );
+                    gy = _mm_sub_ps( _mm_loadu_ps( rm+x   ), _mm_loadu_ps( rp+x   ) );
+                } else {
+                    __m128 ml = _mm_loadu_ps( rm+x-1 ), mc = _mm_loadu_ps( rm+x ), mr_ = _mm_loadu_ps( rm+x+1 );
+                    __m128 pl = _mm_loadu_ps( rp+x-1 ), pc = _mm_loadu_ps( rp+x ), pr  = _mm_loadu_ps( rp+x+1 );
+                    __m128 sr = _mm_add_ps( _mm_mul_ps( vc0, _mm_add_ps( mr_, pr ) ), _mm_mul_ps( vc1, _mm_loadu_ps( r0+x+1 ) ) );
+                    __m128 sl = _mm_add_ps( _mm_mul_ps( vc0, _mm_add_ps( ml,  pl ) ), _mm_mul_ps( vc1, _mm_loadu_ps( r0+x-1 ) ) );
+                    gx = _mm_mul_ps( half, _mm_sub_ps( sr, sl ) );
+                    __m128 d = _mm_add_ps( _mm_sub_ps( pl, ml ), _mm_sub_ps( pr, mr_ ) );
+                    gy = _mm_mul_ps( half, _mm_add_ps( _mm_mul_ps( vc0, d ), _mm_mul_ps( vc1, _mm_sub_ps( pc, mc ) ) ) );
+                }
+                if( gxr ) _mm_storeu_ps( gxr+x, gx );
+                if( gyr ) _mm_storeu_ps( gyr+x, gy );
+                if( mr  ) _mm_storeu_ps( mr +x, _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( gx, gx ), _mm_mul_ps( gy, gy ) ) ) );
+                if( orow ) {
+                    __m128i b = _mm_cvttps_epi32( _mm_mul_ps( fast_atan2_sse( gy, gx ), vbs ) );
+                    __m128i g = _mm_cmpgt_epi32( b, vmax );
+                    b = _mm_or_si128( _mm_and_si128( g, vmax ), _mm_andnot_si128( g, b ) );
+                    b = _mm_packus_epi16( _mm_packs_epi32( b, b ), _mm_setzero_si128() );
+                    *(int*)( orow+x ) = _mm_cvtsi128_si32( b );
+                }
+            }
+        }
+#endif
+        for( ; x<x1; x++ ) {
+            float gx, gy;
+            gradient_at( rm, r0, rp, x, kernel, c0, c1, gx, gy );
+            if( gxr  ) gxr[x]  = gx;
+            if( gyr  ) gyr[x]  = gy;
+            if( mr   ) mr [x]  = std::sqrt( gx*gx + gy*gy );
+            if( orow ) orow[x] = uchar( gradient_bin( fast_atan2( gy, gx ), bscale, n_bins ) );
+        }
+    }
+
+    /// row y of the image (rows is apart) into p[-1..w], the out of range
+    /// rows and columns extrapolated linearly: I(-1) = 2 I(0) - I(1). t is
+    /// a spare row.
+    template<typename T>
+    void gradient_load( const T* im, const size_t& is, const int& w, const int& h, const int& y, float* t, float* p ) {
+        if( y < 0 || y >= h ) {
+            int ye = y < 0 ? 0 : h-1;
+            int yi = y < 0 ? std::min( 1, h-1 ) : std::max( 0, h-2 );
+            gradient_load( im, is, w, h, ye, t, p );
+            gradient_load( im, is, w, h, yi, t+w+2, t );
+            for( int x=-1; x<=w; x++ )
+                p[x] = 2.0f*p[x] - t[x];
+            return;
+        }
+        const T* row = im + size_t(y)*is;
+        for( int x=0; x<w; x++ )
+            p[x] = float( row[x] );
+        p[-1] = ( w > 1 ) ? 2.0f*p[0]   - p[1]   : p[0];
+        p[w]  = ( w > 1 ) ? 2.0f*p[w-1] - p[w-2] : p[w-1];
+    }
+
+    /// the outputs are written through their rows - they can be views
+    template<typename T>
+    void gradient_run( const T* im, const size_t& is, const int& w, const int& h, const GradientKernel& kernel,
+                       const int& n_bins, const bool& sse, const bool& run_parallel,
+                       Image* gx, Image* gy, Image* mag, Image* ori ) {
+        float c0 = 0.0f, c1 = 0.0f;
+        switch( kernel ) {
+        case GRADIENT_SIMPLE : break;
+        case GRADIENT_PREWITT: c0 = 1.0f/3.0f; c1 = 1.0f/3.0f; break;
+        case GRADIENT_SOBEL  : c0 = 1.0f/4.0f; c1 = 2.0f/4.0f; break;
+        default: switch_fatality();
+        }
+        const bool zero_border = ( kernel != GRADIENT_SIMPLE );
+        const int  rl = w+2;
+        const int  nb = ( h + GRADIENT_BAND_H - 1 ) / GRADIENT_BAND_H;
+#pragma omp parallel for if( run_parallel )
+        for( int b=0; b<nb; b++ ) {
+            const int y0 = b*GRADIENT_BAND_H;
+            const int y1 = std::min( h, y0+GRADIENT_BAND_H );
+            const int nr = y1-y0+2;
+            // nr band rows and two spare rows for the extrapolation
+            float* buf = thread_scratch_f( 0, size_t(nr+2)*rl ) + 1;
+            float* spr = buf + size_t(nr)*rl;
+            for( int i=0; i<nr; i++ )
+                gradient_load( im, is, w, h, y0-1+i, spr, buf + size_t(i)*rl );
+
+            for( int y=y0; y<y1; y++ ) {
+                const float* r0  = buf + size_t(y-y0+1)*rl;
+                float*       gxr = gx  ? gx ->get_row_f(y) : NULL;
+                float*       gyr = gy  ? gy ->get_row_f(y) : NULL;
+                float*       mr  = mag ? mag->get_row_f(y) : NULL;
+                uchar*       orw = ori ? ori->get_row_u(y) : NULL;
+                if( zero_border && ( y == 0 || y == h-1 ) ) {
+                    for( int x=0; x<w; x++ ) {
+                        if( gxr ) gxr[x] = 0.0f;
+                        if( gyr ) gyr[x] = 0.0f;
+                        if( mr  ) mr [x] = 0.0f;
+                        if( orw ) orw[x] = 0;
+                    }
+                    continue;
+                }
+                gradient_row( r0-rl, r0, r0+rl, 0, w, kernel, c0, c1, n_bins, sse, gxr, gyr, mr, orw );
+                if( zero_border ) {
+                    const int xb[2] = { 0, w-1 };
+                    for( int k=0; k<2; k++ ) {
+                        if( gxr ) gxr[xb[k]] = 0.0f;
+                        if( gyr ) gyr[xb[k]] = 0.0f;
+                        if( mr  ) mr [xb[k]] = 0.0f;
+                        if( orw ) orw[xb[k]] = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    void image_gradients( const Image& img, const GradientKernel& kernel, const int& n_bins,
+                          const bool& run_parallel, Image* gx, Image* gy, Image* mag, Image* ori ) {
+        passert_statement( !img.is_empty(), "empty image" );
+        img.passert_type( IT_F_GRAY | IT_U_GRAY );
+        if( ori ) passert_statement( n_bins >= 1 && n_bins <= 256, "invalid number of orientation bins" );
+        int w = img.w();
+        int h = img.h();
+        Image* outs[] = { gx, gy, mag, ori };
+        for( int i=0; i<4; i++ ) {
+            if( !outs[i] ) continue;
+            passert_statement( outs[i] != &img, "aliasing is not allowed" );
+            outs[i]->create( w, h, i == 3 ? IT_U_GRAY : IT_F_GRAY );
+        }
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        size_t is = img.stride();
+        switch( img.type() ) {
+        case IT_F_GRAY: gradient_run( img.get_row_f(0), is, w, h, kernel, n_bins, sse, run_parallel, gx, gy, mag, ori ); break;
+        case IT_U_GRAY: gradient_run( img.get_row_u(0), is, w, h, kernel, n_bins, sse, run_parallel, gx, gy, mag, ori ); break;
+        default: switch_fatality();
+        }
+    }
+
+}
@@ -31,9 +31,23 @@ namespace kortex {
         m_data_i       = NULL;
         m_data_u       = NULL;
         m_data_f       = NULL;
+        m_stride       = 0;
+        m_plane        = 0;
         m_wrapper      = false;
     }
 
+    uchar* Image::row_bytes_( const int& r ) const {
+        size_t esz = get_data_byte_size( precision() );
+        uchar* p   = NULL;
+        switch( precision() ) {
+        case TYPE_UCHAR: p = (uchar*)m_data_u; break;
+        case TYPE_FLOAT: p = (uchar*)m_data_f; break;
+        case TYPE_INT  : p = (uchar*)m_data_i; break;
+        default        : switch_fatality();
+        }
+        return p + row_offset( r )*esz;
+    }
+
     Image::Image() {
         init_();
     }
@@ -74,6 +88,8 @@ namespace kortex {
         m_type = type;
         m_ch   = image_no_channels( type );
         m_channel_type = image_channel_type( type );
+        m_stride = row_length();
+        m_plane  = size_t(w)*size_t(h);
     }
 
     void Image::release() {
@@ -117,6 +133,8 @@ namespace kortex {
         std::swap( m_data_i       , img->m_data_i       );
         std::swap( m_data_u       , img->m_data_u       );
         std::swap( m_data_f       , img->m_data_f       );
+        std::swap( m_stride       , img->m_stride       );
+        std::swap( m_plane        , img->m_plane        );
         m_memory.swap( &(img->m_memory) );
     }
 
@@ -124,23 +142,17 @@ namespace kortex {
         passert_pointer( img );
         passert_statement( img != this, "cannot copy self" );
         create( img->w(), img->h(), img->type() );
-        size_t imsz = size_t(m_w) * size_t(m_h) * size_t(m_ch);
-        switch( image_precision(m_type) ) {
-        case TYPE_UCHAR: memcpy( m_data_u, img->m_data_u, sizeof(*m_data_u)* imsz ); break;
-        case TYPE_FLOAT: memcpy( m_data_f, img->m_data_f, sizeof(*m_data_f)* imsz ); break;
-        case TYPE_INT  : memcpy( m_data_i, img->m_data_i, sizeof(*m_data_i)* imsz ); break;
-        default        : switch_fatality();
-        }
+        SampleRows rows( *this, img );
+        size_t     rsz = rows.len * get_data_byte_size( precision() );
+        for( int r=0; r<rows.count; r++ )
+            memcpy( row_bytes_( rows.whole ? 0 : r ), img->row_bytes_( rows.whole ? 0 : r ), rsz );
     }
 
     void Image::zero() {
-        size_t im_sz = size_t(m_w) * size_t(m_h) * size_t(m_ch);
-        switch( precision() ) {
-        case TYPE_UCHAR: memset( m_data_u, 0, sizeof(*m_data_u)*im_sz ); break;
-        case TYPE_FLOAT: memset( m_data_f, 0, sizeof(*m_data_f)*im_sz ); break;
-        case TYPE_INT  : memset( m_data_i, 0, sizeof(*m_data_i)*im_sz ); break;
-        default        : switch_fatality();
-        }
+        SampleRows rows( *this );
+        size_t     rsz = rows.len * get_data_byte_size( precision() );
+        for( int r=0; r<rows.count; r++ )
+            memset( row_bytes_( rows.whole ? 0 : r ), 0, rsz );
     }
 
     void Image::set( const float& v ) {
@@ -183,32 +195,32 @@ namespace kortex {
     uchar      * Image::get_channel_u( int cid ) {
         assert_type( IT_U_GRAY | IT_U_IRGB );
         assert_boundary( cid, 0, m_ch );
-        return m_data_u + cid*m_h*m_w;
+        return m_data_u + cid*m_plane;
     }
     const uchar* Image::get_channel_u( int cid ) const {
         assert_type( IT_U_GRAY | IT_U_IRGB );
         assert_boundary( cid, 0, m_ch );
-        return m_data_u + cid*m_h*m_w;
+        return m_data_u + cid*m_plane;
     }
     float      * Image::get_channel_f( int cid ) {
         assert_type( IT_F_GRAY | IT_F_IRGB );
         assert_boundary( cid, 0, m_ch );
-        return m_data_f + cid*m_h*m_w;
+        return m_data_f + cid*m_plane;
     }
     const float* Image::get_channel_f( int cid ) const {
         assert_type( IT_F_GRAY | IT_F_IRGB );
         assert_boundary( cid, 0, m_ch );
-        return m_data_f + cid*m_h*m_w;
+        return m_data_f + cid*m_plane;
     }
     int        * Image::get_channel_i( int cid ) {
         assert_type( IT_I_GRAY );
         assert_boundary( cid, 0, m_ch );
-        return m_data_i + cid*m_h*m_w;
+        return m_data_i + cid*m_plane;
     }
     const int  * Image::get_channel_i( int cid ) const {
         assert_type( IT_I_GRAY );
         assert_boundary( cid, 0, m_ch );
-        return m_data_i + cid*m_h*m_w;
+        return m_data_i + cid*m_plane;
     }
 
 
@@ -218,54 +230,54 @@ namespace kortex {
     int* Image::get_row_i ( int y0 ) { // use for int gray
         assert_type( IT_I_GRAY );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_i + y0 * m_w * m_ch;
+        return m_data_i + y0 * m_stride;
     }
     uchar* Image::get_row_u ( int y0 ) { // use for u gray, prgb
         assert_type( IT_U_GRAY | IT_U_PRGB );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_u + y0 * m_w * m_ch;
+        return m_data_u + y0 * m_stride;
     }
     float* Image::get_row_f ( int y0 ) { // use for f gray, prgb
         assert_type( IT_F_GRAY | IT_F_PRGB );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_f + y0 * m_w * m_ch;
+        return m_data_f + y0 * m_stride;
     }
 
     uchar* Image::get_row_ui( int y0, int cid ) { // cid'th channel y0'th row
         assert_type( IT_U_IRGB | IT_U_GRAY );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_u + (cid * m_h + y0) * m_w;
+        return m_data_u + cid * m_plane + y0 * m_stride;
     }
     float* Image::get_row_fi( int y0, int cid ) { // cid'th channel y0'th row
         assert_type( IT_F_IRGB | IT_F_GRAY );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_f + (cid * m_h + y0) * m_w;
+        return m_data_f + cid * m_plane + y0 * m_stride;
     }
 
     const int* Image::get_row_i ( int y0 ) const { // use for u gray, prgb
         assert_type( IT_I_GRAY );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_i + y0 * m_w * m_ch;
+        return m_data_i + y0 * m_stride;
     }
     const uchar* Image::get_row_u ( int y0 ) const { // use for u gray, prgb
         assert_type( IT_U_GRAY | IT_U_PRGB );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_u + y0 * m_w * m_ch;
+        return m_data_u + y0 * m_stride;
     }
     const float* Image::get_row_f ( int y0 ) const { // use for f gray, prgb
         assert_type( IT_F_GRAY | IT_F_PRGB );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_f + y0 * m_w * m_ch;
+        return m_data_f + y0 * m_stride;
     }
     const uchar* Image::get_row_ui( int y0, int cid ) const { // cid'th channel y0'th row
         assert_type( IT_U_IRGB | IT_U_GRAY );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_u + (cid * m_h + y0) * m_w;
+        return m_data_u + cid * m_plane + y0 * m_stride;
     }
     const float* Image::get_row_fi( int y0, int cid ) const { // cid'th channel y0'th row
         assert_type( IT_F_IRGB | IT_F_GRAY );
         assert_statement_g( kortex::is_inside(y0,0,m_h), "[y0 %d] oob", y0 );
-        return m_data_f + (cid * m_h + y0) * m_w;
+        return m_data_f + cid * m_plane + y0 * m_stride;
     }
 
 
@@ -274,27 +286,27 @@ namespace kortex {
     float Image::getf( int x0, int y0 ) const {
         assert_type  ( IT_F_GRAY );
         assert_statement_g(is_inside(x0,y0), "[x %d] [y %d] oob", x0, y0);
-        return m_data_f[ y0*m_w+x0 ];
+        return m_data_f[ y0*m_stride+x0 ];
     }
 
     uchar Image::getu( int x0, int y0 ) const {
         assert_type  ( IT_U_GRAY );
         assert_statement_g(is_inside(x0,y0), "[x %d] [y %d] oob", x0, y0);
-        return m_data_u[ y0*m_w+x0 ];
+        return m_data_u[ y0*m_stride+x0 ];
     }
     int   Image::geti( int x0, int y0 ) const {
         assert_type  ( IT_I_GRAY );
         assert_statement_g(is_inside(x0,y0), "[x %d] [y %d] oob", x0, y0);
-        return m_data_i[ y0*m_w+x0 ];
+        return m_data_i[ y0*m_stride+x0 ];
     }
 
 
     float Image::get( int x0, int y0 ) const {
         assert_type( IT_U_GRAY | IT_F_GRAY );
         switch( m_type ) {
-        case IT_U_GRAY: return static_cast<float>(m_data_u[ y0*m_w+x0 ]); break;
-        case IT_F_GRAY: return m_data_f[ y0*m_w+x0 ]; break;
-        case IT_I_GRAY: return static_cast<float>(m_data_i[ y0*m_w+x0 ]); break;
+        case IT_U_GRAY: return static_cast<float>(m_data_u[ y0*m_stride+x0 ]); break;
+        case IT_F_GRAY: return m_data_f[ y0*m_stride+x0 ]; break;
+        case IT_I_GRAY: return static_cast<float>(m_data_i[ y0*m_stride+x0 ]); break;
         default       : switch_fatality();
         }
     }
@@ -315,21 +327,21 @@ namespace kortex {
     }
     float Image::get_bilinear_u( const float& x0, const float& y0 ) const {
         assert_type  ( IT_U_GRAY );
-        return bilinear_interpolation( m_data_u, m_w, m_h, 1, 0, x0, y0 );
+        return bilinear_interpolation( m_data_u, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
     float Image::get_bilinear_f( const float& x0, const float& y0 ) const {
         assert_type  ( IT_F_GRAY );
-        return bilinear_interpolation( m_data_f, m_w, m_h, 1, 0, x0, y0 );
+        return bilinear_interpolation( m_data_f, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
     float Image::get_bicubic_u( const float& x0, const float& y0 ) const {
         assert_type  ( IT_U_GRAY );
         assert_statement_g(is_inside_margin(x0,y0,2), "[x %f] [y %f] oob", x0, y0);
-        return bicubic_interpolation( m_data_u, m_w, m_h, 1, 0, x0, y0 );
+        return bicubic_interpolation( m_data_u, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
     float Image::get_bicubic_f( const float& x0, const float& y0 ) const {
         assert_type  ( IT_F_GRAY );
         assert_statement_g(is_inside_margin(x0,y0,2), "[x %f] [y %f] oob", x0, y0);
-        return bicubic_interpolation( m_data_f, m_w, m_h, 1, 0, x0, y0 );
+        return bicubic_interpolation( m_data_f, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
 
     void Image::get( int x0, int y0, uchar& r, uchar& g, uchar& b ) const {
@@ -341,16 +353,16 @@ namespace kortex {
         r = g = b = 0;
         switch( m_channel_type ) {
         case ITC_PIXEL:
-            shft = y0 * m_w * m_ch + x0*m_ch;
+            shft = y0*m_stride + x0*m_ch;
             r = m_data_u[ shft   ];
             g = m_data_u[ shft+1 ];
             b = m_data_u[ shft+2 ];
             break;
         case ITC_IMAGE:
-            shft = y0*m_w+x0;
+            shft = y0*m_stride + x0;
             r = m_data_u[ shft             ];
-            g = m_data_u[ shft + m_w*m_h   ];
-            b = m_data_u[ shft + m_w*m_h*2 ];
+            g = m_data_u[ shft + m_plane   ];
+            b = m_data_u[ shft + m_plane*2 ];
             break;
         default: switch_fatality();
         }
@@ -365,16 +377,16 @@ namespace kortex {
         r = g = b = 0.0f;
         switch( m_channel_type ) {
         case ITC_PIXEL:
-            shft = y0 * m_w * m_ch + x0*m_ch;
+            shft = y0*m_stride + x0*m_ch;
             r = m_data_f[ shft   ];
             g = m_data_f[ shft+1 ];
             b = m_data_f[ shft+2 ];
             break;
         case ITC_IMAGE:
-            shft = y0*m_w+x0;
+            shft = y0*m_stride + x0;
             r = m_data_f[ shft             ];
-            g = m_data_f[ shft + m_w*m_h   ];
-            b = m_data_f[ shft + m_w*m_h*2 ];
+            g = m_data_f[ shft + m_plane   ];
+            b = m_data_f[ shft + m_plane*2 ];
             break;
         default: switch_fatality();
         }
@@ -393,35 +405,35 @@ namespace kortex {
         assert_type( IT_U_PRGB );
         passert_statement_g( x0>=0 && x0<=m_w-1, "pixel oob [%f %f]", x0, y0 );
         passert_statement_g( y0>=0 && y0<=m_h-1, "pixel oob [%f %f]", x0, y0 );
-        r = bilinear_interpolation( m_data_u, m_w, m_h, m_ch, 0, x0, y0 );
-        g = bilinear_interpolation( m_data_u, m_w, m_h, m_ch, 1, x0, y0 );
-        b = bilinear_interpolation( m_data_u, m_w, m_h, m_ch, 2, x0, y0 );
+        r = bilinear_interpolation( m_data_u, m_w, m_h, m_ch, 0, x0, y0, m_stride );
+        g = bilinear_interpolation( m_data_u, m_w, m_h, m_ch, 1, x0, y0, m_stride );
+        b = bilinear_interpolation( m_data_u, m_w, m_h, m_ch, 2, x0, y0, m_stride );
     }
     void Image::get_bilinear_ui( const float& x0, const float& y0, float& r, float& g, float& b ) const {
         assert_type( IT_U_IRGB );
         passert_statement_g( x0>=0 && x0<=m_w-1, "pixel oob [%f %f]", x0, y0 );
         passert_statement_g( y0>=0 && y0<=m_h-1, "pixel oob [%f %f]", x0, y0 );
         const uchar* channel = NULL;
-        channel = get_channel_u(0); r = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_u(1); g = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_u(2); b = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
+        channel = get_channel_u(0); r = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_u(1); g = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_u(2); b = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
     void Image::get_bilinear_fp( const float& x0, const float& y0, float& r, float& g, float& b ) const {
         assert_type( IT_F_PRGB );
         passert_statement_g( x0>=0 && x0<=m_w-1, "pixel oob [%f %f]", x0, y0 );
         passert_statement_g( y0>=0 && y0<=m_h-1, "pixel oob [%f %f]", x0, y0 );
-        r = bilinear_interpolation( m_data_f, m_w, m_h, 3, 0, x0, y0 );
-        g = bilinear_interpolation( m_data_f, m_w, m_h, 3, 1, x0, y0 );
-        b = bilinear_interpolation( m_data_f, m_w, m_h, 3, 2, x0, y0 );
+        r = bilinear_interpolation( m_data_f, m_w, m_h, 3, 0, x0, y0, m_stride );
+        g = bilinear_interpolation( m_data_f, m_w, m_h, 3, 1, x0, y0, m_stride );
+        b = bilinear_interpolation( m_data_f, m_w, m_h, 3, 2, x0, y0, m_stride );
     }
     void Image::get_bilinear_fi( const float& x0, const float& y0, float& r, float& g, float& b ) const {
         assert_type( IT_F_IRGB );
         passert_statement_g( x0>=0 && x0<=m_w-1, "pixel oob [%f %f]", x0, y0 );
         passert_statement_g( y0>=0 && y0<=m_h-1, "pixel oob [%f %f]", x0, y0 );
         const float* channel = NULL;
-        channel = get_channel_f(0); r = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_f(1); g = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_f(2); b = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
+        channel = get_channel_f(0); r = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_f(1); g = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_f(2); b = bilinear_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
 
     void Image::get_bicubic   (const float& x0, const float& y0, float& r, float& g, float& b) const {
@@ -436,38 +448,38 @@ namespace kortex {
     void Image::get_bicubic_up( const float& x0, const float& y0, float& r, float& g, float& b ) const {
         assert_type( IT_U_PRGB );
         passert_statement( is_inside_margin(x0,y0,2), "pixel oob" );
-        r = bicubic_interpolation( m_data_u, m_w, m_h, m_ch, 0, x0, y0 );
-        g = bicubic_interpolation( m_data_u, m_w, m_h, m_ch, 1, x0, y0 );
-        b = bicubic_interpolation( m_data_u, m_w, m_h, m_ch, 2, x0, y0 );
+        r = bicubic_interpolation( m_data_u, m_w, m_h, m_ch, 0, x0, y0, m_stride );
+        g = bicubic_interpolation( m_data_u, m_w, m_h, m_ch, 1, x0, y0, m_stride );
+        b = bicubic_interpolation( m_data_u, m_w, m_h, m_ch, 2, x0, y0, m_stride );
     }
     void Image::get_bicubic_ui( const float& x0, const float& y0, float& r, float& g, float& b ) const {
         assert_type( IT_U_IRGB );
         passert_statement( is_inside_margin(x0,y0,2), "pixel oob" );
         const uchar* channel = NULL;
-        channel = get_channel_u(0); r = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_u(1); g = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_u(2); b = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
+        channel = get_channel_u(0); r = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_u(1); g = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_u(2); b = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
     void Image::get_bicubic_fp( const float& x0, const float& y0, float& r, float& g, float& b ) const {
         assert_type( IT_F_PRGB );
         passert_statement( is_inside_margin(x0,y0,2), "pixel oob" );
-        r = bicubic_interpolation( m_data_f, m_w, m_h, 3, 0, x0, y0 );
-        g = bicubic_interpolation( m_data_f, m_w, m_h, 3, 1, x0, y0 );
-        b = bicubic_interpolation( m_data_f, m_w, m_h, 3, 2, x0, y0 );
+        r = bicubic_interpolation( m_data_f, m_w, m_h, 3, 0, x0, y0, m_stride );
+        g = bicubic_interpolation( m_data_f, m_w, m_h, 3, 1, x0, y0, m_stride );
+        b = bicubic_interpolation( m_data_f, m_w, m_h, 3, 2, x0, y0, m_stride );
     }
     void Image::get_bicubic_fi( const float& x0, const float& y0, float& r, float& g, float& b ) const {
         assert_type( IT_F_IRGB );
         passert_statement( is_inside_margin(x0,y0,2), "pixel oob" );
         const float* channel = NULL;
-        channel = get_channel_f(0); r = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_f(1); g = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
-        channel = get_channel_f(2); b = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0 );
+        channel = get_channel_f(0); r = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_f(1); g = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
+        channel = get_channel_f(2); b = bicubic_interpolation( channel, m_w, m_h, 1, 0, x0, y0, m_stride );
     }
 
     void Image::add( const int& x0, const int& y0, const float& v ) {
         assert_type( IT_F_GRAY );
         assert_statement_g( is_inside(x0,y0), "xy %d %d oob", x0, y0 );
-        m_data_f[ y0*m_w + x0 ] += v;
+        m_data_f[ y0*m_stride + x0 ] += v;
     }
 
     void Image::add( const int& x0, const int& y0, const float& r, const float& g, const float& b ) {
@@ -477,16 +489,16 @@ namespace kortex {
         size_t shft = 0;
         switch( m_channel_type ) {
         case ITC_PIXEL:
-            shft = (y0*m_w + x0)*m_ch;
+            shft = y0*m_stride + x0*m_ch;
             m_data_f[ shft   ] += r;
             m_data_f[ shft+1 ] += g;
             m_data_f[ shft+2 ] += b;
             break;
         case ITC_IMAGE:
-            shft = y0*m_w + x0;
+            shft = y0*m_stride + x0;
             m_data_f[ shft             ] += r;
-            m_data_f[ shft + m_w*m_h   ] += g;
-            m_data_f[ shft + m_w*m_h*2 ] += b;
+            m_data_f[ shft + m_plane   ] += g;
+            m_data_f[ shft + m_plane*2 ] += b;
             break;
         default: switch_fatality();
         }
@@ -498,17 +510,17 @@ namespace kortex {
     void Image::set ( const int& x0, const int& y0, const float& v ) {
         assert_type( IT_F_GRAY );
         assert_statement_g( is_inside(x0,y0), "[x0 %d] [y0 %d] oob", x0, y0 );
-        m_data_f[ y0*m_w + x0 ] = v;
+        m_data_f[ y0*m_stride + x0 ] = v;
     }
     void Image::set ( const int& x0, const int& y0, const uchar& v ) {
         assert_type( IT_U_GRAY );
         assert_statement_g( is_inside(x0,y0), "[x0 %d] [y0 %d] oob", x0, y0 );
-        m_data_u[ y0*m_w + x0 ] = v;
+        m_data_u[ y0*m_stride + x0 ] = v;
     }
     void Image::set ( const int& x0, const int& y0, const int  & v ) {
         assert_type( IT_I_GRAY );
         assert_statement_g( is_inside(x0,y0), "[x0 %d] [y0 %d] oob", x0, y0 );
-        m_data_i[ y0*m_w + x0 ] = v;
+        m_data_i[ y0*m_stride + x0 ] = v;
     }
 
 
@@ -557,16 +569,16 @@ namespace kortex {
         size_t shft = 0;
         switch( m_channel_type ) {
         case ITC_PIXEL:
-            shft = (y0*m_w + x0)*m_ch;
+            shft = y0*m_stride + x0*m_ch;
             m_data_u[ shft   ] = r;
             m_data_u[ shft+1 ] = g;
             m_data_u[ shft+2 ] = b;
             break;
         case ITC_IMAGE:
-            shft = y0*m_w + x0;
+            shft = y0*m_stride + x0;
             m_data_u[ shft             ] = r;
-            m_data_u[ shft + m_w*m_h   ] = g;
-            m_data_u[ shft + m_w*m_h*2 ] = b;
+            m_data_u[ shft + m_plane   ] = g;
+            m_data_u[ shft + m_plane*2 ] = b;
             break;
         default: switch_fatality();
         }
@@ -577,16 +589,16 @@ namespace kortex {
         size_t shft = 0;
         switch( m_channel_type ) {
         case ITC_PIXEL:
-            shft = (y0*m_w + x0)*m_ch;
+            shft = y0*m_stride + x0*m_ch;
             m_data_f[ shft   ] = r;
             m_data_f[ shft+1 ] = g;
             m_data_f[ shft+2 ] = b;
             break;
         case ITC_IMAGE:
-            shft = y0*m_w + x0;
+            shft = y0*m_stride + x0;
             m_data_f[ shft             ] = r;
-            m_data_f[ shft + m_w*m_h   ] = g;
-            m_data_f[ shft + m_w*m_h*2 ] = b;
+            m_data_f[ shft + m_plane   ] = g;
+            m_data_f[ shft + m_plane*2 ] = b;
             break;
         default: switch_fatality();
         }
@@ -633,7 +645,9 @@ namespace kortex {
         write_bparam( fout, m_h );
         int imt = int( m_type );
         write_bparam( fout, imt );
-        write_barray( fout, m_memory.get_buffer(), req_mem( m_w, m_h, m_type ) );
+        SampleRows rows( *this );
+        for( int r=0; r<rows.count; r++ )
+            write_barray( fout, row_bytes_( rows.whole ? 0 : r ), rows.len*get_data_byte_size( precision() ) );
         insert_binary_stream_end_tag( fout );
     }
 
@@ -645,7 +659,9 @@ namespace kortex {
         read_bparam( fin, imt );
         ImageType type = ImageType(imt);
         this->create( w, h, type );
-        read_barray( fin, m_memory.get_buffer(), req_mem( w, h, type ) );
+        SampleRows rows( *this );
+        for( int r=0; r<rows.count; r++ )
+            read_barray( fin, row_bytes_( rows.whole ? 0 : r ), rows.len*get_data_byte_size( precision() ) );
         check_binary_stream_end_tag( fin );
     }
 
@@ -778,16 +794,18 @@ namespace kortex {
         img->m_h = m_h;
         img->m_ch = 1;
         img->m_channel_type = ITC_IMAGE;
+        img->m_stride = m_stride;
+        img->m_plane  = m_plane;
         img->m_wrapper = true;
         switch( precision() ) {
         case TYPE_UCHAR:
             img->m_type = IT_U_GRAY;
-            img->m_data_u = m_data_u + cid * m_w * m_h;
+            img->m_data_u = m_data_u + cid * m_plane;
             img->m_data_f = NULL;
             break;
         case TYPE_FLOAT:
             img->m_type = IT_F_GRAY;
-            img->m_data_f = m_data_f + cid * m_w * m_h;
+            img->m_data_f = m_data_f + cid * m_plane;
             img->m_data_u = NULL;
             break;
         default: switch_fatality();
@@ -801,16 +819,18 @@ namespace kortex {
         img->m_h = m_h;
         img->m_ch = 1;
         img->m_channel_type = ITC_IMAGE;
+        img->m_stride = m_stride;
+        img->m_plane  = m_plane;
         img->m_wrapper = true;
         switch( precision() ) {
         case TYPE_UCHAR:
             img->m_type = IT_U_GRAY;
-            img->m_data_u = m_data_u + cid * m_w * m_h;
+            img->m_data_u = m_data_u + cid * m_plane;
             img->m_data_f = NULL;
             break;
         case TYPE_FLOAT:
             img->m_type = IT_F_GRAY;
-            img->m_data_f = m_data_f + cid * m_w * m_h;
+            img->m_data_f = m_data_f + cid * m_plane;
             img->m_data_u = NULL;
             break;
         default: switch_fatality();
@@ -818,6 +838,38 @@ namespace kortex {
         return img;
     }
 
+    void Image::wrap( void* data, int w, int h, ImageType type, int stride ) {
+        passert_pointer( data );
+        passert_statement( w*h>0, "will not wrap null image" );
+        release();
+        m_w    = w;
+        m_h    = h;
+        m_type = type;
+        m_ch   = image_no_channels( type );
+        m_channel_type = image_channel_type( type );
+        m_wrapper = true;
+        if( !stride ) stride = row_length();
+        passert_statement_g( stride >= row_length(), "stride is shorter than a row [%d < %d]", stride, row_length() );
+        m_stride = stride;
+        m_plane  = size_t(stride)*size_t(h);
+        switch( image_precision(type) ) {
+        case TYPE_UCHAR: m_data_u = (uchar*) data; break;
+        case TYPE_FLOAT: m_data_f = (float*) data; break;
+        case TYPE_INT  : m_data_i = (int  *) data; break;
+        default        : switch_fatality();
+        }
+    }
+
+    void Image::view( const Image& parent, int x0, int y0, int w, int h ) {
+        passert_statement( &parent != this, "cannot view self" );
+        passert_statement_g( w > 0 && h > 0 && x0 >= 0 && y0 >= 0 && x0+w <= parent.w() && y0+h <= parent.h(),
+                             "region out of bounds [%d %d %d %d] [wh %d %d]", x0, y0, w, h, parent.w(), parent.h() );
+        size_t off = ( image_channel_type( parent.type() ) == ITC_IMAGE ? 1 : parent.ch() ) * size_t(x0)
+            + size_t(y0)*parent.stride();
+        wrap( parent.row_bytes_( 0 ) + off*get_data_byte_size( parent.precision() ), w, h, parent.type(), parent.stride() );
+        m_plane = parent.plane_stride();
+    }
+
     float Image::get_grad_x( const int& x0, const int &y0 ) const {
         assert_type( IT_F_GRAY );
         const float* row = get_row_f( y0 );
@@ -830,9 +882,9 @@ namespace kortex {
         assert_type( IT_F_GRAY );
         passert_boundary( x0, 0, m_w );
         const float* col = m_data_f + x0;
-        if     ( y0 >= m_h-1 ) return 2.0f * ( col[ (m_h-2)*m_w ] - col[ (m_h-1)*m_w ] );
-        else if( y0 <= 0     ) return 2.0f * ( col[           0 ] - col[         m_w ] );
-        else                   return        ( col[  (y0-1)*m_w ] - col[  (y0+1)*m_w ] );
+        if     ( y0 >= m_h-1 ) return 2.0f * ( col[ (m_h-2)*m_stride ] - col[ (m_h-1)*m_stride ] );
+        else if( y0 <= 0     ) return 2.0f * ( col[                0 ] - col[         m_stride ] );
+        else                   return        ( col[  (y0-1)*m_stride ] - col[  (y0+1)*m_stride ] );
     }
 
     bool Image::is_non_zero( const int& x0, const int& y0, const int& rsz ) const {
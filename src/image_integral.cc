@@ -0,0 +1,370 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/image_integral.h>
+#include <kortex/image.h>
+#include <kortex/mem_unit.h>
+#include <kortex/check.h>
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace kortex {
+
+    /// columns per strip of the vertical passes
+    const int INTEGRAL_STRIP = 256;
+
+    //
+    // row prefix sums: out[0] = 0, out[i+1] = out[i] + in[i] (or in[i]^2). the
+    // sse versions scan four values in-register with two shifted adds and
+    // carry the last one over.
+    //
+
+    void integral_row( const float* in, const int& n, const bool& sq, float* out ) {
+        out[0] = 0.0f;
+        int i=0;
+#ifdef WITH_SSE
+        __m128 carry = _mm_setzero_ps();
+        for( ; i+4<=n; i+=4 ) {
+            __m128 v = _mm_loadu_ps( in+i );
+            if( sq ) v = _mm_mul_ps( v, v );
+            v = _mm_add_ps( v, _mm_castsi128_ps( _mm_slli_si128( _mm_castps_si128(v), 4 ) ) );
+            v = _mm_add_ps( v, _mm_castsi128_ps( _mm_slli_si128( _mm_castps_si128(v), 8 ) ) );
+            v = _mm_add_ps( v, carry );
+            _mm_storeu_ps( out+i+1, v );
+            carry = _mm_shuffle_ps( v, v, _MM_SHUFFLE(3,3,3,3) );
+        }
+#endif
+        float s = out[i];
+        for( ; i<n; i++ ) {
+            s += sq ? in[i]*in[i] : in[i];
+            out[i+1] = s;
+        }
+    }
+
+    void integral_row( const uchar* in, const int& n, const bool& sq, uint32_t* out ) {
+        out[0] = 0;
+        int i=0;
+#ifdef WITH_SSE
+        const __m128i zero  = _mm_setzero_si128();
+        __m128i       carry = _mm_setzero_si128();
+        for( ; i+4<=n; i+=4 ) {
+            int32_t b;
+            memcpy( &b, in+i, sizeof(b) );
+            __m128i v = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128(b), zero ), zero );
+            // the high halves of the 32 bit lanes are zero: madd gives v^2
+            if( sq ) v = _mm_madd_epi16( v, v );
+            v = _mm_add_epi32( v, _mm_slli_si128( v, 4 ) );
+            v = _mm_add_epi32( v, _mm_slli_si128( v, 8 ) );
+            v = _mm_add_epi32( v, carry );
+            _mm_storeu_si128( (__m128i*)(out+i+1), v );
+            carry = _mm_shuffle_epi32( v, _MM_SHUFFLE(3,3,3,3) );
+        }
+#endif
+        uint32_t s = out[i];
+        for( ; i<n; i++ ) {
+            uint32_t v = in[i];
+            s += sq ? v*v : v;
+            out[i+1] = s;
+        }
+    }
+
+    void integral_row( const int* in, const int& n, const bool& sq, uint32_t* out ) {
+        out[0] = 0;
+        int i=0;
+#ifdef WITH_SSE
+        __m128i carry = _mm_setzero_si128();
+        for( ; !sq && i+4<=n; i+=4 ) {
+            __m128i v = _mm_loadu_si128( (const __m128i*)(in+i) );
+            v = _mm_add_epi32( v, _mm_slli_si128( v, 4 ) );
+            v = _mm_add_epi32( v, _mm_slli_si128( v, 8 ) );
+            v = _mm_add_epi32( v, carry );
+            _mm_storeu_si128( (__m128i*)(out+i+1), v );
+            carry = _mm_shuffle_epi32( v, _MM_SHUFFLE(3,3,3,3) );
+        }
+#endif
+        uint32_t s = out[i];
+        for( ; i<n; i++ ) {
+            uint32_t v = uint32_t( in[i] );
+            s += sq ? v*v : v;
+            out[i+1] = s;
+        }
+    }
+
+    /// second pass of the table build: accumulates the row sums down the
+    /// columns [x0,x1) - rows are ss elements apart
+    void integral_columns( float* sat, const size_t& ss, const int& sh, const int& x0, const int& x1 ) {
+        for( int y=1; y<sh; y++ ) {
+            const float* prev = sat + size_t(y-1)*ss;
+            float*       row  = sat + size_t(y  )*ss;
+            for( int x=x0; x<x1; x++ )
+                row[x] += prev[x];
+        }
+    }
+    void integral_columns( uint32_t* sat, const size_t& ss, const int& sh, const int& x0, const int& x1 ) {
+        for( int y=1; y<sh; y++ ) {
+            const uint32_t* prev = sat + size_t(y-1)*ss;
+            uint32_t*       row  = sat + size_t(y  )*ss;
+            for( int x=x0; x<x1; x++ )
+                row[x] += prev[x];
+        }
+    }
+
+    /// two pass build: prefix sums of the rows (parallel over rows), then
+    /// accumulation down the columns (parallel over column strips).
+    void integral_image_build( const Image& img, const bool& sq, const bool& run_parallel, Image& sat ) {
+        passert_noalias( img, sat );
+        assert_statement( !img.is_empty(), "empty image" );
+        img.passert_type( IT_U_GRAY | IT_I_GRAY | IT_F_GRAY );
+
+        int w  = img.w();
+        int h  = img.h();
+        int sw = w+1;
+        int sh = h+1;
+        sat.create( sw, sh, img.type() == IT_F_GRAY ? IT_F_GRAY : IT_I_GRAY );
+        size_t ss = sat.stride();
+
+        int n_strips = (sw+INTEGRAL_STRIP-1) / INTEGRAL_STRIP;
+        switch( img.type() ) {
+        case IT_F_GRAY: {
+            float* tab = sat.get_row_f(0);
+            memset( tab, 0, sizeof(*tab)*sw );
+#pragma omp parallel for if( run_parallel )
+            for( int y=0; y<h; y++ )
+                integral_row( img.get_row_f(y), w, sq, tab+size_t(y+1)*ss );
+#pragma omp parallel for if( run_parallel )
+            for( int s=0; s<n_strips; s++ )
+                integral_columns( tab, ss, sh, s*INTEGRAL_STRIP, std::min(sw,(s+1)*INTEGRAL_STRIP) );
+        } break;
+        case IT_U_GRAY:
+        case IT_I_GRAY: {
+            uint32_t* tab = (uint32_t*)sat.get_row_i(0);
+            memset( tab, 0, sizeof(*tab)*sw );
+#pragma omp parallel for if( run_parallel )
+            for( int y=0; y<h; y++ ) {
+                if( img.type() == IT_U_GRAY ) integral_row( img.get_row_u(y), w, sq, tab+size_t(y+1)*ss );
+                else                          integral_row( img.get_row_i(y), w, sq, tab+size_t(y+1)*ss );
+            }
+#pragma omp parallel for if( run_parallel )
+            for( int s=0; s<n_strips; s++ )
+                integral_columns( tab, ss, sh, s*INTEGRAL_STRIP, std::min(sw,(s+1)*INTEGRAL_STRIP) );
+        } break;
+        default: switch_fatality();
+        }
+    }
+
+    void integral_image( const Image& img, Image& sat ) {
+        integral_image_build( img, false, false, sat );
+    }
+    void integral_image_par( const Image& img, Image& sat ) {
+        integral_image_build( img, false, true, sat );
+    }
+    void integral_image_sq( const Image& img, Image& sqsat ) {
+        integral_image_build( img, true, false, sqsat );
+    }
+    void integral_image_sq_par( const Image& img, Image& sqsat ) {
+        integral_image_build( img, true, true, sqsat );
+    }
+
+    double box_sum( const Image& sat, const int& x0, const int& y0, const int& x1, const int& y1 ) {
+        sat.passert_type( IT_F_GRAY | IT_I_GRAY );
+        assert_statement( 0<=x0 && x0<=x1 && x1<sat.w() && 0<=y0 && y0<=y1 && y1<sat.h(), "box is out of the table" );
+        switch( sat.type() ) {
+        case IT_F_GRAY: return box_sum( sat.get_row_f(0), sat.stride(), x0, y0, x1, y1 );
+        case IT_I_GRAY: return box_sum( sat.get_row_i(0), sat.stride(), x0, y0, x1, y1 );
+        default       : switch_fatality();
+        }
+    }
+
+    void box_mean_variance( const Image& sat, const Image& sqsat,
+                            const int& x0, const int& y0, const int& x1, const int& y1,
+                            float& mean, float& var ) {
+        passert_statement( check_dimensions(sat, sqsat) && sat.type() == sqsat.type(), "table mismatch" );
+        double n = double(x1-x0) * double(y1-y0);
+        if( n == 0.0 ) {
+            mean = var = 0.0f;
+            return;
+        }
+        double s  = box_sum( sat,   x0, y0, x1, y1 );
+        double s2 = sat.type() == IT_I_GRAY
+            ? double( uint32_t( box_sum( sqsat.get_row_i(0), sqsat.stride(), x0, y0, x1, y1 ) ) )
+            : box_sum( sqsat, x0, y0, x1, y1 );
+        double m = s / n;
+        mean = float( m );
+        var  = float( std::max( 0.0, s2/n - m*m ) );
+    }
+
+    //
+    // box filters with running sums
+    //
+
+    /// sums over [x-rx, x+rx] along the rows [r0,r1), zero padded. rows of
+    /// im are is elements apart, those of out w.
+    void box_sum_rows( const float* im, const size_t& is, const int& w, const int& rx, const int& r0, const int& r1,
+                       float* out ) {
+        for( int y=r0; y<r1; y++ ) {
+            const float* row  = im  + size_t(y)*is;
+            float*       orow = out + size_t(y)*w;
+            double s = 0.0;
+            for( int x=0; x<=std::min(rx,w-1); x++ )
+                s += row[x];
+            for( int x=0; x<w; x++ ) {
+                orow[x] = float( s );
+                if( x+rx+1 <  w ) s += row[x+rx+1];
+                if( x-rx   >= 0 ) s -= row[x-rx];
+            }
+        }
+    }
+
+    /// sums the row sums over [y-ry, y+ry] for the output rows [r0,r1) - the
+    /// column accumulators run in double. normalize divides by the number of
+    /// pixels of the window inside the image. rows of rsum are w and those
+    /// of out os elements apart.
+    void box_sum_columns( const float* rsum, const int& w, const int& h, const int& rx, const int& ry,
+                          const int& r0, const int& r1, const bool& normalize, float* out, const size_t& os ) {
+        const int nw  = w;
+        double*   acc = (double*)thread_scratch( 0, nw*( sizeof(double) + sizeof(float) ) );
+        float*    icx = (float*)( acc + nw );
+        memset( acc, 0, sizeof(*acc)*nw );
+        for( int x=0; x<nw; x++ )
+            icx[x] = 1.0f / float( std::min(x+rx,nw-1) - std::max(x-rx,0) + 1 );
+
+        for( int y=std::max(0,r0-ry); y<=std::min(h-1,r0+ry); y++ ) {
+            const float* row = rsum + size_t(y)*nw;
+            for( int x=0; x<nw; x++ )
+                acc[x] += row[x];
+        }
+        for( int y=r0; y<r1; y++ ) {
+            float* orow = out + size_t(y)*os;
+            if( normalize ) {
+                double icy = 1.0 / double( std::min(y+ry,h-1) - std::max(y-ry,0) + 1 );
+                for( int x=0; x<nw; x++ )
+                    orow[x] = float( acc[x]*icy ) * icx[x];
+            } else {
+                for( int x=0; x<nw; x++ )
+                    orow[x] = float( acc[x] );
+            }
+            const float* add = y+ry+1 <  h ? rsum + size_t(y+ry+1)*nw : NULL;
+            const float* sub = y-ry   >= 0 ? rsum + size_t(y-ry  )*nw : NULL;
+            if( add && sub ) {
+                for( int x=0; x<nw; x++ )
+                    acc[x] += double(add[x]) - double(sub[x]);
+            } else if( add ) {
+                for( int x=0; x<nw; x++ )
+                    acc[x] += add[x];
+            } else if( sub ) {
+                for( int x=0; x<nw; x++ )
+                    acc[x] -= sub[x];
+            }
+        }
+    }
+
+    /// two passes through an intermediate image of row sums, so img and out
+    /// can be the same. the vertical pass runs in row bands, every band
+    /// primes its accumulators with the 2*ry+1 rows around its first row.
+    void box_filter_run( const Image& img, const int& rx, const int& ry, const bool& normalize,
+                         const bool& run_parallel, Image& out ) {
+        assert_statement( !img.is_empty(), "empty image" );
+        img.passert_type( IT_F_GRAY );
+        passert_statement( rx >= 0 && ry >= 0, "invalid window radius" );
+
+        int w = img.w();
+        int h = img.h();
+        out.create( w, h, IT_F_GRAY );
+
+        Image rsum( w, h, IT_F_GRAY );
+        const int row_band = 64;
+        int n_bands = (h+row_band-1) / row_band;
+#pragma omp parallel for if( run_parallel )
+        for( int b=0; b<n_bands; b++ )
+            box_sum_rows( img.get_row_f(0), img.stride(), w, rx, b*row_band, std::min(h,(b+1)*row_band),
+                          rsum.get_row_f(0) );
+
+        // keep the cost of priming the accumulators below the band itself
+        int band = std::max( 128, 4*ry );
+        n_bands  = (h+band-1) / band;
+#pragma omp parallel for if( run_parallel )
+        for( int b=0; b<n_bands; b++ )
+            box_sum_columns( rsum.get_row_f(0), w, h, rx, ry, b*band, std::min(h,(b+1)*band),
+                             normalize, out.get_row_f(0), out.stride() );
+    }
+
+    void box_filter( const Image& img, const int& rx, const int& ry, Image& out ) {
+        box_filter_run( img, rx, ry, false, false, out );
+    }
+    void box_filter_par( const Image& img, const int& rx, const int& ry, Image& out ) {
+        box_filter_run( img, rx, ry, false, true, out );
+    }
+    void mean_filter( const Image& img, const int& r, Image& out ) {
+        box_filter_run( img, r, r, true, false, out );
+    }
+    void mean_filter_par( const Image& img, const int& r, Image& out ) {
+        box_filter_run( img, r, r, true, true, out );
+    }
+
+    void local_mean_variance( const Image& img, const int& r, const bool& run_parallel, Image& mean, Image& var ) {
+        assert_statement( !img.is_empty(), "empty image" );
+        img.passert_type( IT_F_GRAY );
+        passert_noalias( mean, var );
+
+        int w = img.w();
+        int h = img.h();
+
+        Image sq( w, h, IT_F_GRAY );
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            const float* ip = img.get_row_f(y);
+            float*       sp = sq .get_row_f(y);
+            for( int x=0; x<w; x++ )
+                sp[x] = ip[x]*ip[x];
+        }
+
+        mean_filter( img, r, run_parallel, mean );
+        mean_filter( sq,  r, run_parallel, sq   );
+
+        var.create( w, h, IT_F_GRAY );
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            const float* sp = sq  .get_row_f(y);
+            const float* mp = mean.get_row_f(y);
+            float*       vp = var .get_row_f(y);
+            for( int x=0; x<w; x++ )
+                vp[x] = std::max( 0.0f, sp[x] - mp[x]*mp[x] );
+        }
+    }
+
+    void local_normalize( const Image& img, const int& r, const float& eps, const bool& run_parallel, Image& out ) {
+        passert_statement( eps >= 0.0f, "eps should be non-negative" );
+        Image mean, var;
+        local_mean_variance( img, r, run_parallel, mean, var );
+
+        int w = img.w();
+        int h = img.h();
+        out.create( w, h, IT_F_GRAY );
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            const float* ip = img .get_row_f(y);
+            const float* mp = mean.get_row_f(y);
+            const float* vp = var .get_row_f(y);
+            float*       op = out .get_row_f(y);
+            for( int x=0; x<w; x++ )
+                op[x] = ( ip[x] - mp[x] ) / std::sqrt( vp[x] + eps );
+        }
+    }
+
+}
@@ -22,6 +22,21 @@
 
 namespace kortex {
 
+    /// the samples of img row by row - a single block unless img is a view
+    template<typename T>
+    void write_image_rows( ofstream& fout, const Image* img, const T* p ) {
+        SampleRows rows( *img );
+        for( int r=0; r<rows.count; r++ )
+            write_barray( fout, rows.row( p, *img, r ), rows.len );
+    }
+
+    template<typename T>
+    void read_image_rows( ifstream& fin, Image* img, T* p ) {
+        SampleRows rows( *img );
+        for( int r=0; r<rows.count; r++ )
+            read_barray( fin, rows.row( p, *img, r ), rows.len );
+    }
+
     void save_binary( const string& file, const Image* img ) {
         passert_pointer( img );
         ofstream fout;
@@ -31,14 +46,13 @@ namespace kortex {
         write_bparam( fout, img->h() );
         write_bparam( fout, img->ch() );
         write_bparam( fout, (int)img->type() );
-        size_t imsz = img->element_count();
         switch( img->type() ) {
-        case IT_U_GRAY: write_barray( fout, img->get_row_u (0  ), imsz ); break;
-        case IT_U_PRGB: write_barray( fout, img->get_row_u (0  ), imsz ); break;
-        case IT_U_IRGB: write_barray( fout, img->get_row_ui(0,0), imsz ); break;
-        case IT_F_GRAY: write_barray( fout, img->get_row_f (0  ), imsz ); break;
-        case IT_F_PRGB: write_barray( fout, img->get_row_f (0  ), imsz ); break;
-        case IT_F_IRGB: write_barray( fout, img->get_row_fi(0,0), imsz ); break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+        case IT_U_IRGB: write_image_rows( fout, img, img->get_uptr() ); break;
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+        case IT_F_IRGB: write_image_rows( fout, img, img->get_fptr() ); break;
         default: switch_fatality();
         }
         insert_binary_stream_end_tag( fout );
@@ -56,14 +70,13 @@ namespace kortex {
         read_bparam( fin, ch );
         read_bparam( fin, type );
         img->create( w, h, get_image_type(type) );
-        size_t imsz = img->element_count();
         switch( img->type() ) {
-        case IT_U_GRAY: read_barray( fin, img->get_row_u (0  ), imsz ); break;
-        case IT_U_PRGB: read_barray( fin, img->get_row_u (0  ), imsz ); break;
-        case IT_U_IRGB: read_barray( fin, img->get_row_ui(0,0), imsz ); break;
-        case IT_F_GRAY: read_barray( fin, img->get_row_f (0  ), imsz ); break;
-        case IT_F_PRGB: read_barray( fin, img->get_row_f (0  ), imsz ); break;
-        case IT_F_IRGB: read_barray( fin, img->get_row_fi(0,0), imsz ); break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+        case IT_U_IRGB: read_image_rows( fin, img, img->get_uptr() ); break;
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+        case IT_F_IRGB: read_image_rows( fin, img, img->get_fptr() ); break;
         default: switch_fatality();
         }
         check_binary_stream_end_tag( fin );
@@ -0,0 +1,665 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/image_processing.h>
+#include <kortex/image.h>
+#include <kortex/filter.h>
+#include <kortex/check.h>
+#include <kortex/color.h>
+#include <kortex/log_manager.h>
+
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+//
+// the pointwise operations of image_processing.h. all of them work on the
+// sample rows of SampleRows - the whole image as one row unless a view is
+// involved - cut into blocks of PIXELWISE_BLOCK elements that run in
+// parallel if asked to. every kernel has an sse path for uchar, int and
+// float data that is taken when filter_simd_level() allows it and a scalar
+// path with the same results.
+//
+
+namespace kortex {
+
+    enum PwCompare { PW_GREATER=0, PW_EQUAL };
+
+    /// an operand: its first sample and its layout
+    template<typename T>
+    struct PwArg {
+        T* p; const Image* img;
+        T* at( const SampleRows& rows, const int& r, const size_t& x0 ) const { return rows.row( p, *img, r ) + x0; }
+    };
+    template<typename T>
+    inline PwArg<T> pw_arg( T* p, const Image& img ) {
+        PwArg<T> a = { p, &img };
+        return a;
+    }
+
+    /// k( rows, r, x0, n, sse ) over the blocks of the sample rows
+    template<typename K>
+    void pw_run( const K& k, const SampleRows& rows, const bool& run_parallel ) {
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        const int nx = int( ( rows.len + PIXELWISE_BLOCK - 1 ) / PIXELWISE_BLOCK );
+        const int nb = rows.count * nx;
+#pragma omp parallel for if( run_parallel && nb > 1 )
+        for( int b=0; b<nb; b++ ) {
+            int    r  = b / nx;
+            size_t x0 = size_t(b%nx)*PIXELWISE_BLOCK;
+            k( rows, r, x0, int( std::min( size_t(PIXELWISE_BLOCK), rows.len-x0 ) ), sse );
+        }
+    }
+
+#ifdef WITH_SSE
+    /// the 16 bytes at s as four float vectors
+    inline void pw_load_u8( const uchar* s, __m128* f ) {
+        const __m128i z  = _mm_setzero_si128();
+        __m128i       v  = _mm_loadu_si128( (const __m128i*)s );
+        __m128i       lo = _mm_unpacklo_epi8( v, z );
+        __m128i       hi = _mm_unpackhi_epi8( v, z );
+        f[0] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, z ) );
+        f[1] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, z ) );
+        f[2] = _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, z ) );
+        f[3] = _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, z ) );
+    }
+
+    /// four vectors of [0,255] integers to 16 bytes at o
+    inline void pw_store_u8( const __m128i* v, uchar* o ) {
+        __m128i b = _mm_packus_epi16( _mm_packs_epi32( v[0], v[1] ), _mm_packs_epi32( v[2], v[3] ) );
+        _mm_storeu_si128( (__m128i*)o, b );
+    }
+
+    /// four 32 bit compare masks to 16 bytes of 0/1 at o
+    inline void pw_store_mask( const __m128i* v, uchar* o ) {
+        __m128i b = _mm_packs_epi16( _mm_packs_epi32( v[0], v[1] ), _mm_packs_epi32( v[2], v[3] ) );
+        _mm_storeu_si128( (__m128i*)o, _mm_and_si128( b, _mm_set1_epi8( 1 ) ) );
+    }
+#endif
+
+    //
+    // kernels
+    //
+
+    inline void pw_subtract( const float* a, const float* b, const int& n, const bool& sse, float* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            for( ; i+4<=n; i+=4 )
+                _mm_storeu_ps( o+i, _mm_sub_ps( _mm_loadu_ps( a+i ), _mm_loadu_ps( b+i ) ) );
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = a[i] - b[i];
+    }
+
+    /// saturates at 0
+    inline void pw_subtract( const uchar* a, const uchar* b, const int& n, const bool& sse, uchar* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            for( ; i+16<=n; i+=16 ) {
+                __m128i va = _mm_loadu_si128( (const __m128i*)( a+i ) );
+                __m128i vb = _mm_loadu_si128( (const __m128i*)( b+i ) );
+                _mm_storeu_si128( (__m128i*)( o+i ), _mm_subs_epu8( va, vb ) );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = a[i] > b[i] ? uchar( a[i] - b[i] ) : 0;
+    }
+
+    inline void pw_subtract( const int* a, const int* b, const int& n, const bool& sse, int* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            for( ; i+4<=n; i+=4 ) {
+                __m128i va = _mm_loadu_si128( (const __m128i*)( a+i ) );
+                __m128i vb = _mm_loadu_si128( (const __m128i*)( b+i ) );
+                _mm_storeu_si128( (__m128i*)( o+i ), _mm_sub_epi32( va, vb ) );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = a[i] - b[i];
+    }
+
+    /// 0 where |b| < 1e-6
+    inline void pw_divide( const float* a, const float* b, const int& n, const bool& sse, float* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 sgn = _mm_set1_ps( -0.0f );
+            const __m128 eps = _mm_set1_ps( 1e-6f );
+            for( ; i+4<=n; i+=4 ) {
+                __m128 vb    = _mm_loadu_ps( b+i );
+                __m128 small = _mm_cmplt_ps( _mm_andnot_ps( sgn, vb ), eps );
+                _mm_storeu_ps( o+i, _mm_andnot_ps( small, _mm_div_ps( _mm_loadu_ps( a+i ), vb ) ) );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = std::fabs( b[i] ) < 1e-6f ? 0.0f : a[i] / b[i];
+    }
+
+    /// integer quotient, 0 where b is 0. the float quotient of two bytes is
+    /// never close enough to an integer to truncate to the wrong one.
+    inline void pw_divide( const uchar* a, const uchar* b, const int& n, const bool& sse, uchar* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            __m128  fa[4], fb[4];
+            __m128i q[4];
+            const __m128i z = _mm_setzero_si128();
+            for( ; i+16<=n; i+=16 ) {
+                __m128i zero = _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i*)( b+i ) ), z );
+                pw_load_u8( a+i, fa );
+                pw_load_u8( b+i, fb );
+                for( int k=0; k<4; k++ ) {
+                    // x/0 is inf or nan and converts to 0x80000000
+                    q[k] = _mm_cvttps_epi32( _mm_div_ps( fa[k], fb[k] ) );
+                }
+                __m128i r = _mm_packus_epi16( _mm_packs_epi32( q[0], q[1] ), _mm_packs_epi32( q[2], q[3] ) );
+                _mm_storeu_si128( (__m128i*)( o+i ), _mm_andnot_si128( zero, r ) );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = b[i] ? uchar( a[i] / b[i] ) : 0;
+    }
+
+    /// integer quotient, 0 where b is 0. sse2 has no integer division.
+    inline void pw_divide( const int* a, const int* b, const int& n, const bool&, int* o ) {
+        for( int i=0; i<n; i++ )
+            o[i] = b[i] ? a[i] / b[i] : 0;
+    }
+
+    inline void pw_negate( const float* a, const int& n, const bool& sse, float* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 sgn = _mm_set1_ps( -0.0f );
+            for( ; i+4<=n; i+=4 )
+                _mm_storeu_ps( o+i, _mm_xor_ps( sgn, _mm_loadu_ps( a+i ) ) );
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = -a[i];
+    }
+
+    inline void pw_negate( const int* a, const int& n, const bool& sse, int* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128i z = _mm_setzero_si128();
+            for( ; i+4<=n; i+=4 )
+                _mm_storeu_si128( (__m128i*)( o+i ), _mm_sub_epi32( z, _mm_loadu_si128( (const __m128i*)( a+i ) ) ) );
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = -a[i];
+    }
+
+    /// o = ( a - mn ) * s
+    inline void pw_linear( const float* a, const int& n, const float& mn, const float& s, const bool& sse, float* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 vm = _mm_set1_ps( mn );
+            const __m128 vs = _mm_set1_ps( s  );
+            for( ; i+4<=n; i+=4 )
+                _mm_storeu_ps( o+i, _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( a+i ), vm ), vs ) );
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = ( a[i] - mn ) * s;
+    }
+
+    inline void pw_linear( const uchar* a, const int& n, const float& mn, const float& s, const bool& sse, float* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 vm = _mm_set1_ps( mn );
+            const __m128 vs = _mm_set1_ps( s  );
+            __m128 f[4];
+            for( ; i+16<=n; i+=16 ) {
+                pw_load_u8( a+i, f );
+                for( int k=0; k<4; k++ )
+                    _mm_storeu_ps( o+i+4*k, _mm_mul_ps( _mm_sub_ps( f[k], vm ), vs ) );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = ( float( a[i] ) - mn ) * s;
+    }
+
+    /// o = cast_to_gray_range( ( a - mn ) * s ), 0 for nan
+    inline void pw_stretch( const float* a, const int& n, const float& mn, const float& s, const bool& sse, uchar* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 vm   = _mm_set1_ps( mn );
+            const __m128 vs   = _mm_set1_ps( s  );
+            const __m128 half = _mm_set1_ps( 0.5f );
+            const __m128 lo   = _mm_setzero_ps();
+            const __m128 hi   = _mm_set1_ps( 255.0f );
+            __m128i q[4];
+            for( ; i+16<=n; i+=16 ) {
+                for( int k=0; k<4; k++ ) {
+                    __m128 f = _mm_add_ps( _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( a+i+4*k ), vm ), vs ), half );
+                    // maxps returns its second operand for nan
+                    q[k] = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( f, lo ), hi ) );
+                }
+                pw_store_u8( q, o+i );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = is_a_number( a[i] ) ? cast_to_gray_range( ( a[i] - mn ) * s ) : 0;
+    }
+
+    inline void pw_stretch( const uchar* a, const int& n, const float& mn, const float& s, const bool& sse, uchar* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 vm   = _mm_set1_ps( mn );
+            const __m128 vs   = _mm_set1_ps( s  );
+            const __m128 half = _mm_set1_ps( 0.5f );
+            const __m128 lo   = _mm_setzero_ps();
+            const __m128 hi   = _mm_set1_ps( 255.0f );
+            __m128  f[4];
+            __m128i q[4];
+            for( ; i+16<=n; i+=16 ) {
+                pw_load_u8( a+i, f );
+                for( int k=0; k<4; k++ ) {
+                    __m128 v = _mm_add_ps( _mm_mul_ps( _mm_sub_ps( f[k], vm ), vs ), half );
+                    q[k] = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( v, lo ), hi ) );
+                }
+                pw_store_u8( q, o+i );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = cast_to_gray_range( ( float( a[i] ) - mn ) * s );
+    }
+
+    /// m = a > t or a == t as 0/1. nan compares false.
+    inline void pw_compare( const float* a, const int& n, const PwCompare& c, const float& t, const bool& sse, uchar* m ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 vt = _mm_set1_ps( t );
+            __m128i r[4];
+            for( ; i+16<=n; i+=16 ) {
+                for( int k=0; k<4; k++ ) {
+                    __m128 v = _mm_loadu_ps( a+i+4*k );
+                    r[k] = _mm_castps_si128( c == PW_GREATER ? _mm_cmpgt_ps( v, vt ) : _mm_cmpeq_ps( v, vt ) );
+                }
+                pw_store_mask( r, m+i );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            m[i] = uchar( c == PW_GREATER ? a[i] > t : a[i] == t );
+    }
+
+    inline void pw_compare( const int* a, const int& n, const PwCompare& c, const int& t, const bool& sse, uchar* m ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128i vt = _mm_set1_epi32( t );
+            __m128i r[4];
+            for( ; i+16<=n; i+=16 ) {
+                for( int k=0; k<4; k++ ) {
+                    __m128i v = _mm_loadu_si128( (const __m128i*)( a+i+4*k ) );
+                    r[k] = c == PW_GREATER ? _mm_cmpgt_epi32( v, vt ) : _mm_cmpeq_epi32( v, vt );
+                }
+                pw_store_mask( r, m+i );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            m[i] = uchar( c == PW_GREATER ? a[i] > t : a[i] == t );
+    }
+
+    inline void pw_compare( const uchar* a, const int& n, const PwCompare& c, const uchar& t, const bool& sse, uchar* m ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128i vt  = _mm_set1_epi8( char(t) );
+            const __m128i one = _mm_set1_epi8( 1 );
+            const __m128i z   = _mm_setzero_si128();
+            for( ; i+16<=n; i+=16 ) {
+                __m128i v = _mm_loadu_si128( (const __m128i*)( a+i ) );
+                __m128i r;
+                if( c == PW_GREATER ) r = _mm_andnot_si128( _mm_cmpeq_epi8( _mm_subs_epu8( v, vt ), z ), one );
+                else                  r = _mm_and_si128( _mm_cmpeq_epi8( v, vt ), one );
+                _mm_storeu_si128( (__m128i*)( m+i ), r );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            m[i] = uchar( c == PW_GREATER ? a[i] > t : a[i] == t );
+    }
+
+    /// 0/1 bytes to floats
+    inline void pw_widen( const uchar* m, const int& n, const bool& sse, float* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            __m128 f[4];
+            for( ; i+16<=n; i+=16 ) {
+                pw_load_u8( m+i, f );
+                for( int k=0; k<4; k++ )
+                    _mm_storeu_ps( o+i+4*k, f[k] );
+            }
+        }
+#endif
+        for( ; i<n; i++ )
+            o[i] = float( m[i] );
+    }
+
+    //
+    // block functors
+    //
+
+#define PW_BLOCK_ARGS const SampleRows& rs, const int& r, const size_t& x0, const int& n, const bool& sse
+
+    template<typename T>
+    struct PwSubtract {
+        PwArg<const T> a, b; PwArg<T> o;
+        void operator()( PW_BLOCK_ARGS ) const { pw_subtract( a.at(rs,r,x0), b.at(rs,r,x0), n, sse, o.at(rs,r,x0) ); }
+    };
+
+    template<typename T>
+    struct PwDivide {
+        PwArg<const T> a, b; PwArg<T> o;
+        void operator()( PW_BLOCK_ARGS ) const { pw_divide( a.at(rs,r,x0), b.at(rs,r,x0), n, sse, o.at(rs,r,x0) ); }
+    };
+
+    template<typename T>
+    struct PwNegate {
+        PwArg<const T> a; PwArg<T> o;
+        void operator()( PW_BLOCK_ARGS ) const { pw_negate( a.at(rs,r,x0), n, sse, o.at(rs,r,x0) ); }
+    };
+
+    template<typename T>
+    struct PwLinear {
+        PwArg<const T> a; float mn, s; PwArg<float> o;
+        void operator()( PW_BLOCK_ARGS ) const { pw_linear( a.at(rs,r,x0), n, mn, s, sse, o.at(rs,r,x0) ); }
+    };
+
+    template<typename T>
+    struct PwStretch {
+        PwArg<const T> a; float mn, s; PwArg<uchar> o;
+        void operator()( PW_BLOCK_ARGS ) const { pw_stretch( a.at(rs,r,x0), n, mn, s, sse, o.at(rs,r,x0) ); }
+    };
+
+    /// writes the 0/1 result to mu or, through a block on the stack, to mf
+    template<typename T>
+    struct PwMask {
+        PwArg<const T> a; PwCompare c; T t; PwArg<uchar> mu; PwArg<float> mf;
+        void operator()( PW_BLOCK_ARGS ) const {
+            if( mu.p ) {
+                pw_compare( a.at(rs,r,x0), n, c, t, sse, mu.at(rs,r,x0) );
+            } else {
+                uchar m[PIXELWISE_BLOCK];
+                pw_compare( a.at(rs,r,x0), n, c, t, sse, m );
+                pw_widen( m, n, sse, mf.at(rs,r,x0) );
+            }
+        }
+    };
+
+    struct PwFill {
+        uchar v; PwArg<uchar> mu; PwArg<float> mf;
+        void operator()( const SampleRows& rs, const int& r, const size_t& x0, const int& n, const bool& ) const {
+            if( mu.p ) memset( mu.at(rs,r,x0), v, n );
+            else       std::fill( mf.at(rs,r,x0), mf.at(rs,r,x0)+n, float(v) );
+        }
+    };
+
+#undef PW_BLOCK_ARGS
+
+    /// maps the threshold t of an integer comparison to [lo,hi]: returns 0
+    /// if it is representable (as ti), else the constant result 0 / 1
+    /// as 2 / 3.
+    inline int pw_integer_threshold( const PwCompare& c, const double& t, const int& lo, const int& hi, int& ti ) {
+        if( c == PW_GREATER ) {
+            double f = std::floor( t );
+            if( !( f < hi ) ) return 2; // nan compares false as well
+            if( f < lo      ) return 3;
+            ti = int( f );
+            return 0;
+        }
+        if( t != std::floor( t ) || t < lo || t > hi ) return 2;
+        ti = int( t );
+        return 0;
+    }
+
+    /// out = ( img > t ) or ( img == t ) as 0/1. img is IT_U_GRAY, IT_I_GRAY
+    /// or IT_F_GRAY, out IT_U_GRAY or IT_F_GRAY of the same size.
+    void pw_mask( const Image& img, const PwCompare& c, const double& t, const bool& run_parallel, Image& out ) {
+        passert_statement( check_dimensions(img, out), "dimension mismatch" );
+        img.passert_type( IT_U_GRAY | IT_I_GRAY | IT_F_GRAY );
+        out.passert_type( IT_U_GRAY | IT_F_GRAY );
+        SampleRows   rows( img, &out );
+        PwArg<uchar> mu = pw_arg( out.type() == IT_U_GRAY ? out.get_uptr() : (uchar*)NULL, out );
+        PwArg<float> mf = pw_arg( out.type() == IT_F_GRAY ? out.get_fptr() : (float*)NULL, out );
+
+        int ti = 0, res = 0;
+        switch( img.type() ) {
+        case IT_F_GRAY: {
+            PwMask<float> k = { pw_arg( img.get_fptr(), img ), c, float(t), mu, mf };
+            pw_run( k, rows, run_parallel );
+            return;
+        }
+        case IT_I_GRAY: res = pw_integer_threshold( c, t, INT_MIN, INT_MAX, ti ); break;
+        case IT_U_GRAY: res = pw_integer_threshold( c, t, 0,       255,     ti ); break;
+        default: switch_fatality();
+        }
+        if( res ) {
+            PwFill k = { uchar( res == 3 ), mu, mf };
+            pw_run( k, rows, run_parallel );
+        } else if( img.type() == IT_I_GRAY ) {
+            PwMask<int> k = { pw_arg( img.get_iptr(), img ), c, ti, mu, mf };
+            pw_run( k, rows, run_parallel );
+        } else {
+            PwMask<uchar> k = { pw_arg( img.get_uptr(), img ), c, uchar(ti), mu, mf };
+            pw_run( k, rows, run_parallel );
+        }
+    }
+
+    //
+    // image level
+    //
+
+    void image_subtract( const Image& im0, const Image& im1, bool run_parallel, Image& out ) {
+        passert_statement( check_dimensions(im0,im1), "dimension mismatch" );
+        passert_statement( check_dimensions(im0,out), "dimension mismatch" );
+        passert_statement( im0.type() == im1.type() && im0.type() == out.type(), "type mismatch" );
+        SampleRows rows( im0, &im1, &out );
+        switch( im0.precision() ) {
+        case TYPE_FLOAT: {
+            PwSubtract<float> k = { pw_arg( im0.get_fptr(), im0 ), pw_arg( im1.get_fptr(), im1 ), pw_arg( out.get_fptr(), out ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        case TYPE_UCHAR: {
+            PwSubtract<uchar> k = { pw_arg( im0.get_uptr(), im0 ), pw_arg( im1.get_uptr(), im1 ), pw_arg( out.get_uptr(), out ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        case TYPE_INT: {
+            PwSubtract<int> k = { pw_arg( im0.get_iptr(), im0 ), pw_arg( im1.get_iptr(), im1 ), pw_arg( out.get_iptr(), out ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        default: switch_fatality();
+        }
+    }
+
+    void image_divide( const Image& p, const Image& q, bool run_parallel, Image& r ) {
+        passert_statement( check_dimensions(p,q), "dimension mismatch" );
+        passert_statement( check_dimensions(p,r), "dimension mismatch" );
+        passert_statement( p.type() == q.type() && p.type() == r.type(), "type mismatch" );
+        SampleRows rows( p, &q, &r );
+        switch( p.precision() ) {
+        case TYPE_FLOAT: {
+            PwDivide<float> k = { pw_arg( p.get_fptr(), p ), pw_arg( q.get_fptr(), q ), pw_arg( r.get_fptr(), r ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        case TYPE_UCHAR: {
+            PwDivide<uchar> k = { pw_arg( p.get_uptr(), p ), pw_arg( q.get_uptr(), q ), pw_arg( r.get_uptr(), r ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        case TYPE_INT: {
+            PwDivide<int> k = { pw_arg( p.get_iptr(), p ), pw_arg( q.get_iptr(), q ), pw_arg( r.get_iptr(), r ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        default: switch_fatality();
+        }
+    }
+
+    void image_negate( const Image& img, bool run_parallel, Image& out ) {
+        passert_statement( check_dimensions(img,out), "dimension mismatch" );
+        passert_statement( img.type() == out.type(), "type mismatch" );
+        SampleRows rows( img, &out );
+        switch( img.precision() ) {
+        case TYPE_FLOAT: {
+            PwNegate<float> k = { pw_arg( img.get_fptr(), img ), pw_arg( out.get_fptr(), out ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        case TYPE_INT: {
+            PwNegate<int> k = { pw_arg( img.get_iptr(), img ), pw_arg( out.get_iptr(), out ) };
+            pw_run( k, rows, run_parallel );
+            break;
+        }
+        default: switch_fatality();
+        }
+    }
+
+    void image_linearize( const Image& src, bool run_parallel, Image& dst ) {
+        src.passert_type( IT_F_GRAY | IT_U_GRAY );
+        dst.passert_type( IT_F_GRAY );
+        passert_statement( check_dimensions(src,dst), "dimension mismatch" );
+        passert_statement( !src.is_empty(), "empty image" );
+
+        float mins, maxs;
+        image_min_max( src, 0, 0, src.w(), src.h(), mins, maxs, run_parallel );
+
+        float srange = maxs - mins;
+        if( fabs(srange ) < 1e-8 ) {
+            logman_warning_g( "image range is too low [%f %f]", mins, maxs );
+            dst.zero();
+            return;
+        }
+        float isrange = 1.0f/srange;
+
+        SampleRows rows( src, &dst );
+        if( src.type() == IT_F_GRAY ) {
+            PwLinear<float> k = { pw_arg( src.get_fptr(), src ), mins, isrange, pw_arg( dst.get_fptr(), dst ) };
+            pw_run( k, rows, run_parallel );
+        } else {
+            PwLinear<uchar> k = { pw_arg( src.get_uptr(), src ), mins, isrange, pw_arg( dst.get_fptr(), dst ) };
+            pw_run( k, rows, run_parallel );
+        }
+    }
+
+    void image_stretch( const Image& src, float minv, float maxv, bool run_parallel, Image& out ) {
+        src.passert_type( IT_F_GRAY | IT_U_GRAY );
+        passert_noalias( src, out );
+
+        float scale = 1.0f;
+        if( minv == 0.0f && maxv == 0.0f ) {
+            if( !image_min_max( src, 0, 0, src.w(), src.h(), minv, maxv, run_parallel ) ) {
+                logman_error("min max range for the image could not be found");
+                minv = 0.0f;
+                maxv = 0.0f;
+                scale = 1.0f;
+            } else {
+                scale = 255.0f / ( maxv - minv );
+            }
+        } else {
+            scale = 255.0f / ( maxv - minv );
+        }
+
+        out.create( src.w(), src.h(), IT_U_GRAY );
+
+        SampleRows rows( src, &out );
+        if( src.type() == IT_F_GRAY ) {
+            PwStretch<float> k = { pw_arg( src.get_fptr(), src ), minv, scale, pw_arg( out.get_uptr(), out ) };
+            pw_run( k, rows, run_parallel );
+        } else {
+            PwStretch<uchar> k = { pw_arg( src.get_uptr(), src ), minv, scale, pw_arg( out.get_uptr(), out ) };
+            pw_run( k, rows, run_parallel );
+        }
+    }
+
+    void image_threshold( const Image& img, float th, bool run_parallel, Image& out ) {
+        pw_mask( img, PW_GREATER, th, run_parallel, out );
+    }
+
+    void mask_invert( const Image& img, bool run_parallel, Image& out ) {
+        img.passert_type( IT_U_GRAY | IT_F_GRAY );
+        assert_statement( is_binarized(img), "image needs to be binarized" );
+        pw_mask( img, PW_EQUAL, 0.0, run_parallel, out );
+    }
+
+    void pick_pixels_with_color( const Image& img, const uchar& v, bool run_parallel, Image& out ) {
+        img.passert_type( IT_U_GRAY );
+        pw_mask( img, PW_EQUAL, v, run_parallel, out );
+    }
+
+    void binarize_image( const Image& src, bool run_parallel, Image& dst ) {
+        pw_mask( src, PW_GREATER, 0.0, run_parallel, dst );
+    }
+
+//
+// table lookups - sse2 has no byte shuffle, the lookup stays scalar
+//
+
+    template<typename T>
+    struct PwLut {
+        const T* t;
+        T operator()( const uchar& v ) const { return t[v]; }
+    };
+
+    void apply_pixelwise_lut( const Image& p, const uchar* lut, bool run_parallel, Image& q ) {
+        passert_statement( p.precision() == TYPE_UCHAR && q.precision() == TYPE_UCHAR, "expected uchar images" );
+        passert_statement( check_dimensions(p,q) && p.ch() == q.ch() &&
+                           image_channel_type( p.type() ) == image_channel_type( q.type() ), "layout mismatch" );
+        PwLut<uchar> l = { lut };
+        pixelwise_map( p, p.get_uptr(), l, run_parallel, q, q.get_uptr() );
+    }
+
+    void apply_pixelwise_lut( const Image& p, const float* lut, bool run_parallel, Image& q ) {
+        passert_statement( p.precision() == TYPE_UCHAR && q.precision() == TYPE_FLOAT, "expected uchar input and float output" );
+        passert_statement( check_dimensions(p,q) && p.ch() == q.ch() &&
+                           image_channel_type( p.type() ) == image_channel_type( q.type() ), "layout mismatch" );
+        PwLut<float> l = { lut };
+        pixelwise_map( p, p.get_uptr(), l, run_parallel, q, q.get_fptr() );
+    }
+
+}
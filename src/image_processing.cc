@@ -20,6 +20,12 @@
 #include <kortex/types.h>
 #include <kortex/image.h>
 #include <kortex/filter.h>
+#include <kortex/filter_fixed.h>
+#include <kortex/image_integral.h>
+#include <kortex/resample.h>
+#include <kortex/morphology.h>
+#include <kortex/gradient.h>
+#include <kortex/image_expr.h>
 #include <kortex/mem_manager.h>
 #include <kortex/math.h>
 #include <kortex/color.h>
@@ -29,130 +35,39 @@
 
 namespace kortex {
 
-    template float bilinear_interpolation(const uchar* img, const int& w, const int& h, const int& nc, const int& c,  const float& x, const float& y);
-    template float bilinear_interpolation(const float* img, const int& w, const int& h, const int& nc, const int& c,  const float& x, const float& y);
-    template float  bicubic_interpolation(const uchar* im,  const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y);
-    template float  bicubic_interpolation(const float* im,  const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y);
-
-    bool image_min_max( const Image& img,
-                        const int& xmin, const int& ymin,
-                        const int& xmax, const int& ymax,
-                        float& min_v, float& max_v ) {
-        img.passert_type( IT_F_GRAY | IT_U_GRAY );
-
-        int xs, xe, ys, ye;
-        if( xmin == xmax && ymin == ymax && xmin == xmax && xmin == -1 ) {
-            xs = 0;
-            ys = 0;
-            xe = img.w();
-            ye = img.h();
-        } else {
-            xs = std::max( std::min( xmin, xmax ), 0        );
-            xe = std::min( std::max( xmin, xmax ), img.w() );
-            ys = std::max( std::min( ymin, ymax ), 0        );
-            ye = std::min( std::max( ymin, ymax ), img.h() );
-        }
-
-        min_v =  std::numeric_limits<float>::max();
-        max_v = -std::numeric_limits<float>::max();
-
-        switch( img.type() ) {
-        case IT_F_GRAY:
-            for( int y=ys; y<ye; y++ ) {
-                const float* row = img.get_row_f(y);
-                for( int x=xs; x<xe; x++ ) {
-                    const float& v = row[x];
-                    if( is_a_number(v) ) {
-                        min_v = std::min(v,min_v);
-                        max_v = std::max(v,max_v);
-                    }
-                }
-            }
-            break;
-        case IT_U_GRAY:
-            for( int y=ys; y<ye; y++ ) {
-                const uchar* row = img.get_row_u(y);
-                for( int x=xs; x<xe; x++ ) {
-                    float v = static_cast<float>(row[x]);
-                    if( is_a_number(v) ) {
-                        min_v = std::min(v,min_v);
-                        max_v = std::max(v,max_v);
-                    }
-                }
-            }
-            break;
-        default: switch_fatality();
-        }
-
-        if( (min_v ==  std::numeric_limits<float>::max())  ||
-            (max_v == -std::numeric_limits<float>::max()) ) {
-            return false;
-        }
-        return true;
-    }
-
-    bool abs_image_min_max( const Image& img,
-                            const int& xmin, const int& ymin,
-                            const int& xmax, const int& ymax,
-                            float& min_v, float& max_v ) {
-        img.passert_type( IT_F_GRAY );
-
-        int xs, xe, ys, ye;
-        if( xmin == xmax && ymin == ymax && xmin == xmax && xmin == -1 ) {
-            xs = 0;
-            ys = 0;
-            xe = img.w();
-            ye = img.h();
-        } else {
-            xs = std::max( std::min( xmin, xmax ), 0        );
-            xe = std::min( std::max( xmin, xmax ), img.w() );
-            ys = std::max( std::min( ymin, ymax ), 0        );
-            ye = std::min( std::max( ymin, ymax ), img.h() );
-        }
-
-        min_v =  std::numeric_limits<float>::max();
-        max_v = -std::numeric_limits<float>::max();
-
-        for( int y=ys; y<ye; y++ ) {
-            const float* row = img.get_row_f(y);
-            for( int x=xs; x<xe; x++ ) {
-                const float& v = std::fabs( row[x] );
-                if( is_a_number(v) ) {
-                    min_v = std::min(v,min_v);
-                    max_v = std::max(v,max_v);
-                }
-            }
-        }
-        if( (min_v ==  std::numeric_limits<float>::max())  ||
-            (max_v == -std::numeric_limits<float>::max()) ) {
-            return false;
-        }
-        return true;
-    }
-
+    template float bilinear_interpolation(const uchar* img, const int& w, const int& h, const int& nc, const int& c,  const float& x, const float& y, const int& stride);
+    template float bilinear_interpolation(const float* img, const int& w, const int& h, const int& nc, const int& c,  const float& x, const float& y, const int& stride);
+    template float  bicubic_interpolation(const uchar* im,  const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y, const int& stride);
+    template float  bicubic_interpolation(const float* im,  const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y, const int& stride);
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_hv( const Image& img, const float* kernel, const int& ksz, Image& out ) {
+    void filter_hv( const Image& img, const float* kernel, const int& ksz, Image& out, const BorderMode& border ) {
         assert_pointer( kernel );
         assert_pointer_size( ksz );
         assert_statement( !img.is_empty(), "image is empty" );
         passert_statement( out.type() == img.type(), "image types not agree" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.passert_type( IT_F_GRAY | IT_F_IRGB );
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
 
         switch( img.type() ) {
         case IT_F_GRAY:
-            filter_hv( img.get_row_f(0), img.w(), img.h(), kernel, ksz, out.get_row_f(0) );
+        case IT_F_PRGB:
+            filter_hv( img.get_row_f(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            filter_hv_u8( img.get_row_u(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_u(0), border,
+                          FIXED_ROUND_NEAREST, img.stride(), out.stride() );
             break;
         case IT_F_IRGB: {
-            for( int c=0; c<3; c++ ) {
-                const Image* sch = img.get_channel_wrapper( c );
-                Image      * dch = out.get_channel_wrapper( c );
-                filter_hv( *sch, kernel, ksz, *dch );
-                delete sch;
-                delete dch;
-            }
+            for( int c=0; c<3; c++ )
+                filter_hv( img.get_channel_f(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        case IT_U_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_hv_u8( img.get_channel_u(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_u(c), border,
+                              FIXED_ROUND_NEAREST, img.stride(), out.stride() );
         } break;
         default: switch_fatality();
         }
@@ -160,26 +75,32 @@ namespace kortex {
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_hor( const Image& img, const float* kernel, const int& ksz, Image& out ) {
+    void filter_hor( const Image& img, const float* kernel, const int& ksz, Image& out, const BorderMode& border ) {
         assert_pointer( kernel );
         assert_pointer_size( ksz );
         assert_statement( !img.is_empty(), "empty image" );
         passert_statement( out.type() == img.type(), "image types not agree" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.passert_type( IT_F_GRAY | IT_F_IRGB );
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
 
         switch( img.type() ) {
         case IT_F_GRAY:
-            filter_hor( img.get_row_f(0), img.w(), img.h(), kernel, ksz, out.get_row_f(0) );
+        case IT_F_PRGB:
+            filter_hor( img.get_row_f(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            filter_hor_u8( img.get_row_u(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_u(0), border,
+                           FIXED_ROUND_NEAREST, img.stride(), out.stride() );
             break;
         case IT_F_IRGB: {
-            for( int c=0; c<3; c++ ) {
-                const Image* sch = img.get_channel_wrapper( c );
-                Image      * dch = out.get_channel_wrapper( c );
-                filter_hor( *sch, kernel, ksz, *dch );
-                delete sch;
-                delete dch;
-            }
+            for( int c=0; c<3; c++ )
+                filter_hor( img.get_channel_f(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        case IT_U_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_hor_u8( img.get_channel_u(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_u(c), border,
+                               FIXED_ROUND_NEAREST, img.stride(), out.stride() );
         } break;
         default: switch_fatality();
         }
@@ -188,26 +109,32 @@ namespace kortex {
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_hor_par( const Image& img, const float* kernel, const int& ksz, Image& out ) {
+    void filter_hor_par( const Image& img, const float* kernel, const int& ksz, Image& out, const BorderMode& border ) {
         assert_pointer( kernel );
         assert_pointer_size( ksz );
         assert_statement( !img.is_empty(), "empty image" );
         passert_statement( out.type() == img.type(), "image types not agree" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.passert_type( IT_F_GRAY | IT_F_IRGB );
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
 
         switch( img.type() ) {
         case IT_F_GRAY:
-            filter_hor_par( img.get_row_f(0), img.w(), img.h(), kernel, ksz, out.get_row_f(0) );
+        case IT_F_PRGB:
+            filter_hor_par( img.get_row_f(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            filter_hor_u8_par( img.get_row_u(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_u(0), border,
+                               FIXED_ROUND_NEAREST, img.stride(), out.stride() );
             break;
         case IT_F_IRGB: {
-            for( int c=0; c<3; c++ ) {
-                const Image* sch = img.get_channel_wrapper( c );
-                Image      * dch = out.get_channel_wrapper( c );
-                filter_hor_par( *sch, kernel, ksz, *dch );
-                delete sch;
-                delete dch;
-            }
+            for( int c=0; c<3; c++ )
+                filter_hor_par( img.get_channel_f(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        case IT_U_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_hor_u8_par( img.get_channel_u(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_u(c), border,
+                                   FIXED_ROUND_NEAREST, img.stride(), out.stride() );
         } break;
         default: switch_fatality();
         }
@@ -215,26 +142,32 @@ namespace kortex {
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_ver( const Image& img, const float* kernel, const int& ksz, Image& out ) {
+    void filter_ver( const Image& img, const float* kernel, const int& ksz, Image& out, const BorderMode& border ) {
         assert_pointer( kernel );
         assert_pointer_size( ksz );
         assert_statement( !img.is_empty(), "empty image" );
         passert_statement( out.type() == img.type(), "image types not agree" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.passert_type( IT_F_GRAY | IT_F_IRGB );
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
 
         switch( img.type() ) {
         case IT_F_GRAY:
-            filter_ver( img.get_row_f(0), img.w(), img.h(), kernel, ksz, out.get_row_f(0) );
+        case IT_F_PRGB:
+            filter_ver( img.get_row_f(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            filter_ver_u8( img.get_row_u(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_u(0), border,
+                           FIXED_ROUND_NEAREST, img.stride(), out.stride() );
             break;
         case IT_F_IRGB: {
-            for( int c=0; c<3; c++ ) {
-                const Image* sch = img.get_channel_wrapper( c );
-                Image      * dch = out.get_channel_wrapper( c );
-                filter_ver( *sch, kernel, ksz, *dch );
-                delete sch;
-                delete dch;
-            }
+            for( int c=0; c<3; c++ )
+                filter_ver( img.get_channel_f(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        case IT_U_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_ver_u8( img.get_channel_u(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_u(c), border,
+                               FIXED_ROUND_NEAREST, img.stride(), out.stride() );
         } break;
         default: switch_fatality();
         }
@@ -242,26 +175,32 @@ namespace kortex {
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_ver_par( const Image& img, const float* kernel, const int& ksz, Image& out ) {
+    void filter_ver_par( const Image& img, const float* kernel, const int& ksz, Image& out, const BorderMode& border ) {
         assert_pointer( kernel );
         assert_pointer_size( ksz );
         assert_statement( !img.is_empty(), "empty image" );
         passert_statement( out.type() == img.type(), "image types not agree" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.passert_type( IT_F_GRAY | IT_F_IRGB );
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
 
         switch( img.type() ) {
         case IT_F_GRAY:
-            filter_ver_par( img.get_row_f(0), img.w(), img.h(), kernel, ksz, out.get_row_f(0) );
+        case IT_F_PRGB:
+            filter_ver_par( img.get_row_f(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            filter_ver_u8_par( img.get_row_u(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_u(0), border,
+                               FIXED_ROUND_NEAREST, img.stride(), out.stride() );
             break;
         case IT_F_IRGB: {
-            for( int c=0; c<3; c++ ) {
-                const Image* sch = img.get_channel_wrapper( c );
-                Image      * dch = out.get_channel_wrapper( c );
-                filter_ver_par( *sch, kernel, ksz, *dch );
-                delete sch;
-                delete dch;
-            }
+            for( int c=0; c<3; c++ )
+                filter_ver_par( img.get_channel_f(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        case IT_U_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_ver_u8_par( img.get_channel_u(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_u(c), border,
+                                   FIXED_ROUND_NEAREST, img.stride(), out.stride() );
         } break;
         default: switch_fatality();
         }
@@ -271,26 +210,32 @@ namespace kortex {
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_hv_par( const Image& img, const float* kernel, const int& ksz, Image& out ) {
+    void filter_hv_par( const Image& img, const float* kernel, const int& ksz, Image& out, const BorderMode& border ) {
         assert_pointer( kernel );
         assert_pointer_size( ksz );
         assert_statement( !img.is_empty(), "image is empty" );
         passert_statement( out.type() == img.type(), "image types not agree" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.passert_type( IT_F_GRAY | IT_F_IRGB ); // supporting these types
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB ); // supporting these types
                                                    // for now
         switch( img.type() ) {
         case IT_F_GRAY:
-            filter_hv_par( img.get_row_f(0), img.w(), img.h(), kernel, ksz, out.get_row_f(0) );
+        case IT_F_PRGB:
+            filter_hv_par( img.get_row_f(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            filter_hv_u8_par( img.get_row_u(0), img.w(), img.h(), img.ch(), kernel, ksz, out.get_row_u(0), border,
+                              FIXED_ROUND_NEAREST, img.stride(), out.stride() );
             break;
         case IT_F_IRGB: {
-            for( int c=0; c<3; c++ ) {
-                const Image* sch = img.get_channel_wrapper( c );
-                Image      * dch = out.get_channel_wrapper( c );
-                filter_hv_par( *sch, kernel, ksz, *dch );
-                delete sch;
-                delete dch;
-            }
+            for( int c=0; c<3; c++ )
+                filter_hv_par( img.get_channel_f(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        case IT_U_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_hv_u8_par( img.get_channel_u(c), img.w(), img.h(), 1, kernel, ksz, out.get_channel_u(c), border,
+                                  FIXED_ROUND_NEAREST, img.stride(), out.stride() );
         } break;
         default: switch_fatality();
         }
@@ -307,32 +252,80 @@ namespace kortex {
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_gaussian( const Image& img, const float& sigma, Image& out ) {
+    void filter_gaussian( const Image& img, const float& sigma, Image& out, const BorderMode& border ) {
         assert_statement( !img.is_empty(), "image is empty" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
         passert_statement( out.type() == img.type(), "image types not agree" );
+        if( sigma >= GAUSSIAN_IIR_MIN_SIGMA && img.precision() == TYPE_FLOAT ) {
+            filter_gaussian_iir( img, sigma, out, border );
+            return;
+        }
         int sz = filter_size(sigma);
         float* sfilter = NULL;
         allocate(sfilter, sz);
         gaussian_1d( sfilter, sz, 0, sigma );
-        filter_hv( img, sfilter, sz, out );
+        filter_hv( img, sfilter, sz, out, border );
         deallocate( sfilter );
     }
 
     // allows img out to be point to the same mem location -> therefore passerts
     // that out image is mem-allocated.
-    void filter_gaussian_par( const Image& img, const float& sigma, Image& out ) {
+    void filter_gaussian_par( const Image& img, const float& sigma, Image& out, const BorderMode& border ) {
         assert_statement( !img.is_empty(), "image is empty" );
         passert_statement( check_dimensions(img, out), "dimension mismatch" );
         passert_statement( out.type() == img.type(), "image types not agree" );
+        if( sigma >= GAUSSIAN_IIR_MIN_SIGMA && img.precision() == TYPE_FLOAT ) {
+            filter_gaussian_iir_par( img, sigma, out, border );
+            return;
+        }
         int sz = filter_size(sigma);
         float* sfilter = NULL;
         allocate(sfilter, sz);
         gaussian_1d( sfilter, sz, 0, sigma );
-        filter_hv_par( img, sfilter, sz, out );
+        filter_hv_par( img, sfilter, sz, out, border );
         deallocate( sfilter );
     }
 
+    // allows img out to be point to the same mem location -> therefore passerts
+    // that out image is mem-allocated.
+    void filter_gaussian_iir( const Image& img, const float& sigma, Image& out, const BorderMode& border ) {
+        assert_statement( !img.is_empty(), "image is empty" );
+        passert_statement( check_dimensions(img, out), "dimension mismatch" );
+        passert_statement( out.type() == img.type(), "image types not agree" );
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB );
+        switch( img.type() ) {
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+            filter_gaussian_iir( img.get_row_f(0), img.w(), img.h(), img.ch(), sigma, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_F_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_gaussian_iir( img.get_channel_f(c), img.w(), img.h(), 1, sigma, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        default: switch_fatality();
+        }
+    }
+
+    // allows img out to be point to the same mem location -> therefore passerts
+    // that out image is mem-allocated.
+    void filter_gaussian_iir_par( const Image& img, const float& sigma, Image& out, const BorderMode& border ) {
+        assert_statement( !img.is_empty(), "image is empty" );
+        passert_statement( check_dimensions(img, out), "dimension mismatch" );
+        passert_statement( out.type() == img.type(), "image types not agree" );
+        img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB );
+        switch( img.type() ) {
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+            filter_gaussian_iir_par( img.get_row_f(0), img.w(), img.h(), img.ch(), sigma, out.get_row_f(0), border, img.stride(), out.stride() );
+            break;
+        case IT_F_IRGB: {
+            for( int c=0; c<3; c++ )
+                filter_gaussian_iir_par( img.get_channel_f(c), img.w(), img.h(), 1, sigma, out.get_channel_f(c), border, img.stride(), out.stride() );
+        } break;
+        default: switch_fatality();
+        }
+    }
+
     void combine_horizontally(const Image& im0, const Image& im1, Image& out) {
         passert_statement( im0.precision() == im1.precision(), "image precisions are different" );
         passert_statement( im0.ch() == im1.ch(), "image channels different" );
@@ -454,173 +447,8 @@ namespace kortex {
         }
     }
 
-    void image_threshold( const Image& img, float th, Image& msk ) {
-        passert_statement( check_dimensions(img, msk), "dimension mismatch" );
-        img.passert_type( IT_F_GRAY );
-        msk.passert_type( IT_F_GRAY );
-        int pc = img.pixel_count();
-        const float* irow = img.get_row_f(0);
-        float      * orow = msk.get_row_f(0);
-        for( int x=0; x<pc; x++ ) {
-            if( irow[x] > th ) orow[x] = 1.0f;
-            else               orow[x] = 0.0f;
-        }
-    }
-
-    void image_resize_coarse_rgb    ( const Image& src, const int& nw, const int& nh, Image& dst ) {
-
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_PRGB | IT_U_IRGB | IT_F_IRGB | IT_F_PRGB );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-        float max_y = static_cast<float>( src.h()-1 );
-        float max_x = static_cast<float>( src.w()-1 );
-
-        DataType dtype = image_precision( src.type() );
-
-        float r, g, b;
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            if( ny >= max_y ) ny = max_y;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( nx >= max_x ) nx = max_x;
-                src.get_bilinear(nx, ny, r, g, b);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, r, g, b); break;
-                case TYPE_UCHAR: {
-                    uchar ur = cast_to_gray_range( r );
-                    uchar ug = cast_to_gray_range( g );
-                    uchar ub = cast_to_gray_range( b );
-                    dst.set(x, y, ur, ug, ub);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-    void image_resize_coarse_rgb_par( const Image& src, const int& nw, const int& nh, Image& dst ) {
-
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_PRGB | IT_U_IRGB | IT_F_IRGB | IT_F_PRGB );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-        float max_y  = static_cast<float>( src.h()-1 );
-        float max_x  = static_cast<float>( src.w()-1 );
-
-        DataType dtype = image_precision( src.type() );
-
-#pragma omp parallel for
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            if( ny >= max_y ) ny = max_y;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( nx >= max_x ) nx = max_x;
-                float r, g, b;
-                src.get_bilinear(nx, ny, r, g, b);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, r, g, b); break;
-                case TYPE_UCHAR: {
-                    uchar ur = cast_to_gray_range( r );
-                    uchar ug = cast_to_gray_range( g );
-                    uchar ub = cast_to_gray_range( b );
-                    dst.set(x, y, ur, ug, ub);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-    void image_resize_coarse_g    ( const Image& src, const int& nw, const int& nh, Image& dst ) {
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_GRAY | IT_F_GRAY );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-        float max_y  = static_cast<float>( src.h()-1 );
-        float max_x  = static_cast<float>( src.w()-1 );
-
-        DataType dtype = image_precision( src.type() );
-
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            if( ny >= max_y ) ny = max_y;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( nx >= max_x ) nx = max_x;
-                float v = src.get_bilinear(nx, ny);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, v); break;
-                case TYPE_UCHAR: {
-                    uchar uv = cast_to_gray_range( v );
-                    dst.set(x, y, uv);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-    void image_resize_coarse_g_par( const Image& src, const int& nw, const int& nh, Image& dst ) {
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_GRAY | IT_F_GRAY );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-        float max_y  = static_cast<float>( src.h()-1 );
-        float max_x  = static_cast<float>( src.w()-1 );
-
-        DataType dtype = image_precision( src.type() );
-
-#pragma omp parallel for
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            if( ny >= max_y ) ny = max_y;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( nx >= max_x ) nx = max_x;
-                float v = src.get_bilinear(nx, ny);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, v); break;
-                case TYPE_UCHAR: {
-                    uchar uv = cast_to_gray_range( v );
-                    dst.set(x, y, uv);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-
     void image_resize_coarse( const Image& src, const int& nw, const int& nh, bool run_parallel, Image& dst ) {
-
-        if( run_parallel ) {
-            switch( src.ch() ) {
-            case 1: image_resize_coarse_g_par  ( src, nw, nh, dst ); break;
-            case 3: image_resize_coarse_rgb_par( src, nw, nh, dst ); break;
-            default: switch_fatality();
-            }
-        } else {
-            switch( src.ch() ) {
-            case 1: image_resize_coarse_g  ( src, nw, nh, dst ); break;
-            case 3: image_resize_coarse_rgb( src, nw, nh, dst ); break;
-            default: switch_fatality();
-            }
-        }
+        image_resample( src, nw, nh, RESAMPLE_AREA, run_parallel, dst, BORDER_REPLICATE );
     }
     void image_resize_coarse( const Image& img, int max_img_dim, bool run_parallel, Image& rimg ) {
         int nw = img.w();
@@ -637,156 +465,8 @@ namespace kortex {
 
 
 
-    void image_resize_fine_g( const Image& src, const int& nw, const int& nh, Image& dst ) {
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_GRAY | IT_F_GRAY );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-        float max_y  = static_cast<float>( src.h()-1 );
-        float max_x  = static_cast<float>( src.w()-1 );
-
-        DataType dtype = image_precision( src.type() );
-
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            if( ny >= max_y ) ny = max_y;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( nx >= max_x ) nx = max_x;
-                if( !src.is_inside_margin(nx, ny, 2) ) continue;
-                float v = src.get_bicubic(nx, ny);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, v); break;
-                case TYPE_UCHAR: {
-                    uchar uv = cast_to_gray_range( v );
-                    dst.set(x, y, uv);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-    void image_resize_fine_g_par( const Image& src, const int& nw, const int& nh, Image& dst ) {
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_GRAY | IT_F_GRAY );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-        float max_y  = static_cast<float>( src.h()-1 );
-        float max_x  = static_cast<float>( src.w()-1 );
-
-        DataType dtype = image_precision( src.type() );
-
-#pragma omp parallel for
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            if( ny >= max_y ) ny = max_y;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( nx >= max_x ) nx = max_x;
-                if( !src.is_inside_margin(nx, ny, 2) ) continue;
-                float v = src.get_bicubic(nx, ny);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, v); break;
-                case TYPE_UCHAR: {
-                    uchar uv = cast_to_gray_range( v );
-                    dst.set(x, y, uv);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-
-    void image_resize_fine_rgb( const Image& src, const int& nw, const int& nh, Image& dst ) {
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_PRGB | IT_U_IRGB | IT_F_IRGB | IT_F_PRGB );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-
-        DataType dtype = image_precision( src.type() );
-
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( !src.is_inside_margin(nx, ny, 2) ) continue;
-                float r, g, b;
-                src.get_bicubic(nx, ny, r, g, b);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, r, g, b); break;
-                case TYPE_UCHAR: {
-                    uchar ur = cast_to_gray_range( r );
-                    uchar ug = cast_to_gray_range( g );
-                    uchar ub = cast_to_gray_range( b );
-                    dst.set(x, y, ur, ug, ub);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-
-    void image_resize_fine_rgb_par( const Image& src, const int& nw, const int& nh, Image& dst ) {
-        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
-        src.passert_type( IT_U_PRGB | IT_U_IRGB | IT_F_IRGB | IT_F_PRGB );
-
-        dst.create( nw, nh, src.type() );
-        dst.zero();
-
-        float ratioy = static_cast<float>( src.h() ) / static_cast<float>(nh);
-        float ratiox = static_cast<float>( src.w() ) / static_cast<float>(nw);
-
-        DataType dtype = image_precision( src.type() );
-
-#pragma omp parallel for
-        for( int y=0; y<nh; y++ ) {
-            float ny = static_cast<float>(y)*ratioy;
-            for( int x=0; x<nw; x++ ) {
-                float nx = static_cast<float>(x)*ratiox;
-                if( !src.is_inside_margin(nx, ny, 2) ) continue;
-                float r, g, b;
-                src.get_bicubic(nx, ny, r, g, b);
-                switch( dtype ) {
-                case TYPE_FLOAT: dst.set(x, y, r, g, b); break;
-                case TYPE_UCHAR: {
-                    uchar ur = cast_to_gray_range( r );
-                    uchar ug = cast_to_gray_range( g );
-                    uchar ub = cast_to_gray_range( b );
-                    dst.set(x, y, ur, ug, ub);
-                } break;
-                default: switch_fatality();
-                }
-            }
-        }
-    }
-
-
     void image_resize_fine( const Image& src, const int& nw, const int& nh, bool run_parallel, Image& dst ) {
-        if( run_parallel ) {
-            switch( src.ch() ) {
-            case 1: image_resize_fine_g_par  ( src, nw, nh, dst ); break;
-            case 3: image_resize_fine_rgb_par( src, nw, nh, dst ); break;
-            default: switch_fatality();
-            }
-        } else {
-            switch( src.ch() ) {
-            case 1: image_resize_fine_g  ( src, nw, nh, dst ); break;
-            case 3: image_resize_fine_rgb( src, nw, nh, dst ); break;
-            default: switch_fatality();
-            }
-        }
+        image_resample( src, nw, nh, RESAMPLE_BICUBIC, run_parallel, dst, BORDER_REPLICATE );
     }
 
     void image_resize_fine  ( const Image& img, int max_img_dim, bool run_parallel, Image& rimg ) {
@@ -802,59 +482,11 @@ namespace kortex {
         image_resize_fine( img, nw, nh, run_parallel, rimg );
     }
 
-    void image_subtract( const Image& im0, const Image& im1, Image& out ) {
-        passert_statement( check_dimensions(im0,im1), "dimension mismatch" );
-        passert_statement( check_dimensions(im0,out), "dimension mismatch" );
-        im0.passert_type( IT_F_GRAY );
-        im1.passert_type( IT_F_GRAY );
-        out.passert_type( IT_F_GRAY );
-
-        int w = im0.w();
-        int h = im0.h();
-        for( int y=0; y<h; y++ ) {
-            const float* row0 = im0.get_row_f(y);
-            const float* row1 = im1.get_row_f(y);
-            float      * drow = out.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                drow[x] = row0[x]-row1[x];
-            }
-        }
-    }
-
-    void image_subtract_par( const Image& im0, const Image& im1, Image& out ) {
-        passert_statement( check_dimensions(im0,im1), "dimension mismatch" );
-        passert_statement( check_dimensions(im0,out), "dimension mismatch" );
-        im0.passert_type( IT_F_GRAY );
-        im1.passert_type( IT_F_GRAY );
-        out.passert_type( IT_F_GRAY );
-
-        int w = im0.w();
-        int h = im0.h();
-#pragma omp parallel for
-        for( int y=0; y<h; y++ ) {
-            const float* row0 = im0.get_row_f(y);
-            const float* row1 = im1.get_row_f(y);
-            float      * drow = out.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                drow[x] = row0[x]-row1[x];
-            }
-        }
-    }
-
     void image_add( const Image& img, float v, Image& out ) {
         img.passert_type( IT_F_GRAY );
         out.passert_type( IT_F_GRAY );
         assert_statement( check_dimensions(img,out), "dimension mismatch" );
-
-        int h = img.h();
-        int w = img.w();
-
-        for( int y=0; y<h; y++ ) {
-            const float* irow = img.get_row_f(y);
-            float      * orow = out.get_row_f(y);
-            for( int x=0; x<w; x++ )
-                orow[x] = irow[x] + v;
-        }
+        image_eval( expr(img) + v, false, out );
     }
 
     void image_add( const Image& im0, const Image& im1, Image& out ) {
@@ -866,13 +498,7 @@ namespace kortex {
         passert_statement( im0.type() == im1.type(), "type mismatch" );
         passert_statement( im0.type() == out.type(), "type mismatch" );
 
-        const float* ptr0 = im0.get_fptr();
-        const float* ptr1 = im1.get_fptr();
-        float      * optr = out.get_fptr();
-
-        size_t n_elems = im0.element_count();
-        for( size_t i=0; i<n_elems; i++ )
-            optr[i] = ptr0[i] + ptr1[i];
+        image_eval( expr(im0) + im1, false, out );
     }
 
     void image_add_par( const Image& im0, const Image& im1, Image& out ) {
@@ -884,61 +510,7 @@ namespace kortex {
         passert_statement( im0.type() == im1.type(), "type mismatch" );
         passert_statement( im0.type() == out.type(), "type mismatch" );
 
-        const float* ptr0 = im0.get_fptr();
-        const float* ptr1 = im1.get_fptr();
-        float      * optr = out.get_fptr();
-
-        size_t n_elems = im0.element_count();
-#pragma omp parallel for
-        for( size_t i=0; i<n_elems; i++ )
-            optr[i] = ptr0[i] + ptr1[i];
-    }
-
-    /// r = p/q for q(i,j) > 1e-6
-    void image_divide( const Image& p, const Image& q, Image& r ) {
-        assert_statement( check_dimensions(p,q), "dimension mismatch" );
-        assert_statement( check_dimensions(p,r), "dimension mismatch" );
-        p.assert_type( IT_F_GRAY );
-        q.assert_type( IT_F_GRAY );
-        r.assert_type( IT_F_GRAY );
-        int h = p.h();
-        int w = p.w();
-        for( int y=0; y<h; y++ ) {
-            const float* prow = p.get_row_f(y);
-            const float* qrow = q.get_row_f(y);
-            float      * rrow = r.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                if( fabs(qrow[x]) < 1e-6 ) {
-                    rrow[x] = 0.0f;
-                } else {
-                    rrow[x] = prow[x]/qrow[x];
-                }
-            }
-        }
-    }
-
-    /// r = p/q for q(i,j) > 1e-6
-    void image_divide_par( const Image& p, const Image& q, Image& r ) {
-        assert_statement( check_dimensions(p,q), "dimension mismatch" );
-        assert_statement( check_dimensions(p,r), "dimension mismatch" );
-        p.assert_type( IT_F_GRAY );
-        q.assert_type( IT_F_GRAY );
-        r.assert_type( IT_F_GRAY );
-        int h = p.h();
-        int w = p.w();
-#pragma omp parallel for
-        for( int y=0; y<h; y++ ) {
-            const float* prow = p.get_row_f(y);
-            const float* qrow = q.get_row_f(y);
-            float      * rrow = r.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                if( fabs(qrow[x]) < 1e-6 ) {
-                    rrow[x] = 0.0f;
-                } else {
-                    rrow[x] = prow[x]/qrow[x];
-                }
-            }
-        }
+        image_eval( expr(im0) + im1, true, out );
     }
 
     // r = p*q
@@ -948,16 +520,7 @@ namespace kortex {
         p.assert_type( IT_F_GRAY );
         q.assert_type( IT_F_GRAY );
         r.assert_type( IT_F_GRAY );
-        int h = p.h();
-        int w = p.w();
-        for( int y=0; y<h; y++ ) {
-            const float* prow = p.get_row_f(y);
-            const float* qrow = q.get_row_f(y);
-            float      * rrow = r.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                rrow[x] = prow[x]*qrow[x];
-            }
-        }
+        image_eval( expr(p)*q, false, r );
     }
 
     // r = p*q
@@ -967,17 +530,7 @@ namespace kortex {
         p.assert_type( IT_F_GRAY );
         q.assert_type( IT_F_GRAY );
         r.assert_type( IT_F_GRAY );
-        int h = p.h();
-        int w = p.w();
-#pragma omp parallel for
-        for( int y=0; y<h; y++ ) {
-            const float* prow = p.get_row_f(y);
-            const float* qrow = q.get_row_f(y);
-            float      * rrow = r.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                rrow[x] = prow[x]*qrow[x];
-            }
-        }
+        image_eval( expr(p)*q, true, r );
     }
 
     /// r = o + p*q
@@ -989,17 +542,7 @@ namespace kortex {
         q.assert_type( IT_F_GRAY );
         r.assert_type( IT_F_GRAY );
         o.assert_type( IT_F_GRAY );
-        int h = p.h();
-        int w = p.w();
-        for( int y=0; y<h; y++ ) {
-            const float* prow = p.get_row_f(y);
-            const float* qrow = q.get_row_f(y);
-            const float* rrow = r.get_row_f(y);
-            float      * orow = o.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                orow[x] = rrow[x] + prow[x]*qrow[x];
-            }
-        }
+        image_eval( expr(p)*q + r, false, o );
     }
 
 
@@ -1012,18 +555,7 @@ namespace kortex {
         q.assert_type( IT_F_GRAY );
         r.assert_type( IT_F_GRAY );
         o.assert_type( IT_F_GRAY );
-        int h = p.h();
-        int w = p.w();
-#pragma omp parallel for
-        for( int y=0; y<h; y++ ) {
-            const float* prow = p.get_row_f(y);
-            const float* qrow = q.get_row_f(y);
-            const float* rrow = r.get_row_f(y);
-            float      * orow = o.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                orow[x] = rrow[x] + prow[x]*qrow[x];
-            }
-        }
+        image_eval( expr(p)*q + r, true, o );
     }
 
     /// q = s * p
@@ -1033,96 +565,9 @@ namespace kortex {
 
         p.passert_type( IT_F_GRAY | IT_F_IRGB | IT_F_PRGB );
 
-        size_t psz = p.element_count();
-
-        const float* pptr = p.get_fptr();
-        float      * qptr = q.get_fptr();
-
-        if( run_parallel ) {
-#pragma omp parallel for
-            for( size_t i=0; i<psz; i++ ) {
-                qptr[i] = s * pptr[i];
-            }
-        } else {
-            for( size_t i=0; i<psz; i++ )
-                qptr[i] = s * pptr[i];
-        }
-
-    }
-
-    /// checks whether p has values of either 0 or 1
-    bool is_binarized_u( const Image& p ) {
-        assert_statement( !p.is_empty(), "passed empty image" );
-        p.assert_type( IT_U_GRAY );
-        int sz = p.pixel_count();
-        const uchar* row = p.get_row_u(0);
-        for( int i=0; i<sz; i++ ) {
-            if( row[i] == 0 ) continue;
-            if( row[i] == 1 ) continue;
-            return false;
-        }
-        return true;
-    }
-
-    /// checks whether p has values of either 0.0f or 1.0f
-    bool is_binarized_f( const Image& p ) {
-        assert_statement( !p.is_empty(), "passed empty image" );
-        p.assert_type( IT_F_GRAY );
-        int sz = p.pixel_count();
-        const float* prow = p.get_row_f(0);
-        for( int i=0; i<sz; i++ ) {
-            if( prow[i] == 0.0f ) continue;
-            if( prow[i] == 1.0f ) continue;
-            return false;
-        }
-        return true;
-    }
-
-    /// checks whether p has values of either 0.0f or 1.0f
-    bool is_binarized( const Image& p ) {
-        assert_statement( !p.is_empty(), "passed empty image" );
-        p.assert_type( IT_F_GRAY | IT_U_GRAY );
-        switch( p.type() ) {
-        case IT_U_GRAY: return is_binarized_u(p);
-        case IT_F_GRAY: return is_binarized_f(p);
-        default       : logman_fatal_g( "invalid image type [%d]", p.type() );
-        }
+        image_eval( s * expr(p), run_parallel, q );
     }
 
-    /// checks whether p has values in the range [0.0f 1.0f]
-    bool is_normalized( const Image& p ) {
-        assert_statement( !p.is_empty(), "passed empty image" );
-        p.assert_type( IT_F_GRAY );
-        int sz = p.pixel_count();
-        const float* prow = p.get_row_f(0);
-        for( int i=0; i<sz; i++ ) {
-            if( prow[i] < 0.0f ) return false;
-            if( prow[i] > 1.0f ) return false;
-        }
-        return true;
-    }
-
-
-    /// checks whether p and q are non-zero for the same pixel
-    bool does_overlap( const Image& p, const Image& q ) {
-        assert_statement( check_dimensions(p,q), "dimension mismatch" );
-        p.assert_type( IT_F_GRAY );
-        q.assert_type( IT_F_GRAY );
-        int w = p.w();
-        int h = p.h();
-        for( int y=0; y<h; y++ ) {
-            const float* prow = p.get_row_f(y);
-            const float* qrow = q.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                if( (prow[x] != 0.0f)  && ( qrow[x] != 0.0f ) ) {
-                    return true;
-                }
-            }
-        }
-        return false;
-    }
-
-
     void init_gaussian_weight_mask( Image& mask ) {
         assert_statement( !mask.is_empty(), "passed empty mask" );
         mask.assert_type( IT_F_GRAY );
@@ -1175,6 +620,22 @@ namespace kortex {
         }
     }
 
+    void init_feather_weight_mask( const Image& mask, const float& feather, const bool& run_parallel, Image& weights ) {
+        passert_statement( feather > 0.0f, "invalid feather width" );
+        mask_distance_transform( mask, false, run_parallel, weights );
+        int   w = weights.w();
+        int   h = weights.h();
+        float ifeather = 1.0f / feather;
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            float* wp = weights.get_row_f(y);
+            for( int x=0; x<w; x++ ) {
+                float d = wp[x];
+                wp[x] = d > 0.0f ? 254.0f * std::min( d*ifeather, 1.0f ) + 1.0f : 0.0f;
+            }
+        }
+    }
+
     ///
     /// assumes image_threshold is called first over mask.
     ///
@@ -1184,44 +645,12 @@ namespace kortex {
         assert_statement( !mask.is_empty(), "passed empty image" );
         assert_statement( is_binarized( mask ), "passed image is not binarized" );
 
-        // how much pixels to erode
-        float kernel[255];
-        int ksz = 2*er_size+1;
-        assert_statement( ksz <= 255, "buffer overflow" );
-        for(int i=0; i<ksz; i++)
-            kernel[i] = 1.0f;
-        filter_hv( mask, kernel, ksz, mask );
-        image_threshold( mask, float(ksz*ksz-1) );
+        // outside_is_background: pixels beyond the image borders count as
+        // background, so the erosion eats in from the borders as before
+        mask_morphology( mask, MORPH_ERODE, er_size, er_size, false, mask, true );
     }
 
 
-    /// maps the src image to 0.0 -> 1.0 range linearly. assumes the original
-    /// image is of type IT_F_GRAY
-    void image_linearize( const Image& src, Image& dst ) {
-        src.assert_type( IT_F_GRAY );
-        dst.assert_type( IT_F_GRAY );
-        assert_statement( check_dimensions(src,dst), "dimension mismatch" );
-        assert_statement( !src.is_empty(), "empty image" );
-
-        float mins, maxs;
-        image_min_max( src, 0, 0, src.w(), src.h(), mins, maxs );
-
-        float srange = maxs - mins;
-        if( fabs(srange ) < 1e-8 ) {
-            logman_warning_g( "image range is too low [%f %f]", mins, maxs );
-            dst.zero();
-            return;
-        }
-        float isrange = 1.0f/srange;
-
-        const float* sptr = src.get_row_f(0);
-        float      * dptr = dst.get_row_f(0);
-        int pc = src.pixel_count();
-        for( int i=0; i<pc; i++ ) {
-            dptr[i] = ( sptr[i] - mins ) * isrange;
-        }
-    }
-
     void image_normalize( const Image& src, bool standard, bool parallel, Image& dst ) {
         src.assert_type( IT_F_GRAY );
         dst.assert_type( IT_F_GRAY );
@@ -1230,7 +659,7 @@ namespace kortex {
         float nrm = 1.0f/255.0f;
         if( !standard ) {
             float minv, maxv;
-            image_min_max( src, minv, maxv );
+            image_min_max( src, minv, maxv, parallel );
             nrm = std::max( std::fabs(minv), std::fabs(maxv) );
             assert_statement( nrm > 1e-16, "nrm is dangerously close to 0" );
             nrm = 1.0f/nrm;
@@ -1250,47 +679,14 @@ namespace kortex {
         src.assert_type( IT_F_GRAY );
         assert_statement( !src.is_empty(), "empty image" );
         assert_noalias( src, mag );
-
-        mag.create( src.w(), src.h(), IT_F_GRAY );
-        mag.zero();
-
-        Image dx, dy;
-        image_gradient( src, "simple", dx, dy );
-
-        const float* xptr = dx.get_row_f(0);
-        const float* yptr = dy.get_row_f(0);
-        float      * mptr = mag.get_row_f(0);
-        int pc = src.pixel_count();
-
-        if( run_parallel ) {
-#pragma omp parallel for
-            for( int i=0; i<pc; i++ ) {
-                mptr[i] = std::sqrt( sq( xptr[i] ) + sq( yptr[i] ) );
-            }
-        } else {
-            for( int i=0; i<pc; i++ ) {
-                mptr[i] = std::sqrt( sq( xptr[i] ) + sq( yptr[i] ) );
-            }
-        }
+        image_gradients( src, GRADIENT_SIMPLE, 1, run_parallel, NULL, NULL, &mag, NULL );
     }
 
     void image_clip_lower( const Image& src, float min_v, bool run_parallel, Image& out ) {
         src.assert_type( IT_F_GRAY );
         passert_statement( check_dimensions(src,out), "image dimension mismatch" );
 
-        const float* sptr = src.get_row_f(0);
-        float*       optr = out.get_row_f(0);
-
-        if( !run_parallel ) {
-            for( int i=0; i<src.pixel_count(); i++ ) {
-                optr[i] = std::max( min_v, sptr[i] );
-            }
-        } else {
-#pragma omp parallel for
-            for( int i=0; i<src.pixel_count(); i++ ) {
-                optr[i] = std::max( min_v, sptr[i] );
-            }
-        }
+        image_eval( max( expr(src), min_v ), run_parallel, out );
     }
 
 
@@ -1298,51 +694,7 @@ namespace kortex {
         src.assert_type( IT_F_GRAY );
         passert_statement( check_dimensions(src,out), "image dimension mismatch" );
 
-        const float* sptr = src.get_row_f(0);
-        float*       optr = out.get_row_f(0);
-
-        if( !run_parallel ) {
-            for( int i=0; i<src.pixel_count(); i++ ) {
-                optr[i] = std::max( min_v, std::min( sptr[i], max_v ) );
-            }
-        } else {
-#pragma omp parallel for
-            for( int i=0; i<src.pixel_count(); i++ ) {
-                optr[i] = std::max( min_v, std::min( sptr[i], max_v ) );
-            }
-        }
-    }
-
-    void image_stretch( const Image& src, float minv, float maxv, Image& out ) {
-        src.assert_type( IT_F_GRAY );
-        passert_noalias( src, out );
-
-        float scale = 1.0f;
-        if( minv == 0.0f && maxv == 0.0f ) {
-            if( !image_min_max( src, 0, 0, src.w(), src.h(), minv, maxv ) ) {
-                logman_error("min max range for the image could not be found");
-                minv = 0.0f;
-                maxv = 0.0f;
-                scale = 1.0f;
-            } else {
-                scale = 255.0f / ( maxv - minv );
-            }
-        } else {
-            scale = 255.0f / ( maxv - minv );
-        }
-
-        out.create( src.w(), src.h(), IT_U_GRAY );
-        out.zero();
-
-        for( int y=0; y<src.h(); y++ ) {
-            const float* srow = src.get_row_f(y);
-            uchar      * orow = out.get_row_u(y);
-            for( int x=0; x<src.w(); x++ ) {
-                const float& v = srow[x];
-                if( is_a_number(v) )
-                    orow[x] = cast_to_gray_range( (v-minv)*scale );
-            }
-        }
+        image_eval( clip( expr(src), min_v, max_v ), run_parallel, out );
     }
 
     void image_abs( const Image& img, bool run_parallel, Image& out ) {
@@ -1350,36 +702,7 @@ namespace kortex {
         passert_statement( check_dimensions( img, out ), "dimension mismatch" );
         passert_statement( img.type() == out.type(), "image types do not agree" );
 
-        size_t psz = img.element_count();
-        const float* iptr = img.get_fptr();
-        float      * optr = out.get_fptr();
-
-        if( !run_parallel ) {
-            for( size_t i=0; i<psz; i++ )
-                optr[i] = std::fabs( iptr[i] );
-        } else {
-#pragma omp parallel for
-            for( size_t i=0; i<psz; i++ ) {
-                optr[i] = std::fabs( iptr[i] );
-            }
-        }
-    }
-
-    void image_negate( const Image& img, Image& out ) {
-        img.passert_type( IT_F_GRAY );
-        out.passert_type( IT_F_GRAY );
-        assert_statement( check_dimensions(img,out), "dimension mismatch" );
-
-        int h = img.h();
-        int w = img.w();
-
-        for( int y=0; y<h; y++ ) {
-            const float* irow = img.get_row_f(y);
-            float      * orow = out.get_row_f(y);
-            for( int x=0; x<w; x++ ) {
-                orow[x] = -irow[x];
-            }
-        }
+        image_eval( expr_abs( expr(img) ), run_parallel, out );
     }
 
     void image_gradient( const Image& img, const char* gtype, Image& gx, Image& gy ) {
@@ -1396,48 +719,12 @@ namespace kortex {
 
     void image_gradient_prewitt( const Image& img, Image& gx, Image& gy ) {
         img.passert_type( IT_F_GRAY );
-        int h = img.h();
-        int w = img.w();
-
-        gx.create( w, h, IT_F_GRAY ); gx.zero();
-        gy.create( w, h, IT_F_GRAY ); gy.zero();
-
-        float filter1[] = { -1.0f/2.0f, 0.0f,      1.0f/2.0f };
-        float filter2[] = {  1.0f/3.0f, 1.0f/3.0f, 1.0f/3.0f };
-
-        Image timg(w, h, IT_F_GRAY);
-
-        filter_hor( img,  filter1, 3, gx );
-        filter_ver( gx,   filter2, 3      );
-
-        filter_hor( img,  filter2, 3, gy );
-        filter_ver( gy,   filter1, 3      );
-
-        image_reset_boundary( gx, 1 );
-        image_reset_boundary( gy, 1 );
+        image_gradients( img, GRADIENT_PREWITT, 1, false, &gx, &gy, NULL, NULL );
     }
 
     void image_gradient_sobel( const Image& img, Image& gx, Image& gy ) {
         img.passert_type( IT_F_GRAY );
-        int h = img.h();
-        int w = img.w();
-
-        gx.create( w, h, IT_F_GRAY ); gx.zero();
-        gy.create( w, h, IT_F_GRAY ); gy.zero();
-
-        float filter1[] = { -1.0f/2.0f, 0.0f,      1.0f/2.0f };
-        float filter2[] = {  1.0f/4.0f, 2.0f/4.0f, 1.0f/4.0f };
-
-        Image timg(w, h, IT_F_GRAY);
-
-        filter_hor( img,  filter1, 3, gx );
-        filter_ver( gx,   filter2, 3      );
-
-        filter_hor( img,  filter2, 3, gy );
-        filter_ver( gy,   filter1, 3      );
-
-        image_reset_boundary( gx, 1 );
-        image_reset_boundary( gy, 1 );
+        image_gradients( img, GRADIENT_SOBEL, 1, false, &gx, &gy, NULL, NULL );
     }
 
     void image_gradient_simple(const float* im, int w, int h, float* dx, float* dy) {
@@ -1479,7 +766,7 @@ namespace kortex {
 
         // x=1:w-1; y=h-1
         for( int x=1; x<w-1; x++ ) {
-            dx[ (h-1)*w + x ] = im[ x+1 ] - im[ x-1 ];
+            dx[ (h-1)*w + x ] = im[ (h-1)*w + x+1 ] - im[ (h-1)*w + x-1 ];
             dy[ (h-1)*w + x ] = 2.0f * ( im[ (h-2)*w + x ] - im[ (h-1)*w + x ] );
         }
 
@@ -1505,11 +792,7 @@ namespace kortex {
 
     void image_gradient_simple( const Image& img, Image& gx, Image& gy ) {
         img.passert_type( IT_F_GRAY );
-        int w = img.w();
-        int h = img.h();
-        gx.create( w, h, IT_F_GRAY );
-        gy.create( w, h, IT_F_GRAY );
-        image_gradient_simple( img.get_row_f(0), w, h, gx.get_row_f(0), gy.get_row_f(0) );
+        image_gradients( img, GRADIENT_SIMPLE, 1, false, &gx, &gy, NULL, NULL );
     }
 
     void image_reset_boundary( Image& img, int nb ) {
@@ -1546,74 +829,6 @@ namespace kortex {
 //
 //
 
-    // inverts a binary uchar image - allows aliasing
-    void mask_invert( const Image& img, Image& out ) {
-        passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.assert_type( IT_U_GRAY );
-        out.assert_type( IT_U_GRAY );
-        assert_statement( is_binarized(img), "image needs to be binarized" );
-
-        const uchar* src = img.get_row_u(0);
-        uchar      * dst = out.get_row_u(0);
-
-        int sz  = img.pixel_count();
-        for( int i=0; i<sz; i++ ) {
-            if( src[i] ) dst[i] = 0;
-            else         dst[i] = 1;
-        }
-    }
-
-    // labels pixels with color v as 1, 0 otherwise. allows aliasing
-    void pick_pixels_with_color( const Image& img, const uchar& v, Image& out ) {
-        passert_statement( check_dimensions(img, out), "dimension mismatch" );
-        img.assert_type( IT_U_GRAY );
-        out.assert_type( IT_U_GRAY );
-
-        const uchar* src = img.get_row_u(0);
-        uchar      * dst = out.get_row_u(0);
-
-        int sz  = img.pixel_count();
-        for( int i=0; i<sz; i++ ) {
-            if( src[i] == v ) dst[i] = 1;
-            else              dst[i] = 0;
-        }
-    }
-
-
-    void apply_pixelwise_operation( const Image& p, PixelOperator op, bool run_parallel, Image& q ) {
-        p.assert_type( IT_F_GRAY );
-        q.assert_type( IT_F_GRAY );
-        passert_statement( check_dimensions(p,q), "dimension mismatch" );
-
-        int sz = p.pixel_count();
-        const float* src = p.get_row_f(0);
-        float      * dst = q.get_row_f(0);
-
-        if( run_parallel ) {
-#pragma omp parallel for
-            for( int i=0; i<sz; i++ ) {
-                dst[i] = op( src[i] );
-            }
-        } else {
-            for( int i=0; i<sz; i++ ) {
-                dst[i] = op( src[i] );
-            }
-        }
-    }
-
-    void binarize_image( const Image& src, Image& dst ) {
-        src.passert_type( IT_U_GRAY );
-        dst.passert_type( IT_U_GRAY );
-        passert_statement( check_dimensions(src,dst), "dimension mismatch" );
-        int sz = src.pixel_count();
-        const uchar* srow = src.get_row_u(0);
-        uchar      * drow = dst.get_row_u(0);
-        for( int i=0; i<sz; i++ ) {
-            if( srow[i] > 0 ) drow[i] = 1;
-            else              drow[i] = 0;
-        }
-    }
-
     void insert_image_to_channel( const Image& im, int cid, Image& out ) {
         passert_statement( check_dimensions(im,out), "dimension mismatch" );
         passert_statement( im.ch() == 1, "input image channel should be 1" );
@@ -1622,21 +837,20 @@ namespace kortex {
         passert_boundary( cid, 0, 3 );
         passert_statement( out.channel_type() == ITC_IMAGE, "output channel should be image ordered" );
 
+        int    w  = im.w();
+        int    h  = im.h();
+        size_t os = out.stride();
         switch( im.precision() ) {
         case TYPE_FLOAT: {
-            const float* iptr = im.get_fptr();
-            float      * optr = out.get_channel_f(cid);
-            int pix_count = im.pixel_count();
-            for( int i=0; i<pix_count; i++ )
-                optr[i] = iptr[i];
+            float* optr = out.get_channel_f(cid);
+            for( int y=0; y<h; y++ )
+                memcpy( optr + y*os, im.get_row_f(y), sizeof(*optr)*w );
         } break;
 
         case TYPE_UCHAR: {
-            const uchar* iptr = im.get_uptr();
-            uchar      * optr = out.get_channel_u(cid);
-            int pix_count = im.pixel_count();
-            for( int i=0; i<pix_count; i++ )
-                optr[i] = iptr[i];
+            uchar* optr = out.get_channel_u(cid);
+            for( int y=0; y<h; y++ )
+                memcpy( optr + y*os, im.get_row_u(y), sizeof(*optr)*w );
         } break;
         default:
             switch_fatality();
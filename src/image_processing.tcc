@@ -16,7 +16,7 @@
 namespace kortex {
 
     template<typename T>
-    float bilinear_interpolation( const T* img, const int& w, const int& h, const int& nc, const int& c, const float& x, const float& y ) {
+    float bilinear_interpolation( const T* img, const int& w, const int& h, const int& nc, const int& c, const float& x, const float& y, const int& stride ) {
         assert_pointer( img );
         passert_statement_g( x>=0.0f && x<float(w) && y>=0.0f && y<float(h), "[x %f][y %f] [w %d] [h %d]", x, y, w, h );
 
@@ -31,8 +31,9 @@ namespace kortex {
         assert_statement( is_inside(x0,0,w) && is_inside(x1,0,w), "coords oob" );
         assert_statement( is_inside(y0,0,h) && is_inside(y1,0,h), "coords oob" );
 
-        const T* I = img + y0*w*nc + c;
-        const T* J = img + y1*w*nc + c;
+        const int rs = stride ? stride : w*nc;
+        const T* I = img + y0*rs + c;
+        const T* J = img + y1*rs + c;
 
         x0 = x0 * nc;
         x1 = x1 * nc;
@@ -54,18 +55,19 @@ namespace kortex {
     /// computes the bicubic interpolation at y, x for channel ch for a
     /// color-image. assumes rgb values are sequential for pixels
     template<typename T>
-    float bicubic_interpolation(const T* im, const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y) {
+    float bicubic_interpolation(const T* im, const int& w, const int& h, const int& nc, const int& ch, const float& x, const float& y, const int& stride) {
         assert_pointer( im );
         int iy=int(y);
         int ix=int(x);
         assert_statement( is_inside(ix,0,w) && is_inside(iy,0,h), "coords oob" );
 
+        const int rs = stride ? stride : w*nc;
         if ((ix < 2) || (iy < 2) || (ix >= w-3) || (iy >= h-3))
-            return (float)im[ iy*w*nc + nc*ix + ch ];
+            return (float)im[ iy*rs + nc*ix + ch ];
 
         float p = x - ix; // sub-pixel offset in the x axis
         float q = y - iy; // sub-pixel offset in the y axis
-        int offset = (iy-1)*w*nc + (ix-1)*nc + ch; // position of the top-left point
+        int offset = (iy-1)*rs + (ix-1)*nc + ch; // position of the top-left point
 
         float N[16];
         for(int i = 0; i < 4; ++i) {
@@ -73,7 +75,7 @@ namespace kortex {
             N[4*i+1] = im[offset +   nc];
             N[4*i+2] = im[offset + 2*nc];
             N[4*i+3] = im[offset + 3*nc];
-            offset += w*nc;
+            offset += rs;
         }
 
         // interpolate in the x direction
@@ -0,0 +1,641 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/image_stats.h>
+#include <kortex/image_processing.h>
+#include <kortex/image.h>
+#include <kortex/filter.h>
+#include <kortex/check.h>
+
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+using std::vector;
+
+namespace kortex {
+
+    /// samples per block of the reductions
+    const int STAT_BLOCK = 16384;
+
+    /// sse2 products of uchar squares are summed in 32 bit lanes for at
+    /// most this many iterations
+    const int STAT_U8_FLUSH = 4096;
+
+    struct StatAccum {
+        double mn, mx, s, s2;
+        size_t cnt, nan;
+
+        void init() {
+            mn  =  std::numeric_limits<double>::infinity();
+            mx  = -std::numeric_limits<double>::infinity();
+            s   = s2 = 0.0;
+            cnt = nan = 0;
+        }
+        void merge( const StatAccum& b ) {
+            mn   = std::min( mn, b.mn );
+            mx   = std::max( mx, b.mx );
+            s   += b.s;
+            s2  += b.s2;
+            cnt += b.cnt;
+            nan += b.nan;
+        }
+    };
+
+    /// the rows [ly,uy) of the region cut into blocks of about STAT_BLOCK
+    /// samples. every row is one segment per plane of an image ordered
+    /// image and one segment otherwise.
+    struct StatRegion {
+        int lx, ux, ly, uy;
+        int n_planes, seg_len, rows_per_block, n_blocks;
+
+        StatRegion( const Image& img, const Rect2i* roi ) {
+            lx = 0; ux = img.w(); ly = 0; uy = img.h();
+            if( roi ) {
+                lx = std::max( roi->lx, lx ); ux = std::min( roi->ux, ux );
+                ly = std::max( roi->ly, ly ); uy = std::min( roi->uy, uy );
+            }
+            if( ux < lx ) ux = lx;
+            if( uy < ly ) uy = ly;
+            bool planar    = image_channel_type( img.type() ) == ITC_IMAGE;
+            n_planes       = planar ? img.ch() : 1;
+            seg_len        = ( ux - lx ) * ( planar ? 1 : img.ch() );
+            rows_per_block = std::max( 1, STAT_BLOCK / std::max( 1, seg_len*n_planes ) );
+            n_blocks       = ( uy - ly + rows_per_block - 1 ) / rows_per_block;
+            if( !seg_len ) n_blocks = 0;
+        }
+    };
+
+    inline const float* stat_row( const Image& img, const float*, const int& y, const int& c, const int& x ) {
+        if( img.type() == IT_F_IRGB ) return img.get_row_fi( y, c ) + x;
+        return img.get_row_f( y ) + x*img.ch();
+    }
+    inline const uchar* stat_row( const Image& img, const uchar*, const int& y, const int& c, const int& x ) {
+        if( img.type() == IT_U_IRGB ) return img.get_row_ui( y, c ) + x;
+        return img.get_row_u( y ) + x*img.ch();
+    }
+    inline const int*   stat_row( const Image& img, const int*,   const int& y, const int&,   const int& x ) {
+        return img.get_row_i( y ) + x;
+    }
+
+    inline bool stat_sse() {
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        return sse;
+    }
+
+    /// the early-exit flag of a parallel scan - set by any thread, polled
+    /// by all of them between rows
+    inline bool stat_done( const int& done ) {
+        int v;
+#pragma omp atomic read
+        v = done;
+        return v != 0;
+    }
+    inline void stat_set_done( int& done ) {
+#pragma omp atomic write
+        done = 1;
+    }
+
+    /// combines the block results pairwise: 0+1, 2+3, .. then 0+2, ..
+    template<typename T>
+    void stat_tree( vector<T>& part ) {
+        int n = int( part.size() );
+        for( int step=1; step<n; step*=2 ) {
+            for( int i=0; i+step<n; i+=2*step )
+                part[i].merge( part[i+step] );
+        }
+    }
+
+    //
+    // statistics of one segment
+    //
+
+    inline void stat_segment( const float* p, const int& n, const int& flags, const bool& sse, StatAccum& a ) {
+        const bool  ab = ( flags & STAT_ABS     ) != 0;
+        const bool  mm = ( flags & STAT_MIN_MAX ) != 0;
+        const bool  sm = ( flags & STAT_SUM     ) != 0;
+        const bool  sq = ( flags & STAT_SUM_SQ  ) != 0;
+        const float inf = std::numeric_limits<float>::infinity();
+        float  mn = inf, mx = -inf;
+        double s  = 0.0, s2 = 0.0;
+        size_t valid = 0;
+        int    i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 sgn = _mm_set1_ps( -0.0f );
+            __m128  vmn = _mm_set1_ps( inf ), vmx = _mm_set1_ps( -inf );
+            __m128d s0  = _mm_setzero_pd(), s1 = s0, q0 = s0, q1 = s0;
+            __m128i vc  = _mm_setzero_si128();
+            for( ; i+4<=n; i+=4 ) {
+                __m128 v = _mm_loadu_ps( p+i );
+                if( ab ) v = _mm_andnot_ps( sgn, v );
+                __m128 ord = _mm_cmpord_ps( v, v );
+                vc = _mm_sub_epi32( vc, _mm_castps_si128( ord ) );
+                if( mm ) {
+                    // a nan first operand returns the second
+                    vmn = _mm_min_ps( v, vmn );
+                    vmx = _mm_max_ps( v, vmx );
+                }
+                if( sm || sq ) {
+                    v = _mm_and_ps( v, ord );
+                    __m128d lo = _mm_cvtps_pd( v );
+                    __m128d hi = _mm_cvtps_pd( _mm_movehl_ps( v, v ) );
+                    if( sm ) { s0 = _mm_add_pd( s0, lo ); s1 = _mm_add_pd( s1, hi ); }
+                    if( sq ) { q0 = _mm_add_pd( q0, _mm_mul_pd( lo, lo ) ); q1 = _mm_add_pd( q1, _mm_mul_pd( hi, hi ) ); }
+                }
+            }
+            float  fm[8];
+            double ds[4];
+            int    ic[4];
+            _mm_storeu_ps( fm, vmn ); _mm_storeu_ps( fm+4, vmx );
+            for( int k=0; k<4; k++ ) {
+                mn = std::min( mn, fm[k] );
+                mx = std::max( mx, fm[4+k] );
+            }
+            _mm_storeu_pd( ds, _mm_add_pd( s0, s1 ) ); _mm_storeu_pd( ds+2, _mm_add_pd( q0, q1 ) );
+            s  = ds[0] + ds[1];
+            s2 = ds[2] + ds[3];
+            _mm_storeu_si128( (__m128i*)ic, vc );
+            valid = size_t( ic[0] ) + ic[1] + ic[2] + ic[3];
+        }
+#endif
+        for( ; i<n; i++ ) {
+            float v = ab ? std::fabs( p[i] ) : p[i];
+            if( v != v ) continue;
+            valid++;
+            mn  = std::min( mn, v );
+            mx  = std::max( mx, v );
+            s  += v;
+            s2 += double( v ) * v;
+        }
+        a.cnt += valid;
+        a.nan += n - valid;
+        if( mm ) { a.mn = std::min( a.mn, double( mn ) ); a.mx = std::max( a.mx, double( mx ) ); }
+        if( sm ) a.s  += s;
+        if( sq ) a.s2 += s2;
+    }
+
+    inline void stat_segment( const uchar* p, const int& n, const int& flags, const bool& sse, StatAccum& a ) {
+        const bool mm = ( flags & STAT_MIN_MAX ) != 0;
+        const bool sm = ( flags & STAT_SUM     ) != 0;
+        const bool sq = ( flags & STAT_SUM_SQ  ) != 0;
+        int    mn = 255, mx = 0;
+        size_t s  = 0, s2 = 0;
+        int    i  = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128i z = _mm_setzero_si128();
+            __m128i vmn = _mm_set1_epi8( char(0xff) ), vmx = z;
+            __m128i vs  = z, vq = z, vq64 = z;
+            int     it  = 0;
+            for( ; i+16<=n; i+=16 ) {
+                __m128i v = _mm_loadu_si128( (const __m128i*)( p+i ) );
+                if( mm ) {
+                    vmn = _mm_min_epu8( vmn, v );
+                    vmx = _mm_max_epu8( vmx, v );
+                }
+                if( sm ) vs = _mm_add_epi64( vs, _mm_sad_epu8( v, z ) );
+                if( sq ) {
+                    __m128i lo = _mm_unpacklo_epi8( v, z );
+                    __m128i hi = _mm_unpackhi_epi8( v, z );
+                    vq = _mm_add_epi32( vq, _mm_add_epi32( _mm_madd_epi16( lo, lo ), _mm_madd_epi16( hi, hi ) ) );
+                    if( ++it == STAT_U8_FLUSH ) {
+                        vq64 = _mm_add_epi64( vq64, _mm_add_epi64( _mm_unpacklo_epi32( vq, z ), _mm_unpackhi_epi32( vq, z ) ) );
+                        vq   = z;
+                        it   = 0;
+                    }
+                }
+            }
+            vq64 = _mm_add_epi64( vq64, _mm_add_epi64( _mm_unpacklo_epi32( vq, z ), _mm_unpackhi_epi32( vq, z ) ) );
+            uchar   bm[32];
+            long long ls[4];
+            _mm_storeu_si128( (__m128i*)bm, vmn ); _mm_storeu_si128( (__m128i*)( bm+16 ), vmx );
+            for( int k=0; k<16; k++ ) {
+                mn = std::min( mn, int( bm[k]    ) );
+                mx = std::max( mx, int( bm[16+k] ) );
+            }
+            _mm_storeu_si128( (__m128i*)ls, vs ); _mm_storeu_si128( (__m128i*)( ls+2 ), vq64 );
+            s  = size_t( ls[0] + ls[1] );
+            s2 = size_t( ls[2] + ls[3] );
+        }
+#endif
+        for( ; i<n; i++ ) {
+            int v = p[i];
+            mn  = std::min( mn, v );
+            mx  = std::max( mx, v );
+            s  += v;
+            s2 += v*v;
+        }
+        a.cnt += n;
+        if( mm ) { a.mn = std::min( a.mn, double( mn ) ); a.mx = std::max( a.mx, double( mx ) ); }
+        if( sm ) a.s  += double( s  );
+        if( sq ) a.s2 += double( s2 );
+    }
+
+    inline void stat_segment( const int* p, const int& n, const int& flags, const bool& sse, StatAccum& a ) {
+        const bool ab = ( flags & STAT_ABS     ) != 0;
+        const bool mm = ( flags & STAT_MIN_MAX ) != 0;
+        const bool sm = ( flags & STAT_SUM     ) != 0;
+        const bool sq = ( flags & STAT_SUM_SQ  ) != 0;
+        double mn = std::numeric_limits<double>::infinity(), mx = -mn;
+        double s  = 0.0, s2 = 0.0;
+        int    i  = 0;
+#ifdef WITH_SSE
+        // |INT_MIN| does not fit in the lanes - abs runs on the scalar path
+        if( sse && !ab ) {
+            __m128i vmn = _mm_set1_epi32( INT_MAX ), vmx = _mm_set1_epi32( INT_MIN );
+            __m128d s0  = _mm_setzero_pd(), s1 = s0, q0 = s0, q1 = s0;
+            for( ; i+4<=n; i+=4 ) {
+                __m128i v = _mm_loadu_si128( (const __m128i*)( p+i ) );
+                if( mm ) {
+                    __m128i lt = _mm_cmpgt_epi32( vmn, v );
+                    __m128i gt = _mm_cmpgt_epi32( v, vmx );
+                    vmn = _mm_or_si128( _mm_and_si128( lt, v ), _mm_andnot_si128( lt, vmn ) );
+                    vmx = _mm_or_si128( _mm_and_si128( gt, v ), _mm_andnot_si128( gt, vmx ) );
+                }
+                if( sm || sq ) {
+                    __m128d lo = _mm_cvtepi32_pd( v );
+                    __m128d hi = _mm_cvtepi32_pd( _mm_shuffle_epi32( v, _MM_SHUFFLE(1,0,3,2) ) );
+                    if( sm ) { s0 = _mm_add_pd( s0, lo ); s1 = _mm_add_pd( s1, hi ); }
+                    if( sq ) { q0 = _mm_add_pd( q0, _mm_mul_pd( lo, lo ) ); q1 = _mm_add_pd( q1, _mm_mul_pd( hi, hi ) ); }
+                }
+            }
+            int    im[8];
+            double ds[4];
+            _mm_storeu_si128( (__m128i*)im, vmn ); _mm_storeu_si128( (__m128i*)( im+4 ), vmx );
+            if( i ) {
+                for( int k=0; k<4; k++ ) {
+                    mn = std::min( mn, double( im[k]   ) );
+                    mx = std::max( mx, double( im[4+k] ) );
+                }
+            }
+            _mm_storeu_pd( ds, _mm_add_pd( s0, s1 ) ); _mm_storeu_pd( ds+2, _mm_add_pd( q0, q1 ) );
+            s  = ds[0] + ds[1];
+            s2 = ds[2] + ds[3];
+        }
+#endif
+        for( ; i<n; i++ ) {
+            double v = ab ? std::fabs( double( p[i] ) ) : double( p[i] );
+            mn  = std::min( mn, v );
+            mx  = std::max( mx, v );
+            s  += v;
+            s2 += v*v;
+        }
+        a.cnt += n;
+        if( mm ) { a.mn = std::min( a.mn, mn ); a.mx = std::max( a.mx, mx ); }
+        if( sm ) a.s  += s;
+        if( sq ) a.s2 += s2;
+    }
+
+    template<typename T>
+    void stat_run( const Image& img, const StatRegion& rg, const int& flags, const bool& run_parallel,
+                   vector<StatAccum>& part ) {
+        const bool sse = stat_sse();
+        const T*   tag = NULL;
+#pragma omp parallel for if( run_parallel && rg.n_blocks > 1 )
+        for( int b=0; b<rg.n_blocks; b++ ) {
+            StatAccum& a  = part[b];
+            int        y0 = rg.ly + b*rg.rows_per_block;
+            int        y1 = std::min( rg.uy, y0 + rg.rows_per_block );
+            a.init();
+            for( int y=y0; y<y1; y++ ) {
+                for( int c=0; c<rg.n_planes; c++ )
+                    stat_segment( stat_row( img, tag, y, c, rg.lx ), rg.seg_len, flags, sse, a );
+            }
+        }
+    }
+
+    void image_stats( const Image& img, const int& flags, const bool& run_parallel, ImageStats& st,
+                      const Rect2i* roi ) {
+        StatRegion rg( img, roi );
+        vector<StatAccum> part( std::max( 1, rg.n_blocks ) );
+        part[0].init();
+        switch( img.precision() ) {
+        case TYPE_FLOAT: stat_run<float>( img, rg, flags, run_parallel, part ); break;
+        case TYPE_UCHAR: stat_run<uchar>( img, rg, flags, run_parallel, part ); break;
+        case TYPE_INT  : stat_run<int>  ( img, rg, flags, run_parallel, part ); break;
+        default: switch_fatality();
+        }
+        stat_tree( part );
+        const StatAccum& a = part[0];
+        st.min_v     = a.cnt ? a.mn :  DBL_MAX;
+        st.max_v     = a.cnt ? a.mx : -DBL_MAX;
+        st.sum       = a.s;
+        st.sum_sq    = a.s2;
+        st.count     = a.cnt;
+        st.nan_count = a.nan;
+    }
+
+    //
+    // predicates
+    //
+
+    /// a test resolved for integer samples: lo <= v <= hi or v == lo or
+    /// v == hi, the count complemented if invert is set
+    struct IntTest {
+        bool   range, invert, none;
+        int    lo, hi;
+    };
+
+    /// the integer samples of [vmin,vmax] that pass test
+    IntTest int_test( const SampleTest& test, const double& a, const double& b, const int& vmin, const int& vmax ) {
+        IntTest t = { true, false, false, 0, 0 };
+        switch( test ) {
+        case TEST_NONZERO:
+            t.invert = true;
+            break;
+        case TEST_NAN:
+            t.none = true;
+            break;
+        case TEST_IN_RANGE:
+        case TEST_OUTSIDE: {
+            t.invert  = test == TEST_OUTSIDE;
+            double lo = std::max( std::ceil ( a ), double( vmin ) );
+            double hi = std::min( std::floor( b ), double( vmax ) );
+            if( a != a || b != b ) { t.none = true; t.invert = false; }  // every comparison fails
+            else if( lo > hi     )   t.none = true;
+            else { t.lo = int( lo ); t.hi = int( hi ); }
+        } break;
+        case TEST_EITHER: {
+            t.range = false;
+            bool va = a == std::floor( a ) && a >= vmin && a <= vmax;
+            bool vb = b == std::floor( b ) && b >= vmin && b <= vmax;
+            if( !va && !vb ) {
+                t.none = true;
+            } else {
+                t.lo = int( va ? a : b );
+                t.hi = int( vb ? b : a );
+            }
+        } break;
+        }
+        return t;
+    }
+
+    size_t test_segment( const float* p, const int& n, const SampleTest& test, const float& a, const float& b,
+                         const bool& sse ) {
+        size_t c = 0;
+        int    i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 va = _mm_set1_ps( a );
+            const __m128 vb = _mm_set1_ps( b );
+            const __m128 z  = _mm_setzero_ps();
+            for( ; i+4<=n; i+=4 ) {
+                __m128 v = _mm_loadu_ps( p+i ), m;
+                switch( test ) {
+                case TEST_NONZERO : m = _mm_cmpneq_ps( v, z );                                     break;
+                case TEST_NAN     : m = _mm_cmpunord_ps( v, v );                                   break;
+                case TEST_IN_RANGE: m = _mm_and_ps( _mm_cmple_ps( va, v ), _mm_cmple_ps( v, vb ) ); break;
+                case TEST_OUTSIDE : m = _mm_or_ps ( _mm_cmplt_ps( v, va ), _mm_cmpgt_ps( v, vb ) ); break;
+                default           : m = _mm_or_ps ( _mm_cmpeq_ps( v, va ), _mm_cmpeq_ps( v, vb ) ); break;
+                }
+                c += __builtin_popcount( _mm_movemask_ps( m ) );
+            }
+        }
+#endif
+        for( ; i<n; i++ ) {
+            const float& v = p[i];
+            bool r;
+            switch( test ) {
+            case TEST_NONZERO : r = v != 0.0f;          break;
+            case TEST_NAN     : r = v != v;             break;
+            case TEST_IN_RANGE: r = a <= v && v <= b;   break;
+            case TEST_OUTSIDE : r = v < a || v > b;     break;
+            default           : r = v == a || v == b;   break;
+            }
+            c += r;
+        }
+        return c;
+    }
+
+    size_t test_segment( const uchar* p, const int& n, const IntTest& t, const bool& sse ) {
+        if( t.none ) return t.invert ? n : 0;
+        size_t c = 0;
+        int    i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128i lo = _mm_set1_epi8( char( t.lo ) );
+            const __m128i hi = _mm_set1_epi8( char( t.hi ) );
+            for( ; i+16<=n; i+=16 ) {
+                __m128i v = _mm_loadu_si128( (const __m128i*)( p+i ) ), m;
+                if( t.range ) m = _mm_and_si128( _mm_cmpeq_epi8( _mm_max_epu8( v, lo ), v ),
+                                                 _mm_cmpeq_epi8( _mm_min_epu8( v, hi ), v ) );
+                else          m = _mm_or_si128 ( _mm_cmpeq_epi8( v, lo ), _mm_cmpeq_epi8( v, hi ) );
+                c += __builtin_popcount( _mm_movemask_epi8( m ) );
+            }
+        }
+#endif
+        for( ; i<n; i++ ) {
+            int v = p[i];
+            c += t.range ? ( t.lo <= v && v <= t.hi ) : ( v == t.lo || v == t.hi );
+        }
+        return t.invert ? n - c : c;
+    }
+
+    size_t test_segment( const int* p, const int& n, const IntTest& t, const bool& sse ) {
+        if( t.none ) return t.invert ? n : 0;
+        size_t c = 0;
+        int    i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128i lo = _mm_set1_epi32( t.lo );
+            const __m128i hi = _mm_set1_epi32( t.hi );
+            for( ; i+4<=n; i+=4 ) {
+                __m128i v = _mm_loadu_si128( (const __m128i*)( p+i ) );
+                if( t.range ) {
+                    __m128i out = _mm_or_si128( _mm_cmpgt_epi32( lo, v ), _mm_cmpgt_epi32( v, hi ) );
+                    c += 4 - __builtin_popcount( _mm_movemask_ps( _mm_castsi128_ps( out ) ) );
+                } else {
+                    __m128i m = _mm_or_si128( _mm_cmpeq_epi32( v, lo ), _mm_cmpeq_epi32( v, hi ) );
+                    c += __builtin_popcount( _mm_movemask_ps( _mm_castsi128_ps( m ) ) );
+                }
+            }
+        }
+#endif
+        for( ; i<n; i++ ) {
+            int v = p[i];
+            c += t.range ? ( t.lo <= v && v <= t.hi ) : ( v == t.lo || v == t.hi );
+        }
+        return t.invert ? n - c : c;
+    }
+
+    enum TestMode { TEST_COUNT=0, TEST_ANY, TEST_ALL };
+
+    /// counts the passing samples. for TEST_ANY / TEST_ALL the blocks stop
+    /// at the first row with a passing / failing sample and the ones that
+    /// have not started yet are skipped - the count is then only good for
+    /// telling whether the answer was found.
+    size_t test_run( const Image& img, const SampleTest& test, const float& a, const float& b,
+                     const bool& run_parallel, const Rect2i* roi, const TestMode& mode, bool& found ) {
+        StatRegion rg( img, roi );
+        const bool sse = stat_sse();
+        IntTest it = { true, false, false, 0, 0 };
+        switch( img.precision() ) {
+        case TYPE_FLOAT: break;
+        case TYPE_UCHAR: it = int_test( test, a, b, 0,       255     ); break;
+        case TYPE_INT  : it = int_test( test, a, b, INT_MIN, INT_MAX ); break;
+        default: switch_fatality();
+        }
+
+        vector<size_t> part( std::max( 1, rg.n_blocks ), 0 );
+        // set once the answer is known. a late read only costs a row.
+        int done = 0;
+#pragma omp parallel for if( run_parallel && rg.n_blocks > 1 )
+        for( int k=0; k<rg.n_blocks; k++ ) {
+            int    y0 = rg.ly + k*rg.rows_per_block;
+            int    y1 = std::min( rg.uy, y0 + rg.rows_per_block );
+            size_t c  = 0;
+            for( int y=y0; y<y1 && !stat_done( done ); y++ ) {
+                for( int ch=0; ch<rg.n_planes; ch++ ) {
+                    size_t r = 0;
+                    switch( img.precision() ) {
+                    case TYPE_FLOAT: r = test_segment( stat_row( img, (const float*)NULL, y, ch, rg.lx ), rg.seg_len, test, a, b, sse ); break;
+                    case TYPE_UCHAR: r = test_segment( stat_row( img, (const uchar*)NULL, y, ch, rg.lx ), rg.seg_len, it, sse );         break;
+                    default        : r = test_segment( stat_row( img, (const int*  )NULL, y, ch, rg.lx ), rg.seg_len, it, sse );         break;
+                    }
+                    c += r;
+                    if( ( mode == TEST_ANY && r ) || ( mode == TEST_ALL && r < size_t( rg.seg_len ) ) )
+                        stat_set_done( done );
+                }
+            }
+            part[k] = c;
+        }
+        found = done != 0;
+        size_t c = 0;
+        for( int k=0; k<rg.n_blocks; k++ )
+            c += part[k];
+        return c;
+    }
+
+    size_t image_count( const Image& img, const SampleTest& test, const float& a, const float& b,
+                        const bool& run_parallel, const Rect2i* roi ) {
+        bool found;
+        return test_run( img, test, a, b, run_parallel, roi, TEST_COUNT, found );
+    }
+
+    bool image_any( const Image& img, const SampleTest& test, const float& a, const float& b,
+                    const bool& run_parallel, const Rect2i* roi ) {
+        bool found;
+        test_run( img, test, a, b, run_parallel, roi, TEST_ANY, found );
+        return found;
+    }
+
+    bool image_all( const Image& img, const SampleTest& test, const float& a, const float& b,
+                    const bool& run_parallel, const Rect2i* roi ) {
+        bool found;
+        test_run( img, test, a, b, run_parallel, roi, TEST_ALL, found );
+        return !found;
+    }
+
+    //
+    // the checks of image_processing.h
+    //
+
+    bool image_min_max( const Image& img,
+                        const int& xmin, const int& ymin,
+                        const int& xmax, const int& ymax,
+                        float& min_v, float& max_v, const bool& run_parallel ) {
+        Rect2i roi( 0, img.w(), 0, img.h() );
+        if( !( xmin == xmax && ymin == ymax && xmin == -1 ) )
+            roi.init( std::min( xmin, xmax ), std::max( xmin, xmax ), std::min( ymin, ymax ), std::max( ymin, ymax ) );
+        ImageStats st;
+        image_stats( img, STAT_MIN_MAX, run_parallel, st, &roi );
+        if( !st.count ) {
+            min_v =  std::numeric_limits<float>::max();
+            max_v = -std::numeric_limits<float>::max();
+            return false;
+        }
+        min_v = float( st.min_v );
+        max_v = float( st.max_v );
+        return true;
+    }
+
+    bool abs_image_min_max( const Image& img,
+                            const int& xmin, const int& ymin,
+                            const int& xmax, const int& ymax,
+                            float& min_v, float& max_v, const bool& run_parallel ) {
+        Rect2i roi( 0, img.w(), 0, img.h() );
+        if( !( xmin == xmax && ymin == ymax && xmin == -1 ) )
+            roi.init( std::min( xmin, xmax ), std::max( xmin, xmax ), std::min( ymin, ymax ), std::max( ymin, ymax ) );
+        ImageStats st;
+        image_stats( img, STAT_MIN_MAX | STAT_ABS, run_parallel, st, &roi );
+        if( !st.count ) {
+            min_v =  std::numeric_limits<float>::max();
+            max_v = -std::numeric_limits<float>::max();
+            return false;
+        }
+        min_v = float( st.min_v );
+        max_v = float( st.max_v );
+        return true;
+    }
+
+    bool is_binarized( const Image& p, const bool& run_parallel ) {
+        assert_statement( !p.is_empty(), "passed empty image" );
+        p.assert_type( IT_F_GRAY | IT_U_GRAY );
+        return image_all( p, TEST_EITHER, 0.0f, 1.0f, run_parallel );
+    }
+
+    bool is_normalized( const Image& p, const bool& run_parallel ) {
+        assert_statement( !p.is_empty(), "passed empty image" );
+        p.assert_type( IT_F_GRAY );
+        return !image_any( p, TEST_OUTSIDE, 0.0f, 1.0f, run_parallel );
+    }
+
+    /// rows of p and q with a pixel that is non-zero in both
+    inline bool overlap_row( const float* p, const float* q, const int& n, const bool& sse ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 z = _mm_setzero_ps();
+            for( ; i+4<=n; i+=4 ) {
+                __m128 m = _mm_and_ps( _mm_cmpneq_ps( _mm_loadu_ps( p+i ), z ), _mm_cmpneq_ps( _mm_loadu_ps( q+i ), z ) );
+                if( _mm_movemask_ps( m ) ) return true;
+            }
+        }
+#endif
+        for( ; i<n; i++ ) {
+            if( p[i] != 0.0f && q[i] != 0.0f )
+                return true;
+        }
+        return false;
+    }
+
+    bool does_overlap( const Image& p, const Image& q, const bool& run_parallel ) {
+        assert_statement( check_dimensions(p,q), "dimension mismatch" );
+        p.assert_type( IT_F_GRAY );
+        q.assert_type( IT_F_GRAY );
+        StatRegion rg( p, NULL );
+        const bool sse  = stat_sse();
+        int        done = 0;
+#pragma omp parallel for if( run_parallel && rg.n_blocks > 1 )
+        for( int b=0; b<rg.n_blocks; b++ ) {
+            int y1 = std::min( rg.uy, (b+1)*rg.rows_per_block );
+            for( int y=b*rg.rows_per_block; y<y1 && !stat_done( done ); y++ ) {
+                if( overlap_row( p.get_row_f(y), q.get_row_f(y), rg.seg_len, sse ) )
+                    stat_set_done( done );
+            }
+        }
+        return done != 0;
+    }
+
+}
@@ -112,8 +112,11 @@ namespace kortex {
         read_barray( fin, m_buffer, cap );
     }
 
-
-
+    uchar* thread_scratch( const int& slot, const size_t& n_bytes ) {
+        assert_boundary( slot, 0, N_THREAD_SCRATCH_SLOTS );
+        static thread_local MemUnit scratch[N_THREAD_SCRATCH_SLOTS];
+        scratch[slot].resize( n_bytes );
+        return scratch[slot].get_buffer();
+    }
 
 }
-
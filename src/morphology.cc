@@ -0,0 +1,607 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/morphology.h>
+#include <kortex/image.h>
+#include <kortex/mem_unit.h>
+#include <kortex/bit_operations.h>
+#include <kortex/filter.h>
+#include <kortex/check.h>
+
+#include <cstring>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace kortex {
+
+    /// columns of a segment of the column pass
+    const int MORPH_STRIP = 256;
+
+    /// rows transposed together by the row pass
+    const int MORPH_BAND  = 16;
+
+    /// o = min(a,b) or max(a,b) over n elements - o can be a or b
+    inline void morph_combine( const float* a, const float* b, const int& n, const bool& is_min,
+                               const bool& sse, float* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            if( is_min ) for( ; i+4<=n; i+=4 ) _mm_storeu_ps( o+i, _mm_min_ps( _mm_loadu_ps(a+i), _mm_loadu_ps(b+i) ) );
+            else         for( ; i+4<=n; i+=4 ) _mm_storeu_ps( o+i, _mm_max_ps( _mm_loadu_ps(a+i), _mm_loadu_ps(b+i) ) );
+        }
+#endif
+        if( is_min ) for( ; i<n; i++ ) o[i] = std::min( a[i], b[i] );
+        else         for( ; i<n; i++ ) o[i] = std::max( a[i], b[i] );
+    }
+
+    inline void morph_combine( const uchar* a, const uchar* b, const int& n, const bool& is_min,
+                               const bool& sse, uchar* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            if( is_min ) {
+                for( ; i+16<=n; i+=16 ) {
+                    __m128i va = _mm_loadu_si128( (const __m128i*)(a+i) );
+                    __m128i vb = _mm_loadu_si128( (const __m128i*)(b+i) );
+                    _mm_storeu_si128( (__m128i*)(o+i), _mm_min_epu8( va, vb ) );
+                }
+            } else {
+                for( ; i+16<=n; i+=16 ) {
+                    __m128i va = _mm_loadu_si128( (const __m128i*)(a+i) );
+                    __m128i vb = _mm_loadu_si128( (const __m128i*)(b+i) );
+                    _mm_storeu_si128( (__m128i*)(o+i), _mm_max_epu8( va, vb ) );
+                }
+            }
+        }
+#endif
+        if( is_min ) for( ; i<n; i++ ) o[i] = std::min( a[i], b[i] );
+        else         for( ; i<n; i++ ) o[i] = std::max( a[i], b[i] );
+    }
+
+    /// sse2 has no 32-bit integer min / max - compare and blend
+    inline void morph_combine( const int* a, const int* b, const int& n, const bool& is_min,
+                               const bool& sse, int* o ) {
+        int i = 0;
+#ifdef WITH_SSE
+        if( sse ) {
+            for( ; i+4<=n; i+=4 ) {
+                __m128i va = _mm_loadu_si128( (const __m128i*)(a+i) );
+                __m128i vb = _mm_loadu_si128( (const __m128i*)(b+i) );
+                __m128i gt = is_min ? _mm_cmpgt_epi32( vb, va ) : _mm_cmpgt_epi32( va, vb );
+                _mm_storeu_si128( (__m128i*)(o+i), _mm_or_si128( _mm_and_si128( gt, va ), _mm_andnot_si128( gt, vb ) ) );
+            }
+        }
+#endif
+        if( is_min ) for( ; i<n; i++ ) o[i] = std::min( a[i], b[i] );
+        else         for( ; i<n; i++ ) o[i] = std::max( a[i], b[i] );
+    }
+
+    /// packed masks: erosion is and, dilation is or
+    inline void morph_combine( const uint64_t* a, const uint64_t* b, const int& n, const bool& is_min,
+                               const bool&, uint64_t* o ) {
+        if( is_min ) for( int i=0; i<n; i++ ) o[i] = a[i] & b[i];
+        else         for( int i=0; i<n; i++ ) o[i] = a[i] | b[i];
+    }
+
+    /// van herk / gil-werman over a line of vectors of nb elements:
+    /// out[p] = op( in[p], ..., in[p+k-1] ) for p in [0,n). in holds n+k-1
+    /// vectors. the line is cut into blocks of k; g is the running op from
+    /// the start of every block, hb from its end, and every window spans at
+    /// most two blocks: out[p] = op( hb[p], g[p+k-1] ). g and hb hold
+    /// (n+k-1)*nb elements. out[p] can be in[p].
+    template<typename T>
+    void morph_vhgw( const T* const* in, const int& n, const int& k, const int& nb, const bool& is_min,
+                     const bool& sse, T* g, T* hb, T* const* out ) {
+        const int    L  = n+k-1;
+        const size_t vb = sizeof(T)*nb;
+        for( int i=0; i<L; i++ ) {
+            T* gi = g + size_t(i)*nb;
+            if( i%k == 0 ) memcpy( gi, in[i], vb );
+            else           morph_combine( gi-nb, in[i], nb, is_min, sse, gi );
+        }
+        for( int i=L-1; i>=0; i-- ) {
+            T* hi = hb + size_t(i)*nb;
+            if( i == L-1 || (i+1)%k == 0 ) memcpy( hi, in[i], vb );
+            else                           morph_combine( hi+nb, in[i], nb, is_min, sse, hi );
+        }
+        for( int p=0; p<n; p++ )
+            morph_combine( hb + size_t(p)*nb, g + size_t(p+k-1)*nb, nb, is_min, sse, out[p] );
+    }
+
+    /// h rows of w elements, st apart, from src to dst
+    template<typename T>
+    void morph_copy( const T* src, const int& w, const int& h, const size_t& st, T* dst ) {
+        if( src == dst ) return;
+        for( int y=0; y<h; y++ )
+            memcpy( dst + size_t(y)*st, src + size_t(y)*st, sizeof(T)*w );
+    }
+
+    /// column pass over a w x h array with rows st apart: every row becomes
+    /// the op of the 2*r+1 rows around it. rows outside are filled with the
+    /// neutral value. processed in strips of MORPH_STRIP columns. dst can be
+    /// src.
+    template<typename T>
+    void morph_columns( const T* src, const int& w, const int& h, const size_t& st, const int& r,
+                        const bool& is_min, const T& neutral, const bool& sse, const bool& run_parallel, T* dst ) {
+        if( r == 0 ) {
+            morph_copy( src, w, h, st, dst );
+            return;
+        }
+        const int k  = 2*r+1;
+        const int L  = h+2*r;
+        const int ns = ( w + MORPH_STRIP - 1 ) / MORPH_STRIP;
+#pragma omp parallel for if( run_parallel )
+        for( int s=0; s<ns; s++ ) {
+            int    c0 = s*MORPH_STRIP;
+            int    sw = std::min( MORPH_STRIP, w-c0 );
+            size_t nv = size_t(L)*sw;
+            uchar* buf = thread_scratch( 0, sizeof(T*)*(L+h) + sizeof(T)*( 2*nv + sw ) );
+            const T** in  = (const T**)buf;
+            T**       out = (T**)( in + L );
+            T*        g   = (T*)( out + h );
+            T*        hb  = g  + nv;
+            T*        nr  = hb + nv;
+            std::fill( nr, nr+sw, neutral );
+            for( int i=0; i<L; i++ ) {
+                int y = i-r;
+                in[i] = ( y < 0 || y >= h ) ? nr : src + size_t(y)*st + c0;
+            }
+            for( int y=0; y<h; y++ )
+                out[y] = dst + size_t(y)*st + c0;
+            morph_vhgw( in, h, k, sw, is_min, sse, g, hb, out );
+        }
+    }
+
+    /// row pass: MORPH_BAND rows are transposed so that the positions along
+    /// the row become vectors of the band and run through morph_vhgw like
+    /// the columns do. dst can be src.
+    template<typename T>
+    void morph_rows( const T* src, const int& w, const int& h, const size_t& st, const int& r, const bool& is_min,
+                     const T& neutral, const bool& sse, const bool& run_parallel, T* dst ) {
+        if( r == 0 ) {
+            morph_copy( src, w, h, st, dst );
+            return;
+        }
+        const int B  = MORPH_BAND;
+        const int k  = 2*r+1;
+        const int L  = w+2*r;
+        const int nb = ( h + B - 1 ) / B;
+#pragma omp parallel for if( run_parallel )
+        for( int b=0; b<nb; b++ ) {
+            const int y0 = b*B;
+            const int nr = std::min( B, h-y0 );
+            const int ww = w;
+            const int rr = r;
+            size_t nv  = size_t(L)*B;
+            uchar* buf = thread_scratch( 0, sizeof(T*)*(L+ww) + sizeof(T)*( 3*nv + size_t(ww)*B ) );
+            const T** in  = (const T**)buf;
+            T**       out = (T**)( in + L );
+            T*        t   = (T*)( out + ww );
+            T*        g   = t  + nv;
+            T*        hb  = g  + nv;
+            T*        o   = hb + nv;
+            std::fill( t,                   t + size_t(rr)*B, neutral );
+            std::fill( t + size_t(rr+ww)*B, t + nv,           neutral );
+            if( nr < B ) {
+                for( int x=rr; x<rr+ww; x++ )
+                    std::fill( t + size_t(x)*B + nr, t + size_t(x+1)*B, neutral );
+            }
+            for( int j=0; j<nr; j++ ) {
+                const T* row = src + size_t(y0+j)*st;
+                T*       tc  = t + size_t(rr)*B + j;
+                for( int x=0; x<ww; x++ )
+                    tc[size_t(x)*B] = row[x];
+            }
+            for( int i=0; i<L; i++ )
+                in[i] = t + size_t(i)*B;
+            for( int x=0; x<ww; x++ )
+                out[x] = o + size_t(x)*B;
+            morph_vhgw( in, ww, k, B, is_min, sse, g, hb, out );
+            for( int j=0; j<nr; j++ ) {
+                T*       row = dst + size_t(y0+j)*st;
+                const T* oc  = o + j;
+                for( int x=0; x<ww; x++ )
+                    row[x] = oc[size_t(x)*B];
+            }
+        }
+    }
+
+    template<typename T>
+    void morph_pass( T* im, const int& w, const int& h, const size_t& st, const int& rx, const int& ry,
+                     const bool& is_min, const T& lo, const T& hi, const bool& sse, const bool& run_parallel ) {
+        T neutral = is_min ? hi : lo;
+        morph_rows   ( im, w, h, st, rx, is_min, neutral, sse, run_parallel, im );
+        morph_columns( im, w, h, st, ry, is_min, neutral, sse, run_parallel, im );
+    }
+
+    /// the erode / dilate sequence of op: true for erosion
+    int morph_steps( const MorphOp& op, bool steps[2] ) {
+        switch( op ) {
+        case MORPH_ERODE : steps[0] = true;                     return 1;
+        case MORPH_DILATE: steps[0] = false;                    return 1;
+        case MORPH_OPEN  : steps[0] = true;  steps[1] = false;  return 2;
+        case MORPH_CLOSE : steps[0] = false; steps[1] = true;   return 2;
+        default: switch_fatality();
+        }
+        return 0;
+    }
+
+    void image_morphology( const Image& src, const MorphOp& op, const int& rx, const int& ry,
+                           const bool& run_parallel, Image& dst ) {
+        passert_statement( !src.is_empty(), "empty image" );
+        passert_statement( rx >= 0 && ry >= 0, "invalid structuring element" );
+        src.passert_type( IT_U_GRAY | IT_F_GRAY | IT_I_GRAY );
+
+        bool steps[2];
+        int  ns = morph_steps( op, steps );
+
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        int w = src.w();
+        int h = src.h();
+        if( &src != &dst )
+            dst.copy( &src );
+        size_t st = dst.stride();
+        for( int s=0; s<ns; s++ ) {
+            switch( src.type() ) {
+            case IT_U_GRAY: morph_pass( dst.get_row_u(0), w, h, st, rx, ry, steps[s], uchar(0), uchar(255), sse, run_parallel ); break;
+            case IT_F_GRAY: morph_pass( dst.get_row_f(0), w, h, st, rx, ry, steps[s], -FLT_MAX,  FLT_MAX,    sse, run_parallel ); break;
+            case IT_I_GRAY: morph_pass( dst.get_row_i(0), w, h, st, rx, ry, steps[s], INT_MIN,   INT_MAX,    sse, run_parallel ); break;
+            default: switch_fatality();
+            }
+        }
+    }
+
+    /// rows of a tile of the maxima scan
+    const int MAXIMA_TILE_H = 32;
+
+    /// appends the x of the pixels in [x0,x1) of a row with v >= d and
+    /// v > th - four at a time with a compare mask, the set bits of which
+    /// are the candidates.
+    inline void maxima_row( const float* v, const float* d, const int& x0, const int& x1, const float& th,
+                            const bool& sse, std::vector<int>& xs ) {
+        int x = x0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128 t = _mm_set1_ps( th );
+            for( ; x+4<=x1; x+=4 ) {
+                __m128 vv = _mm_loadu_ps( v+x );
+                int m = _mm_movemask_ps( _mm_and_ps( _mm_cmpge_ps( vv, _mm_loadu_ps(d+x) ), _mm_cmpgt_ps( vv, t ) ) );
+                for( ; m; m &= m-1 )
+                    xs.push_back( x + __builtin_ctz( m ) );
+            }
+        }
+#endif
+        for( ; x<x1; x++ )
+            if( v[x] >= d[x] && v[x] > th ) xs.push_back( x );
+    }
+
+    inline void maxima_row( const int* v, const int* d, const int& x0, const int& x1, const int& th,
+                            const bool& sse, std::vector<int>& xs ) {
+        int x = x0;
+#ifdef WITH_SSE
+        if( sse ) {
+            const __m128i t = _mm_set1_epi32( th );
+            for( ; x+4<=x1; x+=4 ) {
+                __m128i vv = _mm_loadu_si128( (const __m128i*)(v+x) );
+                __m128i dv = _mm_loadu_si128( (const __m128i*)(d+x) );
+                __m128i mk = _mm_andnot_si128( _mm_cmpgt_epi32( dv, vv ), _mm_cmpgt_epi32( vv, t ) );
+                int m = _mm_movemask_ps( _mm_castsi128_ps( mk ) );
+                for( ; m; m &= m-1 )
+                    xs.push_back( x + __builtin_ctz( m ) );
+            }
+        }
+#endif
+        for( ; x<x1; x++ )
+            if( v[x] >= d[x] && v[x] > th ) xs.push_back( x );
+    }
+
+    template<typename T>
+    void maxima_run( const T* im, const size_t& is, const T* dil, const size_t& ds, const int& w, const int& h,
+                     const T& th, const int& margin,
+                     const bool& sse, const bool& run_parallel, std::vector<LocalMaximum>& maxima ) {
+        const int y0 = margin;
+        const int y1 = h-margin;
+        const int x0 = margin;
+        const int x1 = w-margin;
+        if( y1 <= y0 || x1 <= x0 ) return;
+        const int nt = ( y1 - y0 + MAXIMA_TILE_H - 1 ) / MAXIMA_TILE_H;
+        std::vector< std::vector<LocalMaximum> > found( nt );
+#pragma omp parallel for if( run_parallel )
+        for( int t=0; t<nt; t++ ) {
+            const int ty0 = y0 + t*MAXIMA_TILE_H;
+            const int ty1 = std::min( y1, ty0+MAXIMA_TILE_H );
+            std::vector<int> xs;
+            for( int y=ty0; y<ty1; y++ ) {
+                const T* ir = im  + size_t(y)*is;
+                xs.clear();
+                maxima_row( ir, dil + size_t(y)*ds, x0, x1, th, sse, xs );
+                for( size_t i=0; i<xs.size(); i++ ) {
+                    LocalMaximum m = { xs[i], y, float( ir[xs[i]] ) };
+                    found[t].push_back( m );
+                }
+            }
+        }
+        for( int t=0; t<nt; t++ )
+            maxima.insert( maxima.end(), found[t].begin(), found[t].end() );
+    }
+
+    void image_local_maxima( const Image& img, const int& r, const float& threshold, const int& margin,
+                             const bool& run_parallel, std::vector<LocalMaximum>& maxima ) {
+        passert_statement( !img.is_empty(), "empty image" );
+        passert_statement( r >= 0 && margin >= 0, "invalid window" );
+        img.passert_type( IT_F_GRAY | IT_I_GRAY );
+        maxima.clear();
+
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        Image dil;
+        image_morphology( img, MORPH_DILATE, r, r, run_parallel, dil );
+        int w = img.w();
+        int h = img.h();
+        switch( img.type() ) {
+        case IT_F_GRAY:
+            maxima_run( img.get_row_f(0), img.stride(), dil.get_row_f(0), dil.stride(), w, h, threshold, margin,
+                        sse, run_parallel, maxima );
+            break;
+        case IT_I_GRAY: {
+            // v > threshold <=> v > floor(threshold) for integers
+            double ft = std::floor( double(threshold) );
+            int    th = int( std::max( double(INT_MIN), std::min( double(INT_MAX), ft ) ) );
+            maxima_run( img.get_row_i(0), img.stride(), dil.get_row_i(0), dil.stride(), w, h, th, margin,
+                        sse, run_parallel, maxima );
+        } break;
+        default: switch_fatality();
+        }
+    }
+
+    //
+    // bit-packed masks: bit i of word j of a row is pixel 64*j+i
+    //
+
+    inline uint64_t morph_word( const uint64_t* a, const int& n, const int& i, const uint64_t& fill ) {
+        return ( i >= 0 && i < n ) ? a[i] : fill;
+    }
+
+    /// bit i of o = bit i+s of a - bits past a are fill. o has n words.
+    void bits_shift_down( const uint64_t* a, const int& n, const int& s, const uint64_t& fill, uint64_t* o ) {
+        const int q = s >> 6;
+        const int b = s & 63;
+        for( int j=0; j<n; j++ ) {
+            uint64_t lo = morph_word( a, n, j+q, fill );
+            if( b == 0 ) { o[j] = lo; continue; }
+            uint64_t hi = morph_word( a, n, j+q+1, fill );
+            o[j] = ( lo >> b ) | ( hi << (64-b) );
+        }
+    }
+
+    /// bit i of o = bit i-s of a - bits before and past a are fill. o has no words.
+    void bits_shift_up( const uint64_t* a, const int& na, const int& s, const uint64_t& fill,
+                        uint64_t* o, const int& no ) {
+        const int q = s >> 6;
+        const int b = s & 63;
+        for( int j=0; j<no; j++ ) {
+            uint64_t hi = morph_word( a, na, j-q, fill );
+            if( b == 0 ) { o[j] = hi; continue; }
+            uint64_t lo = morph_word( a, na, j-q-1, fill );
+            o[j] = ( hi << b ) | ( lo >> (64-b) );
+        }
+    }
+
+    /// row pass of a packed mask: the row is shifted by r into p so that
+    /// bit j of p is pixel j-r, then p is combined with itself shifted by
+    /// 1, 2, 4, ... until bit j covers the k = 2r+1 pixels j-r..j+r - the
+    /// O(log r) doubling takes the place of van herk / gil-werman along the
+    /// packed bits. p and t hold np = (w+2r+63)/64 words.
+    void bits_rows( uint64_t* pk, const int& w, const int& h, const int& nw, const int& r, const bool& is_min,
+                    const uint64_t& fill, const bool& run_parallel ) {
+        if( r == 0 ) return;
+        const int      k    = 2*r+1;
+        const int      np   = ( w + 2*r + 63 ) / 64;
+        const int      tail = w & 63;
+        const uint64_t tm   = tail ? ( ~uint64_t(0) << tail ) : 0;
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            uint64_t* a = pk + size_t(y)*nw;
+            uint64_t* p = (uint64_t*)thread_scratch( 0, sizeof(uint64_t)*2*np );
+            uint64_t* t = p + np;
+            if( tail ) a[nw-1] = ( a[nw-1] & ~tm ) | ( fill & tm );
+            bits_shift_up( a, nw, r, fill, p, np );
+            int len = 1;
+            while( 2*len <= k ) {
+                bits_shift_down( p, np, len, fill, t );
+                morph_combine( p, t, np, is_min, false, p );
+                len *= 2;
+            }
+            if( len < k ) {
+                bits_shift_down( p, np, k-len, fill, t );
+                morph_combine( p, t, np, is_min, false, p );
+            }
+            memcpy( a, p, sizeof(uint64_t)*nw );
+        }
+    }
+
+    template<typename T>
+    void bits_pack( const T* im, const size_t& is, const int& w, const int& h, const int& nw, const bool& run_parallel,
+                    uint64_t* pk ) {
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            const T*  row = im + size_t(y)*is;
+            uint64_t* prw = pk + size_t(y)*nw;
+            uchar     bits[64];
+            for( int j=0; j<nw; j++ ) {
+                int x0 = 64*j;
+                int n  = std::min( 64, w-x0 );
+                for( int i=0; i<n;  i++ ) bits[i] = ( row[x0+i] != 0 );
+                for( int i=n; i<64; i++ ) bits[i] = 0;
+                prw[j] = pack64( bits );
+            }
+        }
+    }
+
+    template<typename T>
+    void bits_unpack( const uint64_t* pk, const int& w, const int& h, const int& nw, const T& fg,
+                      const bool& run_parallel, T* im, const size_t& os ) {
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            const uint64_t* prw = pk + size_t(y)*nw;
+            T*              row = im + size_t(y)*os;
+            const int       ww  = w;
+            const T         v   = fg;
+            for( int x=0; x<ww; x++ )
+                row[x] = ( ( prw[x>>6] >> (x&63) ) & 1 ) ? v : T(0);
+        }
+    }
+
+    void mask_morphology( const Image& mask, const MorphOp& op, const int& rx, const int& ry,
+                          const bool& run_parallel, Image& dst, const bool& outside_is_background ) {
+        passert_statement( !mask.is_empty(), "empty image" );
+        passert_statement( rx >= 0 && ry >= 0, "invalid structuring element" );
+        mask.passert_type( IT_U_GRAY | IT_F_GRAY );
+
+        bool steps[2];
+        int  ns = morph_steps( op, steps );
+
+        int w  = mask.w();
+        int h  = mask.h();
+        int nw = ( w + 63 ) / 64;
+        uint64_t* pk = (uint64_t*)thread_scratch( 1, sizeof(uint64_t)*size_t(nw)*h );
+        switch( mask.type() ) {
+        case IT_U_GRAY: bits_pack( mask.get_row_u(0), mask.stride(), w, h, nw, run_parallel, pk ); break;
+        case IT_F_GRAY: bits_pack( mask.get_row_f(0), mask.stride(), w, h, nw, run_parallel, pk ); break;
+        default: switch_fatality();
+        }
+
+        for( int s=0; s<ns; s++ ) {
+            uint64_t fill = ( steps[s] && !outside_is_background ) ? ~uint64_t(0) : 0;
+            bits_rows    ( pk, w, h, nw, rx, steps[s], fill, run_parallel );
+            morph_columns( pk, nw, h, size_t(nw), ry, steps[s], fill, false, run_parallel, pk );
+        }
+
+        if( &mask != &dst )
+            dst.create( w, h, mask.type() );
+        switch( mask.type() ) {
+        case IT_U_GRAY: bits_unpack( pk, w, h, nw, uchar(255), run_parallel, dst.get_row_u(0), dst.stride() ); break;
+        case IT_F_GRAY: bits_unpack( pk, w, h, nw, 1.0f,       run_parallel, dst.get_row_f(0), dst.stride() ); break;
+        default: switch_fatality();
+        }
+    }
+
+    /// squared distances at or above this have no background pixel in reach
+    const double EDT_INF = 1e20;
+
+    /// distance to the nearest background pixel of the column, w+h if there
+    /// is none - the rows are scanned down and up so the pass runs along
+    /// whole rows. is and gs are the row strides of im and g.
+    template<typename T>
+    void edt_columns( const T* im, const size_t& is, const int& w, const int& h, const bool& run_parallel,
+                      float* g, const size_t& gs ) {
+        const float none = float( w+h );
+        const int   ns   = ( w + MORPH_STRIP - 1 ) / MORPH_STRIP;
+#pragma omp parallel for if( run_parallel )
+        for( int s=0; s<ns; s++ ) {
+            const int c0 = s*MORPH_STRIP;
+            const int c1 = std::min( w, c0+MORPH_STRIP );
+            const int hh = h;
+            for( int x=c0; x<c1; x++ )
+                g[x] = im[x] ? none : 0.0f;
+            for( int y=1; y<hh; y++ ) {
+                const T*     ir = im + size_t(y)*is;
+                const float* gp = g  + size_t(y-1)*gs;
+                float*       gr = g  + size_t(y)*gs;
+                for( int x=c0; x<c1; x++ )
+                    gr[x] = ir[x] ? std::min( gp[x] + 1.0f, none ) : 0.0f;
+            }
+            for( int y=hh-2; y>=0; y-- ) {
+                const float* gn = g + size_t(y+1)*gs;
+                float*       gr = g + size_t(y)*gs;
+                for( int x=c0; x<c1; x++ )
+                    gr[x] = std::min( gr[x], gn[x] + 1.0f );
+            }
+        }
+    }
+
+    /// along every row: d(x) = min_q (x-q)^2 + f(q) with f = g^2, from the
+    /// lower envelope of the parabolas rooted at q. v holds the roots of the
+    /// envelope, z the boundaries between them.
+    void edt_rows( float* g, const size_t& gs, const int& w, const int& h, const bool& squared,
+                   const bool& run_parallel ) {
+        const float none = float( w+h );
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            const int n   = w;
+            float*    row = g + size_t(y)*gs;
+            uchar*    buf = thread_scratch( 0, sizeof(double)*( 2*n+1 ) + sizeof(int)*n );
+            double*   f   = (double*)buf;
+            double*   z   = f + n;
+            int*      v   = (int*)( z + n + 1 );
+            for( int q=0; q<n; q++ )
+                f[q] = ( row[q] >= none ) ? EDT_INF : double(row[q])*row[q];
+
+            int k = 0;
+            v[0] = 0;
+            z[0] = -HUGE_VAL;
+            z[1] =  HUGE_VAL;
+            for( int q=1; q<n; q++ ) {
+                double fq = f[q] + double(q)*q;
+                double s  = ( fq - ( f[v[k]] + double(v[k])*v[k] ) ) / ( 2.0*( q-v[k] ) );
+                while( s <= z[k] ) {
+                    k--;
+                    s = ( fq - ( f[v[k]] + double(v[k])*v[k] ) ) / ( 2.0*( q-v[k] ) );
+                }
+                k++;
+                v[k]   = q;
+                z[k]   = s;
+                z[k+1] = HUGE_VAL;
+            }
+            k = 0;
+            for( int q=0; q<n; q++ ) {
+                while( z[k+1] < q ) k++;
+                double d = double(q-v[k])*(q-v[k]) + f[v[k]];
+                if( d >= EDT_INF ) row[q] = FLT_MAX;
+                else               row[q] = squared ? float(d) : float( std::sqrt(d) );
+            }
+        }
+    }
+
+    void mask_distance_transform( const Image& mask, const bool& squared, const bool& run_parallel, Image& dist ) {
+        passert_statement( !mask.is_empty(), "empty image" );
+        mask.passert_type( IT_U_GRAY | IT_F_GRAY );
+        int w = mask.w();
+        int h = mask.h();
+        if( &mask == &dist ) {
+            passert_statement( mask.type() == IT_F_GRAY, "in-place transform needs a float mask" );
+        } else {
+            dist.create( w, h, IT_F_GRAY );
+        }
+        size_t is = mask.stride();
+        size_t gs = dist.stride();
+        switch( mask.type() ) {
+        case IT_U_GRAY: edt_columns( mask.get_row_u(0), is, w, h, run_parallel, dist.get_row_f(0), gs ); break;
+        case IT_F_GRAY: edt_columns( mask.get_row_f(0), is, w, h, run_parallel, dist.get_row_f(0), gs ); break;
+        default: switch_fatality();
+        }
+        edt_rows( dist.get_row_f(0), gs, w, h, squared, run_parallel );
+    }
+
+}
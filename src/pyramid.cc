@@ -0,0 +1,192 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/pyramid.h>
+#include <kortex/check.h>
+#include <cstring>
+#include <cmath>
+
+namespace kortex {
+
+    /// alignment of the levels in the pyramid buffer
+    const size_t PYRAMID_ALIGN = 64;
+
+    size_t pyramid_align( const size_t& n ) {
+        return ( n + PYRAMID_ALIGN - 1 ) & ~( PYRAMID_ALIGN - 1 );
+    }
+
+    /// out = a + sign * out over the w x h x nc samples of a level
+    void pyramid_combine( const float* a, const int& w, const int& h, const int& nc, const float& sign,
+                          const bool& run_parallel, float* out ) {
+        const int rl = w*nc;
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<h; y++ ) {
+            const float* ar = a   + size_t(y)*rl;
+            float*       orow = out + size_t(y)*rl;
+            const float  s  = sign;
+            const int    n  = rl;
+            for( int i=0; i<n; i++ )
+                orow[i] = ar[i] + s*orow[i];
+        }
+    }
+
+    Pyramid::Pyramid() {
+        m_w           = 0;
+        m_h           = 0;
+        m_type        = IT_F_GRAY;
+        m_n_octaves   = 0;
+        m_n_sublevels = 0;
+        m_laplacian   = false;
+    }
+
+    void Pyramid::configure( const int& w, const int& h, const ImageType& type,
+                             const int& n_octaves, const int& n_sublevels, const bool& laplacian ) {
+        if( w == m_w && h == m_h && type == m_type && n_octaves == m_n_octaves &&
+            n_sublevels == m_n_sublevels && laplacian == m_laplacian )
+            return;
+
+        int nc = image_no_channels( type );
+
+        std::vector<int> lw, lh;
+        for( int l=0; l<n_octaves*n_sublevels; l++ ) {
+            double s  = std::pow( 2.0, -double(l)/n_sublevels );
+            int    ww = int( w*s + 0.5 );
+            int    hh = int( h*s + 0.5 );
+            if( l && ( ww < PYRAMID_MIN_SIZE || hh < PYRAMID_MIN_SIZE ) )
+                break;
+            lw.push_back( ww );
+            lh.push_back( hh );
+        }
+        int nl = (int)lw.size();
+
+        std::vector<size_t> gofs( nl ), lofs( nl );
+        size_t total = 0;
+        for( int l=0; l<nl; l++ ) {
+            gofs[l] = total;
+            total  += pyramid_align( Image::req_mem( lw[l], lh[l], type ) );
+        }
+        if( laplacian ) {
+            for( int l=0; l<nl-1; l++ ) {
+                lofs[l] = total;
+                total  += pyramid_align( Image::req_mem( lw[l], lh[l], type ) );
+            }
+        }
+        m_memory.resize( total + PYRAMID_ALIGN );
+        uchar* base = m_memory.get_buffer();
+        base += ( PYRAMID_ALIGN - size_t(base) % PYRAMID_ALIGN ) % PYRAMID_ALIGN;
+
+        m_gauss.clear(); m_gauss.resize( nl );
+        m_lap  .clear();
+        for( int l=0; l<nl; l++ )
+            m_gauss[l].wrap( base + gofs[l], lw[l], lh[l], type );
+        if( laplacian ) {
+            m_lap.resize( nl );
+            for( int l=0; l<nl-1; l++ )
+                m_lap[l].wrap( base + lofs[l], lw[l], lh[l], type );
+            m_lap[nl-1].wrap( base + gofs[nl-1], lw[nl-1], lh[nl-1], type );
+        }
+
+        m_down.clear(); m_down.resize( nl-1 );
+        m_up  .clear();
+        for( int l=0; l<nl-1; l++ )
+            resample_plan( lw[l], lh[l], nc, lw[l+1], lh[l+1], RESAMPLE_GAUSSIAN, BORDER_REPLICATE, m_down[l] );
+        if( laplacian ) {
+            m_up.resize( nl-1 );
+            for( int l=0; l<nl-1; l++ )
+                resample_plan( lw[l+1], lh[l+1], nc, lw[l], lh[l], RESAMPLE_BICUBIC, BORDER_REPLICATE, m_up[l] );
+        }
+
+        m_w           = w;
+        m_h           = h;
+        m_type        = type;
+        m_n_octaves   = n_octaves;
+        m_n_sublevels = n_sublevels;
+        m_laplacian   = laplacian;
+    }
+
+    void Pyramid::build( const Image& img, const int& n_octaves, const int& n_sublevels,
+                         const bool& laplacian, const bool& run_parallel ) {
+        passert_statement( !img.is_empty(), "empty image" );
+        passert_statement( n_octaves > 0 && n_sublevels > 0, "invalid pyramid configuration" );
+        if( laplacian ) img.passert_type( IT_F_GRAY | IT_F_PRGB );
+        else            img.passert_type( IT_F_GRAY | IT_F_PRGB | IT_U_GRAY | IT_U_PRGB );
+
+        configure( img.w(), img.h(), img.type(), n_octaves, n_sublevels, laplacian );
+
+        int nl = n_levels();
+        int nc = img.ch();
+        switch( img.precision() ) {
+        case TYPE_FLOAT:
+            m_gauss[0].copy( &img );
+            for( int l=1; l<nl; l++ )
+                resample( m_down[l-1], m_gauss[l-1].get_row_f(0), run_parallel, m_gauss[l].get_row_f(0) );
+            if( laplacian ) {
+                for( int l=0; l<nl-1; l++ ) {
+                    float* lap = m_lap[l].get_row_f(0);
+                    resample( m_up[l], m_gauss[l+1].get_row_f(0), run_parallel, lap );
+                    pyramid_combine( m_gauss[l].get_row_f(0), m_lap[l].w(), m_lap[l].h(), nc, -1.0f, run_parallel, lap );
+                }
+            }
+            break;
+        case TYPE_UCHAR:
+            m_gauss[0].copy( &img );
+            for( int l=1; l<nl; l++ )
+                resample( m_down[l-1], m_gauss[l-1].get_row_u(0), run_parallel, m_gauss[l].get_row_u(0) );
+            break;
+        default: switch_fatality();
+        }
+    }
+
+    const Image& Pyramid::gaussian( const int& l ) const {
+        passert_statement( l >= 0 && l < n_levels(), "invalid pyramid level" );
+        return m_gauss[l];
+    }
+
+    const Image& Pyramid::laplacian( const int& l ) const {
+        passert_statement( m_laplacian, "laplacian levels are not built" );
+        passert_statement( l >= 0 && l < n_levels(), "invalid pyramid level" );
+        return m_lap[l];
+    }
+
+    float Pyramid::scale( const int& l ) const {
+        passert_statement( l >= 0 && l < n_levels(), "invalid pyramid level" );
+        return float( std::pow( 2.0, -double(l)/m_n_sublevels ) );
+    }
+
+    void Pyramid::collapse( const bool& run_parallel, Image& out ) {
+        passert_statement( m_laplacian && n_levels(), "laplacian levels are not built" );
+        int nl = n_levels();
+        int nc = image_no_channels( m_type );
+        out.create( m_w, m_h, m_type );
+        if( nl == 1 ) {
+            out.copy( &m_lap[0] );
+            return;
+        }
+        // the levels are packed: a view is collapsed into a packed copy
+        Image  packed;
+        Image& dst = out.is_contiguous() ? out : packed;
+        dst.create( m_w, m_h, m_type );
+        // reconstructions of the even levels go to dst, the odd ones to m_work
+        m_work.resize( Image::req_mem( m_lap[1].w(), m_lap[1].h(), m_type ) );
+        const float* prev = m_lap[nl-1].get_row_f(0);
+        for( int l=nl-2; l>=0; l-- ) {
+            float* cur = ( l%2 ) ? (float*)m_work.get_buffer() : dst.get_row_f(0);
+            resample( m_up[l], prev, run_parallel, cur );
+            pyramid_combine( m_lap[l].get_row_f(0), m_lap[l].w(), m_lap[l].h(), nc, 1.0f, run_parallel, cur );
+            prev = cur;
+        }
+        if( &dst != &out )
+            out.copy( &dst );
+    }
+
+}
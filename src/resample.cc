@@ -0,0 +1,574 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/resample.h>
+#include <kortex/image.h>
+#include <kortex/mem_unit.h>
+#include <kortex/check.h>
+#include <kortex/defs.h>
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+using std::vector;
+
+namespace kortex {
+
+    /// output rows per band of the vertical pass. a band resamples the source
+    /// rows it needs along the rows first - the ntaps-1 rows it shares with
+    /// the next band are computed twice.
+    const int RESAMPLE_BAND = 64;
+
+    //
+    // weight tables
+    //
+
+    /// keys' cubic convolution kernel with a=-0.5 (catmull-rom)
+    double resample_cubic( const double& t ) {
+        double x = std::fabs( t );
+        if( x < 1.0 ) return ( 1.5*x - 2.5 )*x*x + 1.0;
+        if( x < 2.0 ) return ( ( -0.5*x + 2.5 )*x - 4.0 )*x + 2.0;
+        return 0.0;
+    }
+
+    /// lanczos kernel with a=3: sinc(x) sinc(x/3)
+    double resample_lanczos( const double& t ) {
+        double x = std::fabs( t );
+        if( x < 1e-8 ) return 1.0;
+        if( x >= 3.0 ) return 0.0;
+        double px = PI * x;
+        return 3.0 * std::sin(px) * std::sin(px/3.0) / ( px*px );
+    }
+
+    void resample_axis( const int& n_in, const int& n_out, const ResampleMode& mode, ResampleAxis& axis ) {
+        passert_statement( n_in > 0 && n_out > 0, "invalid resampling size" );
+        double scale = double(n_in) / double(n_out);
+        // kernels are stretched by the scale when shrinking
+        double fs    = std::max( 1.0, scale );
+        double support = 0.0; // half width of the kernel in source pixels
+        switch( mode ) {
+        case RESAMPLE_BICUBIC : support = 2.0*fs;         break;
+        case RESAMPLE_LANCZOS : support = 3.0*fs;         break;
+        case RESAMPLE_AREA    : support = 0.5*fs + 0.5;   break;
+        case RESAMPLE_GAUSSIAN: support = 1.5*fs;         break;
+        default: switch_fatality();
+        }
+        int ntaps = std::max( 1, int( std::ceil( 2.0*support - 1e-9 ) ) );
+
+        axis.n_out = n_out;
+        axis.ntaps = ntaps;
+        axis.first  .resize( n_out );
+        axis.weights.resize( size_t(n_out)*ntaps );
+
+        vector<double> wd( ntaps );
+        for( int i=0; i<n_out; i++ ) {
+            double c     = ( i + 0.5 ) * scale - 0.5;
+            int    first = int( std::floor( c - support ) ) + 1;
+            double sum   = 0.0;
+            for( int k=0; k<ntaps; k++ ) {
+                double d = first + k - c;
+                switch( mode ) {
+                case RESAMPLE_BICUBIC: wd[k] = resample_cubic  ( d/fs ); break;
+                case RESAMPLE_LANCZOS: wd[k] = resample_lanczos( d/fs ); break;
+                case RESAMPLE_AREA   : // overlap of pixel [d-0.5,d+0.5] with [-fs/2,fs/2]
+                    wd[k] = std::max( 0.0, std::min(d+0.5, 0.5*fs) - std::max(d-0.5, -0.5*fs) );
+                    break;
+                case RESAMPLE_GAUSSIAN: // sigma of half an output pixel, cut at 3 sigma
+                    wd[k] = std::exp( -2.0*d*d/(fs*fs) );
+                    break;
+                default: switch_fatality();
+                }
+                sum += wd[k];
+            }
+            axis.first[i] = first;
+            float* wi = &axis.weights[ size_t(i)*ntaps ];
+            for( int k=0; k<ntaps; k++ )
+                wi[k] = float( wd[k] / sum );
+        }
+    }
+
+    //
+    // horizontal kernels: out[x*nc+c] = sum_k wt[x*nt+k] * line[(ofs[x]+k)*nc+c]
+    // for x<n.
+    //
+
+    void resample_row_basic( const float* line, const int& nc, const int* ofs, const float* wt, const int& nt,
+                             const int& n, float* out ) {
+        for( int x=0; x<n; x++ ) {
+            const float* lx = line + ofs[x]*nc;
+            const float* wx = wt + size_t(x)*nt;
+            for( int c=0; c<nc; c++ ) {
+                float s = lx[c]*wx[0];
+                for( int k=1; k<nt; k++ )
+                    s += lx[k*nc+c]*wx[k];
+                out[x*nc+c] = s;
+            }
+        }
+    }
+
+#ifdef WITH_SSE
+    /// nc == 1 : a dot product per output - nt is a multiple of 4.
+    /// nc <= 4 : all channels of a pixel in one register. reads and writes 4
+    ///           floats per pixel, so line and out need 4 floats of slack.
+    void resample_row_sse( const float* line, const int& nc, const int* ofs, const float* wt, const int& nt,
+                           const int& n, float* out ) {
+        if( nc == 1 ) {
+            for( int x=0; x<n; x++ ) {
+                const float* lx = line + ofs[x];
+                const float* wx = wt + size_t(x)*nt;
+                __m128 s = _mm_mul_ps( _mm_loadu_ps(lx), _mm_loadu_ps(wx) );
+                for( int k=4; k<nt; k+=4 )
+                    s = _mm_add_ps( s, _mm_mul_ps( _mm_loadu_ps(lx+k), _mm_loadu_ps(wx+k) ) );
+                s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+                s = _mm_add_ss( s, _mm_shuffle_ps( s, s, 1 ) );
+                out[x] = _mm_cvtss_f32( s );
+            }
+            return;
+        }
+        for( int x=0; x<n; x++ ) {
+            const float* lx = line + ofs[x]*nc;
+            const float* wx = wt + size_t(x)*nt;
+            __m128 s = _mm_mul_ps( _mm_loadu_ps(lx), _mm_set1_ps(wx[0]) );
+            for( int k=1; k<nt; k++ )
+                s = _mm_add_ps( s, _mm_mul_ps( _mm_loadu_ps(lx+k*nc), _mm_set1_ps(wx[k]) ) );
+            _mm_storeu_ps( out+x*nc, s );
+        }
+    }
+#endif
+
+    //
+    // conversions
+    //
+
+    inline void resample_load( const float* src, const int& n, float* dst ) {
+        memcpy( dst, src, sizeof(*dst)*n );
+    }
+    inline void resample_load( const uchar* src, const int& n, float* dst ) {
+        for( int i=0; i<n; i++ )
+            dst[i] = float( src[i] );
+    }
+
+    inline void resample_load( const int* src, const int& n, float* dst ) {
+        for( int i=0; i<n; i++ )
+            dst[i] = float( src[i] );
+    }
+
+    inline void resample_store( const float* src, const int& n, int* dst ) {
+        for( int i=0; i<n; i++ )
+            dst[i] = int( std::floor( src[i] + 0.5f ) );
+    }
+
+    /// rounds to nearest and saturates
+    inline void resample_store( const float* src, const int& n, uchar* dst ) {
+        int i=0;
+#ifdef WITH_SSE
+        const __m128 lo   = _mm_setzero_ps();
+        const __m128 hi   = _mm_set1_ps( 255.0f );
+        const __m128 half = _mm_set1_ps( 0.5f );
+        for( ; i+16<=n; i+=16 ) {
+            __m128i v[4];
+            for( int k=0; k<4; k++ ) {
+                __m128 f = _mm_min_ps( _mm_max_ps( _mm_loadu_ps(src+i+4*k), lo ), hi );
+                v[k] = _mm_cvttps_epi32( _mm_add_ps( f, half ) );
+            }
+            __m128i p = _mm_packus_epi16( _mm_packs_epi32( v[0], v[1] ), _mm_packs_epi32( v[2], v[3] ) );
+            _mm_storeu_si128( (__m128i*)(dst+i), p );
+        }
+#endif
+        for( ; i<n; i++ )
+            dst[i] = uchar( std::min( 255.0f, std::max( 0.0f, src[i] ) ) + 0.5f );
+    }
+
+    //
+    // engine
+    //
+
+    void resample_plan( const int& w, const int& h, const int& nc, const int& nw, const int& nh,
+                        const ResampleMode& mode, const BorderMode& border, ResamplePlan& rs ) {
+        passert_statement( w > 0 && h > 0 && nc > 0, "empty image" );
+        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
+        rs.w  = w;  rs.h  = h;  rs.nc = nc;
+        rs.nw = nw; rs.nh = nh;
+        rs.mode   = mode;
+        rs.border = border;
+        resample_axis( w, nw, mode, rs.ax );
+        resample_axis( h, nh, mode, rs.ay );
+
+        rs.sse = false;
+#ifdef WITH_SSE
+        rs.sse = filter_simd_level() >= SIMD_SSE && nc <= 4;
+#endif
+        int nt = rs.ax.ntaps;
+        rs.hnt = ( rs.sse && nc == 1 ) ? (nt+3) & ~3 : nt;
+        rs.u0  = rs.ax.first[0];
+        rs.nu  = rs.ax.first[nw-1] + rs.hnt - rs.u0;
+        rs.hofs.resize( nw );
+        rs.hwt .assign( size_t(nw)*rs.hnt, 0.0f );
+        for( int x=0; x<nw; x++ ) {
+            rs.hofs[x] = rs.ax.first[x] - rs.u0;
+            memcpy( &rs.hwt[size_t(x)*rs.hnt], &rs.ax.weights[size_t(x)*nt], sizeof(float)*nt );
+        }
+    }
+
+    /// pads a source row to the columns [u0,u0+nu) in line
+    template<typename T>
+    void resampler_fill_line( const ResamplePlan& rs, const T* row, float* line ) {
+        const int nc = rs.nc;
+        const int ue = rs.u0 + rs.nu;
+        int xs = std::max( rs.u0, 0 );
+        int xe = std::min( ue, rs.w );
+        resample_load( row + size_t(xs)*nc, (xe-xs)*nc, line + (xs-rs.u0)*nc );
+        for( int u=rs.u0; u<ue; u++ ) {
+            if( u == xs ) u = xe;
+            if( u == ue ) break;
+            int    m  = border_index( u, rs.w, rs.border );
+            float* lu = line + (u-rs.u0)*nc;
+            if( m < 0 ) memset( lu, 0, sizeof(*lu)*nc );
+            else        resample_load( row + size_t(m)*nc, nc, lu );
+        }
+    }
+
+    /// vertical pass of an output row - uchar rows go through tmp
+    inline void resampler_combine( const float* const* rows, const int& n, const float* wt, const int& nt,
+                                   float* out, float* ) {
+        filter_rows( rows, n, wt, nt, out );
+    }
+    inline void resampler_combine( const float* const* rows, const int& n, const float* wt, const int& nt,
+                                   uchar* out, float* tmp ) {
+        filter_rows( rows, n, wt, nt, tmp );
+        resample_store( tmp, n, out );
+    }
+    inline void resampler_combine( const float* const* rows, const int& n, const float* wt, const int& nt,
+                                   int* out, float* tmp ) {
+        filter_rows( rows, n, wt, nt, tmp );
+        resample_store( tmp, n, out );
+    }
+
+    /// output rows [y0,y1): resamples the source rows the band needs along
+    /// the rows, then combines them down the columns. is and os are the row
+    /// strides of im and out.
+    template<typename T, typename U>
+    void resampler_band( const ResamplePlan& rs, const T* im, const size_t& is, const int& y0, const int& y1,
+                         U* out, const size_t& os ) {
+        const int nc = rs.nc;
+        const int rl = rs.nw*nc;
+        const int nt = rs.ay.ntaps;
+        const int v0 = rs.ay.first[y0];
+        const int nv = rs.ay.first[y1-1] + nt - v0;
+
+        size_t n_line    = size_t(rs.nu)*nc + 4;
+        size_t n_hrows   = size_t(nv)*rl + 4;
+        size_t n_scratch = n_line + n_hrows + 2*size_t(rl);
+        uchar* scratch = thread_scratch( 0, sizeof(const float*)*nt + sizeof(float)*n_scratch );
+        const float** rows = (const float**)scratch;
+        float* line  = (float*)( rows + nt );
+        float* hrows = line  + n_line;
+        float* zeros = hrows + n_hrows;
+        float* orow  = zeros + rl;
+        memset( line + n_line - 4, 0, sizeof(*line)*4 );
+        memset( zeros, 0, sizeof(*zeros)*rl );
+
+        for( int v=v0; v<v0+nv; v++ ) {
+            int m = border_index( v, rs.h, rs.border );
+            if( m < 0 ) continue;
+            resampler_fill_line( rs, im + size_t(m)*is, line );
+            float* hr = hrows + size_t(v-v0)*rl;
+#ifdef WITH_SSE
+            if( rs.sse ) {
+                resample_row_sse( line, nc, &rs.hofs[0], &rs.hwt[0], rs.hnt, rs.nw, hr );
+                continue;
+            }
+#endif
+            resample_row_basic( line, nc, &rs.hofs[0], &rs.hwt[0], rs.hnt, rs.nw, hr );
+        }
+
+        for( int y=y0; y<y1; y++ ) {
+            int first = rs.ay.first[y];
+            for( int k=0; k<nt; k++ ) {
+                int m = border_index( first+k, rs.h, rs.border );
+                rows[k] = m < 0 ? zeros : hrows + size_t(first+k-v0)*rl;
+            }
+            resampler_combine( rows, rl, &rs.ay.weights[size_t(y)*nt], nt, out+size_t(y)*os, orow );
+        }
+    }
+
+    //
+    // exact 2x and 4x area reductions: the mean of the f x f blocks. the
+    // rows of a block are summed first, then the f samples of a block in
+    // every channel - pairwise, in the same order in the sse and the scalar
+    // code. uchar means are rounded half up from the exact integer sums.
+    //
+
+    /// output samples [x0,nw) of a row from the f source rows
+    void area_shrink_row( const float* const* rows, const int& nw, const int& nc, const int& f, const int& x0,
+                          float* acc, float* out ) {
+        const int   n   = nw*f*nc;
+        const float inv = 1.0f / float( f*f );
+        const float *r0 = rows[0], *r1 = rows[1];
+        if( f == 2 ) {
+            for( int i=x0*f*nc; i<n; i++ )
+                acc[i] = r0[i] + r1[i];
+        } else {
+            const float *r2 = rows[2], *r3 = rows[3];
+            for( int i=x0*f*nc; i<n; i++ )
+                acc[i] = ( r0[i] + r1[i] ) + ( r2[i] + r3[i] );
+        }
+        for( int x=x0; x<nw; x++ ) {
+            for( int c=0; c<nc; c++ ) {
+                const float* a = acc + x*f*nc + c;
+                float s = f == 2 ? a[0] + a[nc] : ( a[0] + a[nc] ) + ( a[2*nc] + a[3*nc] );
+                out[x*nc+c] = s * inv;
+            }
+        }
+    }
+
+    void area_shrink_row( const uchar* const* rows, const int& nw, const int& nc, const int& f, const int& x0,
+                          uint16_t* acc, uchar* out ) {
+        const int    n  = nw*f*nc;
+        const uchar *r0 = rows[0], *r1 = rows[1];
+        if( f == 2 ) {
+            for( int i=x0*f*nc; i<n; i++ )
+                acc[i] = uint16_t( r0[i] + r1[i] );
+            for( int x=x0; x<nw; x++ ) {
+                const uint16_t* a = acc + 2*x*nc;
+                for( int c=0; c<nc; c++ )
+                    out[x*nc+c] = uchar( ( a[c] + a[nc+c] + 2 ) >> 2 );
+            }
+            return;
+        }
+        const uchar *r2 = rows[2], *r3 = rows[3];
+        for( int i=x0*f*nc; i<n; i++ )
+            acc[i] = uint16_t( r0[i] + r1[i] + r2[i] + r3[i] );
+        for( int x=x0; x<nw; x++ ) {
+            const uint16_t* a = acc + 4*x*nc;
+            for( int c=0; c<nc; c++ )
+                out[x*nc+c] = uchar( ( a[c] + a[nc+c] + a[2*nc+c] + a[3*nc+c] + 8 ) >> 4 );
+        }
+    }
+
+#ifdef WITH_SSE
+    /// single channel rows: returns the number of outputs done
+    int area_shrink_row_sse( const float* const* rows, const int& nw, const int& f, float* out ) {
+        const __m128 inv = _mm_set1_ps( 1.0f / float( f*f ) );
+        const float *r0 = rows[0], *r1 = rows[1];
+        int x=0;
+        if( f == 2 ) {
+            for( ; x+4<=nw; x+=4 ) {
+                __m128 s0 = _mm_add_ps( _mm_loadu_ps(r0+2*x  ), _mm_loadu_ps(r1+2*x  ) );
+                __m128 s1 = _mm_add_ps( _mm_loadu_ps(r0+2*x+4), _mm_loadu_ps(r1+2*x+4) );
+                __m128 ev = _mm_shuffle_ps( s0, s1, _MM_SHUFFLE(2,0,2,0) );
+                __m128 od = _mm_shuffle_ps( s0, s1, _MM_SHUFFLE(3,1,3,1) );
+                _mm_storeu_ps( out+x, _mm_mul_ps( _mm_add_ps( ev, od ), inv ) );
+            }
+            return x;
+        }
+        const float *r2 = rows[2], *r3 = rows[3];
+        for( ; x+4<=nw; x+=4 ) {
+            __m128 v[4];
+            for( int k=0; k<4; k++ ) {
+                int i = 4*x + 4*k;
+                v[k] = _mm_add_ps( _mm_add_ps( _mm_loadu_ps(r0+i), _mm_loadu_ps(r1+i) ),
+                                   _mm_add_ps( _mm_loadu_ps(r2+i), _mm_loadu_ps(r3+i) ) );
+            }
+            _MM_TRANSPOSE4_PS( v[0], v[1], v[2], v[3] );
+            __m128 s = _mm_add_ps( _mm_add_ps( v[0], v[1] ), _mm_add_ps( v[2], v[3] ) );
+            _mm_storeu_ps( out+x, _mm_mul_ps( s, inv ) );
+        }
+        return x;
+    }
+
+    /// sums of the byte pairs of 16 samples, summed over the f rows
+    inline __m128i area_pair_sums( const uchar* const* rows, const int& f, const int& i ) {
+        const __m128i lo = _mm_set1_epi16( 0x00ff );
+        __m128i s = _mm_setzero_si128();
+        for( int j=0; j<f; j++ ) {
+            __m128i v = _mm_loadu_si128( (const __m128i*)(rows[j]+i) );
+            s = _mm_add_epi16( s, _mm_add_epi16( _mm_and_si128( v, lo ), _mm_srli_epi16( v, 8 ) ) );
+        }
+        return s;
+    }
+
+    int area_shrink_row_sse( const uchar* const* rows, const int& nw, const int& f, uchar* out ) {
+        int x=0;
+        if( f == 2 ) {
+            const __m128i half = _mm_set1_epi16( 2 );
+            for( ; x+16<=nw; x+=16 ) {
+                __m128i s0 = _mm_srli_epi16( _mm_add_epi16( area_pair_sums( rows, 2, 2*x    ), half ), 2 );
+                __m128i s1 = _mm_srli_epi16( _mm_add_epi16( area_pair_sums( rows, 2, 2*x+16 ), half ), 2 );
+                _mm_storeu_si128( (__m128i*)(out+x), _mm_packus_epi16( s0, s1 ) );
+            }
+            return x;
+        }
+        const __m128i ones = _mm_set1_epi16( 1 );
+        const __m128i half = _mm_set1_epi32( 8 );
+        for( ; x+16<=nw; x+=16 ) {
+            __m128i q[4];
+            for( int k=0; k<4; k++ ) {
+                __m128i p = area_pair_sums( rows, 4, 4*x + 16*k );
+                q[k] = _mm_srli_epi32( _mm_add_epi32( _mm_madd_epi16( p, ones ), half ), 4 );
+            }
+            __m128i p = _mm_packus_epi16( _mm_packs_epi32( q[0], q[1] ), _mm_packs_epi32( q[2], q[3] ) );
+            _mm_storeu_si128( (__m128i*)(out+x), p );
+        }
+        return x;
+    }
+#endif
+
+    template<typename T, typename A>
+    void area_shrink_run( const T* im, const size_t& is, const int& w, const int& h, const int& nc, const int& f,
+                          const bool& run_parallel, T* out, const size_t& os, A* ) {
+        const int nw = w/f;
+        const int nh = h/f;
+        const int rl = w*nc;
+        const int n_bands = (nh+RESAMPLE_BAND-1) / RESAMPLE_BAND;
+#ifdef WITH_SSE
+        const bool sse = nc == 1 && filter_simd_level() >= SIMD_SSE;
+#endif
+#pragma omp parallel for if( run_parallel )
+        for( int b=0; b<n_bands; b++ ) {
+            A* acc = (A*)thread_scratch( 0, sizeof(A)*rl );
+            const T* rows[4];
+            for( int y=b*RESAMPLE_BAND; y<std::min(nh,(b+1)*RESAMPLE_BAND); y++ ) {
+                for( int j=0; j<f; j++ )
+                    rows[j] = im + size_t(y*f+j)*is;
+                T*  orow = out + size_t(y)*os;
+                int x0   = 0;
+#ifdef WITH_SSE
+                if( sse ) x0 = area_shrink_row_sse( rows, nw, f, orow );
+#endif
+                area_shrink_row( rows, nw, nc, f, x0, acc, orow );
+            }
+        }
+    }
+
+    /// type of the row sums: exact for uchar
+    inline float*    area_accumulator( const float* ) { return NULL; }
+    inline uint16_t* area_accumulator( const uchar* ) { return NULL; }
+
+    /// runs the exact 2x / 4x reductions - returns false if they do not apply
+    template<typename T>
+    bool resample_area_shrink( const T* im, const size_t& is, const int& w, const int& h, const int& nc,
+                               const int& nw, const int& nh, const bool& run_parallel, T* out, const size_t& os ) {
+        int f = w / nw;
+        if( ( f != 2 && f != 4 ) || w != nw*f || h != nh*f )
+            return false;
+        area_shrink_run( im, is, w, h, nc, f, run_parallel, out, os, area_accumulator( im ) );
+        return true;
+    }
+    template<>
+    bool resample_area_shrink( const int*, const size_t&, const int&, const int&, const int&,
+                               const int&, const int&, const bool&, int*, const size_t& ) {
+        return false;
+    }
+
+    /// istride / ostride are the row strides in samples - 0 for packed rows
+    template<typename T>
+    void resample_run( const ResamplePlan& rs, const T* im, const bool& run_parallel, T* out,
+                       const int& istride=0, const int& ostride=0 ) {
+        passert_pointer( im ); passert_pointer( out );
+        passert_noalias_p( (const void*)im, (const void*)out );
+        size_t is = istride ? istride : size_t(rs.w)*rs.nc;
+        size_t os = ostride ? ostride : size_t(rs.nw)*rs.nc;
+        if( rs.mode == RESAMPLE_AREA &&
+            resample_area_shrink( im, is, rs.w, rs.h, rs.nc, rs.nw, rs.nh, run_parallel, out, os ) )
+            return;
+        int n_bands = (rs.nh+RESAMPLE_BAND-1) / RESAMPLE_BAND;
+#pragma omp parallel for if( run_parallel )
+        for( int b=0; b<n_bands; b++ )
+            resampler_band( rs, im, is, b*RESAMPLE_BAND, std::min(rs.nh,(b+1)*RESAMPLE_BAND), out, os );
+    }
+
+    template<typename T>
+    void resample_run( const T* im, const int& w, const int& h, const int& nc,
+                       const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border,
+                       const bool& run_parallel, T* out, const int& istride=0, const int& ostride=0 ) {
+        size_t is = istride ? istride : size_t(w)*nc;
+        size_t os = ostride ? ostride : size_t(nw)*nc;
+        if( mode == RESAMPLE_AREA && resample_area_shrink( im, is, w, h, nc, nw, nh, run_parallel, out, os ) )
+            return;
+        ResamplePlan rs;
+        resample_plan( w, h, nc, nw, nh, mode, border, rs );
+        resample_run( rs, im, run_parallel, out, istride, ostride );
+    }
+
+    void resample( const ResamplePlan& plan, const float* im, const bool& run_parallel, float* out ) {
+        resample_run( plan, im, run_parallel, out );
+    }
+    void resample( const ResamplePlan& plan, const uchar* im, const bool& run_parallel, uchar* out ) {
+        resample_run( plan, im, run_parallel, out );
+    }
+
+    void resample( const float* im, const int& w, const int& h, const int& nc,
+                   const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, float* out ) {
+        resample_run( im, w, h, nc, nw, nh, mode, border, false, out );
+    }
+    void resample_par( const float* im, const int& w, const int& h, const int& nc,
+                       const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, float* out ) {
+        resample_run( im, w, h, nc, nw, nh, mode, border, true, out );
+    }
+    void resample( const uchar* im, const int& w, const int& h, const int& nc,
+                   const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, uchar* out ) {
+        resample_run( im, w, h, nc, nw, nh, mode, border, false, out );
+    }
+    void resample_par( const uchar* im, const int& w, const int& h, const int& nc,
+                       const int& nw, const int& nh, const ResampleMode& mode, const BorderMode& border, uchar* out ) {
+        resample_run( im, w, h, nc, nw, nh, mode, border, true, out );
+    }
+
+    void image_resample( const Image& src, const int& nw, const int& nh, const ResampleMode& mode,
+                         const bool& run_parallel, Image& dst, const BorderMode& border ) {
+        assert_statement( !src.is_empty(), "empty image" );
+        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
+        passert_noalias( src, dst );
+        src.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB | IT_I_GRAY );
+        dst.create( nw, nh, src.type() );
+
+        int w  = src.w();
+        int h  = src.h();
+        int is = src.stride();
+        int os = dst.stride();
+        switch( src.type() ) {
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+            resample_run( src.get_row_f(0), w, h, src.ch(), nw, nh, mode, border, run_parallel, dst.get_row_f(0),
+                          is, os );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            resample_run( src.get_row_u(0), w, h, src.ch(), nw, nh, mode, border, run_parallel, dst.get_row_u(0),
+                          is, os );
+            break;
+        case IT_I_GRAY:
+            resample_run( src.get_row_i(0), w, h, 1, nw, nh, mode, border, run_parallel, dst.get_row_i(0),
+                          is, os );
+            break;
+        case IT_F_IRGB:
+            for( int c=0; c<3; c++ )
+                resample_run( src.get_channel_f(c), w, h, 1, nw, nh, mode, border, run_parallel,
+                              dst.get_channel_f(c), is, os );
+            break;
+        case IT_U_IRGB:
+            for( int c=0; c<3; c++ )
+                resample_run( src.get_channel_u(c), w, h, 1, nw, nh, mode, border, run_parallel,
+                              dst.get_channel_u(c), is, os );
+            break;
+        default: switch_fatality();
+        }
+    }
+
+}
@@ -0,0 +1,738 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#include <kortex/warp.h>
+#include <kortex/image.h>
+#include <kortex/mem_unit.h>
+#include <kortex/check.h>
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#ifdef WITH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace kortex {
+
+    /// destination tiles are WARP_TILE_W x WARP_TILE_H pixels: wide enough
+    /// to keep the pages a tile touches few, tall enough for the source
+    /// rows to be reused from cache under rotations.
+    const int WARP_TILE_W = 128;
+    const int WARP_TILE_H = 32;
+
+    /// source coordinates are clamped to +-WARP_FAR: far enough to read as
+    /// border, close enough for integer arithmetic. nans go to -WARP_FAR.
+    const float WARP_FAR = 1e6f;
+
+    inline float warp_clamp( const float& v ) {
+        float u = v > -WARP_FAR ? v : -WARP_FAR;
+        return    u <  WARP_FAR ? u :  WARP_FAR;
+    }
+
+    inline void warp_store( const float& v, float* o ) { *o = v; }
+
+    /// rounds to nearest and saturates
+    inline void warp_store( const float& v, uchar* o ) {
+        float r = std::floor( v + 0.5f );
+        *o = uchar( r < 0.0f ? 0.0f : ( r > 255.0f ? 255.0f : r ) );
+    }
+
+    /// pixel (x,y) of the image with rows is elements apart after the
+    /// border mode - zero if it reads as zero
+    template<typename T>
+    inline const T* warp_pixel( const T* im, const int& w, const int& h, const int& nc, const size_t& is,
+                                const int& x, const int& y, const BorderMode& border, const T* zero ) {
+        if( x >= 0 && y >= 0 && x < w && y < h )
+            return im + size_t(y)*is + size_t(x)*nc;
+        int u = border_index( x, w, border );
+        int v = border_index( y, h, border );
+        if( u < 0 || v < 0 ) return zero;
+        return im + size_t(v)*is + size_t(u)*nc;
+    }
+
+    /// the k x k neighbourhood starting at (x0,y0) after the border mode:
+    /// p[j*k+i] is pixel (x0+i,y0+j) or zero if it reads as zero
+    template<typename T>
+    inline void warp_neighbourhood( const T* im, const int& w, const int& h, const int& nc, const size_t& is,
+                                    const int& x0, const int& y0, const int& k, const BorderMode& border, const T* zero, const T** p ) {
+        if( x0 >= 0 && y0 >= 0 && x0 <= w-k && y0 <= h-k ) {
+            for( int j=0; j<k; j++ )
+                for( int i=0; i<k; i++ )
+                    p[j*k+i] = im + size_t(y0+j)*is + size_t(x0+i)*nc;
+            return;
+        }
+        int cx[4], ry[4];
+        for( int i=0; i<k; i++ ) {
+            cx[i] = border_index( x0+i, w, border );
+            ry[i] = border_index( y0+i, h, border );
+        }
+        for( int j=0; j<k; j++ )
+            for( int i=0; i<k; i++ )
+                p[j*k+i] = ( cx[i] < 0 || ry[j] < 0 ) ? zero : im + size_t(ry[j])*is + size_t(cx[i])*nc;
+    }
+
+    /// the kernel of bicubic_interpolation_1d as the weights of n0..n3
+    inline void warp_cubic_weights( const float& t, float* wt ) {
+        float t2 = t*t;
+        float t3 = t2*t;
+        wt[0] = 0.5f*( -t3 + 2.0f*t2 - t );
+        wt[1] = 0.5f*( 3.0f*t3 - 5.0f*t2 + 2.0f );
+        wt[2] = 0.5f*( -3.0f*t3 + 4.0f*t2 + t );
+        wt[3] = 0.5f*( t3 - t2 );
+    }
+
+    //
+    // samplers: all nc channels of one destination pixel from the source
+    // position (sx,sy)
+    //
+
+    template<typename T, typename O>
+    inline void warp_sample_nearest( const T* im, const int& w, const int& h, const int& nc, const size_t& is,
+                                     const float& sx, const float& sy, const BorderMode& border, O* o ) {
+        const T zero[4] = { 0, 0, 0, 0 };
+        const T* p = warp_pixel( im, w, h, nc, is, int( std::floor(sx+0.5f) ), int( std::floor(sy+0.5f) ), border, zero );
+        for( int c=0; c<nc; c++ )
+            o[c] = p[c];
+    }
+
+    template<typename T, typename O>
+    inline void warp_sample_bilinear( const T* im, const int& w, const int& h, const int& nc, const size_t& is,
+                                      const float& sx, const float& sy, const BorderMode& border, O* o ) {
+        const T zero[4] = { 0, 0, 0, 0 };
+        float fx = std::floor( sx );
+        float fy = std::floor( sy );
+        int   x0 = int( fx );
+        int   y0 = int( fy );
+        float ax = sx - fx;
+        float ay = sy - fy;
+        const T* p[4];
+        warp_neighbourhood( im, w, h, nc, is, x0, y0, 2, border, zero, p );
+        for( int c=0; c<nc; c++ ) {
+            float a = p[0][c], b = p[1][c], d = p[2][c], e = p[3][c];
+            float t = a + ax*( b - a );
+            float u = d + ax*( e - d );
+            warp_store( t + ay*( u - t ), o+c );
+        }
+    }
+
+    template<typename T, typename O>
+    inline void warp_sample_bicubic( const T* im, const int& w, const int& h, const int& nc, const size_t& is,
+                                     const float& sx, const float& sy, const BorderMode& border, O* o ) {
+        const T zero[4] = { 0, 0, 0, 0 };
+        float fx = std::floor( sx );
+        float fy = std::floor( sy );
+        int   x0 = int( fx );
+        int   y0 = int( fy );
+        float wx[4], wy[4];
+        warp_cubic_weights( sx - fx, wx );
+        warp_cubic_weights( sy - fy, wy );
+        if( x0 >= 1 && y0 >= 1 && x0 < w-2 && y0 < h-2 ) {
+            const size_t rs = is;
+            const T*     p0 = im + size_t(y0-1)*is + size_t(x0-1)*nc;
+            for( int c=0; c<nc; c++ ) {
+                const T* r = p0 + c;
+                float s = 0.0f;
+                for( int j=0; j<4; j++, r+=rs )
+                    s += wy[j] * ( wx[0]*r[0] + wx[1]*r[nc] + wx[2]*r[2*nc] + wx[3]*r[3*nc] );
+                warp_store( s, o+c );
+            }
+            return;
+        }
+        const T* p[16];
+        warp_neighbourhood( im, w, h, nc, is, x0-1, y0-1, 4, border, zero, p );
+        for( int c=0; c<nc; c++ ) {
+            float s = 0.0f;
+            for( int j=0; j<4; j++ ) {
+                const T* const* pj = p + 4*j;
+                s += wy[j] * ( wx[0]*pj[0][c] + wx[1]*pj[1][c] + wx[2]*pj[2][c] + wx[3]*pj[3][c] );
+            }
+            warp_store( s, o+c );
+        }
+    }
+
+#ifdef WITH_SSE
+    inline void warp_store4( const __m128& v, float* o ) {
+        _mm_storeu_ps( o, v );
+    }
+    inline void warp_store4( const __m128& v, uchar* o ) {
+        __m128  f = _mm_min_ps( _mm_max_ps( v, _mm_setzero_ps() ), _mm_set1_ps(255.0f) );
+        __m128i q = _mm_cvttps_epi32( _mm_add_ps( f, _mm_set1_ps(0.5f) ) );
+        q = _mm_packs_epi32( q, q );
+        q = _mm_packus_epi16( q, q );
+        int r = _mm_cvtsi128_si32( q );
+        memcpy( o, &r, 4 );
+    }
+
+    /// nearest neighbour single channel rows, 4 pixels at a time
+    template<typename T, typename O>
+    void warp_row_nearest_sse( const T* im, const int& w, const int& h, const size_t& is, const float* xs, const float* ys,
+                               const int& n, const BorderMode& border, O* out ) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps( 0.5f );
+        const __m128 xmax = _mm_set1_ps( float(w-1) );
+        const __m128 ymax = _mm_set1_ps( float(h-1) );
+        const size_t ss   = is;
+        int x=0;
+        for( ; x+4<=n; x+=4 ) {
+            __m128 sx = _mm_loadu_ps( xs+x );
+            __m128 sy = _mm_loadu_ps( ys+x );
+            __m128 in = _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( sx, zero ), _mm_cmplt_ps( sx, xmax ) ),
+                                    _mm_and_ps( _mm_cmpge_ps( sy, zero ), _mm_cmplt_ps( sy, ymax ) ) );
+            if( _mm_movemask_ps( in ) != 15 ) {
+                for( int k=x; k<x+4; k++ )
+                    warp_sample_nearest( im, w, h, 1, is, xs[k], ys[k], border, out+k );
+                continue;
+            }
+            int xi[4], yi[4];
+            _mm_storeu_si128( (__m128i*)xi, _mm_cvttps_epi32( _mm_add_ps( sx, half ) ) );
+            _mm_storeu_si128( (__m128i*)yi, _mm_cvttps_epi32( _mm_add_ps( sy, half ) ) );
+            for( int k=0; k<4; k++ )
+                out[x+k] = im[ size_t(yi[k])*ss + xi[k] ];
+        }
+        for( ; x<n; x++ )
+            warp_sample_nearest( im, w, h, 1, is, xs[x], ys[x], border, out+x );
+    }
+
+    /// bilinear single channel rows, 4 pixels at a time. groups that are
+    /// entirely inside the image take the weights and the blend in simd and
+    /// load the 2x2 neighbourhoods one by one - there is no gather.
+    template<typename T, typename O>
+    void warp_row_bilinear_sse( const T* im, const int& w, const int& h, const size_t& is, const float* xs, const float* ys,
+                                const int& n, const BorderMode& border, O* out ) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 xmax = _mm_set1_ps( float(w-1) );
+        const __m128 ymax = _mm_set1_ps( float(h-1) );
+        const size_t ss   = is;
+        int x=0;
+        for( ; x+4<=n; x+=4 ) {
+            __m128 sx = _mm_loadu_ps( xs+x );
+            __m128 sy = _mm_loadu_ps( ys+x );
+            __m128 in = _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( sx, zero ), _mm_cmplt_ps( sx, xmax ) ),
+                                    _mm_and_ps( _mm_cmpge_ps( sy, zero ), _mm_cmplt_ps( sy, ymax ) ) );
+            if( _mm_movemask_ps( in ) != 15 ) {
+                for( int k=x; k<x+4; k++ )
+                    warp_sample_bilinear( im, w, h, 1, is, xs[k], ys[k], border, out+k );
+                continue;
+            }
+            // non-negative: truncation is the floor
+            __m128i ix = _mm_cvttps_epi32( sx );
+            __m128i iy = _mm_cvttps_epi32( sy );
+            __m128  ax = _mm_sub_ps( sx, _mm_cvtepi32_ps( ix ) );
+            __m128  ay = _mm_sub_ps( sy, _mm_cvtepi32_ps( iy ) );
+            int xi[4], yi[4];
+            _mm_storeu_si128( (__m128i*)xi, ix );
+            _mm_storeu_si128( (__m128i*)yi, iy );
+            float a[4], b[4], d[4], e[4];
+            for( int k=0; k<4; k++ ) {
+                const T* p = im + size_t(yi[k])*ss + xi[k];
+                a[k] = p[0];
+                b[k] = p[1];
+                d[k] = p[ss];
+                e[k] = p[ss+1];
+            }
+            __m128 va = _mm_loadu_ps( a ), vd = _mm_loadu_ps( d );
+            __m128 t  = _mm_add_ps( va, _mm_mul_ps( ax, _mm_sub_ps( _mm_loadu_ps(b), va ) ) );
+            __m128 u  = _mm_add_ps( vd, _mm_mul_ps( ax, _mm_sub_ps( _mm_loadu_ps(e), vd ) ) );
+            warp_store4( _mm_add_ps( t, _mm_mul_ps( ay, _mm_sub_ps( u, t ) ) ), out+x );
+        }
+        for( ; x<n; x++ )
+            warp_sample_bilinear( im, w, h, 1, is, xs[x], ys[x], border, out+x );
+    }
+
+    inline __m128 warp_load4( const float* p ) {
+        return _mm_loadu_ps( p );
+    }
+    inline __m128 warp_load4( const uchar* p ) {
+        int v;
+        memcpy( &v, p, 4 );
+        __m128i z = _mm_setzero_si128();
+        __m128i q = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( v ), z ), z );
+        return _mm_cvtepi32_ps( q );
+    }
+
+    /// bicubic single channel rows: the 4 rows of the neighbourhood are
+    /// blended with the vertical weights first, then reduced with the
+    /// horizontal ones. the weights of bicubic_interpolation_1d are
+    /// evaluated as one polynomial for all 4 taps.
+    template<typename T, typename O>
+    void warp_row_bicubic_sse( const T* im, const int& w, const int& h, const size_t& is, const float* xs, const float* ys,
+                               const int& n, const BorderMode& border, O* out ) {
+        const __m128 a3   = _mm_setr_ps( -0.5f,  1.5f, -1.5f,  0.5f );
+        const __m128 a2   = _mm_setr_ps(  1.0f, -2.5f,  2.0f, -0.5f );
+        const __m128 a1   = _mm_setr_ps( -0.5f,  0.0f,  0.5f,  0.0f );
+        const __m128 a0   = _mm_setr_ps(  0.0f,  1.0f,  0.0f,  0.0f );
+        const int    ww   = w;
+        const int    hh   = h;
+        const size_t ss   = is;
+        const BorderMode bm = border;
+        for( int x=0; x<n; x++ ) {
+            float fx = std::floor( xs[x] );
+            float fy = std::floor( ys[x] );
+            int   x0 = int( fx );
+            int   y0 = int( fy );
+            if( x0 < 1 || y0 < 1 || x0 >= ww-2 || y0 >= hh-2 ) {
+                warp_sample_bicubic( im, ww, hh, 1, ss, xs[x], ys[x], bm, out+x );
+                continue;
+            }
+            __m128 tx = _mm_set1_ps( xs[x] - fx );
+            __m128 wx = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( a3, tx ), a2 ), tx ), a1 ), tx ), a0 );
+            float  ty = ys[x] - fy;
+            float  t2 = ty*ty;
+            float  t3 = t2*ty;
+            const T* r = im + size_t(y0-1)*ss + x0-1;
+            __m128 s = _mm_mul_ps( warp_load4( r ), _mm_set1_ps( 0.5f*( -t3 + 2.0f*t2 - ty ) ) );
+            r += ss;
+            s = _mm_add_ps( s, _mm_mul_ps( warp_load4( r ), _mm_set1_ps( 0.5f*( 3.0f*t3 - 5.0f*t2 + 2.0f ) ) ) );
+            r += ss;
+            s = _mm_add_ps( s, _mm_mul_ps( warp_load4( r ), _mm_set1_ps( 0.5f*( -3.0f*t3 + 4.0f*t2 + ty ) ) ) );
+            r += ss;
+            s = _mm_add_ps( s, _mm_mul_ps( warp_load4( r ), _mm_set1_ps( 0.5f*( t3 - t2 ) ) ) );
+            s = _mm_mul_ps( s, wx );
+            s = _mm_add_ps( s, _mm_movehl_ps( s, s ) );
+            s = _mm_add_ss( s, _mm_shuffle_ps( s, s, 1 ) );
+            warp_store( _mm_cvtss_f32( s ), out+x );
+        }
+    }
+#endif
+
+    template<typename T, typename O>
+    void warp_row( const T* im, const int& w, const int& h, const int& nc, const size_t& is,
+                   const float* xs, const float* ys, const int& n, const InterpolationMode& interp, const BorderMode& border, const bool& sse, O* out ) {
+        // locals: the stores to out could alias the references otherwise
+        const int        sw = w;
+        const int        sh = h;
+        const int        sc = nc;
+        const size_t     ss = is;
+        const BorderMode bm = border;
+        switch( interp ) {
+        case INTERP_NEAREST:
+#ifdef WITH_SSE
+            if( sse && sc == 1 ) {
+                warp_row_nearest_sse( im, sw, sh, ss, xs, ys, n, bm, out );
+                break;
+            }
+#endif
+            for( int x=0; x<n; x++ )
+                warp_sample_nearest( im, sw, sh, sc, ss, xs[x], ys[x], bm, out+x*sc );
+            break;
+        case INTERP_BILINEAR:
+#ifdef WITH_SSE
+            if( sse && sc == 1 ) {
+                warp_row_bilinear_sse( im, sw, sh, ss, xs, ys, n, bm, out );
+                break;
+            }
+#endif
+            for( int x=0; x<n; x++ )
+                warp_sample_bilinear( im, sw, sh, sc, ss, xs[x], ys[x], bm, out+x*sc );
+            break;
+        case INTERP_BICUBIC:
+#ifdef WITH_SSE
+            if( sse && sc == 1 ) {
+                warp_row_bicubic_sse( im, sw, sh, ss, xs, ys, n, bm, out );
+                break;
+            }
+#endif
+            for( int x=0; x<n; x++ )
+                warp_sample_bicubic( im, sw, sh, sc, ss, xs[x], ys[x], bm, out+x*sc );
+            break;
+        default: switch_fatality();
+        }
+    }
+
+    //
+    // source coordinates of the destination pixels
+    //
+
+    /// an affine (m[0..5]) or perspective (m[0..8]) transformation, or float
+    /// maps with rows xstride and ystride elements apart when m is NULL
+    struct WarpCoords {
+        const double* m;
+        bool          perspective;
+        const float*  mapx;
+        const float*  mapy;
+        size_t        xstride;
+        size_t        ystride;
+
+        /// pixels [x0,x0+n) of row y. the transformations are evaluated at
+        /// the start of the row segment and stepped along it.
+        void fill( const int& x0, const int& y, const int& n, float* xs, float* ys ) const {
+            if( !m ) {
+                const float* mx = mapx + size_t(y)*xstride + x0;
+                const float* my = mapy + size_t(y)*ystride + x0;
+                for( int i=0; i<n; i++ ) {
+                    xs[i] = warp_clamp( mx[i] );
+                    ys[i] = warp_clamp( my[i] );
+                }
+            } else if( !perspective ) {
+                float bx = float( m[0]*x0 + m[1]*y + m[2] ), dx = float( m[0] );
+                float by = float( m[3]*x0 + m[4]*y + m[5] ), dy = float( m[3] );
+                for( int i=0; i<n; i++ ) {
+                    xs[i] = warp_clamp( bx + i*dx );
+                    ys[i] = warp_clamp( by + i*dy );
+                }
+            } else {
+                float bu = float( m[0]*x0 + m[1]*y + m[2] ), du = float( m[0] );
+                float bv = float( m[3]*x0 + m[4]*y + m[5] ), dv = float( m[3] );
+                float bw = float( m[6]*x0 + m[7]*y + m[8] ), dw = float( m[6] );
+                for( int i=0; i<n; i++ ) {
+                    float iw = 1.0f / ( bw + i*dw );
+                    xs[i] = warp_clamp( ( bu + i*du ) * iw );
+                    ys[i] = warp_clamp( ( bv + i*dv ) * iw );
+                }
+            }
+        }
+    };
+
+    template<typename T>
+    void warp_run( const T* im, const int& w, const int& h, const int& nc, const size_t& is, const WarpCoords& wc,
+                   const int& nw, const int& nh, const InterpolationMode& interp, const BorderMode& border,
+                   const bool& run_parallel, T* out, const size_t& os ) {
+        passert_statement( nc <= 4, "warping supports up to 4 channels" );
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        int ntx = ( nw + WARP_TILE_W - 1 ) / WARP_TILE_W;
+        int nty = ( nh + WARP_TILE_H - 1 ) / WARP_TILE_H;
+#pragma omp parallel for if( run_parallel )
+        for( int t=0; t<ntx*nty; t++ ) {
+            int x0 = ( t % ntx ) * WARP_TILE_W;
+            int y0 = ( t / ntx ) * WARP_TILE_H;
+            int n  = std::min( WARP_TILE_W, nw-x0 );
+            int y1 = std::min( nh, y0+WARP_TILE_H );
+            float xs[WARP_TILE_W], ys[WARP_TILE_W];
+            for( int y=y0; y<y1; y++ ) {
+                wc.fill( x0, y, n, xs, ys );
+                warp_row( im, w, h, nc, is, xs, ys, n, interp, border, sse, out + size_t(y)*os + size_t(x0)*nc );
+            }
+        }
+    }
+
+    void warp_image( const Image& src, const WarpCoords& wc, const int& nw, const int& nh,
+                     const InterpolationMode& interp, const bool& run_parallel, Image& dst,
+                     const BorderMode& border ) {
+        assert_statement( !src.is_empty(), "empty image" );
+        passert_statement( nw > 0 && nh > 0, "invalid new image size" );
+        passert_noalias( src, dst );
+        src.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
+        dst.create( nw, nh, src.type() );
+
+        int    w  = src.w();
+        int    h  = src.h();
+        size_t is = src.stride();
+        size_t os = dst.stride();
+        switch( src.type() ) {
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+            warp_run( src.get_row_f(0), w, h, src.ch(), is, wc, nw, nh, interp, border, run_parallel, dst.get_row_f(0), os );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            warp_run( src.get_row_u(0), w, h, src.ch(), is, wc, nw, nh, interp, border, run_parallel, dst.get_row_u(0), os );
+            break;
+        case IT_F_IRGB:
+            for( int c=0; c<3; c++ )
+                warp_run( src.get_channel_f(c), w, h, 1, is, wc, nw, nh, interp, border, run_parallel,
+                          dst.get_channel_f(c), os );
+            break;
+        case IT_U_IRGB:
+            for( int c=0; c<3; c++ )
+                warp_run( src.get_channel_u(c), w, h, 1, is, wc, nw, nh, interp, border, run_parallel,
+                          dst.get_channel_u(c), os );
+            break;
+        default: switch_fatality();
+        }
+    }
+
+    void warp_affine( const Image& src, const double* A, const int& nw, const int& nh,
+                      const InterpolationMode& interp, const bool& run_parallel, Image& dst,
+                      const BorderMode& border ) {
+        passert_pointer( A );
+        WarpCoords wc = { A, false, NULL, NULL, 0, 0 };
+        warp_image( src, wc, nw, nh, interp, run_parallel, dst, border );
+    }
+
+    void warp_perspective( const Image& src, const double* H, const int& nw, const int& nh,
+                           const InterpolationMode& interp, const bool& run_parallel, Image& dst,
+                           const BorderMode& border ) {
+        passert_pointer( H );
+        WarpCoords wc = { H, true, NULL, NULL, 0, 0 };
+        warp_image( src, wc, nw, nh, interp, run_parallel, dst, border );
+    }
+
+    void remap( const Image& src, const Image& mapx, const Image& mapy,
+                const InterpolationMode& interp, const bool& run_parallel, Image& dst,
+                const BorderMode& border ) {
+        mapx.passert_type( IT_F_GRAY );
+        mapy.passert_type( IT_F_GRAY );
+        passert_statement( mapx.w() == mapy.w() && mapx.h() == mapy.h(), "map dimensions mismatch" );
+        passert_noalias( mapx, dst );
+        passert_noalias( mapy, dst );
+        WarpCoords wc = { NULL, false, mapx.get_row_f(0), mapy.get_row_f(0), size_t( mapx.stride() ), size_t( mapy.stride() ) };
+        warp_image( src, wc, mapx.w(), mapy.h(), interp, run_parallel, dst, border );
+    }
+
+    //
+    // batch interpolation
+    //
+
+    /// points per chunk of a batch
+    const int    INTERP_CHUNK       = 256;
+
+    /// batches are bucketed when they have at least INTERP_BUCKET_MIN points
+    /// and the image is larger than bucket_bytes - below that, the bucketing
+    /// pass and the scattered writes of the results cost more than the cache
+    /// misses they save, even beyond the last level cache.
+    /// buckets are at most INTERP_MAX_CELLS square cells in row-major order:
+    /// few enough for the bucketing pass to write them as streams.
+    const int    INTERP_BUCKET_MIN  = 4096;
+    const int    INTERP_MAX_CELLS   = 256;
+
+    /// np planes of nc interleaved channels, rows are is and planes ps
+    /// elements apart
+    template<typename T>
+    void interpolate_run( const T* im, const int& w, const int& h, const int& nc, const size_t& is,
+                          const int& np, const size_t& ps,
+                          const float* xs, const float* ys, const int& n, const InterpolationMode& interp,
+                          const BorderMode& border, const bool& run_parallel, const size_t& bucket_bytes,
+                          float* out ) {
+        passert_statement( nc <= 4, "interpolation supports up to 4 channels" );
+        bool sse = false;
+#ifdef WITH_SSE
+        sse = filter_simd_level() >= SIMD_SSE;
+#endif
+        // counting sort of the points by cell - the coordinates move along
+        const float* px    = xs;
+        const float* py    = ys;
+        const int*   order = NULL;
+        if( n >= INTERP_BUCKET_MIN && ps*np*sizeof(T) > bucket_bytes ) {
+            int    side   = int( std::ceil( std::sqrt( double(w)*h / INTERP_MAX_CELLS ) ) );
+            int    ncx    = ( w + side - 1 ) / side;
+            int    ncells = ncx * ( ( h + side - 1 ) / side );
+            uchar* buf    = thread_scratch( 3, sizeof(int)*( size_t(ncells) + 1 ) + 4*sizeof(float)*size_t(n) );
+            int*   count  = (int*)buf;
+            int*   key    = count + ncells + 1;
+            int*   ord    = key + n;
+            float* bx     = (float*)( ord + n );
+            float* by     = bx + n;
+            memset( count, 0, sizeof(*count)*( ncells+1 ) );
+            for( int i=0; i<n; i++ ) {
+                int cx = std::min( w-1, std::max( 0, int( warp_clamp( xs[i] ) ) ) ) / side;
+                int cy = std::min( h-1, std::max( 0, int( warp_clamp( ys[i] ) ) ) ) / side;
+                key[i] = cy*ncx + cx;
+                count[ key[i]+1 ]++;
+            }
+            for( int c=0; c<ncells; c++ )
+                count[c+1] += count[c];
+            for( int i=0; i<n; i++ ) {
+                int o = count[ key[i] ]++;
+                ord[o] = i;
+                bx [o] = xs[i];
+                by [o] = ys[i];
+            }
+            px    = bx;
+            py    = by;
+            order = ord;
+        }
+
+        const int n_chunks = ( n + INTERP_CHUNK - 1 ) / INTERP_CHUNK;
+        const int stride   = nc*np;
+#pragma omp parallel for if( run_parallel )
+        for( int k=0; k<n_chunks; k++ ) {
+            int i0 = k*INTERP_CHUNK;
+            int m  = std::min( INTERP_CHUNK, n-i0 );
+            float sx[INTERP_CHUNK], sy[INTERP_CHUNK], v[4*INTERP_CHUNK];
+            for( int i=0; i<m; i++ ) {
+                sx[i] = warp_clamp( px[i0+i] );
+                sy[i] = warp_clamp( py[i0+i] );
+            }
+            if( !order && np == 1 ) {
+                warp_row( im, w, h, nc, is, sx, sy, m, interp, border, sse, out + size_t(i0)*nc );
+                continue;
+            }
+            for( int p=0; p<np; p++ ) {
+                warp_row( im + p*ps, w, h, nc, is, sx, sy, m, interp, border, sse, v );
+                for( int i=0; i<m; i++ ) {
+                    int    j = order ? order[i0+i] : i0+i;
+                    float* o = out + size_t(j)*stride + p*nc;
+                    for( int c=0; c<nc; c++ )
+                        o[c] = v[i*nc+c];
+                }
+            }
+        }
+    }
+
+    void image_interpolate( const Image& src, const float* xs, const float* ys, const int& n,
+                            const InterpolationMode& interp, const bool& run_parallel, float* out,
+                            const BorderMode& border, const size_t& bucket_bytes ) {
+        assert_statement( !src.is_empty(), "empty image" );
+        passert_statement( n >= 0, "invalid number of points" );
+        if( n == 0 ) return;
+        passert_pointer( xs ); passert_pointer( ys ); passert_pointer( out );
+        src.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
+
+        int    w  = src.w();
+        int    h  = src.h();
+        size_t is = src.stride();
+        size_t ps = src.plane_stride();
+        switch( src.type() ) {
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+            interpolate_run( src.get_row_f(0), w, h, src.ch(), is, 1, size_t(h)*is, xs, ys, n, interp, border, run_parallel, bucket_bytes, out );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            interpolate_run( src.get_row_u(0), w, h, src.ch(), is, 1, size_t(h)*is, xs, ys, n, interp, border, run_parallel, bucket_bytes, out );
+            break;
+        case IT_F_IRGB:
+            interpolate_run( src.get_row_fi(0,0), w, h, 1, is, 3, ps, xs, ys, n, interp, border, run_parallel, bucket_bytes, out );
+            break;
+        case IT_U_IRGB:
+            interpolate_run( src.get_row_ui(0,0), w, h, 1, is, 3, ps, xs, ys, n, interp, border, run_parallel, bucket_bytes, out );
+            break;
+        default: switch_fatality();
+        }
+    }
+
+    //
+    // fixed-point maps
+    //
+
+    void warp_map_build( const WarpCoords& wc, const int& nw, const int& nh, const bool& run_parallel, WarpMap& map ) {
+        passert_statement( nw > 0 && nh > 0, "invalid map size" );
+        map.w = nw;
+        map.h = nh;
+        map.xy  .resize( 2*size_t(nw)*nh );
+        map.frac.resize(   size_t(nw)*nh );
+        int*      xy   = &map.xy[0];
+        uint16_t* frac = &map.frac[0];
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<nh; y++ ) {
+            float xs[WARP_TILE_W], ys[WARP_TILE_W];
+            for( int x0=0; x0<nw; x0+=WARP_TILE_W ) {
+                int n = std::min( WARP_TILE_W, nw-x0 );
+                wc.fill( x0, y, n, xs, ys );
+                size_t o = size_t(y)*nw + x0;
+                for( int i=0; i<n; i++ ) {
+                    int qx = int( std::floor( xs[i]*WARP_MAP_FRAC + 0.5f ) );
+                    int qy = int( std::floor( ys[i]*WARP_MAP_FRAC + 0.5f ) );
+                    xy[2*(o+i)  ] = qx >> WARP_MAP_BITS;
+                    xy[2*(o+i)+1] = qy >> WARP_MAP_BITS;
+                    frac[o+i]     = uint16_t( ( qy & (WARP_MAP_FRAC-1) )*WARP_MAP_FRAC + ( qx & (WARP_MAP_FRAC-1) ) );
+                }
+            }
+        }
+    }
+
+    void warp_map_affine( const double* A, const int& nw, const int& nh, const bool& run_parallel, WarpMap& map ) {
+        passert_pointer( A );
+        WarpCoords wc = { A, false, NULL, NULL, 0, 0 };
+        warp_map_build( wc, nw, nh, run_parallel, map );
+    }
+
+    void warp_map_perspective( const double* H, const int& nw, const int& nh, const bool& run_parallel, WarpMap& map ) {
+        passert_pointer( H );
+        WarpCoords wc = { H, true, NULL, NULL, 0, 0 };
+        warp_map_build( wc, nw, nh, run_parallel, map );
+    }
+
+    void warp_map( const Image& mapx, const Image& mapy, const bool& run_parallel, WarpMap& map ) {
+        mapx.passert_type( IT_F_GRAY );
+        mapy.passert_type( IT_F_GRAY );
+        passert_statement( mapx.w() == mapy.w() && mapx.h() == mapy.h(), "map dimensions mismatch" );
+        WarpCoords wc = { NULL, false, mapx.get_row_f(0), mapy.get_row_f(0), size_t( mapx.stride() ), size_t( mapy.stride() ) };
+        warp_map_build( wc, mapx.w(), mapx.h(), run_parallel, map );
+    }
+
+    /// the bilinear weights of a map entry sum to WARP_MAP_FRAC^2: uchar
+    /// images are blended in integers and rounded, float images scaled.
+    inline void warp_map_blend( const uchar* const* p, const int& nc, const int* wt, uchar* o ) {
+        const int half = 1 << ( 2*WARP_MAP_BITS - 1 );
+        for( int c=0; c<nc; c++ )
+            o[c] = uchar( ( p[0][c]*wt[0] + p[1][c]*wt[1] + p[2][c]*wt[2] + p[3][c]*wt[3] + half ) >> ( 2*WARP_MAP_BITS ) );
+    }
+    inline void warp_map_blend( const float* const* p, const int& nc, const int* wt, float* o ) {
+        const float s = 1.0f / float( WARP_MAP_FRAC*WARP_MAP_FRAC );
+        for( int c=0; c<nc; c++ )
+            o[c] = ( p[0][c]*wt[0] + p[1][c]*wt[1] + p[2][c]*wt[2] + p[3][c]*wt[3] ) * s;
+    }
+
+    template<typename T>
+    void warp_map_run( const T* im, const int& w, const int& h, const int& nc, const size_t& is, const WarpMap& map,
+                       const BorderMode& border, const bool& run_parallel, T* out, const size_t& os ) {
+        passert_statement( nc <= 4, "warping supports up to 4 channels" );
+        const int       sw   = w;
+        const int       sh   = h;
+        const int       sc   = nc;
+        const size_t    ss   = is;
+        const size_t    ds   = os;
+        const BorderMode bm  = border;
+        const int       nw   = map.w;
+        const int       nh   = map.h;
+        const int*      xy   = &map.xy[0];
+        const uint16_t* frac = &map.frac[0];
+#pragma omp parallel for if( run_parallel )
+        for( int y=0; y<nh; y++ ) {
+            const T zero[4] = { 0, 0, 0, 0 };
+            T*      row     = out + size_t(y)*ds;
+            for( int x=0; x<nw; x++ ) {
+                size_t i  = size_t(y)*nw + x;
+                int    x0 = xy[2*i];
+                int    y0 = xy[2*i+1];
+                int    fx = frac[i] & ( WARP_MAP_FRAC-1 );
+                int    fy = frac[i] >> WARP_MAP_BITS;
+                int    wt[4] = { ( WARP_MAP_FRAC-fx )*( WARP_MAP_FRAC-fy ), fx*( WARP_MAP_FRAC-fy ),
+                                 ( WARP_MAP_FRAC-fx )*fy,                  fx*fy };
+                const T* p[4];
+                warp_neighbourhood( im, sw, sh, sc, ss, x0, y0, 2, bm, zero, p );
+                warp_map_blend( p, sc, wt, row + size_t(x)*sc );
+            }
+        }
+    }
+
+    void remap( const Image& src, const WarpMap& map, const bool& run_parallel, Image& dst,
+                const BorderMode& border ) {
+        assert_statement( !src.is_empty(), "empty image" );
+        passert_statement( map.w > 0 && map.h > 0 && map.frac.size() == size_t(map.w)*map.h, "invalid map" );
+        passert_noalias( src, dst );
+        src.passert_type( IT_F_GRAY | IT_F_PRGB | IT_F_IRGB | IT_U_GRAY | IT_U_PRGB | IT_U_IRGB );
+        dst.create( map.w, map.h, src.type() );
+
+        int    w  = src.w();
+        int    h  = src.h();
+        size_t is = src.stride();
+        size_t os = dst.stride();
+        switch( src.type() ) {
+        case IT_F_GRAY:
+        case IT_F_PRGB:
+            warp_map_run( src.get_row_f(0), w, h, src.ch(), is, map, border, run_parallel, dst.get_row_f(0), os );
+            break;
+        case IT_U_GRAY:
+        case IT_U_PRGB:
+            warp_map_run( src.get_row_u(0), w, h, src.ch(), is, map, border, run_parallel, dst.get_row_u(0), os );
+            break;
+        case IT_F_IRGB:
+            for( int c=0; c<3; c++ )
+                warp_map_run( src.get_channel_f(c), w, h, 1, is, map, border, run_parallel, dst.get_channel_f(c), os );
+            break;
+        case IT_U_IRGB:
+            for( int c=0; c<3; c++ )
+                warp_map_run( src.get_channel_u(c), w, h, 1, is, map, border, run_parallel, dst.get_channel_u(c), os );
+            break;
+        default: switch_fatality();
+        }
+    }
+
+}
@@ -0,0 +1,292 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/image.h>
+#include <kortex/image_processing.h>
+#include <kortex/warp.h>
+#include <kortex/log_manager.h>
+#include <kortex/timer.h>
+#include <kortex/filter.h>
+#include <kortex/image_stats.h>
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+using namespace kortex;
+
+void interpolation_benchmark();
+void pointwise_benchmark();
+void reduction_benchmark();
+void pixelwise_benchmark();
+void view_benchmark();
+
+int main(int argc, char **argv) {
+    interpolation_benchmark();
+    pointwise_benchmark();
+    reduction_benchmark();
+    pixelwise_benchmark();
+    view_benchmark();
+    release_log_man();
+}
+
+/// number of runs of a timing - the best one is reported
+const int N_RUNS = 5;
+
+void random_image( Image& im ) {
+    size_t ne = im.element_count();
+    for( size_t i=0; i<ne; i++ ) {
+        if( im.precision() == TYPE_UCHAR ) im.get_row_u(0)[i] = uchar( rand()%256 );
+        else                               im.get_row_f(0)[i] = float( rand()%256 );
+    }
+}
+
+/// per-point bilinear_interpolation calls against image_interpolate for
+/// sparse random points
+void interpolation_benchmark() {
+    const ImageType types[] = { IT_F_GRAY, IT_U_GRAY, IT_F_PRGB };
+    const char*     tnames[] = { "f gray", "u gray", "f prgb" };
+    int w = 1920, h = 1080, n = 200000;
+
+    vector<float> xs( n ), ys( n );
+    for( int i=0; i<n; i++ ) {
+        xs[i] = ( w-1.001f ) * float( rand() ) / float( RAND_MAX );
+        ys[i] = ( h-1.001f ) * float( rand() ) / float( RAND_MAX );
+    }
+
+    printf("bilinear interpolation of %d random points in %d x %d [ms]\n", n, w, h);
+    printf("%10s %10s %10s %10s %10s\n", "type", "per-call", "batch", "batch par", "max diff");
+    for( int t=0; t<3; t++ ) {
+        Image im( w, h, types[t] );
+        random_image( im );
+        int ch = im.ch();
+        vector<float> ref( n*ch ), out( n*ch );
+
+        double t_call = 1e30, t_batch = 1e30, t_par = 1e30;
+        for( int r=0; r<N_RUNS; r++ ) {
+            Timer timer;
+            for( int i=0; i<n; i++ ) {
+                for( int c=0; c<ch; c++ ) {
+                    if( im.precision() == TYPE_UCHAR )
+                        ref[i*ch+c] = bilinear_interpolation( im.get_row_u(0), w, h, ch, c, xs[i], ys[i] );
+                    else
+                        ref[i*ch+c] = bilinear_interpolation( im.get_row_f(0), w, h, ch, c, xs[i], ys[i] );
+                }
+            }
+            t_call  = std::min( t_call,  1000.0*timer.elapsed() );
+            image_interpolate( im, &xs[0], &ys[0], n, INTERP_BILINEAR, false, &out[0] );
+            t_batch = std::min( t_batch, 1000.0*timer.elapsed() );
+            image_interpolate( im, &xs[0], &ys[0], n, INTERP_BILINEAR, true,  &out[0] );
+            t_par   = std::min( t_par,   1000.0*timer.elapsed() );
+        }
+
+        float err = 0.0f;
+        for( int i=0; i<n*ch; i++ )
+            err = std::max( err, std::fabs( ref[i]-out[i] ) );
+        printf("%10s %10.2f %10.2f %10.2f %10.5f\n", tnames[t], t_call, t_batch, t_par, err);
+    }
+}
+
+struct PointwiseImages {
+    Image fa, fb, ua, ub, ia, ib, mask;
+    Image fo, uo, io;
+};
+
+const int N_POINTWISE_OPS = 14;
+
+void pointwise_op( const int& op, const bool& par, PointwiseImages& m ) {
+    switch( op ) {
+    case  0: image_subtract        ( m.fa, m.fb,   par, m.fo ); break;
+    case  1: image_subtract        ( m.ua, m.ub,   par, m.uo ); break;
+    case  2: image_subtract        ( m.ia, m.ib,   par, m.io ); break;
+    case  3: image_divide          ( m.fa, m.fb,   par, m.fo ); break;
+    case  4: image_divide          ( m.ua, m.ub,   par, m.uo ); break;
+    case  5: image_negate          ( m.fa,         par, m.fo ); break;
+    case  6: image_linearize       ( m.fa,         par, m.fo ); break;
+    case  7: image_linearize       ( m.ua,         par, m.fo ); break;
+    case  8: image_stretch         ( m.fa, 0, 255, par, m.uo ); break;
+    case  9: image_threshold       ( m.fa, 128,    par, m.fo ); break;
+    case 10: image_threshold       ( m.ua, 128,    par, m.uo ); break;
+    case 11: mask_invert           ( m.mask,       par, m.uo ); break;
+    case 12: binarize_image        ( m.ua,         par, m.uo ); break;
+    case 13: pick_pixels_with_color( m.ua, 7,      par, m.uo ); break;
+    }
+}
+
+/// the pointwise operations of image_processing.h with the scalar kernels,
+/// the sse kernels and the sse kernels in parallel
+void pointwise_benchmark() {
+    const char* names[] = { "subtract f", "subtract u", "subtract i", "divide f", "divide u",
+                            "negate f", "linearize f", "linearize u", "stretch f", "threshold f",
+                            "threshold u", "mask_invert", "binarize", "pick_pixels" };
+    int w = 1920, h = 1080;
+    PointwiseImages m;
+    m.fa.create( w, h, IT_F_GRAY ); m.fb.create( w, h, IT_F_GRAY ); m.fo.create( w, h, IT_F_GRAY );
+    m.ua.create( w, h, IT_U_GRAY ); m.ub.create( w, h, IT_U_GRAY ); m.uo.create( w, h, IT_U_GRAY );
+    m.ia.create( w, h, IT_I_GRAY ); m.ib.create( w, h, IT_I_GRAY ); m.io.create( w, h, IT_I_GRAY );
+    m.mask.create( w, h, IT_U_GRAY );
+    random_image( m.fa ); random_image( m.fb );
+    random_image( m.ua ); random_image( m.ub );
+    for( int i=0; i<w*h; i++ ) {
+        m.ia.get_row_i(0)[i] = rand();
+        m.ib.get_row_i(0)[i] = rand();
+        m.mask.get_row_u(0)[i] = uchar( rand()%2 );
+    }
+
+    const SimdLevel level = filter_simd_level();
+    printf("\npointwise operations on %d x %d [ms]\n", w, h);
+    printf("%12s %10s %10s %10s %10s\n", "op", "scalar", "simd", "simd par", "speedup");
+    for( int op=0; op<N_POINTWISE_OPS; op++ ) {
+        double t[3] = { 1e30, 1e30, 1e30 };
+        for( int k=0; k<3; k++ ) {
+            filter_set_simd_level( k ? level : SIMD_NONE );
+            for( int r=0; r<N_RUNS; r++ ) {
+                Timer timer;
+                pointwise_op( op, k==2, m );
+                t[k] = std::min( t[k], 1000.0*timer.elapsed() );
+            }
+        }
+        filter_set_simd_level( level );
+        printf("%12s %10.2f %10.2f %10.2f %10.2f\n", names[op], t[0], t[1], t[2], t[0]/t[2]);
+    }
+}
+
+/// the whole image reductions - the checks scan every pixel as the images
+/// pass them
+void reduction_benchmark() {
+    const char* names[] = { "min_max f", "min_max u", "stats f", "stats u", "is_binarized",
+                            "is_normalized", "does_overlap", "count nan" };
+    int w = 1920, h = 1080;
+    Image fa( w, h, IT_F_GRAY ), ua( w, h, IT_U_GRAY ), fb( w, h, IT_F_GRAY ), fc( w, h, IT_F_GRAY );
+    random_image( fa );
+    random_image( ua );
+    for( int i=0; i<w*h; i++ ) {
+        fb.get_row_f(0)[i] = float( rand()%2 );
+        fc.get_row_f(0)[i] = 1.0f - fb.get_row_f(0)[i];
+    }
+
+    const SimdLevel level = filter_simd_level();
+    printf("\nreductions on %d x %d [ms]\n", w, h);
+    printf("%14s %10s %10s %10s %10s\n", "op", "scalar", "simd", "simd par", "speedup");
+    size_t sink = 0;
+    for( int op=0; op<8; op++ ) {
+        double t[3] = { 1e30, 1e30, 1e30 };
+        for( int k=0; k<3; k++ ) {
+            filter_set_simd_level( k ? level : SIMD_NONE );
+            bool par = k==2;
+            for( int r=0; r<N_RUNS; r++ ) {
+                Timer timer;
+                float mn, mx;
+                ImageStats st;
+                switch( op ) {
+                case 0: sink += image_min_max( fa, mn, mx, par );           break;
+                case 1: sink += image_min_max( ua, mn, mx, par );           break;
+                case 2: image_stats( fa, STAT_ALL, par, st ); sink += st.count; break;
+                case 3: image_stats( ua, STAT_ALL, par, st ); sink += st.count; break;
+                case 4: sink += is_binarized ( fb, par );                   break;
+                case 5: sink += is_normalized( fb, par );                   break;
+                case 6: sink += does_overlap ( fb, fc, par );               break;
+                case 7: sink += image_count( fa, TEST_NAN, 0, 0, par );     break;
+                }
+                t[k] = std::min( t[k], 1000.0*timer.elapsed() );
+            }
+        }
+        filter_set_simd_level( level );
+        printf("%14s %10.2f %10.2f %10.2f %10.2f\n", names[op], t[0], t[1], t[2], t[0]/t[2]);
+    }
+    if( !sink ) printf("\n");
+}
+
+float contrast_op( float v ) { return std::max( 0.0f, std::min( 255.0f, 1.2f*v - 20.0f ) ); }
+
+struct ContrastOp {
+    float operator()( const float& v ) const { return contrast_op( v ); }
+};
+
+/// apply_pixelwise_operation with a functor against a per-pixel call
+/// through a function pointer - a 256-entry table for the uchar image
+void pixelwise_benchmark() {
+    const ImageType types[] = { IT_F_GRAY, IT_U_GRAY };
+    const char*     tnames[] = { "f gray", "u gray" };
+    int w = 1920, h = 1080;
+    PixelOperator volatile fp = contrast_op;
+
+    printf("\npixelwise operation on %d x %d [ms]\n", w, h);
+    printf("%10s %10s %10s %10s %10s\n", "type", "fn ptr", "functor", "par", "speedup");
+    for( int t=0; t<2; t++ ) {
+        Image a( w, h, types[t] ), o( w, h, types[t] );
+        random_image( a );
+        size_t n = a.element_count();
+        double t_fp = 1e30, t_fn = 1e30, t_par = 1e30;
+        for( int r=0; r<N_RUNS; r++ ) {
+            Timer timer;
+            PixelOperator op = fp;
+            if( t == 0 ) {
+                for( size_t i=0; i<n; i++ ) o.get_fptr()[i] = op( a.get_fptr()[i] );
+            } else {
+                for( size_t i=0; i<n; i++ ) o.get_uptr()[i] = cast_to_gray_range( op( a.get_uptr()[i] ) );
+            }
+            t_fp = std::min( t_fp, 1000.0*timer.elapsed() );
+            apply_pixelwise_operation( a, ContrastOp(), false, o );
+            t_fn = std::min( t_fn, 1000.0*timer.elapsed() );
+            apply_pixelwise_operation( a, ContrastOp(), true, o );
+            t_par = std::min( t_par, 1000.0*timer.elapsed() );
+        }
+        printf("%10s %10.2f %10.2f %10.2f %10.2f\n", tnames[t], t_fp, t_fn, t_par, t_fp/t_par);
+    }
+}
+
+/// tile-wise smoothing: copying every tile out and back against filtering
+/// views of the tiles in place
+void view_benchmark() {
+    const ImageType types[] = { IT_F_GRAY, IT_U_PRGB };
+    const char*     tnames[] = { "f gray", "u prgb" };
+    const float     kernel[] = { 0.03f, 0.11f, 0.21f, 0.3f, 0.21f, 0.11f, 0.03f };
+    int w = 1920, h = 1080, tile = 128;
+
+    printf("\n%d x %d tiles of a %d x %d image through filter_hv [ms]\n", tile, tile, w, h);
+    printf("%10s %10s %10s %10s\n", "type", "copy", "view", "speedup");
+    for( int t=0; t<2; t++ ) {
+        Image a( w, h, types[t] ), o( w, h, types[t] );
+        random_image( a );
+        double t_copy = 1e30, t_view = 1e30;
+        for( int r=0; r<N_RUNS; r++ ) {
+            Timer timer;
+            for( int y=0; y<h; y+=tile ) {
+                for( int x=0; x<w; x+=tile ) {
+                    int   tw = std::min( tile, w-x ), th = std::min( tile, h-y );
+                    Image in, out( tw, th, types[t] );
+                    extract_region_patch( a, x, y, x+tw, y+th, in );
+                    filter_hv( in, kernel, 7, out );
+                    o.copy_from_region( &out, 0, 0, tw, th, x, y );
+                }
+            }
+            t_copy = std::min( t_copy, 1000.0*timer.elapsed() );
+            for( int y=0; y<h; y+=tile ) {
+                for( int x=0; x<w; x+=tile ) {
+                    int   tw = std::min( tile, w-x ), th = std::min( tile, h-y );
+                    Image in, out;
+                    in .view( a, x, y, tw, th );
+                    out.view( o, x, y, tw, th );
+                    filter_hv( in, kernel, 7, out );
+                }
+            }
+            t_view = std::min( t_view, 1000.0*timer.elapsed() );
+        }
+        printf("%10s %10.2f %10.2f %10.2f\n", tnames[t], t_copy, t_view, t_copy/t_view);
+    }
+}
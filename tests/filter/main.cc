@@ -0,0 +1,491 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/filter_fixed.h>
+#include <kortex/image_integral.h>
+#include <kortex/image_processing.h>
+#include <kortex/filter.h>
+#include <kortex/log_manager.h>
+#include <kortex/image.h>
+#include <kortex/math.h>
+#include <kortex/defs.h>
+
+#include "../test_utils.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+using namespace kortex;
+
+typedef void (*FilterFn)(const float* im, const int& w, const int& h, const float* kernel, const int& ksize, float* out);
+
+void filter_kernel_test();
+void filter_transpose_test();
+void filter_fused_test();
+void filter_iir_test();
+void box_filter_test();
+void filter_border_test();
+void filter_fixed_test();
+void filter_interleaved_test();
+
+int main(int argc, char **argv) {
+    print_simd_levels();
+    filter_kernel_test();
+    filter_transpose_test();
+    filter_fused_test();
+    filter_iir_test();
+    box_filter_test();
+    filter_border_test();
+    filter_fixed_test();
+    filter_interleaved_test();
+    release_log_man();
+    return n_failed ? 1 : 0;
+}
+
+void run_filter_test( const char* name, FilterFn fn, SimdLevel level,
+                      int w, int h, int ksize, bool in_place ) {
+    vector<float> im(w*h), kernel(ksize), ref(w*h), out(w*h);
+    random_array( &im[0],     w*h,    0.0f, 255.0f );
+    random_array( &kernel[0], ksize, -0.2f, 1.0f   );
+
+    filter_set_simd_level( SIMD_NONE );
+    if( in_place ) { ref = im; fn( &ref[0], w, h, &kernel[0], ksize, &ref[0] ); }
+    else           {           fn( &im [0], w, h, &kernel[0], ksize, &ref[0] ); }
+
+    filter_set_simd_level( level );
+    if( in_place ) { out = im; fn( &out[0], w, h, &kernel[0], ksize, &out[0] ); }
+    else           {           fn( &im [0], w, h, &kernel[0], ksize, &out[0] ); }
+
+    bool bit_exact = ( level == SIMD_SSE );
+    char str[256];
+    sprintf( str, "%-14s %-6s [%4d x %4d] [k %2d]%s", name, simd_level_name(level).c_str(),
+             w, h, ksize, in_place ? " in-place" : "" );
+    if( compare_outputs( &ref[0], &out[0], w*h, bit_exact ) ) {
+        printf("%60s passed\n", str );
+    } else {
+        printf("%60s failed\n", str );
+        n_failed++;
+    }
+}
+
+void filter_kernel_test() {
+    const SimdLevel levels[] = { SIMD_SSE, SIMD_AVX2, SIMD_AVX512 };
+    const int sizes[][2] = { {1,1}, {5,3}, {37,19}, {128,64}, {333,97}, {61,611}, {1500,90} };
+    const int ksizes[]   = { 1, 3, 5, 7, 9, 11, 13, 15, 17, 25, 31 };
+
+    const char* names[] = { "filter_hor", "filter_ver", "filter_hv",
+                            "filter_hor_par", "filter_ver_par", "filter_hv_par" };
+    FilterFn fns[] = { filter_hor, filter_ver, filter_hv,
+                       filter_hor_par, filter_ver_par, filter_hv_par };
+
+    srand(0);
+    for( int l=0; l<3; l++ ) {
+        filter_set_simd_level( levels[l] );
+        if( filter_simd_level() != levels[l] ) {
+            printf("%60s skipped\n", simd_level_name(levels[l]).c_str() );
+            continue;
+        }
+        for( int f=0; f<6; f++ ) {
+            for( int s=0; s<7; s++ ) {
+                for( int k=0; k<11; k++ ) {
+                    run_filter_test( names[f], fns[f], levels[l], sizes[s][0], sizes[s][1], ksizes[k], false );
+                    run_filter_test( names[f], fns[f], levels[l], sizes[s][0], sizes[s][1], ksizes[k], true  );
+                }
+            }
+        }
+    }
+    filter_set_simd_level( SIMD_AVX512 );
+}
+
+/// the vertical pass runs over rows while the horizontal one filters a padded
+/// line buffer - with the basic kernels both accumulate the taps in the same
+/// order, so filtering the transpose has to give the transposed result
+/// exactly.
+void filter_transpose_test() {
+    const int sizes[][2] = { {7,5}, {129,67}, {45,700} };
+    const int ksizes[]   = { 1, 5, 9, 17 };
+    filter_set_simd_level( SIMD_NONE );
+    for( int s=0; s<3; s++ ) {
+        for( int k=0; k<4; k++ ) {
+            int w = sizes[s][0], h = sizes[s][1], ksize = ksizes[k];
+            vector<float> im(w*h), imt(w*h), kernel(ksize), ver(w*h), hor(w*h);
+            random_array( &im[0],     w*h,    0.0f, 255.0f );
+            random_array( &kernel[0], ksize, -0.2f, 1.0f   );
+            for( int y=0; y<h; y++ )
+                for( int x=0; x<w; x++ )
+                    imt[x*h+y] = im[y*w+x];
+            filter_ver_par( &im [0], w, h, &kernel[0], ksize, &ver[0] );
+            filter_hor    ( &imt[0], h, w, &kernel[0], ksize, &hor[0] );
+            for( int y=0; y<h; y++ )
+                for( int x=0; x<w; x++ )
+                    imt[y*w+x] = hor[x*h+y];
+            char str[256];
+            sprintf( str, "ver/hor transpose [%4d x %4d] [k %2d]", w, h, ksize );
+            if( compare_outputs( &ver[0], &imt[0], w*h, true ) ) {
+                printf("%60s passed\n", str );
+            } else {
+                printf("%60s failed\n", str );
+                n_failed++;
+            }
+        }
+    }
+    filter_set_simd_level( SIMD_AVX512 );
+}
+
+/// the fused filter_hv has to reproduce filter_hor followed by filter_ver
+/// exactly on every kernel level
+void filter_fused_test() {
+    const SimdLevel levels[] = { SIMD_NONE, SIMD_SSE, SIMD_AVX2, SIMD_AVX512 };
+    const int sizes[][2] = { {5,3}, {333,97}, {61,611}, {2100,300} };
+    const int ksizes[]   = { 1, 3, 9, 17, 31 };
+    for( int l=0; l<4; l++ ) {
+        filter_set_simd_level( levels[l] );
+        if( filter_simd_level() != levels[l] ) continue;
+        for( int s=0; s<4; s++ ) {
+            for( int k=0; k<5; k++ ) {
+                int w = sizes[s][0], h = sizes[s][1], ksize = ksizes[k];
+                vector<float> im(w*h), kernel(ksize), ref(w*h), out(w*h);
+                random_array( &im[0],     w*h,    0.0f, 255.0f );
+                random_array( &kernel[0], ksize, -0.2f, 1.0f   );
+                filter_hor( &im [0], w, h, &kernel[0], ksize, &ref[0] );
+                filter_ver( &ref[0], w, h, &kernel[0], ksize, &ref[0] );
+
+                const char* names[] = { "filter_hv", "filter_hv_par" };
+                FilterFn    fns  [] = {  filter_hv,   filter_hv_par  };
+                for( int f=0; f<2; f++ ) {
+                    for( int in_place=0; in_place<2; in_place++ ) {
+                        if( in_place ) { out = im; fns[f]( &out[0], w, h, &kernel[0], ksize, &out[0] ); }
+                        else           {           fns[f]( &im [0], w, h, &kernel[0], ksize, &out[0] ); }
+                        char str[256];
+                        sprintf( str, "%-14s fused %-6s [%4d x %4d] [k %2d]%s", names[f],
+                                 simd_level_name(levels[l]).c_str(), w, h, ksize, in_place ? " in-place" : "" );
+                        if( compare_outputs( &ref[0], &out[0], w*h, true ) ) {
+                            printf("%70s passed\n", str );
+                        } else {
+                            printf("%70s failed\n", str );
+                            n_failed++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    filter_set_simd_level( SIMD_AVX512 );
+}
+
+/// the recursive gaussian has to stay within 0.1% of the input range of the
+/// fir one, the parallel variant and in-place calls have to agree exactly.
+void filter_iir_test() {
+    const int   sizes[][2] = { {1,1}, {7,5}, {333,97}, {61,611} };
+    const float sigmas[]   = { 0.5f, 1.0f, 2.5f, 8.0f, 20.0f };
+    for( int s=0; s<4; s++ ) {
+        for( int k=0; k<5; k++ ) {
+            int   w = sizes[s][0], h = sizes[s][1];
+            float sigma = sigmas[k];
+            int   ksize = filter_size( sigma );
+            vector<float> im(w*h), kernel(ksize), fir(w*h), iir(w*h), par(w*h);
+            random_array( &im[0], w*h, 0.0f, 255.0f );
+            gaussian_1d( &kernel[0], ksize, 0.0f, sigma );
+            filter_hv( &im[0], w, h, &kernel[0], ksize, &fir[0] );
+            filter_gaussian_iir( &im[0], w, h, sigma, &iir[0] );
+            par = im;
+            filter_gaussian_iir_par( &par[0], w, h, sigma, &par[0] );
+
+            float max_err = 0.0f;
+            for( int i=0; i<w*h; i++ )
+                max_err = std::max( max_err, std::fabs( fir[i]-iir[i] ) );
+            bool passed = max_err <= 0.001f*255.0f && compare_outputs( &iir[0], &par[0], w*h, true );
+
+            char str[256];
+            sprintf( str, "gaussian iir [%4d x %4d] [sigma %4.1f] [err %.4f]", w, h, sigma, max_err );
+            if( passed ) {
+                printf("%60s passed\n", str );
+            } else {
+                printf("%60s failed\n", str );
+                n_failed++;
+            }
+        }
+    }
+}
+
+/// box_filter against filter_hv with a kernel of ones, summed-area table box
+/// sums against brute force sums - exact for the integer tables.
+void box_filter_test() {
+    const int sizes[][2] = { {1,1}, {7,5}, {333,97}, {61,611} };
+    const int radii[]    = { 0, 1, 4, 15, 40 };
+    for( int s=0; s<4; s++ ) {
+        int w = sizes[s][0], h = sizes[s][1];
+        Image img( w, h, IT_F_GRAY );
+        random_array( img.get_row_f(0), w*h, 0.0f, 255.0f );
+        for( int k=0; k<5; k++ ) {
+            int r = radii[k], ksize = 2*r+1;
+            vector<float> ones( ksize, 1.0f ), ref(w*h);
+            filter_hv( img.get_row_f(0), w, h, &ones[0], ksize, &ref[0] );
+            Image out, par( img );
+            box_filter    ( img, r, r, out );
+            box_filter_par( par, r, r, par );
+            char str[256];
+            sprintf( str, "box_filter [%4d x %4d] [r %2d]", w, h, r );
+            report( str, compare_outputs( &ref[0], out.get_row_f(0), w*h, false ) &&
+                         compare_outputs( out.get_row_f(0), par.get_row_f(0), w*h, true ) );
+        }
+
+        Image uimg( w, h, IT_U_GRAY ), sat, sqsat, fsat;
+        for( int i=0; i<w*h; i++ )
+            uimg.get_row_u(0)[i] = uchar( rand() & 255 );
+        integral_image_par( uimg, sat   );
+        integral_image_sq ( uimg, sqsat );
+        integral_image    ( img,  fsat  );
+        bool passed = true;
+        for( int t=0; t<50; t++ ) {
+            int x0 = rand()%(w+1), x1 = rand()%(w+1), y0 = rand()%(h+1), y1 = rand()%(h+1);
+            if( x0 > x1 ) std::swap( x0, x1 );
+            if( y0 > y1 ) std::swap( y0, y1 );
+            double su = 0.0, sq = 0.0, sf = 0.0;
+            for( int y=y0; y<y1; y++ ) {
+                for( int x=x0; x<x1; x++ ) {
+                    double v = uimg.get_row_u(y)[x];
+                    su += v;
+                    sq += v*v;
+                    sf += img.get_row_f(y)[x];
+                }
+            }
+            passed = passed && box_sum( sat,   x0, y0, x1, y1 ) == su
+                            && box_sum( sqsat, x0, y0, x1, y1 ) == sq
+                            && std::fabs( box_sum( fsat, x0, y0, x1, y1 ) - sf ) <= 1e-5 * 255.0 * w*h;
+        }
+        char str[256];
+        sprintf( str, "integral_image [%4d x %4d]", w, h );
+        report( str, passed );
+    }
+}
+
+/// filtering with a border mode has to match zero padded filtering of the
+/// image explicitly extended by that mode - exactly on the basic kernels.
+void filter_border_test() {
+    const BorderMode borders[] = { BORDER_REPLICATE, BORDER_REFLECT_101, BORDER_WRAP };
+    const char*      bnames [] = { "replicate", "reflect-101", "wrap" };
+    const SimdLevel  levels [] = { SIMD_NONE, SIMD_AVX512 };
+    const int sizes[][2] = { {1,1}, {7,5}, {333,97}, {1500,90} };
+    const int ksizes[]   = { 3, 9, 31 };
+    for( int l=0; l<2; l++ ) {
+        filter_set_simd_level( levels[l] );
+        for( int bm=0; bm<3; bm++ ) {
+            for( int s=0; s<4; s++ ) {
+                for( int k=0; k<3; k++ ) {
+                    int w = sizes[s][0], h = sizes[s][1], ksize = ksizes[k], hs = ksize/2;
+                    int pw = w+2*hs, ph = h+2*hs;
+                    vector<float> im(w*h), kernel(ksize), pad(pw*ph), ref(w*h), out(w*h), par(w*h);
+                    random_array( &im[0],     w*h,    0.0f, 255.0f );
+                    random_array( &kernel[0], ksize, -0.2f, 1.0f   );
+                    for( int y=0; y<ph; y++ )
+                        for( int x=0; x<pw; x++ )
+                            pad[y*pw+x] = im[ border_index(y-hs,h,borders[bm])*w + border_index(x-hs,w,borders[bm]) ];
+                    filter_hv( &pad[0], pw, ph, &kernel[0], ksize, &pad[0] );
+                    for( int y=0; y<h; y++ )
+                        for( int x=0; x<w; x++ )
+                            ref[y*w+x] = pad[(y+hs)*pw+x+hs];
+
+                    filter_hv( &im[0], w, h, &kernel[0], ksize, &out[0], borders[bm] );
+                    par = im;
+                    filter_hv_par( &par[0], w, h, &kernel[0], ksize, &par[0], borders[bm] );
+                    bool passed = compare_outputs( &ref[0], &out[0], w*h, levels[l] == SIMD_NONE )
+                        &&        compare_outputs( &out[0], &par[0], w*h, true );
+
+                    // two pass version
+                    par = im;
+                    filter_hor    ( &par[0], w, h, &kernel[0], ksize, &par[0], borders[bm] );
+                    filter_ver_par( &par[0], w, h, &kernel[0], ksize, &par[0], borders[bm] );
+                    passed = passed && compare_outputs( &out[0], &par[0], w*h, true );
+
+                    char str[256];
+                    sprintf( str, "border %-11s %-6s [%4d x %4d] [k %2d]", bnames[bm],
+                             simd_level_name(filter_simd_level()).c_str(), w, h, ksize );
+                    report( str, passed );
+                }
+            }
+        }
+    }
+    filter_set_simd_level( SIMD_AVX512 );
+
+    // the recursive gaussian against the fir one with the same border
+    for( int bm=0; bm<3; bm++ ) {
+        int   w = 333, h = 97;
+        float sigma = 9.0f;
+        int   ksize = filter_size( sigma );
+        vector<float> im(w*h), kernel(ksize), fir(w*h), iir(w*h), par(w*h);
+        random_array( &im[0], w*h, 0.0f, 255.0f );
+        gaussian_1d( &kernel[0], ksize, 0.0f, sigma );
+        filter_hv( &im[0], w, h, &kernel[0], ksize, &fir[0], borders[bm] );
+        filter_gaussian_iir( &im[0], w, h, sigma, &iir[0], borders[bm] );
+        par = im;
+        filter_gaussian_iir_par( &par[0], w, h, sigma, &par[0], borders[bm] );
+        float max_err = 0.0f;
+        for( int i=0; i<w*h; i++ )
+            max_err = std::max( max_err, std::fabs( fir[i]-iir[i] ) );
+        char str[256];
+        sprintf( str, "gaussian iir %-11s [err %.4f]", bnames[bm], max_err );
+        report( str, max_err <= 0.001f*255.0f && compare_outputs( &iir[0], &par[0], w*h, true ) );
+    }
+}
+
+/// the fixed point filters have to stay within one gray level of the float
+/// filters and give the same result on every kernel level, in-place and in
+/// parallel.
+void filter_fixed_test() {
+    const SimdLevel levels[] = { SIMD_NONE, SIMD_SSE, SIMD_AVX2, SIMD_AVX512 };
+    const int sizes[][2] = { {1,1}, {7,5}, {333,97}, {61,611} };
+    const int ksizes[]   = { 1, 3, 8, 17, 31 };
+    const int ncs[]      = { 1, 3 };
+    for( int s=0; s<4; s++ ) {
+        for( int k=0; k<5; k++ ) {
+            for( int c=0; c<2; c++ ) {
+                int w = sizes[s][0], h = sizes[s][1], ksize = ksizes[k], nc = ncs[c], n = w*h*nc;
+                vector<uchar> im(n), ref(n), out(n);
+                vector<float> kernel(ksize), fref(n), fim(w*h), fout(w*h);
+                for( int i=0; i<n; i++ ) im[i] = uchar( rand() & 255 );
+                random_array( &kernel[0], ksize, 0.0f, 1.0f );
+                float ksum = 0.0f;
+                for( int j=0; j<ksize; j++ ) ksum += kernel[j];
+                for( int j=0; j<ksize; j++ ) kernel[j] /= ksum;
+
+                // float reference per channel
+                int max_err = 0;
+                for( int ch=0; ch<nc; ch++ ) {
+                    for( int i=0; i<w*h; i++ ) fim[i] = im[i*nc+ch];
+                    filter_hv( &fim[0], w, h, &kernel[0], ksize, &fout[0], BORDER_REFLECT_101 );
+                    for( int i=0; i<w*h; i++ ) fref[i*nc+ch] = fout[i];
+                }
+                filter_set_simd_level( SIMD_NONE );
+                filter_hv_u8( &im[0], w, h, nc, &kernel[0], ksize, &ref[0], BORDER_REFLECT_101 );
+                for( int i=0; i<n; i++ )
+                    max_err = std::max( max_err, std::abs( int(ref[i]) - int(std::floor(fref[i]+0.5f)) ) );
+                bool passed = max_err <= 1;
+                for( int l=1; l<4; l++ ) {
+                    filter_set_simd_level( levels[l] );
+                    out = im;
+                    filter_hv_u8_par( &out[0], w, h, nc, &kernel[0], ksize, &out[0], BORDER_REFLECT_101 );
+                    passed = passed && memcmp( &ref[0], &out[0], n ) == 0;
+                }
+                // the single passes against each other
+                out = im;
+                filter_hor_u8    ( &out[0], w, h, nc, &kernel[0], ksize, &out[0], BORDER_WRAP );
+                filter_ver_u8_par( &out[0], w, h, nc, &kernel[0], ksize, &out[0], BORDER_WRAP );
+                filter_hv_u8( &im[0], w, h, nc, &kernel[0], ksize, &ref[0], BORDER_WRAP );
+                for( int i=0; i<n; i++ )
+                    passed = passed && std::abs( int(ref[i]) - int(out[i]) ) <= 1;
+                filter_set_simd_level( SIMD_AVX512 );
+
+                char str[256];
+                sprintf( str, "fixed u8 [%4d x %4d x %d] [k %2d] [err %d]", w, h, nc, ksize, max_err );
+                report( str, passed );
+            }
+        }
+    }
+
+    // signed derivative output
+    int w = 333, h = 97;
+    float dk[] = { -0.5f, 0.0f, 0.5f };
+    float sk[] = { 0.25f, 0.5f, 0.25f };
+    vector<uchar>   im(w*h);
+    vector<int16_t> d(w*h), dp(w*h);
+    vector<float>   fim(w*h), fd(w*h);
+    for( int i=0; i<w*h; i++ ) fim[i] = im[i] = uchar( rand() & 255 );
+    filter_hor( &fim[0], w, h, dk, 3, &fd[0], BORDER_REPLICATE );
+    filter_ver( &fd [0], w, h, sk, 3, &fd[0], BORDER_REPLICATE );
+    filter_hv_s16    ( &im[0], w, h, 1, dk, 3, sk, 3, 4, &d [0], BORDER_REPLICATE );
+    filter_hv_s16_par( &im[0], w, h, 1, dk, 3, sk, 3, 4, &dp[0], BORDER_REPLICATE );
+    float max_err = 0.0f;
+    for( int i=0; i<w*h; i++ )
+        max_err = std::max( max_err, std::fabs( d[i]/16.0f - fd[i] ) );
+    char str[256];
+    sprintf( str, "fixed s16 derivative [err %.4f]", max_err );
+    report( str, max_err <= 1.0f/16.0f && d == dp );
+}
+
+/// interleaved filtering against filtering the channel planes one by one
+void filter_interleaved_test() {
+    const BorderMode borders[] = { BORDER_ZERO, BORDER_REPLICATE, BORDER_REFLECT_101, BORDER_WRAP };
+    const char*      bnames [] = { "zero", "replicate", "reflect-101", "wrap" };
+    const SimdLevel  levels [] = { SIMD_NONE, SIMD_SSE, SIMD_AVX512 };
+    const int sizes[][2] = { {1,1}, {7,5}, {333,97}, {700,90} };
+    const int ksizes[]   = { 3, 9, 31 };
+    const int nc = 3;
+    for( int l=0; l<3; l++ ) {
+        filter_set_simd_level( levels[l] );
+        bool bit_exact = filter_simd_level() < SIMD_AVX2;
+        for( int bm=0; bm<4; bm++ ) {
+            for( int s=0; s<4; s++ ) {
+                for( int k=0; k<3; k++ ) {
+                    int w = sizes[s][0], h = sizes[s][1], ksize = ksizes[k], pc = w*h;
+                    vector<float> im(pc*nc), kernel(ksize), planes(pc*nc), ref(pc*nc), out(pc*nc), par(pc*nc);
+                    random_array( &im[0],     pc*nc,  0.0f, 255.0f );
+                    random_array( &kernel[0], ksize, -0.2f, 1.0f   );
+                    deinterleave( &im[0], pc, nc, &planes[0] );
+                    for( int c=0; c<nc; c++ )
+                        filter_hv( &planes[c*pc], w, h, &kernel[0], ksize, &planes[c*pc], borders[bm] );
+                    interleave( &planes[0], pc, nc, &ref[0] );
+
+                    filter_hv( &im[0], w, h, nc, &kernel[0], ksize, &out[0], borders[bm] );
+                    par = im;
+                    filter_hv_par( &par[0], w, h, nc, &kernel[0], ksize, &par[0], borders[bm] );
+                    bool passed = compare_outputs( &ref[0], &out[0], pc*nc, bit_exact )
+                        &&        compare_outputs( &out[0], &par[0], pc*nc, true );
+
+                    par = im;
+                    filter_hor_par( &par[0], w, h, nc, &kernel[0], ksize, &par[0], borders[bm] );
+                    filter_ver    ( &par[0], w, h, nc, &kernel[0], ksize, &par[0], borders[bm] );
+                    passed = passed && compare_outputs( &out[0], &par[0], pc*nc, true );
+
+                    char str[256];
+                    sprintf( str, "interleaved %-11s %-6s [%4d x %4d] [k %2d]", bnames[bm],
+                             simd_level_name(filter_simd_level()).c_str(), w, h, ksize );
+                    report( str, passed );
+                }
+            }
+        }
+    }
+    filter_set_simd_level( SIMD_AVX512 );
+
+    // recursive gaussian, and the image level dispatch of both layouts
+    for( int bm=0; bm<4; bm++ ) {
+        int   w = 333, h = 97, pc = w*h;
+        float sigma = 9.0f;
+        Image prgb( w, h, IT_F_PRGB ), irgb( w, h, IT_F_IRGB );
+        random_array( prgb.get_row_f(0), pc*nc, 0.0f, 255.0f );
+        deinterleave( prgb.get_row_f(0), pc, nc, irgb );
+        filter_gaussian    ( irgb, sigma, irgb, borders[bm] );
+        filter_gaussian_par( prgb, sigma, prgb, borders[bm] );
+        vector<float> ref(pc*nc);
+        interleave( irgb, pc, nc, &ref[0] );
+        bool passed = compare_outputs( &ref[0], prgb.get_row_f(0), pc*nc, true );
+
+        sigma = 2.0f;
+        random_array( prgb.get_row_f(0), pc*nc, 0.0f, 255.0f );
+        deinterleave( prgb.get_row_f(0), pc, nc, irgb );
+        filter_gaussian( irgb, sigma, irgb, borders[bm] );
+        filter_gaussian( prgb, sigma, prgb, borders[bm] );
+        interleave( irgb, pc, nc, &ref[0] );
+        passed = passed && compare_outputs( &ref[0], prgb.get_row_f(0), pc*nc, false );
+
+        char str[256];
+        sprintf( str, "interleaved gaussian %-11s", bnames[bm] );
+        report( str, passed );
+    }
+}
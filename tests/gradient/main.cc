@@ -0,0 +1,121 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/gradient.h>
+#include <kortex/image_processing.h>
+#include <kortex/filter.h>
+#include <kortex/log_manager.h>
+#include <kortex/image.h>
+#include <kortex/math.h>
+#include <kortex/defs.h>
+
+#include "../test_utils.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+using namespace kortex;
+
+void gradient_test();
+
+int main(int argc, char **argv) {
+    print_simd_levels();
+    gradient_test();
+    release_log_man();
+    return n_failed ? 1 : 0;
+}
+
+/// fast_atan2 error over the circle, the fused gradients against the
+/// separate filter passes the kernels were built from, uchar against float
+/// input, sse against scalar and the orientation bins against fast_atan2.
+void gradient_test() {
+    float err = 0.0f;
+    for( int i=0; i<=100000; i++ ) {
+        double t = 2.0*PI*i/100000.0;
+        float  x = float( std::cos( t ) ) * 3.7f;
+        float  y = float( std::sin( t ) ) * 3.7f;
+        double r = std::atan2( double(y), double(x) );
+        if( r < 0.0 ) r += 2.0*PI;
+        double e = std::fabs( fast_atan2( y, x ) - r );
+        err = float( std::max( double(err), std::min( e, 2.0*PI - e ) ) );
+    }
+    char str[256];
+    sprintf( str, "fast_atan2 [max err %.2e]", err );
+    report( str, err < 1.5e-5f && fast_atan2( 0.0f, 0.0f ) == 0.0f );
+
+    const SimdLevel level   = filter_simd_level();
+    const int       sizes[][2] = { {2,2}, {5,3}, {64,33}, {131,70} };
+    const char*     names[] = { "simple", "prewitt", "sobel" };
+    for( int s=0; s<4; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        Image fim( w, h, IT_F_GRAY ), uim( w, h, IT_U_GRAY );
+        for( int i=0; i<w*h; i++ ) {
+            uim.get_row_u(0)[i] = uchar( rand() % 256 );
+            fim.get_row_f(0)[i] = uim.get_row_u(0)[i];
+        }
+        for( int k=0; k<3; k++ ) {
+            // the reference passes
+            vector<float> rx( w*h, 0.0f ), ry( w*h, 0.0f ), tmp( w*h );
+            const float* im = fim.get_row_f(0);
+            if( k == 0 ) {
+                image_gradient_simple( im, w, h, &rx[0], &ry[0] );
+            } else {
+                float d[] = { -0.5f, 0.0f, 0.5f };
+                float a[] = { 1.0f/3.0f, 1.0f/3.0f, 1.0f/3.0f };
+                float b[] = { 0.25f, 0.5f, 0.25f };
+                float* sm = k == 1 ? a : b;
+                vector<float> fx( w*h ), fy( w*h );
+                filter_hor( im, w, h, d, 3, &tmp[0] ); filter_ver( &tmp[0], w, h, sm, 3, &fx[0] );
+                filter_hor( im, w, h, sm, 3, &tmp[0] ); filter_ver( &tmp[0], w, h, d, 3, &fy[0] );
+                for( int y=1; y<h-1; y++ ) {
+                    for( int x=1; x<w-1; x++ ) {
+                        rx[y*w+x] = fx[y*w+x];
+                        ry[y*w+x] = fy[y*w+x];
+                    }
+                }
+            }
+            bool passed = true;
+            Image base_ori;
+            for( int l=0; l<2; l++ ) {
+                filter_set_simd_level( l ? level : SIMD_NONE );
+                for( int u=0; u<2; u++ ) {
+                    Image gx, gy, mag, ori, mo;
+                    image_gradients( u ? uim : fim, GradientKernel(k), 8, l==1, &gx, &gy, &mag, &ori );
+                    image_gradients( u ? uim : fim, GradientKernel(k), 0, l==1, NULL, NULL, &mo, NULL );
+                    passed = passed && compare_outputs( &rx[0], gx.get_row_f(0), w*h, false );
+                    passed = passed && compare_outputs( &ry[0], gy.get_row_f(0), w*h, false );
+                    passed = passed && memcmp( mag.get_row_f(0), mo.get_row_f(0), sizeof(float)*w*h ) == 0;
+                    for( int i=0; i<w*h; i++ ) {
+                        float gxv = gx.get_row_f(0)[i];
+                        float gyv = gy.get_row_f(0)[i];
+                        passed = passed && std::fabs( mag.get_row_f(0)[i] - std::sqrt( gxv*gxv + gyv*gyv ) ) <= 1e-5f * ( 1.0f + mag.get_row_f(0)[i] );
+                        int bin = std::min( 7, int( fast_atan2( gyv, gxv ) * ( 8.0f / float( 2.0*PI ) ) ) );
+                        passed = passed && bin == ori.get_row_u(0)[i];
+                    }
+                    if( base_ori.is_empty() ) base_ori.copy( &ori );
+                    else passed = passed && memcmp( base_ori.get_row_u(0), ori.get_row_u(0), w*h ) == 0;
+                }
+            }
+            filter_set_simd_level( level );
+            sprintf( str, "gradients %-7s [%3d x %3d]", names[k], w, h );
+            report( str, passed );
+        }
+    }
+}
@@ -0,0 +1,425 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/image_processing.h>
+#include <kortex/image_expr.h>
+#include <kortex/image_stats.h>
+#include <kortex/image_integral.h>
+#include <kortex/image_io.h>
+#include <kortex/resample.h>
+#include <kortex/pyramid.h>
+#include <kortex/warp.h>
+#include <kortex/morphology.h>
+#include <kortex/connected_components.h>
+#include <kortex/gradient.h>
+#include <kortex/filter.h>
+#include <kortex/log_manager.h>
+#include <kortex/image.h>
+#include <kortex/defs.h>
+
+#include "../test_utils.h"
+
+#include <cstdlib>
+#include <vector>
+
+using std::vector;
+
+using namespace kortex;
+
+void view_test();
+void view_paths_test();
+
+int main(int argc, char **argv) {
+    print_simd_levels();
+    view_test();
+    view_paths_test();
+    release_log_man();
+    return n_failed ? 1 : 0;
+}
+
+/// the samples of a view as a packed image
+bool same_samples( const Image& v, const Image& ref ) {
+    Image c;
+    c.copy( &v );
+    if( c.type() != ref.type() || !check_dimensions( c, ref ) ) return false;
+    for( size_t i=0; i<ref.element_count(); i++ )
+        if( sample( c, i ) != sample( ref, i ) ) return false;
+    return true;
+}
+
+/// a and b agree outside of the region r - both packed
+bool same_outside( const Image& a, const Image& b, const Rect2i& r ) {
+    bool   planar = image_channel_type( a.type() ) == ITC_IMAGE;
+    size_t pc     = a.pixel_count();
+    for( size_t i=0; i<a.element_count(); i++ ) {
+        size_t p = planar ? i%pc : i/a.ch();
+        int    x = int( p % a.w() );
+        int    y = int( p / a.w() );
+        if( x >= r.lx && x < r.ux && y >= r.ly && y < r.uy ) continue;
+        if( sample( a, i ) != sample( b, i ) ) return false;
+    }
+    return true;
+}
+
+/// a random parent of the type with a view of the region r, the parent
+/// before the calls in p0
+void view_parent( const ImageType& type, const int& pw, const int& ph, const Rect2i& r,
+                  Image& p, Image& p0, Image& v ) {
+    p.create( pw, ph, type );
+    random_samples( p, 100 );
+    p0.copy( &p );
+    v.view( p, r.lx, r.ly, r.ux-r.lx, r.uy-r.ly );
+}
+
+void view_test() {
+    const ImageType types[] = { IT_F_GRAY, IT_F_PRGB, IT_F_IRGB, IT_U_GRAY, IT_U_PRGB, IT_U_IRGB };
+    const int pw = 71, ph = 43;
+    const Rect2i r( 6, 58, 5, 37 );
+    const int w = r.ux-r.lx, h = r.uy-r.ly;
+    char str[256];
+
+    {
+        vector<float> buf( 16*4, -1.0f );
+        Image im;
+        im.wrap( &buf[0], 10, 4, IT_F_GRAY, 16 );
+        im.set( 2.0f );
+        bool passed = im.stride() == 16 && !im.is_contiguous() && im.get_row_f(3) == &buf[48];
+        for( int i=0; i<64; i++ )
+            passed = passed && buf[i] == ( i%16 < 10 ? 2.0f : -1.0f );
+        report( "view wrap with a row stride", passed );
+    }
+
+    const float kernel[] = { 0.03f, 0.11f, 0.21f, 0.3f, 0.21f, 0.11f, 0.03f };
+    for( int t=0; t<6; t++ ) {
+        bool  u8 = image_precision( types[t] ) == TYPE_UCHAR;
+        Image pa( pw, ph, types[t] ), pb( pw, ph, types[t] ), pb0;
+        random_samples( pa, 1000 );
+        random_samples( pb, 1000 );
+        pb0.copy( &pb );
+
+        Image va, vb, ref;
+        va.view( pa, r.lx, r.ly, w, h );
+        vb.view( pb, r.lx, r.ly, w, h );
+        extract_region_patch( pa, r.lx, r.ly, r.ux, r.uy, ref );
+        bool passed = !va.is_contiguous() && va.stride() == pa.stride() && same_samples( va, ref );
+        sprintf( str, "view [%2d x %2d] type %d", w, h, t );
+        report( str, passed );
+
+        for( int par=0; par<2; par++ ) {
+            Image out( w, h, ref.type() );
+            filter_hv( ref, kernel, 7, out );
+            if( par ) filter_hv_par( va, kernel, 7, vb );
+            else      filter_hv    ( va, kernel, 7, vb );
+            passed = same_samples( vb, out ) && same_outside( pb, pb0, r );
+
+            if( !u8 ) {
+                filter_gaussian_iir( ref, 5.0f, par==1, out, BORDER_REPLICATE );
+                filter_gaussian_iir( va,  5.0f, par==1, vb,  BORDER_REPLICATE );
+                passed = passed && same_samples( vb, out );
+            }
+
+            Image rin, vin;
+            rin.copy( &ref );
+            if( par ) { filter_hv_par( rin, kernel, 7, rin ); vin.view( pa, r.lx, r.ly, w, h ); filter_hv_par( vin, kernel, 7, vin ); }
+            else      { filter_hv    ( rin, kernel, 7, rin ); vin.view( pa, r.lx, r.ly, w, h ); filter_hv    ( vin, kernel, 7, vin ); }
+            passed = passed && same_samples( vin, rin );
+            pa.copy_from_region( &ref, 0, 0, w, h, r.lx, r.ly );
+
+            sprintf( str, "view filters [%2d x %2d] type %d par %d", w, h, t, par );
+            report( str, passed );
+
+            const ResampleMode modes[] = { RESAMPLE_AREA, RESAMPLE_BICUBIC };
+            for( int m=0; m<2; m++ ) {
+                Image rr, vr, vo;
+                image_resample( ref, w/2, h/2, modes[m], par==1, rr, BORDER_REPLICATE );
+                image_resample( va,  w/2, h/2, modes[m], par==1, vr, BORDER_REPLICATE );
+                pb.copy( &pb0 );
+                vo.view( pb, 1, 2, w/2, h/2 );
+                image_resample( va,  w/2, h/2, modes[m], par==1, vo, BORDER_REPLICATE );
+                Rect2i ro( 1, 1+w/2, 2, 2+h/2 );
+                passed = same_samples( vr, rr ) && same_samples( vo, rr ) && same_outside( pb, pb0, ro );
+                sprintf( str, "view resample [%2d x %2d] type %d mode %d par %d", w, h, t, m, par );
+                report( str, passed );
+            }
+
+            Image rb, rs, vs, rd;
+            extract_region_patch( pb0, r.lx, r.ly, r.ux, r.uy, rb );
+            pb.copy( &pb0 );
+            rd.create( w, h, ref.type() );
+            image_subtract( ref, rb, par==1, rd );
+            image_subtract( va,  vb, par==1, vb );
+            passed = same_samples( vb, rd ) && same_outside( pb, pb0, r );
+
+            image_eval( expr(ref)*0.5f + rb, par==1, rs );
+            image_eval( expr(va)*0.5f + rb, par==1, vs );
+            passed = passed && same_samples( vs, rs );
+
+            apply_pixelwise_operation( ref, pixel_halve, par==1, rd );
+            apply_pixelwise_operation( va,  pixel_halve, par==1, vb );
+            passed = passed && same_samples( vb, rd ) && same_outside( pb, pb0, r );
+
+            ImageStats sr, sv;
+            image_stats( ref, STAT_ALL, par==1, sr );
+            image_stats( va,  STAT_ALL, par==1, sv );
+            passed = passed && sr.sum == sv.sum && sr.min_v == sv.min_v && sr.max_v == sv.max_v &&
+                sr.count == sv.count;
+
+            if( types[t] == IT_F_GRAY ) {
+                Image rt( w, h, IT_U_GRAY ), pt( pw, ph, IT_U_GRAY ), vt;
+                pt.zero();
+                vt.view( pt, r.lx, r.ly, w, h );
+                image_threshold( ref, 10.0f, par==1, rt );
+                image_threshold( va,  10.0f, par==1, vt );
+                passed = passed && same_samples( vt, rt );
+                image_abs( va, par==1, vb );
+                image_abs( ref, par==1, rd );
+                passed = passed && same_samples( vb, rd );
+            }
+            pb.copy( &pb0 );
+            sprintf( str, "view pointwise [%2d x %2d] type %d par %d", w, h, t, par );
+            report( str, passed );
+        }
+    }
+}
+
+/// the entry points that index the rows themselves: views as inputs and
+/// outputs against packed copies, and the parents of the output views
+/// untouched outside of them
+void view_paths_test() {
+    const ImageType types[] = { IT_F_GRAY, IT_F_PRGB, IT_F_IRGB, IT_U_GRAY, IT_U_PRGB, IT_U_IRGB };
+    const int pw = 71, ph = 43;
+    const Rect2i r( 6, 58, 5, 37 );
+    const int w = r.ux-r.lx, h = r.uy-r.ly;
+    char str[256];
+
+    for( int par=0; par<2; par++ ) {
+        const bool p = par == 1;
+        for( int u=0; u<2; u++ ) {
+            const ImageType t = u ? IT_U_GRAY : IT_F_GRAY;
+            Image pa, pa0, va, ref;
+            view_parent( t, pw, ph, r, pa, pa0, va );
+            ref.copy( &va );
+
+            Image rgx, rmag, rori, pgx, pgx0, vgx, pmag, pmag0, vmag, pori, pori0, vori;
+            view_parent( IT_F_GRAY, pw, ph, r, pgx,  pgx0,  vgx  );
+            view_parent( IT_F_GRAY, pw, ph, r, pmag, pmag0, vmag );
+            view_parent( IT_U_GRAY, pw, ph, r, pori, pori0, vori );
+            image_gradients( ref, GRADIENT_SOBEL, 8, p, &rgx, NULL, &rmag, &rori );
+            image_gradients( va,  GRADIENT_SOBEL, 8, p, &vgx, NULL, &vmag, &vori );
+            bool passed = same_samples( vgx, rgx ) && same_samples( vmag, rmag ) && same_samples( vori, rori ) &&
+                same_outside( pgx, pgx0, r ) && same_outside( pmag, pmag0, r ) && same_outside( pori, pori0, r );
+            sprintf( str, "view gradients type %d par %d", t, par );
+            report( str, passed );
+
+            Image rm, pb, pb0, vb, pin, pin0, vin;
+            view_parent( t, pw, ph, r, pb,  pb0,  vb  );
+            view_parent( t, pw, ph, r, pin, pin0, vin );
+            vin.copy( &ref );
+            image_morphology( ref, MORPH_OPEN, 2, 3, p, rm );
+            image_morphology( va,  MORPH_OPEN, 2, 3, p, vb );
+            image_morphology( vin, MORPH_OPEN, 2, 3, p, vin );
+            passed = same_samples( vb, rm ) && same_outside( pb, pb0, r ) &&
+                same_samples( vin, rm ) && same_outside( pin, pin0, r );
+            sprintf( str, "view morphology type %d par %d", t, par );
+            report( str, passed );
+
+            Image pk( pw, ph, t ), vk, rk, rd, rfw, pd, pd0, vd, pl, pl0, vl, rl;
+            for( int y=0; y<ph; y++ ) {
+                for( int x=0; x<pw; x++ ) {
+                    bool fg = ( rand() % 5 ) != 0;
+                    if( u ) pk.get_row_u(y)[x] = fg ? 255 : 0;
+                    else    pk.get_row_f(y)[x] = fg ? 1.0f : 0.0f;
+                }
+            }
+            vk.view( pk, r.lx, r.ly, w, h );
+            rk.copy( &vk );
+            mask_morphology( rk, MORPH_CLOSE, 3, 2, p, rm, true );
+            pb.copy( &pb0 );
+            mask_morphology( vk, MORPH_CLOSE, 3, 2, p, vb, true );
+            passed = same_samples( vb, rm ) && same_outside( pb, pb0, r );
+
+            view_parent( IT_F_GRAY, pw, ph, r, pd, pd0, vd );
+            mask_distance_transform( rk, false, p, rd );
+            mask_distance_transform( vk, false, p, vd );
+            passed = passed && same_samples( vd, rd ) && same_outside( pd, pd0, r );
+            pd.copy( &pd0 );
+            init_feather_weight_mask( rk, 4.0f, p, rfw );
+            init_feather_weight_mask( vk, 4.0f, p, vd );
+            passed = passed && same_samples( vd, rfw ) && same_outside( pd, pd0, r );
+
+            view_parent( IT_I_GRAY, pw, ph, r, pl, pl0, vl );
+            vector<ComponentStats> rs, vs;
+            int rn = connected_components( rk, true, p, rl, &rs );
+            int vn = connected_components( vk, true, p, vl, &vs );
+            passed = passed && rn == vn && same_samples( vl, rl ) && same_outside( pl, pl0, r );
+            for( int i=0; passed && i<rn; i++ )
+                passed = rs[i].area == vs[i].area && rs[i].cx == vs[i].cx && rs[i].cy == vs[i].cy;
+            sprintf( str, "view masks type %d par %d", t, par );
+            report( str, passed );
+        }
+
+        {
+            Image pa, pa0, va, ref;
+            view_parent( IT_F_GRAY, pw, ph, r, pa, pa0, va );
+            ref.copy( &va );
+            vector<LocalMaximum> rmax, vmax;
+            image_local_maxima( ref, 2, 5.0f, 1, p, rmax );
+            image_local_maxima( va,  2, 5.0f, 1, p, vmax );
+            bool passed = !rmax.empty() && rmax.size() == vmax.size();
+            for( size_t i=0; passed && i<rmax.size(); i++ )
+                passed = rmax[i].x == vmax[i].x && rmax[i].y == vmax[i].y && rmax[i].v == vmax[i].v;
+            sprintf( str, "view local maxima par %d", par );
+            report( str, passed );
+        }
+
+        for( int u=0; u<2; u++ ) {
+            const ImageType t = u ? IT_U_GRAY : IT_F_GRAY;
+            Image pa, pa0, va, ref, rs, vs;
+            view_parent( t, pw, ph, r, pa, pa0, va );
+            ref.copy( &va );
+            integral_image_sq( ref, p, rs );
+            integral_image_sq( va,  p, vs );
+            bool passed = same_samples( vs, rs ) && box_sum( vs, 3, 2, w-4, h-1 ) == box_sum( rs, 3, 2, w-4, h-1 );
+            sprintf( str, "view integral image type %d par %d", t, par );
+            report( str, passed );
+        }
+
+        {
+            Image pa, pa0, va, ref;
+            view_parent( IT_F_GRAY, pw, ph, r, pa, pa0, va );
+            ref.copy( &va );
+            Image rb, rm, rv, rn, pb, pb0, vb, pm, pm0, vm, pv, pv0, vv;
+            view_parent( IT_F_GRAY, pw, ph, r, pb, pb0, vb );
+            view_parent( IT_F_GRAY, pw, ph, r, pm, pm0, vm );
+            view_parent( IT_F_GRAY, pw, ph, r, pv, pv0, vv );
+            box_filter( ref, 4, 2, p, rb );
+            box_filter( va,  4, 2, p, vb );
+            bool passed = same_samples( vb, rb ) && same_outside( pb, pb0, r );
+            pb.copy( &pb0 );
+            mean_filter( ref, 3, p, rb );
+            mean_filter( va,  3, p, vb );
+            passed = passed && same_samples( vb, rb ) && same_outside( pb, pb0, r );
+            local_mean_variance( ref, 3, p, rm, rv );
+            local_mean_variance( va,  3, p, vm, vv );
+            passed = passed && same_samples( vm, rm ) && same_samples( vv, rv ) &&
+                same_outside( pm, pm0, r ) && same_outside( pv, pv0, r );
+            pb.copy( &pb0 );
+            local_normalize( ref, 3, 1.0f, p, rn );
+            local_normalize( va,  3, 1.0f, p, vb );
+            passed = passed && same_samples( vb, rn ) && same_outside( pb, pb0, r );
+            local_normalize( va,  3, 1.0f, p, va );
+            passed = passed && same_samples( va, rn ) && same_outside( pa, pa0, r );
+            sprintf( str, "view box filters par %d", par );
+            report( str, passed );
+        }
+
+        for( int t=0; !p && t<6; t++ ) {
+            const string file = "/tmp/kortex_view_tmp.ibin";
+            Image pa, pa0, va, ref, ld, pb, pb0, vb;
+            view_parent( types[t], pw, ph, r, pa, pa0, va );
+            view_parent( types[t], pw, ph, r, pb, pb0, vb );
+            ref.copy( &va );
+            save_image( file, &va );
+            load_image( file, &ld );
+            load_image( file, &vb );
+            bool passed = same_samples( ld, ref ) && same_samples( vb, ref ) && same_outside( pb, pb0, r );
+            sprintf( str, "view binary io type %d", t );
+            report( str, passed );
+        }
+
+        for( int t=0; t<6; t++ ) {
+            Image pa, pa0, va, ref;
+            view_parent( types[t], pw, ph, r, pa, pa0, va );
+            ref.copy( &va );
+
+            const double A[] = { 0.9, 0.2, 1.5, -0.15, 1.05, 2.25 };
+            const int    nw = w-3, nh = h-2;
+            const Rect2i ro( 2, 2+nw, 3, 3+nh );
+            Image rw, pb, pb0, vb;
+            view_parent( types[t], pw, ph, ro, pb, pb0, vb );
+            warp_affine( ref, A, nw, nh, INTERP_BICUBIC, p, rw, BORDER_REPLICATE );
+            warp_affine( va,  A, nw, nh, INTERP_BICUBIC, p, vb, BORDER_REPLICATE );
+            bool passed = same_samples( vb, rw ) && same_outside( pb, pb0, ro );
+
+            Image pmx( pw, ph, IT_F_GRAY ), pmy( pw+9, ph, IT_F_GRAY ), vmx, vmy, mx, my;
+            vmx.view( pmx, ro.lx, ro.ly, nw, nh );
+            vmy.view( pmy, r.lx,  r.ly,  nw, nh );
+            for( int y=0; y<nh; y++ ) {
+                for( int x=0; x<nw; x++ ) {
+                    vmx.get_row_f(y)[x] = x + 0.37f*y - 1.5f;
+                    vmy.get_row_f(y)[x] = 0.8f*y + 0.11f*x + 0.25f;
+                }
+            }
+            mx.copy( &vmx );
+            my.copy( &vmy );
+            pb.copy( &pb0 );
+            remap( ref, mx,  my,   INTERP_BILINEAR, p, rw, BORDER_REFLECT_101 );
+            remap( va,  vmx, vmy,  INTERP_BILINEAR, p, vb, BORDER_REFLECT_101 );
+            passed = passed && same_samples( vb, rw ) && same_outside( pb, pb0, ro );
+
+            WarpMap map;
+            warp_map_affine( A, nw, nh, p, map );
+            pb.copy( &pb0 );
+            remap( ref, map, p, rw, BORDER_REPLICATE );
+            remap( va,  map, p, vb, BORDER_REPLICATE );
+            passed = passed && same_samples( vb, rw ) && same_outside( pb, pb0, ro );
+
+            const int n = 5000;
+            vector<float> xs( n ), ys( n ), ro1( n*ref.ch() ), vo1( n*ref.ch() ), vo2( n*ref.ch() );
+            for( int i=0; i<n; i++ ) {
+                xs[i] = float( rand() % ( 100*w ) ) / 100.0f - 1.0f;
+                ys[i] = float( rand() % ( 100*h ) ) / 100.0f - 1.0f;
+            }
+            image_interpolate( ref, &xs[0], &ys[0], n, INTERP_BILINEAR, p, &ro1[0] );
+            image_interpolate( va,  &xs[0], &ys[0], n, INTERP_BILINEAR, p, &vo1[0] );
+            image_interpolate( va,  &xs[0], &ys[0], n, INTERP_BILINEAR, p, &vo2[0], BORDER_REPLICATE, 0 );
+            passed = passed && ro1 == vo1 && ro1 == vo2;
+            sprintf( str, "view warps type %d par %d", t, par );
+            report( str, passed );
+        }
+
+        {
+            Image pa, pa0, va, ref, rc, pc, pc0, vc;
+            view_parent( IT_F_PRGB, pw, ph, r, pa, pa0, va );
+            ref.copy( &va );
+            Pyramid rp, vp;
+            rp.build( ref, 2, 2, true, p );
+            vp.build( va,  2, 2, true, p );
+            bool passed = rp.n_levels() == vp.n_levels();
+            for( int l=0; passed && l<rp.n_levels(); l++ )
+                passed = same_samples( vp.gaussian(l), rp.gaussian(l) ) && same_samples( vp.laplacian(l), rp.laplacian(l) );
+            view_parent( IT_F_PRGB, pw, ph, r, pc, pc0, vc );
+            rp.collapse( p, rc );
+            vp.collapse( p, vc );
+            passed = passed && same_samples( vc, rc ) && same_outside( pc, pc0, r );
+            sprintf( str, "view pyramid par %d", par );
+            report( str, passed );
+        }
+    }
+
+    for( int u=0; u<2; u++ ) {
+        const ImageType t = u ? IT_U_GRAY : IT_F_GRAY;
+        const ImageType c = u ? IT_U_IRGB : IT_F_IRGB;
+        Image pa, pa0, va, ref, rc, pc, pc0, vc;
+        view_parent( t, pw, ph, r, pa, pa0, va );
+        ref.copy( &va );
+        view_parent( c, pw, ph, r, pc, pc0, vc );
+        rc.copy( &vc );
+        insert_image_to_channel( ref, 1, rc );
+        insert_image_to_channel( va,  1, vc );
+        bool passed = same_samples( vc, rc ) && same_outside( pc, pc0, r );
+        sprintf( str, "view insert channel type %d", t );
+        report( str, passed );
+    }
+}
@@ -0,0 +1,334 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/morphology.h>
+#include <kortex/connected_components.h>
+#include <kortex/image_processing.h>
+#include <kortex/filter.h>
+#include <kortex/log_manager.h>
+#include <kortex/image.h>
+#include <kortex/defs.h>
+
+#include "../test_utils.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+using namespace kortex;
+
+void morphology_test();
+void distance_transform_test();
+void connected_components_test();
+void local_maxima_test();
+
+int main(int argc, char **argv) {
+    print_simd_levels();
+    morphology_test();
+    distance_transform_test();
+    connected_components_test();
+    local_maxima_test();
+    release_log_man();
+    return n_failed ? 1 : 0;
+}
+
+/// brute force min / max over the window clipped at the image - or with
+/// the pixels outside counting as zero when zero_outside is set.
+float morph_reference( const float* im, int w, int h, int x, int y, int rx, int ry,
+                       bool is_min, bool zero_outside ) {
+    float v = is_min ? 1e30f : -1e30f;
+    for( int yy=y-ry; yy<=y+ry; yy++ ) {
+        for( int xx=x-rx; xx<=x+rx; xx++ ) {
+            float p;
+            if( xx < 0 || yy < 0 || xx >= w || yy >= h ) {
+                if( !zero_outside ) continue;
+                p = 0.0f;
+            } else {
+                p = im[yy*w+xx];
+            }
+            v = is_min ? std::min( v, p ) : std::max( v, p );
+        }
+    }
+    return v;
+}
+
+void morph_reference( const vector<float>& im, int w, int h, int rx, int ry, bool is_min,
+                      bool zero_outside, vector<float>& out ) {
+    out.resize( w*h );
+    for( int y=0; y<h; y++ )
+        for( int x=0; x<w; x++ )
+            out[y*w+x] = morph_reference( &im[0], w, h, x, y, rx, ry, is_min, zero_outside );
+}
+
+/// breadth-first labelling in raster order - the components are numbered
+/// by their first pixel like connected_components does.
+int components_reference( const vector<int>& m, int w, int h, bool eight, vector<int>& lab ) {
+    lab.assign( w*h, 0 );
+    vector<int> queue;
+    int n = 0;
+    for( int i=0; i<w*h; i++ ) {
+        if( !m[i] || lab[i] ) continue;
+        lab[i] = ++n;
+        queue.assign( 1, i );
+        for( size_t q=0; q<queue.size(); q++ ) {
+            int x = queue[q] % w;
+            int y = queue[q] / w;
+            for( int dy=-1; dy<=1; dy++ ) {
+                for( int dx=-1; dx<=1; dx++ ) {
+                    if( !eight && dx && dy ) continue;
+                    int xx = x+dx, yy = y+dy;
+                    if( xx < 0 || yy < 0 || xx >= w || yy >= h ) continue;
+                    int j = yy*w+xx;
+                    if( m[j] && !lab[j] ) { lab[j] = n; queue.push_back( j ); }
+                }
+            }
+        }
+    }
+    return n;
+}
+
+/// van herk / gil-werman erosion / dilation / opening / closing against
+/// brute force window min / max for both grayscale types, with and without
+/// sse, and the bit-packed mask path against the grayscale one.
+void morphology_test() {
+    const int sizes[][2] = { {1,1}, {7,5}, {67,33}, {300,41} };
+    const int radii[][2] = { {0,0}, {1,1}, {2,0}, {0,3}, {3,2}, {40,9} };
+    const MorphOp   ops  [] = { MORPH_ERODE, MORPH_DILATE, MORPH_OPEN, MORPH_CLOSE };
+    const char*     names[] = { "erode", "dilate", "open", "close" };
+    const SimdLevel level   = filter_simd_level();
+
+    for( int s=0; s<4; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        for( int r=0; r<6; r++ ) {
+            int rx = radii[r][0];
+            int ry = radii[r][1];
+            vector<float> fim( w*h ), msk( w*h );
+            random_array( &fim[0], w*h, 0.0f, 255.0f );
+            for( int i=0; i<w*h; i++ ) {
+                fim[i] = float( int( fim[i] ) );
+                msk[i] = fim[i] < 200.0f ? 1.0f : 0.0f;
+            }
+            Image fsrc( w, h, IT_F_GRAY ), usrc( w, h, IT_U_GRAY ), fmsk( w, h, IT_F_GRAY );
+            for( int i=0; i<w*h; i++ ) {
+                fsrc.get_row_f(0)[i] = fim[i];
+                usrc.get_row_u(0)[i] = uchar( fim[i] );
+                fmsk.get_row_f(0)[i] = msk[i];
+            }
+            for( int o=0; o<4; o++ ) {
+                vector<float> ref, mref, tmp;
+                bool first_min = ( ops[o] == MORPH_ERODE || ops[o] == MORPH_OPEN );
+                morph_reference( fim, w, h, rx, ry, first_min, false, ref );
+                morph_reference( msk, w, h, rx, ry, first_min, false, mref );
+                if( ops[o] == MORPH_OPEN || ops[o] == MORPH_CLOSE ) {
+                    tmp = ref;  morph_reference( tmp, w, h, rx, ry, !first_min, false, ref  );
+                    tmp = mref; morph_reference( tmp, w, h, rx, ry, !first_min, false, mref );
+                }
+                bool passed = true;
+                for( int l=0; l<2; l++ ) {
+                    filter_set_simd_level( l ? level : SIMD_NONE );
+                    Image fout, uout, mout, umout;
+                    image_morphology( fsrc, ops[o], rx, ry, l==1, fout );
+                    image_morphology( usrc, ops[o], rx, ry, l==1, uout );
+                    mask_morphology ( fmsk, ops[o], rx, ry, l==1, mout );
+                    mask_morphology ( usrc, ops[o], rx, ry, l==1, umout );
+                    for( int i=0; i<w*h; i++ ) {
+                        passed = passed && fout.get_row_f(0)[i] == ref[i];
+                        passed = passed && uout.get_row_u(0)[i] == uchar( ref[i] );
+                        passed = passed && mout.get_row_f(0)[i] == mref[i];
+                    }
+                    // every pixel of usrc but the zeros is foreground
+                    vector<float> nz( w*h ), nzref;
+                    for( int i=0; i<w*h; i++ ) nz[i] = fim[i] != 0.0f;
+                    morph_reference( nz, w, h, rx, ry, first_min, false, nzref );
+                    if( ops[o] == MORPH_OPEN || ops[o] == MORPH_CLOSE ) {
+                        tmp = nzref; morph_reference( tmp, w, h, rx, ry, !first_min, false, nzref );
+                    }
+                    for( int i=0; i<w*h; i++ )
+                        passed = passed && umout.get_row_u(0)[i] == ( nzref[i] ? 255 : 0 );
+                }
+                filter_set_simd_level( level );
+                char str[256];
+                sprintf( str, "morphology %-6s [%3d x %3d] [r %2d %d]", names[o], w, h, rx, ry );
+                report( str, passed );
+            }
+
+            // erode_mask pads with background
+            Image em; em.copy( &fmsk );
+            erode_mask( em, rx );
+            vector<float> eref;
+            morph_reference( msk, w, h, rx, rx, true, true, eref );
+            bool passed = true;
+            for( int i=0; i<w*h; i++ )
+                passed = passed && em.get_row_f(0)[i] == eref[i];
+            char str[256];
+            sprintf( str, "erode_mask [%3d x %3d] [r %2d]", w, h, rx );
+            report( str, passed );
+        }
+    }
+}
+
+/// exact distance transform against the brute force nearest background
+/// pixel - sparse and dense backgrounds, single rows and columns and a mask
+/// without background.
+void distance_transform_test() {
+    const int   sizes[][2] = { {1,1}, {1,17}, {23,1}, {40,30}, {131,77} };
+    const float density [] = { 0.0f, 0.002f, 0.05f, 0.5f };
+    for( int s=0; s<5; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        for( int d=0; d<4; d++ ) {
+            Image fmsk( w, h, IT_F_GRAY ), umsk( w, h, IT_U_GRAY );
+            vector<int> bx, by;
+            for( int y=0; y<h; y++ ) {
+                for( int x=0; x<w; x++ ) {
+                    bool bg = float( rand() ) / float( RAND_MAX ) < density[d];
+                    fmsk.get_row_f(y)[x] = bg ? 0.0f : 1.0f;
+                    umsk.get_row_u(y)[x] = bg ? 0 : 7;
+                    if( bg ) { bx.push_back(x); by.push_back(y); }
+                }
+            }
+            Image fd, ud, sq;
+            mask_distance_transform( fmsk, false, false, fd );
+            mask_distance_transform( umsk, false, true,  ud );
+            mask_distance_transform( fmsk, true,  true,  sq );
+            bool passed = true;
+            for( int y=0; y<h; y++ ) {
+                for( int x=0; x<w; x++ ) {
+                    int best = -1;
+                    for( size_t i=0; i<bx.size(); i++ ) {
+                        int dd = (x-bx[i])*(x-bx[i]) + (y-by[i])*(y-by[i]);
+                        if( best < 0 || dd < best ) best = dd;
+                    }
+                    float rs = best < 0 ? FLT_MAX : float( best );
+                    float rd = best < 0 ? FLT_MAX : std::sqrt( float( best ) );
+                    passed = passed && sq.get_row_f(y)[x] == rs;
+                    passed = passed && std::fabs( fd.get_row_f(y)[x] - rd ) <= 1e-5f * std::max( 1.0f, rd );
+                    passed = passed && ud.get_row_f(y)[x] == fd.get_row_f(y)[x];
+                }
+            }
+            char str[256];
+            sprintf( str, "distance transform [%3d x %3d] [bg %5.3f]", w, h, density[d] );
+            report( str, passed );
+        }
+    }
+}
+
+/// connected_components against the reference labelling for masks that
+/// span several strips, with statistics checked from the reference labels.
+void connected_components_test() {
+    const int   sizes[][2] = { {1,1}, {1,200}, {150,1}, {37,64}, {97,65}, {201,300} };
+    const float density [] = { 0.0f, 0.3f, 0.55f, 0.8f, 1.0f };
+    for( int s=0; s<6; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        for( int d=0; d<5; d++ ) {
+            vector<int> m( w*h );
+            Image umsk( w, h, IT_U_GRAY ), fmsk( w, h, IT_F_GRAY );
+            for( int i=0; i<w*h; i++ ) {
+                m[i] = float( rand() ) / float( RAND_MAX ) < density[d];
+                umsk.get_row_u(0)[i] = m[i] ? 255 : 0;
+                fmsk.get_row_f(0)[i] = m[i] ? 0.5f : 0.0f;
+            }
+            for( int e=0; e<2; e++ ) {
+                vector<int> ref;
+                int nref = components_reference( m, w, h, e==1, ref );
+                bool passed = true;
+                for( int p=0; p<2; p++ ) {
+                    Image lab;
+                    vector<ComponentStats> st;
+                    int n = connected_components( p ? umsk : fmsk, e==1, p==1, lab, &st );
+                    passed = passed && n == nref && (int)st.size() == n;
+                    if( !passed ) break;
+                    passed = passed && memcmp( lab.get_row_i(0), &ref[0], sizeof(int)*w*h ) == 0;
+
+                    vector<int>    area( n, 0 );
+                    vector<double> sx( n, 0.0 ), sy( n, 0.0 );
+                    vector<Rect2i> box( n, Rect2i( w, -1, h, -1 ) );
+                    for( int i=0; i<w*h; i++ ) {
+                        if( !ref[i] ) continue;
+                        int l = ref[i]-1;
+                        area[l]++;
+                        sx[l] += i%w;
+                        sy[l] += i/w;
+                        box[l].insert( i%w, i/w );
+                    }
+                    for( int l=0; l<n; l++ ) {
+                        passed = passed && st[l].area == area[l];
+                        passed = passed && st[l].bbox.lx == box[l].lx && st[l].bbox.ux == box[l].ux+1;
+                        passed = passed && st[l].bbox.ly == box[l].ly && st[l].bbox.uy == box[l].uy+1;
+                        passed = passed && std::fabs( st[l].cx - sx[l]/area[l] ) < 1e-3;
+                        passed = passed && std::fabs( st[l].cy - sy[l]/area[l] ) < 1e-3;
+                    }
+                }
+                char str[256];
+                sprintf( str, "connected components %d [%3d x %3d] [fg %4.2f]", e ? 8 : 4, w, h, density[d] );
+                report( str, passed );
+            }
+        }
+    }
+}
+
+/// image_local_maxima against Image::is_maximum at every pixel - coarse
+/// values so that plateaus occur, with thresholds and margins.
+void local_maxima_test() {
+    const int sizes[][2] = { {1,1}, {9,3}, {70,45}, {203,97} };
+    const int radii[]    = { 1, 2, 5 };
+    for( int s=0; s<4; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        Image fim( w, h, IT_F_GRAY ), iim( w, h, IT_I_GRAY );
+        for( int i=0; i<w*h; i++ ) {
+            int v = rand() % 40 - 10;
+            fim.get_row_f(0)[i] = v * 0.5f;
+            iim.get_row_i(0)[i] = v;
+        }
+        for( int r=0; r<3; r++ ) {
+            for( int m=0; m<3; m++ ) {
+                int   margin = m*2;
+                float th     = m == 1 ? 5.0f : -100.0f;
+                bool  passed = true;
+                for( int p=0; p<2; p++ ) {
+                    vector<LocalMaximum> fmax, imax;
+                    image_local_maxima( fim, radii[r], th*0.5f, margin, p==1, fmax );
+                    image_local_maxima( iim, radii[r], th,      margin, p==1, imax );
+                    size_t nf = 0, ni = 0;
+                    for( int y=margin; y<h-margin; y++ ) {
+                        for( int x=margin; x<w-margin; x++ ) {
+                            float fv = fim.get_row_f(y)[x];
+                            if( fv > th*0.5f && fim.is_maximum( x, y, radii[r], fv ) ) {
+                                passed = passed && nf < fmax.size() && fmax[nf].x == x && fmax[nf].y == y && fmax[nf].v == fv;
+                                nf++;
+                            }
+                            int iv = iim.get_row_i(y)[x];
+                            if( iv > th && iim.is_maximum( x, y, radii[r], iv ) ) {
+                                passed = passed && ni < imax.size() && imax[ni].x == x && imax[ni].y == y && imax[ni].v == iv;
+                                ni++;
+                            }
+                        }
+                    }
+                    passed = passed && nf == fmax.size() && ni == imax.size();
+                }
+                char str[256];
+                sprintf( str, "local maxima [%3d x %3d] [r %d] [margin %d]", w, h, radii[r], margin );
+                report( str, passed );
+            }
+        }
+    }
+}
@@ -0,0 +1,470 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/image_expr.h>
+#include <kortex/image_processing.h>
+#include <kortex/image_stats.h>
+#include <kortex/color.h>
+#include <kortex/filter.h>
+#include <kortex/log_manager.h>
+#include <kortex/image.h>
+#include <kortex/defs.h>
+
+#include "../test_utils.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+using namespace kortex;
+
+void expression_test();
+void pointwise_test();
+void reduction_test();
+void pixelwise_test();
+
+int main(int argc, char **argv) {
+    print_simd_levels();
+    expression_test();
+    pointwise_test();
+    reduction_test();
+    pixelwise_test();
+    release_log_man();
+    return n_failed ? 1 : 0;
+}
+
+/// the samples of im in roi, channel by channel
+void region_samples( const Image& im, const Rect2i& roi, vector<double>& v ) {
+    v.clear();
+    int nc = im.ch();
+    for( int y=roi.ly; y<roi.uy; y++ ) {
+        for( int x=roi.lx; x<roi.ux; x++ ) {
+            for( int c=0; c<nc; c++ ) {
+                size_t i = image_channel_type( im.type() ) == ITC_IMAGE ? ( size_t(c)*im.h() + y )*im.w() + x
+                                                                          : ( size_t(y)*im.w() + x )*nc + c;
+                v.push_back( sample( im, i ) );
+            }
+        }
+    }
+}
+
+void expression_test() {
+    const SimdLevel level = filter_simd_level();
+    const int sizes[][2] = { {1,1}, {7,3}, {67,41}, {300,200} };
+    char str[256];
+    for( int s=0; s<4; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        int n = w*h;
+        Image a( w, h, IT_F_GRAY ), b( w, h, IT_F_GRAY ), c( w, h, IT_U_GRAY ), d( w, h, IT_I_GRAY );
+        for( int i=0; i<n; i++ ) {
+            a.get_row_f(0)[i] = rand() / float(RAND_MAX) * 2.0f - 0.5f;
+            b.get_row_f(0)[i] = rand() / float(RAND_MAX);
+            c.get_row_u(0)[i] = uchar( rand() % 256 );
+            d.get_row_i(0)[i] = rand() % 2001 - 1000;
+        }
+        const float sc = 0.003f;
+
+        // reference of clip( a*b + sc*c, 0, 1 ) and ( a - d ) * 100 / ( |b| + 1 )
+        vector<float> r0( n ), r1( n );
+        for( int i=0; i<n; i++ ) {
+            float v = a.get_row_f(0)[i] * b.get_row_f(0)[i] + sc * c.get_row_u(0)[i];
+            v = v > 0.0f ? v : 0.0f;
+            r0[i] = v < 1.0f ? v : 1.0f;
+            r1[i] = -( a.get_row_f(0)[i] - d.get_row_i(0)[i] ) * 100.0f / ( std::fabs( b.get_row_f(0)[i] ) + 1.0f );
+        }
+
+        bool passed = true;
+        for( int l=0; l<2; l++ ) {
+            filter_set_simd_level( l ? level : SIMD_NONE );
+            for( int par=0; par<2; par++ ) {
+                Image o0, o1, ou( w, h, IT_U_GRAY ), oi( w, h, IT_I_GRAY );
+                image_eval( clip( expr(a)*b + sc*expr(c), 0.0f, 1.0f ), par==1, o0 );
+                image_eval( -( expr(a) - d ) * 100.0f / ( expr_abs( expr(b) ) + 1.0f ), par==1, o1 );
+                image_eval( expr(c)*0.5f + 64.4f, par==1, ou );
+                image_eval( expr(d)*0.5f, par==1, oi );
+                passed = passed && o0.type() == IT_F_GRAY && o1.type() == IT_F_GRAY;
+                passed = passed && compare_outputs( &r0[0], o0.get_row_f(0), n, false );
+                passed = passed && compare_outputs( &r1[0], o1.get_row_f(0), n, false );
+                for( int i=0; i<n; i++ ) {
+                    float v  = c.get_row_u(0)[i]*0.5f + 64.4f;
+                    int   ev = std::min( 255, int( v + 0.5f ) );
+                    passed = passed && ou.get_row_u(0)[i] == ev;
+                    float dv = d.get_row_i(0)[i]*0.5f;
+                    int   di = int( dv >= 0.0f ? dv + 0.5f : dv - 0.5f );
+                    passed = passed && oi.get_row_i(0)[i] == di;
+                }
+
+                // in place: b = sqrt( max( b, a ) )
+                Image bb; bb.copy( &b );
+                image_eval( expr_sqrt( max( expr(bb), a ) ), par==1, bb );
+                for( int i=0; i<n; i++ ) {
+                    float m = std::max( b.get_row_f(0)[i], a.get_row_f(0)[i] );
+                    passed = passed && std::fabs( bb.get_row_f(0)[i] - std::sqrt( m ) ) <= 1e-6f;
+                }
+            }
+        }
+        filter_set_simd_level( level );
+        sprintf( str, "expression [%3d x %3d]", w, h );
+        report( str, passed );
+    }
+
+    // channel layouts
+    {
+        int w = 33, h = 17, n = w*h*3;
+        Image p( w, h, IT_F_IRGB ), q( w, h, IT_U_IRGB ), o;
+        for( int i=0; i<n; i++ ) {
+            p.get_row_fi(0,0)[i] = rand() / float(RAND_MAX);
+            q.get_row_ui(0,0)[i] = uchar( rand() % 256 );
+        }
+        image_eval( expr(p) * 255.0f - q, true, o );
+        bool passed = o.type() == IT_F_IRGB;
+        for( int i=0; passed && i<n; i++ )
+            passed = passed && o.get_row_fi(0,0)[i] == p.get_row_fi(0,0)[i]*255.0f - q.get_row_ui(0,0)[i];
+        Image ou( w, h, IT_U_IRGB );
+        image_eval( expr(p) * 255.0f, false, ou );
+        for( int i=0; passed && i<n; i++ )
+            passed = passed && ou.get_row_ui(0,0)[i] == uchar( std::min( 255.0f, p.get_row_fi(0,0)[i]*255.0f ) + 0.5f );
+        report( "expression irgb", passed );
+    }
+
+    // the image_processing routines that evaluate through expressions
+    {
+        int w = 67, h = 41, n = w*h;
+        Image a( w, h, IT_F_GRAY ), b( w, h, IT_F_GRAY ), c( w, h, IT_F_GRAY );
+        Image o0( w, h, IT_F_GRAY ), o1( w, h, IT_F_GRAY ), o2( w, h, IT_F_GRAY ), o3( w, h, IT_F_GRAY );
+        random_array( a.get_row_f(0), n, -1.0f, 1.0f );
+        random_array( b.get_row_f(0), n, -1.0f, 1.0f );
+        random_array( c.get_row_f(0), n, -1.0f, 1.0f );
+        image_add         ( a, 0.25f, o0 );
+        image_multiply    ( a, b, o1 );
+        image_multiply_par( a, b, o2 );
+        image_multiply_add( a, b, c, true, o3 );
+        vector<float> r3( n );
+        bool passed = true;
+        for( int i=0; i<n; i++ ) {
+            float m = a.get_row_f(0)[i] * b.get_row_f(0)[i];
+            passed = passed && o0.get_row_f(0)[i] == a.get_row_f(0)[i] + 0.25f;
+            passed = passed && o1.get_row_f(0)[i] == m && o2.get_row_f(0)[i] == m;
+            r3[i] = m + c.get_row_f(0)[i];
+        }
+        passed = passed && compare_outputs( &r3[0], o3.get_row_f(0), n, false );
+        report( "expression image_add / image_multiply", passed );
+    }
+}
+
+void pointwise_test() {
+    const SimdLevel level = filter_simd_level();
+    const int sizes[][2] = { {1,1}, {17,3}, {131,70} };
+    const ImageType types[] = { IT_F_GRAY, IT_U_GRAY, IT_I_GRAY, IT_F_IRGB, IT_U_PRGB };
+    char str[256];
+    for( int s=0; s<3; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        for( int t=0; t<5; t++ ) {
+            Image a( w, h, types[t] ), b( w, h, types[t] );
+            random_samples( a, 300 );
+            random_samples( b, 4 );
+            size_t n = a.element_count();
+            bool flt = a.precision() == TYPE_FLOAT;
+            bool u8  = a.precision() == TYPE_UCHAR;
+            bool passed = true;
+            for( int l=0; l<2; l++ ) {
+                filter_set_simd_level( l ? level : SIMD_NONE );
+                for( int par=0; par<2; par++ ) {
+                    Image d( w, h, types[t] ), q( w, h, types[t] ), ng( w, h, types[t] );
+                    image_subtract( a, b, par==1, d );
+                    image_divide  ( a, b, par==1, q );
+                    if( !u8 ) image_negate( a, par==1, ng );
+                    for( size_t i=0; i<n; i++ ) {
+                        double va = sample( a, i ), vb = sample( b, i ), rd, rq;
+                        if( flt ) {
+                            rd = float( va ) - float( vb );
+                            rq = std::fabs( vb ) < 1e-6 ? 0.0 : float( va ) / float( vb );
+                        } else {
+                            rd = u8 ? std::max( 0.0, va-vb ) : va-vb;
+                            rq = vb ? double( int(va) / int(vb) ) : 0.0;
+                        }
+                        passed = passed && sample( d, i ) == rd && sample( q, i ) == rq;
+                        if( !u8 ) passed = passed && sample( ng, i ) == -va;
+                    }
+                    // in place
+                    Image ip; ip.copy( &b );
+                    image_divide( a, ip, par==1, ip );
+                    for( size_t i=0; i<n; i++ )
+                        passed = passed && sample( ip, i ) == sample( q, i );
+                }
+            }
+            filter_set_simd_level( level );
+            sprintf( str, "pointwise arithmetic [%3d x %3d] type %d", w, h, t );
+            report( str, passed );
+        }
+
+        // masks
+        const ImageType gtypes[] = { IT_F_GRAY, IT_U_GRAY, IT_I_GRAY };
+        for( int t=0; t<3; t++ ) {
+            Image a( w, h, gtypes[t] );
+            random_samples( a, 3 );
+            size_t n = a.pixel_count();
+            if( a.type() == IT_F_GRAY && n > 1 ) a.get_fptr()[1] = std::sqrt( -1.0f );
+            const float ths[] = { -1e10f, -0.5f, 0.0f, 2.0f, 130.3f, 255.0f, 1e10f };
+            bool passed = true;
+            for( int l=0; l<2; l++ ) {
+                filter_set_simd_level( l ? level : SIMD_NONE );
+                for( int par=0; par<2; par++ ) {
+                    for( int k=0; k<7; k++ ) {
+                        Image mu( w, h, IT_U_GRAY ), mf( w, h, IT_F_GRAY );
+                        image_threshold( a, ths[k], par==1, mu );
+                        image_threshold( a, ths[k], par==1, mf );
+                        for( size_t i=0; i<n; i++ ) {
+                            int e = sample( a, i ) > ths[k];
+                            passed = passed && mu.get_uptr()[i] == e && mf.get_fptr()[i] == e;
+                        }
+                    }
+                    Image bu( w, h, IT_U_GRAY ), bf( w, h, IT_F_GRAY ), iu( w, h, IT_U_GRAY );
+                    binarize_image( a, par==1, bu );
+                    binarize_image( a, par==1, bf );
+                    mask_invert( bu, par==1, iu );
+                    for( size_t i=0; i<n; i++ ) {
+                        int e = sample( a, i ) > 0.0;
+                        passed = passed && bu.get_uptr()[i] == e && bf.get_fptr()[i] == e && iu.get_uptr()[i] == 1-e;
+                    }
+                    mask_invert( bf, par==1, bf );
+                    for( size_t i=0; i<n; i++ )
+                        passed = passed && bf.get_fptr()[i] == float( 1-bu.get_uptr()[i] );
+                    if( a.type() == IT_U_GRAY ) {
+                        Image pk; pk.copy( &a );
+                        uchar v = a.get_uptr()[n/2];
+                        pick_pixels_with_color( pk, v, par==1, pk );
+                        for( size_t i=0; i<n; i++ )
+                            passed = passed && pk.get_uptr()[i] == ( a.get_uptr()[i] == v );
+                    }
+                }
+            }
+            filter_set_simd_level( level );
+            sprintf( str, "pointwise masks [%3d x %3d] type %d", w, h, t );
+            report( str, passed );
+        }
+
+        // range maps
+        for( int t=0; t<2; t++ ) {
+            Image a( w, h, t ? IT_U_GRAY : IT_F_GRAY );
+            random_samples( a, 300 );
+            size_t n = a.pixel_count();
+            if( !t && n > 2 ) a.get_fptr()[2] = std::sqrt( -1.0f );
+            float mn, mx;
+            image_min_max( a, mn, mx );
+            bool passed = true;
+            for( int l=0; l<2; l++ ) {
+                filter_set_simd_level( l ? level : SIMD_NONE );
+                for( int par=0; par<2; par++ ) {
+                    if( n == 1 ) continue;
+                    Image ln( w, h, IT_F_GRAY ), st, sr;
+                    image_linearize( a, par==1, ln );
+                    image_stretch( a, 0.0f, 0.0f, par==1, st );
+                    image_stretch( a, -20.0f, 100.0f, par==1, sr );
+                    for( size_t i=0; i<n; i++ ) {
+                        float v  = float( sample( a, i ) );
+                        float el = ( v - mn ) * ( 1.0f / ( mx - mn ) );
+                        passed = passed && ( ln.get_fptr()[i] == el || ( v != v && el != el ) );
+                        uchar es = v == v ? cast_to_gray_range( ( v - mn ) * ( 255.0f / ( mx - mn ) ) ) : 0;
+                        uchar er = v == v ? cast_to_gray_range( ( v + 20.0f ) * ( 255.0f / 120.0f ) ) : 0;
+                        passed = passed && st.get_uptr()[i] == es && sr.get_uptr()[i] == er;
+                    }
+                }
+            }
+            filter_set_simd_level( level );
+            sprintf( str, "pointwise ranges [%3d x %3d] type %d", w, h, t );
+            report( str, passed );
+        }
+    }
+}
+
+void reduction_test() {
+    const SimdLevel level = filter_simd_level();
+    const ImageType types[] = { IT_F_GRAY, IT_U_GRAY, IT_I_GRAY, IT_F_IRGB, IT_U_PRGB, IT_F_PRGB };
+    const int sizes[][2] = { {1,1}, {19,7}, {301,140} };
+    char str[256];
+    for( int s=0; s<3; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        for( int t=0; t<6; t++ ) {
+            Image im( w, h, types[t] );
+            random_samples( im, 1000 );
+            bool flt = im.precision() == TYPE_FLOAT;
+            if( flt ) {
+                for( size_t i=3; i<im.element_count(); i+=97 )
+                    im.get_fptr()[i] = std::sqrt( -1.0f );
+            }
+            Rect2i rois[3];
+            rois[0].init( 0, w, 0, h );
+            rois[1].init( w/3, w-w/4, h/2, h );
+            rois[2].init( -5, w/2+1, 1, h+10 );
+            bool passed = true;
+            for( int r=0; r<3; r++ ) {
+                Rect2i cr; cr.init( std::max( 0, rois[r].lx ), std::min( w, rois[r].ux ), std::max( 0, rois[r].ly ), std::min( h, rois[r].uy ) );
+                vector<double> v;
+                region_samples( im, cr, v );
+                for( int ab=0; ab<2; ab++ ) {
+                    double mn = DBL_MAX, mx = -DBL_MAX, sm = 0.0, sq = 0.0;
+                    size_t cnt = 0, nan = 0;
+                    for( size_t i=0; i<v.size(); i++ ) {
+                        double x = ab ? std::fabs( v[i] ) : v[i];
+                        if( x != x ) { nan++; continue; }
+                        cnt++;
+                        mn = std::min( mn, x ); mx = std::max( mx, x );
+                        sm += x; sq += x*x;
+                    }
+                    ImageStats base;
+                    for( int l=0; l<2; l++ ) {
+                        filter_set_simd_level( l ? level : SIMD_NONE );
+                        for( int par=0; par<2; par++ ) {
+                            ImageStats st;
+                            image_stats( im, STAT_ALL | ( ab ? STAT_ABS : 0 ), par==1, st, r ? &rois[r] : NULL );
+                            passed = passed && st.count == cnt && st.nan_count == nan && st.min_v == mn && st.max_v == mx;
+                            passed = passed && std::fabs( st.sum    - sm ) <= 1e-12 * ( 1.0 + std::fabs( sq ) );
+                            passed = passed && std::fabs( st.sum_sq - sq ) <= 1e-12 * ( 1.0 + sq );
+                            // the block tree makes serial and parallel agree exactly
+                            if( par ) passed = passed && st.sum == base.sum && st.sum_sq == base.sum_sq;
+                            else      base = st;
+                        }
+                    }
+                }
+
+                const SampleTest tests[] = { TEST_NONZERO, TEST_NAN, TEST_IN_RANGE, TEST_OUTSIDE, TEST_EITHER };
+                const float      pa[]    = { 0.0f, 0.0f, -20.5f, 3.0f,    0.0f };
+                const float      pb[]    = { 0.0f, 0.0f, 200.0f, 100.0f,  7.0f };
+                for( int k=0; k<5; k++ ) {
+                    size_t e = 0;
+                    for( size_t i=0; i<v.size(); i++ ) {
+                        double x = v[i];
+                        switch( tests[k] ) {
+                        case TEST_NONZERO : e += x != 0.0;                 break;
+                        case TEST_NAN     : e += x != x;                   break;
+                        case TEST_IN_RANGE: e += pa[k] <= x && x <= pb[k]; break;
+                        case TEST_OUTSIDE : e += x < pa[k] || x > pb[k];   break;
+                        case TEST_EITHER  : e += x == pa[k] || x == pb[k]; break;
+                        }
+                    }
+                    for( int l=0; l<2; l++ ) {
+                        filter_set_simd_level( l ? level : SIMD_NONE );
+                        for( int par=0; par<2; par++ ) {
+                            const Rect2i* roi = r ? &rois[r] : NULL;
+                            passed = passed && image_count( im, tests[k], pa[k], pb[k], par==1, roi ) == e;
+                            passed = passed && image_any  ( im, tests[k], pa[k], pb[k], par==1, roi ) == ( e > 0 );
+                            passed = passed && image_all  ( im, tests[k], pa[k], pb[k], par==1, roi ) == ( e == v.size() );
+                        }
+                    }
+                }
+            }
+            filter_set_simd_level( level );
+            sprintf( str, "reductions [%3d x %3d] type %d", w, h, t );
+            report( str, passed );
+        }
+    }
+
+    // the checks built on them
+    {
+        int w = 257, h = 129;
+        Image b( w, h, IT_F_GRAY ), c( w, h, IT_F_GRAY ), u( w, h, IT_U_GRAY );
+        for( int i=0; i<w*h; i++ ) {
+            b.get_row_f(0)[i] = float( rand() % 2 );
+            c.get_row_f(0)[i] = 1.0f - b.get_row_f(0)[i];
+            u.get_row_u(0)[i] = uchar( rand() % 2 );
+        }
+        bool passed = true;
+        for( int par=0; par<2; par++ ) {
+            passed = passed &&  is_binarized( b, par==1 ) &&  is_binarized( u, par==1 );
+            passed = passed &&  is_normalized( b, par==1 );
+            passed = passed && !does_overlap( b, c, par==1 );
+            float mn, mx;
+            passed = passed && image_min_max( b, mn, mx, par==1 ) && mn == 0.0f && mx == 1.0f;
+            b.get_row_f(h-1)[w-2] = 0.5f;
+            c.get_row_f(h-1)[w-2] = 0.5f;
+            u.get_row_u(h-1)[w-1] = 2;
+            passed = passed && !is_binarized( b, par==1 ) && !is_binarized( u, par==1 );
+            passed = passed &&  is_normalized( b, par==1 ) && does_overlap( b, c, par==1 );
+            b.get_row_f(h/2)[3] = -0.25f;
+            passed = passed && !is_normalized( b, par==1 );
+            passed = passed && abs_image_min_max( b, mn, mx, par==1 ) && mn == 0.0f && mx == 1.0f;
+            b.get_row_f(h-1)[w-2] = c.get_row_f(h-1)[w-2] = 0.0f;
+            b.get_row_f(h/2)[3] = 1.0f;
+            c.get_row_f(h/2)[3] = 0.0f;
+            u.get_row_u(h-1)[w-1] = 0;
+        }
+        Image nn( 4, 4, IT_F_GRAY );
+        for( int i=0; i<16; i++ ) nn.get_row_f(0)[i] = std::sqrt( -1.0f );
+        float mn, mx;
+        passed = passed && !image_min_max( nn, mn, mx );
+        report( "reduction checks", passed );
+    }
+}
+
+struct PixelGamma {
+    float g;
+    float operator()( const float& v ) const { return 255.0f * std::pow( v / 255.0f, g ); }
+};
+
+void pixelwise_test() {
+    const int sizes[][2] = { {1,1}, {17,3}, {131,70} };
+    const ImageType types[] = { IT_F_GRAY, IT_U_GRAY, IT_F_IRGB, IT_U_PRGB };
+    PixelGamma gm = { 0.45f };
+    char str[256];
+    for( int s=0; s<3; s++ ) {
+        int w = sizes[s][0];
+        int h = sizes[s][1];
+        for( int t=0; t<4; t++ ) {
+            Image a( w, h, types[t] );
+            random_samples( a, 1000 );
+            size_t n   = a.element_count();
+            bool   u8  = a.precision() == TYPE_UCHAR;
+            ImageType ft = u8 ? ( a.ch() == 1 ? IT_F_GRAY : IT_F_PRGB ) : types[t];
+            ImageType ut = u8 ? types[t] : ( a.ch() == 1 ? IT_U_GRAY : IT_U_IRGB );
+            bool passed = true;
+            for( int par=0; par<2; par++ ) {
+                Image f( w, h, ft ), u( w, h, ut ), p( w, h, ft );
+                apply_pixelwise_operation( a, gm,          par==1, f );
+                apply_pixelwise_operation( a, gm,          par==1, u );
+                apply_pixelwise_operation( a, pixel_halve, par==1, p );
+                for( size_t i=0; i<n; i++ ) {
+                    float v  = float( sample( a, i ) );
+                    float ef = gm( v );
+                    passed = passed && ( f.get_fptr()[i] == ef || ( ef != ef && f.get_fptr()[i] != f.get_fptr()[i] ) );
+                    passed = passed && u.get_uptr()[i] == cast_to_gray_range( ef );
+                    passed = passed && p.get_fptr()[i] == pixel_halve( v );
+                }
+            }
+            sprintf( str, "pixelwise [%3d x %3d] type %d", w, h, t );
+            report( str, passed );
+        }
+    }
+    {
+        Image a( 67, 45, IT_U_GRAY ), q( 67, 45, IT_U_GRAY );
+        random_samples( a, 0 );
+        uchar lut[256];
+        for( int i=0; i<256; i++ ) lut[i] = uchar( 255-i );
+        apply_pixelwise_lut( a, lut, true, q );
+        bool passed = true;
+        for( size_t i=0; i<a.element_count(); i++ )
+            passed = passed && q.get_uptr()[i] == 255-a.get_uptr()[i];
+        apply_pixelwise_lut( a, lut, false, a );
+        passed = passed && memcmp( a.get_uptr(), q.get_uptr(), a.element_count() ) == 0;
+        report( "pixelwise lut in place", passed );
+    }
+}
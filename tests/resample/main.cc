@@ -0,0 +1,270 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/resample.h>
+#include <kortex/pyramid.h>
+#include <kortex/image_processing.h>
+#include <kortex/filter.h>
+#include <kortex/log_manager.h>
+#include <kortex/image.h>
+#include <kortex/defs.h>
+
+#include "../test_utils.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+using namespace kortex;
+
+void resample_test();
+void pyramid_test();
+
+int main(int argc, char **argv) {
+    print_simd_levels();
+    resample_test();
+    pyramid_test();
+    release_log_man();
+    return n_failed ? 1 : 0;
+}
+
+float max_abs_diff( const float* a, const float* b, int sz ) {
+    float d = 0.0f;
+    for( int i=0; i<sz; i++ )
+        d = std::max( d, std::fabs( a[i]-b[i] ) );
+    return d;
+}
+
+void resample_test() {
+    const ResampleMode modes[] = { RESAMPLE_BICUBIC, RESAMPLE_LANCZOS, RESAMPLE_AREA, RESAMPLE_GAUSSIAN };
+    const char*        mnames[] = { "bicubic", "lanczos", "area", "gaussian" };
+    const int sizes[][4] = { {64,48,64,48}, {97,61,200,150}, {640,480,213,160}, {333,97,41,300}, {5,3,1,1} };
+    const SimdLevel levels[] = { SIMD_NONE, SIMD_AVX512 };
+
+    for( int m=0; m<4; m++ ) {
+        for( int s=0; s<5; s++ ) {
+            for( int nc=1; nc<=3; nc+=2 ) {
+                int w = sizes[s][0], h = sizes[s][1], nw = sizes[s][2], nh = sizes[s][3];
+                vector<float> im(w*h*nc), ref(nw*nh*nc), out(nw*nh*nc), par(nw*nh*nc);
+                vector<uchar> uim(w*h*nc), uout(nw*nh*nc);
+                random_array( &im[0], w*h*nc, 0.0f, 255.0f );
+
+                // a constant image stays constant
+                std::fill( im.begin(), im.end(), 93.0f );
+                resample( &im[0], w, h, nc, nw, nh, modes[m], BORDER_REPLICATE, &out[0] );
+                float cerr = 0.0f;
+                for( int i=0; i<nw*nh*nc; i++ )
+                    cerr = std::max( cerr, std::fabs( out[i]-93.0f ) );
+                bool passed = cerr < 1e-3f;
+
+                // simd kernels, serial and parallel
+                random_array( &im[0], w*h*nc, 0.0f, 255.0f );
+                filter_set_simd_level( levels[0] );
+                resample( &im[0], w, h, nc, nw, nh, modes[m], BORDER_REFLECT_101, &ref[0] );
+                filter_set_simd_level( levels[1] );
+                resample    ( &im[0], w, h, nc, nw, nh, modes[m], BORDER_REFLECT_101, &out[0] );
+                resample_par( &im[0], w, h, nc, nw, nh, modes[m], BORDER_REFLECT_101, &par[0] );
+                passed = passed && compare_outputs( &ref[0], &out[0], nw*nh*nc, false )
+                    &&             compare_outputs( &out[0], &par[0], nw*nh*nc, true  );
+
+                // uchar rounds the float result
+                for( int i=0; i<w*h*nc; i++ ) {
+                    uim[i] = uchar( im[i] );
+                    im [i] = uim[i];
+                }
+                resample_par( &im [0], w, h, nc, nw, nh, modes[m], BORDER_REFLECT_101, &out [0] );
+                resample_par( &uim[0], w, h, nc, nw, nh, modes[m], BORDER_REFLECT_101, &uout[0] );
+                for( int i=0; i<nw*nh*nc; i++ ) {
+                    float e = std::min( 255.0f, std::max( 0.0f, out[i] ) );
+                    if( std::fabs( e - uout[i] ) > 0.5f+1e-3f ) { passed = false; break; }
+                }
+
+                // same size: bicubic and area copy the image
+                if( w == nw && h == nh && ( modes[m] == RESAMPLE_BICUBIC || modes[m] == RESAMPLE_AREA ) ) {
+                    resample( &im[0], w, h, nc, nw, nh, modes[m], BORDER_ZERO, &out[0] );
+                    passed = passed && memcmp( &im[0], &out[0], sizeof(float)*w*h*nc ) == 0;
+                }
+
+                char str[256];
+                sprintf( str, "resample %-8s [%3d x %3d] -> [%3d x %3d] nc %d", mnames[m], w, h, nw, nh, nc );
+                report( str, passed );
+            }
+        }
+    }
+
+    // bicubic enlargement against bicubic_interpolation inside the image
+    {
+        int w = 57, h = 43, nw = 150, nh = 101;
+        vector<float> im(w*h), out(nw*nh);
+        random_array( &im[0], w*h, 0.0f, 255.0f );
+        resample( &im[0], w, h, 1, nw, nh, RESAMPLE_BICUBIC, BORDER_REPLICATE, &out[0] );
+        float err = 0.0f;
+        for( int y=0; y<nh; y++ ) {
+            float sy = (y+0.5f)*h/nh - 0.5f;
+            for( int x=0; x<nw; x++ ) {
+                float sx = (x+0.5f)*w/nw - 0.5f;
+                if( sx < 2 || sy < 2 || sx >= w-3 || sy >= h-3 ) continue;
+                err = std::max( err, std::fabs( out[y*nw+x] - bicubic_interpolation( &im[0], w, h, 1, 0, sx, sy ) ) );
+            }
+        }
+        char str[256];
+        sprintf( str, "resample bicubic vs bicubic_interpolation [err %.5f]", err );
+        report( str, err < 1e-2f );
+    }
+
+    // exact 2x and 4x reductions: bit-exact across kernel variants, uchar
+    // rounds the integer block sums half up
+    for( int f=2; f<=4; f+=2 ) {
+        for( int nc=1; nc<=3; nc+=2 ) {
+            int nw = 37, nh = 21, w = nw*f, h = nh*f;
+            vector<float> im(w*h*nc), ref(nw*nh*nc, 0.0f), out(nw*nh*nc), par(nw*nh*nc);
+            vector<uchar> uim(w*h*nc), uout(nw*nh*nc);
+            vector<int>   usum(nw*nh*nc, 0);
+            random_array( &im[0], w*h*nc, 0.0f, 255.0f );
+            for( int i=0; i<w*h*nc; i++ )
+                uim[i] = uchar( im[i] );
+            for( int y=0; y<h; y++ ) {
+                for( int x=0; x<w; x++ ) {
+                    for( int c=0; c<nc; c++ ) {
+                        int o = ((y/f)*nw+x/f)*nc+c, i = (y*w+x)*nc+c;
+                        ref [o] += im[i] / float(f*f);
+                        usum[o] += uim[i];
+                    }
+                }
+            }
+            filter_set_simd_level( SIMD_NONE );
+            resample    ( &im[0], w, h, nc, nw, nh, RESAMPLE_AREA, BORDER_ZERO, &out[0] );
+            filter_set_simd_level( SIMD_AVX512 );
+            resample_par( &im[0], w, h, nc, nw, nh, RESAMPLE_AREA, BORDER_ZERO, &par[0] );
+            resample_par( &uim[0], w, h, nc, nw, nh, RESAMPLE_AREA, BORDER_ZERO, &uout[0] );
+            bool passed = max_abs_diff( &ref[0], &out[0], nw*nh*nc ) < 1e-3f
+                &&        compare_outputs( &out[0], &par[0], nw*nh*nc, true );
+            for( int i=0; i<nw*nh*nc; i++ )
+                passed = passed && uout[i] == ( usum[i] + f*f/2 ) / (f*f);
+            char str[256];
+            sprintf( str, "resample area 1/%d nc %d", f, nc );
+            report( str, passed );
+        }
+    }
+
+    // area shrinking by other integer factors averages the blocks too
+    for( int f=3; f<=5; f+=2 ) {
+        int nw = 50, nh = 31, w = nw*f, h = nh*f;
+        vector<float> im(w*h), out(nw*nh), ref(nw*nh, 0.0f);
+        random_array( &im[0], w*h, 0.0f, 255.0f );
+        for( int y=0; y<h; y++ )
+            for( int x=0; x<w; x++ )
+                ref[(y/f)*nw+x/f] += im[y*w+x] / float(f*f);
+        resample_par( &im[0], w, h, 1, nw, nh, RESAMPLE_AREA, BORDER_ZERO, &out[0] );
+        char str[256];
+        sprintf( str, "resample area 1/%d block mean", f );
+        report( str, max_abs_diff( &ref[0], &out[0], nw*nh ) < 1e-3f );
+    }
+
+    // image level: both rgb layouts
+    {
+        int w = 120, h = 77, pc = w*h;
+        Image prgb( w, h, IT_F_PRGB ), irgb( w, h, IT_F_IRGB ), pout, iout;
+        random_array( prgb.get_row_f(0), pc*3, 0.0f, 255.0f );
+        deinterleave( prgb.get_row_f(0), pc, 3, irgb );
+        image_resize_fine( prgb, 71, 190, true,  pout );
+        image_resize_fine( irgb, 71, 190, false, iout );
+        vector<float> ref( 71*190*3 );
+        interleave( iout, 71*190, 3, &ref[0] );
+        report( "image_resize_fine prgb vs irgb",
+                pout.w() == 71 && pout.h() == 190 && compare_outputs( &ref[0], pout.get_row_f(0), 71*190*3, false ) );
+    }
+
+    // coarse reduction of an integer image
+    {
+        Image im( 64, 48, IT_I_GRAY ), out;
+        for( int i=0; i<64*48; i++ )
+            im.get_row_i(0)[i] = (i%64) + 1000*(i/64);
+        image_resize_coarse( im, 16, 12, true, out );
+        bool passed = out.type() == IT_I_GRAY && out.w() == 16 && out.h() == 12;
+        for( int y=0; y<12 && passed; y++ )
+            for( int x=0; x<16; x++ )
+                passed = passed && out.get_row_i(y)[x] == int( std::floor( 4*x+1.5 + 1000*(4*y+1.5) + 0.5 ) );
+        report( "image_resize_coarse int 1/4", passed );
+    }
+}
+
+void pyramid_test() {
+    const ImageType types[] = { IT_F_GRAY, IT_F_PRGB };
+    for( int t=0; t<2; t++ ) {
+        for( int sub=1; sub<=3; sub++ ) {
+            int w = 301, h = 187;
+            Image im( w, h, types[t] ), out;
+            random_array( im.get_row_f(0), int(im.element_count()), 0.0f, 255.0f );
+
+            Pyramid pyr, ref;
+            pyr.build( im, 5, sub, true, true  );
+            ref.build( im, 5, sub, true, false );
+
+            // level sizes follow the scale and the levels match the resampler
+            int n_levels = 0;
+            while( n_levels < 5*sub && int( h*std::pow( 2.0, -double(n_levels)/sub ) + 0.5 ) >= PYRAMID_MIN_SIZE )
+                n_levels++;
+            bool passed = pyr.n_levels() == n_levels;
+            for( int l=0; l<pyr.n_levels() && passed; l++ ) {
+                const Image& g = pyr.gaussian(l);
+                passed = g.w() == int( w*pyr.scale(l) + 0.5f ) && g.h() == int( h*pyr.scale(l) + 0.5f )
+                    &&   compare_outputs( g.get_row_f(0), ref.gaussian(l).get_row_f(0), int(g.element_count()), true )
+                    &&   compare_outputs( pyr.laplacian(l).get_row_f(0), ref.laplacian(l).get_row_f(0), int(g.element_count()), true );
+                if( l && passed ) {
+                    Image lev;
+                    image_resample( pyr.gaussian(l-1), g.w(), g.h(), RESAMPLE_GAUSSIAN, false, lev );
+                    passed = compare_outputs( g.get_row_f(0), lev.get_row_f(0), int(g.element_count()), true );
+                }
+            }
+
+            // the laplacian pyramid reconstructs the input
+            pyr.collapse( true, out );
+            float err = max_abs_diff( im.get_row_f(0), out.get_row_f(0), int(im.element_count()) );
+            passed = passed && err < 1e-2f;
+
+            // same configuration: no reallocation, same levels
+            const float* g0  = pyr.gaussian(1).get_row_f(0);
+            size_t       mem = pyr.mem_usage();
+            random_array( im.get_row_f(0), int(im.element_count()), 0.0f, 255.0f );
+            pyr.build( im, 5, sub, true, true );
+            ref.build( im, 5, sub, true, false );
+            passed = passed && g0 == pyr.gaussian(1).get_row_f(0) && mem == pyr.mem_usage()
+                &&   compare_outputs( pyr.gaussian(pyr.n_levels()-1).get_row_f(0),
+                                      ref.gaussian(ref.n_levels()-1).get_row_f(0),
+                                      int(pyr.gaussian(pyr.n_levels()-1).element_count()), true );
+
+            char str[256];
+            sprintf( str, "pyramid %s sublevels %d [levels %2d, collapse err %.5f]",
+                     t ? "prgb" : "gray", sub, pyr.n_levels(), err );
+            report( str, passed );
+        }
+    }
+
+    // uchar gaussian pyramid stops at the minimum level size
+    {
+        Image im( 100, 40, IT_U_GRAY );
+        for( int i=0; i<100*40; i++ )
+            im.get_row_u(0)[i] = uchar( i*7 );
+        Pyramid pyr;
+        pyr.build( im, 10, 1, false, true );
+        const Image& top = pyr.gaussian( pyr.n_levels()-1 );
+        report( "pyramid uchar min size",
+                pyr.n_levels() == 3 && top.w() == 25 && top.h() == 10 && top.type() == IT_U_GRAY );
+    }
+}
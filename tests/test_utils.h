@@ -0,0 +1,126 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+#ifndef KORTEX_TEST_UTILS_H
+#define KORTEX_TEST_UTILS_H
+
+// helpers shared by the test programs - each program is a single main.cc
+// that includes this header once.
+
+#include <kortex/cpu_features.h>
+#include <kortex/filter.h>
+#include <kortex/image.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+
+using namespace kortex;
+
+/// number of failed checks - the exit code of the test programs
+static int n_failed = 0;
+
+inline void print_simd_levels() {
+    printf("host simd level   : %s\n", simd_level_name( cpu_simd_level()    ).c_str() );
+    printf("filter simd level : %s\n", simd_level_name( filter_simd_level() ).c_str() );
+}
+
+inline void report( const char* str, bool passed ) {
+    if( passed ) {
+        printf("%60s passed\n", str );
+    } else {
+        printf("%60s failed\n", str );
+        n_failed++;
+    }
+}
+
+inline void random_array( float* arr, int asz, float minv, float maxv ) {
+    for( int i=0; i<asz; i++ )
+        arr[i] = minv + (maxv-minv) * float( rand() ) / float( RAND_MAX );
+}
+
+/// bit-exact comparison for the kernels that share the scalar accumulation
+/// order (sse), tolerance based for the fused multiply-add ones - the
+/// tolerance is relative to the output range as taps with mixed signs cancel.
+inline bool compare_outputs( const float* a, const float* b, int sz, bool bit_exact ) {
+    if( bit_exact )
+        return memcmp( a, b, sizeof(*a)*sz ) == 0;
+    float range = 1.0f;
+    for( int i=0; i<sz; i++ )
+        range = std::max( range, std::fabs(a[i]) );
+    for( int i=0; i<sz; i++ ) {
+        if( std::fabs( a[i]-b[i] ) > 1e-5f * range )
+            return false;
+    }
+    return true;
+}
+
+/// channel c of the interleaved image im -> plane c of planes and back
+inline void deinterleave( const float* im, int pc, int nc, float* planes ) {
+    for( int c=0; c<nc; c++ )
+        for( int i=0; i<pc; i++ )
+            planes[c*pc+i] = im[i*nc+c];
+}
+
+inline void interleave( const float* planes, int pc, int nc, float* im ) {
+    for( int c=0; c<nc; c++ )
+        for( int i=0; i<pc; i++ )
+            im[i*nc+c] = planes[c*pc+i];
+}
+
+/// the same against the channels of a planar image
+inline void deinterleave( const float* im, int pc, int nc, Image& planes ) {
+    for( int c=0; c<nc; c++ ) {
+        float* p = planes.get_row_fi(0,c);
+        for( int i=0; i<pc; i++ )
+            p[i] = im[i*nc+c];
+    }
+}
+
+inline void interleave( const Image& planes, int pc, int nc, float* im ) {
+    for( int c=0; c<nc; c++ ) {
+        const float* p = planes.get_row_fi(0,c);
+        for( int i=0; i<pc; i++ )
+            im[i*nc+c] = p[i];
+    }
+}
+
+/// fills im with random samples in [-range,range] - [0,255] for uchar
+inline void random_samples( Image& im, const int& range ) {
+    size_t n = im.element_count();
+    for( size_t i=0; i<n; i++ ) {
+        int v = rand() % ( 2*range+1 ) - range;
+        switch( im.precision() ) {
+        case TYPE_UCHAR: im.get_uptr()[i] = uchar( rand() % 256 );                    break;
+        case TYPE_INT  : im.get_iptr()[i] = v;                                        break;
+        case TYPE_FLOAT: im.get_fptr()[i] = v * 0.25f + ( rand() % 8 ? 0.0f : 1e-7f ); break;
+        default: break;
+        }
+    }
+}
+
+inline double sample( const Image& im, const size_t& i ) {
+    switch( im.precision() ) {
+    case TYPE_UCHAR: return im.get_uptr()[i];
+    case TYPE_INT  : return im.get_iptr()[i];
+    case TYPE_FLOAT: return im.get_fptr()[i];
+    default: return 0.0;
+    }
+}
+
+/// the pixelwise operation of the pixelwise tests
+inline float pixel_halve( float v ) { return v * 0.5f - 3.0f; }
+
+#endif
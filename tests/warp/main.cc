@@ -0,0 +1,234 @@
+// ---------------------------------------------------------------------------
+//
+// This file is part of the <kortex> library suite
+//
+// Copyright (C) 2014 Engin Tola
+//
+// See LICENSE file for license information.
+//
+// author: Engin Tola
+// e-mail: engintola@gmail.com
+// web   : http://www.engintola.com
+//
+// ---------------------------------------------------------------------------
+
+#include <kortex/warp.h>
+#include <kortex/image_processing.h>
+#include <kortex/filter.h>
+#include <kortex/log_manager.h>
+#include <kortex/image.h>
+#include <kortex/math.h>
+#include <kortex/defs.h>
+
+#include "../test_utils.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+using std::vector;
+
+using namespace kortex;
+
+void warp_test();
+void interpolate_test();
+
+int main(int argc, char **argv) {
+    print_simd_levels();
+    warp_test();
+    interpolate_test();
+    release_log_man();
+    return n_failed ? 1 : 0;
+}
+
+/// warps against the per-sample interpolation functions, the simd rows
+/// against the scalar ones and the fixed-point maps against float maps of
+/// the same quantized coordinates.
+void warp_test() {
+    const InterpolationMode modes[] = { INTERP_NEAREST, INTERP_BILINEAR, INTERP_BICUBIC };
+    const char*             mnames[] = { "nearest", "bilinear", "bicubic" };
+    int w = 211, h = 157, nw = 190, nh = 170;
+
+    // identity and integer shifts copy the image
+    for( int m=0; m<3; m++ ) {
+        Image im( w, h, IT_F_PRGB ), out;
+        random_array( im.get_row_f(0), w*h*3, 0.0f, 255.0f );
+        double A[] = { 1, 0, 3, 0, 1, -2 };
+        warp_affine( im, A, w, h, modes[m], true, out, BORDER_REPLICATE );
+        bool passed = true;
+        for( int y=0; y<h && passed; y++ ) {
+            for( int x=0; x<w; x++ ) {
+                int sx = std::min( w-1, x+3 ), sy = std::max( 0, y-2 );
+                if( memcmp( out.get_row_f(y)+3*x, im.get_row_f(sy)+3*sx, 3*sizeof(float) ) ) { passed = false; break; }
+            }
+        }
+        char str[256];
+        sprintf( str, "warp %-8s integer shift", mnames[m] );
+        report( str, passed );
+    }
+
+    // rotation and scaling against bilinear_interpolation / bicubic_interpolation
+    double a = 0.3, s = 1.2;
+    double A[] = { s*cos(a), -s*sin(a), 40.0, s*sin(a), s*cos(a), -30.0 };
+    double H[] = { A[0], A[1], A[2], A[3], A[4], A[5], 0.0, 0.0, 1.0 };
+    const SimdLevel levels[] = { SIMD_NONE, SIMD_AVX512 };
+    for( int m=0; m<3; m++ ) {
+        Image im( w, h, IT_F_GRAY ), uim( w, h, IT_U_GRAY ), ref, out, par, per, uout;
+        random_array( im.get_row_f(0), w*h, 0.0f, 255.0f );
+        for( int i=0; i<w*h; i++ ) {
+            uim.get_row_u(0)[i] = uchar( im.get_row_f(0)[i] );
+            im .get_row_f(0)[i] = uim.get_row_u(0)[i];
+        }
+        filter_set_simd_level( levels[0] );
+        warp_affine( im, A, nw, nh, modes[m], false, ref );
+        filter_set_simd_level( levels[1] );
+        warp_affine     ( im, A, nw, nh, modes[m], false, out );
+        warp_affine     ( im, A, nw, nh, modes[m], true,  par );
+        warp_perspective( im, H, nw, nh, modes[m], true,  per );
+        warp_affine     ( uim, A, nw, nh, modes[m], true, uout );
+        bool  passed = compare_outputs( ref.get_row_f(0), out.get_row_f(0), nw*nh, false )
+            &&         compare_outputs( out.get_row_f(0), par.get_row_f(0), nw*nh, true  )
+            &&         compare_outputs( out.get_row_f(0), per.get_row_f(0), nw*nh, false );
+        float err = 0.0f;
+        for( int y=0; y<nh; y++ ) {
+            for( int x=0; x<nw; x++ ) {
+                float sx = float( A[0]*x + A[1]*y + A[2] );
+                float sy = float( A[3]*x + A[4]*y + A[5] );
+                float o  = out.get_row_f(y)[x];
+                float e  = std::min( 255.0f, std::max( 0.0f, o ) );
+                if( std::fabs( e - uout.get_row_u(y)[x] ) > 0.5f+1e-3f ) passed = false;
+                if( sx < 3 || sy < 3 || sx >= w-4 || sy >= h-4 ) continue;
+                float r = 0.0f;
+                switch( m ) {
+                case 0: r = im.get_row_f( int(std::floor(sy+0.5f)) )[ int(std::floor(sx+0.5f)) ];  break;
+                case 1: r = bilinear_interpolation( im.get_row_f(0), w, h, 1, 0, sx, sy ); break;
+                case 2: r = bicubic_interpolation ( im.get_row_f(0), w, h, 1, 0, sx, sy ); break;
+                }
+                // nearest can round the other way at half pixels
+                if( m == 0 && ( std::fabs( sx-std::floor(sx)-0.5f ) < 1e-3f || std::fabs( sy-std::floor(sy)-0.5f ) < 1e-3f ) )
+                    continue;
+                err = std::max( err, std::fabs( o - r ) );
+            }
+        }
+        passed = passed && err < 1e-2f;
+        char str[256];
+        sprintf( str, "warp %-8s affine [err %.5f]", mnames[m], err );
+        report( str, passed );
+    }
+
+    // perspective with the zero border: outside samples are zero
+    {
+        Image im( w, h, IT_F_GRAY ), out;
+        std::fill( im.get_row_f(0), im.get_row_f(0)+w*h, 7.0f );
+        double P[] = { 1.0, 0.1, -20.0, 0.05, 1.0, -10.0, 0.001, 0.002, 1.0 };
+        warp_perspective( im, P, nw, nh, INTERP_BILINEAR, true, out );
+        bool passed = true;
+        for( int y=0; y<nh; y++ ) {
+            for( int x=0; x<nw; x++ ) {
+                double u = P[0]*x + P[1]*y + P[2], v = P[3]*x + P[4]*y + P[5], q = P[6]*x + P[7]*y + P[8];
+                double sx = u/q, sy = v/q;
+                float  o  = out.get_row_f(y)[x];
+                if( sx > 0.01 && sy > 0.01 && sx < w-1.01 && sy < h-1.01 ) passed = passed && std::fabs( o-7.0f ) < 1e-4f;
+                if( sx < -1.01 || sy < -1.01 || sx > w+0.01 || sy > h+0.01 ) passed = passed && o == 0.0f;
+            }
+        }
+        report( "warp perspective zero border", passed );
+    }
+
+    // fixed-point maps
+    for( int t=0; t<2; t++ ) {
+        ImageType type = t ? IT_U_PRGB : IT_F_PRGB;
+        Image im( w, h, type ), fim( w, h, IT_F_PRGB ), out, ref, mapx( nw, nh, IT_F_GRAY ), mapy( nw, nh, IT_F_GRAY );
+        random_array( fim.get_row_f(0), w*h*3, 0.0f, 255.0f );
+        for( int i=0; i<w*h*3; i++ ) {
+            fim.get_row_f(0)[i] = float( int( fim.get_row_f(0)[i] ) );
+            if( t ) im.get_row_u(0)[i] = uchar( fim.get_row_f(0)[i] );
+            else    im.get_row_f(0)[i] = fim.get_row_f(0)[i];
+        }
+        WarpMap map;
+        warp_map_affine( A, nw, nh, false, map );
+        for( int i=0; i<nw*nh; i++ ) {
+            mapx.get_row_f(0)[i] = map.xy[2*i  ] + ( map.frac[i] % WARP_MAP_FRAC ) / float(WARP_MAP_FRAC);
+            mapy.get_row_f(0)[i] = map.xy[2*i+1] + ( map.frac[i] / WARP_MAP_FRAC ) / float(WARP_MAP_FRAC);
+        }
+        remap( im,  map,                         true, out, BORDER_REFLECT_101 );
+        remap( fim, mapx, mapy, INTERP_BILINEAR, true, ref, BORDER_REFLECT_101 );
+        float err = 0.0f;
+        for( int i=0; i<nw*nh*3; i++ ) {
+            float o = t ? out.get_row_u(0)[i] : out.get_row_f(0)[i];
+            err = std::max( err, std::fabs( o - ref.get_row_f(0)[i] ) );
+        }
+        // the map of the float maps is the same map
+        WarpMap map2;
+        warp_map( mapx, mapy, true, map2 );
+        bool passed = map2.xy == map.xy && map2.frac == map.frac && err < ( t ? 0.5f+1e-3f : 1e-3f );
+        char str[256];
+        sprintf( str, "warp map remap %s [err %.5f]", t ? "uchar" : "float", err );
+        report( str, passed );
+    }
+}
+
+/// batch interpolation against the per-point functions, and the bucketed
+/// path - forced by a zero threshold - against the direct one
+void interpolate_test() {
+    const ImageType types[] = { IT_F_GRAY, IT_U_GRAY, IT_F_PRGB, IT_U_IRGB };
+    const char*     tnames[] = { "f gray", "u gray", "f prgb", "u irgb" };
+    for( int t=0; t<4; t++ ) {
+        for( int big=0; big<2; big++ ) {
+            int w = big ? 700 : 120, h = big ? 500 : 90, n = big ? 20000 : 1000;
+            Image im( w, h, types[t] );
+            int   ch = im.ch();
+            int   ne = int( im.element_count() );
+            vector<float> fim( ne );
+            random_array( &fim[0], ne, 0.0f, 255.0f );
+            for( int i=0; i<ne; i++ ) {
+                if( im.precision() == TYPE_UCHAR ) im.get_row_ui(0,0)[i] = uchar( fim[i] );
+                else                               im.get_row_f(0)[i] = fim[i];
+            }
+            // the per-point functions take pixel ordered channels
+            vector<float> pim( ne );
+            for( int i=0; i<ne; i++ ) pim[i] = ( im.precision() == TYPE_UCHAR ) ? im.get_row_ui(0,0)[i] : im.get_row_f(0)[i];
+            if( types[t] == IT_U_IRGB ) {
+                vector<float> planes( pim );
+                interleave( &planes[0], w*h, 3, &pim[0] );
+            }
+
+            vector<float> xs( n ), ys( n ), out( n*ch ), par( n*ch );
+            random_array( &xs[0], n, -3.0f, w+2.0f );
+            random_array( &ys[0], n, -3.0f, h+2.0f );
+            bool passed = true;
+            for( int m=1; m<3; m++ ) {
+                InterpolationMode mode = m == 1 ? INTERP_BILINEAR : INTERP_BICUBIC;
+                image_interpolate( im, &xs[0], &ys[0], n, mode, false, &out[0] );
+                image_interpolate( im, &xs[0], &ys[0], n, mode, true,  &par[0] );
+                passed = passed && compare_outputs( &out[0], &par[0], n*ch, true );
+                float err = 0.0f;
+                for( int i=0; i<n; i++ ) {
+                    if( xs[i] < 2 || ys[i] < 2 || xs[i] >= w-3 || ys[i] >= h-3 ) continue;
+                    for( int c=0; c<ch; c++ ) {
+                        float r = m == 1 ? bilinear_interpolation( &pim[0], w, h, ch, c, xs[i], ys[i] )
+                            :              bicubic_interpolation ( &pim[0], w, h, ch, c, xs[i], ys[i] );
+                        err = std::max( err, std::fabs( r - out[i*ch+c] ) );
+                    }
+                }
+                passed = passed && err < 1e-3f;
+
+                if( big ) {
+                    vector<float> bkt( n*ch ), bpar( n*ch );
+                    image_interpolate( im, &xs[0], &ys[0], n, mode, false, &bkt [0], BORDER_REPLICATE, 0 );
+                    image_interpolate( im, &xs[0], &ys[0], n, mode, true,  &bpar[0], BORDER_REPLICATE, 0 );
+                    bool bucketed = compare_outputs( &out[0], &bkt[0], n*ch, true ) &&
+                        compare_outputs( &out[0], &bpar[0], n*ch, true );
+                    char str[256];
+                    sprintf( str, "image_interpolate %s bucketed vs direct mode %d", tnames[t], m );
+                    report( str, bucketed );
+                }
+            }
+            char str[256];
+            sprintf( str, "image_interpolate %s %s batch", tnames[t], big ? "large" : "small" );
+            report( str, passed );
+        }
+    }
+}